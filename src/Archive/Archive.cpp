@@ -1298,6 +1298,53 @@ string Archive::detectNamespace(ArchiveEntry* entry)
 		return "global"; // Error, just return global
 }
 
+// -----------------------------------------------------------------------------
+// Returns true if [entry] matches the search criteria in [options].
+// The match_name in [options] must be uppercase
+// -----------------------------------------------------------------------------
+bool Archive::matchesSearch(ArchiveEntry* entry, const SearchOptions& options)
+{
+	// Check type
+	if (options.match_type)
+	{
+		if (entry->type() == EntryType::unknownType())
+		{
+			if (!options.match_type->isThisType(*entry))
+				return false;
+		}
+		else if (options.match_type != entry->type())
+			return false;
+	}
+
+	// Check name
+	if (!options.match_name.empty())
+	{
+		// Cut extension if ignoring
+		auto check_name = options.ignore_ext ? entry->upperNameNoExt() : entry->upperName();
+		if (!strutil::matches(check_name, options.match_name))
+			return false;
+	}
+
+	// Check namespace
+	if (!options.match_namespace.empty())
+	{
+		if (!strutil::equalCI(detectNamespace(entry), options.match_namespace))
+			return false;
+	}
+
+	// Entry passed all checks
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if [options] matches an exact entry name (no wildcards), in
+// which case entries can be looked up by name rather than checking them all
+// -----------------------------------------------------------------------------
+bool Archive::isExactNameSearch(const SearchOptions& options)
+{
+	return !options.match_name.empty() && options.match_name.find_first_of("*?") == string::npos;
+}
+
 // -----------------------------------------------------------------------------
 // Returns the first entry matching the search criteria in [options], or null if
 // no matching entry was found
@@ -1313,40 +1360,21 @@ ArchiveEntry* Archive::findFirst(SearchOptions& options)
 	// Begin search
 
 	// Search entries
-	for (unsigned a = 0; a < dir->numEntries(); a++)
+	if (isExactNameSearch(options))
 	{
-		auto entry = dir->entryAt(a);
-
-		// Check type
-		if (options.match_type)
-		{
-			if (entry->type() == EntryType::unknownType())
-			{
-				if (!options.match_type->isThisType(*entry))
-					continue;
-			}
-			else if (options.match_type != entry->type())
-				continue;
-		}
-
-		// Check name
-		if (!options.match_name.empty())
-		{
-			// Cut extension if ignoring
-			auto check_name = options.ignore_ext ? entry->upperNameNoExt() : entry->upperName();
-			if (!strutil::matches(check_name, options.match_name))
-				continue;
-		}
-
-		// Check namespace
-		if (!options.match_namespace.empty())
+		// Only need to check entries with the exact name
+		for (auto entry : dir->entriesNamed(options.match_name, options.ignore_ext))
+			if (matchesSearch(entry, options))
+				return entry;
+	}
+	else
+	{
+		for (unsigned a = 0; a < dir->numEntries(); a++)
 		{
-			if (!strutil::equalCI(detectNamespace(entry), options.match_namespace))
-				continue;
+			auto entry = dir->entryAt(a);
+			if (matchesSearch(entry, options))
+				return entry;
 		}
-
-		// Entry passed all checks so far, so we found a match
-		return entry;
 	}
 
 	// Search subdirectories (if needed)
@@ -1383,40 +1411,22 @@ ArchiveEntry* Archive::findLast(SearchOptions& options)
 	// Begin search
 
 	// Search entries (bottom-up)
-	for (int a = dir->numEntries() - 1; a >= 0; a--)
+	if (isExactNameSearch(options))
 	{
-		auto entry = dir->entryAt(a);
-
-		// Check type
-		if (options.match_type)
-		{
-			if (entry->type() == EntryType::unknownType())
-			{
-				if (!options.match_type->isThisType(*entry))
-					continue;
-			}
-			else if (options.match_type != entry->type())
-				continue;
-		}
-
-		// Check name
-		if (!options.match_name.empty())
-		{
-			// Cut extension if ignoring
-			auto check_name = options.ignore_ext ? entry->upperNameNoExt() : entry->upperName();
-			if (!strutil::matches(check_name, options.match_name))
-				continue;
-		}
-
-		// Check namespace
-		if (!options.match_namespace.empty())
+		// Only need to check entries with the exact name
+		auto& entries = dir->entriesNamed(options.match_name, options.ignore_ext);
+		for (auto i = entries.rbegin(); i != entries.rend(); ++i)
+			if (matchesSearch(*i, options))
+				return *i;
+	}
+	else
+	{
+		for (int a = dir->numEntries() - 1; a >= 0; a--)
 		{
-			if (!strutil::equalCI(detectNamespace(entry), options.match_namespace))
-				continue;
+			auto entry = dir->entryAt(a);
+			if (matchesSearch(entry, options))
+				return entry;
 		}
-
-		// Entry passed all checks so far, so we found a match
-		return entry;
 	}
 
 	// Search subdirectories (if needed) (bottom-up)
@@ -1453,40 +1463,21 @@ vector<ArchiveEntry*> Archive::findAll(SearchOptions& options)
 	// Begin search
 
 	// Search entries
-	for (unsigned a = 0; a < dir->numEntries(); a++)
+	if (isExactNameSearch(options))
 	{
-		auto entry = dir->entryAt(a);
-
-		// Check type
-		if (options.match_type)
-		{
-			if (entry->type() == EntryType::unknownType())
-			{
-				if (!options.match_type->isThisType(*entry))
-					continue;
-			}
-			else if (options.match_type != entry->type())
-				continue;
-		}
-
-		// Check name
-		if (!options.match_name.empty())
-		{
-			// Cut extension if ignoring
-			auto check_name = options.ignore_ext ? entry->upperNameNoExt() : entry->upperName();
-			if (!strutil::matches(check_name, options.match_name))
-				continue;
-		}
-
-		// Check namespace
-		if (!options.match_namespace.empty())
+		// Only need to check entries with the exact name
+		for (auto entry : dir->entriesNamed(options.match_name, options.ignore_ext))
+			if (matchesSearch(entry, options))
+				ret.push_back(entry);
+	}
+	else
+	{
+		for (unsigned a = 0; a < dir->numEntries(); a++)
 		{
-			if (!strutil::equalCI(detectNamespace(entry), options.match_namespace))
-				continue;
+			auto entry = dir->entryAt(a);
+			if (matchesSearch(entry, options))
+				ret.push_back(entry);
 		}
-
-		// Entry passed all checks so far, so we found a match
-		ret.push_back(entry);
 	}
 
 	// Search subdirectories (if needed)
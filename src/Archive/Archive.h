@@ -192,6 +192,9 @@ private:
 	Signals                signals_;
 
 	static vector<ArchiveFormat> formats_;
+
+	bool        matchesSearch(ArchiveEntry* entry, const SearchOptions& options);
+	static bool isExactNameSearch(const SearchOptions& options);
 };
 
 // Base class for list-based archive formats
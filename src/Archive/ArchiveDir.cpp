@@ -41,6 +41,40 @@
 using namespace slade;
 
 
+// -----------------------------------------------------------------------------
+//
+// Functions
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// -----------------------------------------------------------------------------
+// Returns [name] without its extension (everything from the first .)
+// -----------------------------------------------------------------------------
+string_view nameNoExt(string_view name)
+{
+	auto ext_pos = name.find('.');
+	return ext_pos == string_view::npos ? name : name.substr(0, ext_pos);
+}
+
+// -----------------------------------------------------------------------------
+// Removes [entry] from the list at [key] in [index], removing the list
+// entirely if it becomes empty
+// -----------------------------------------------------------------------------
+void removeFromIndexList(std::unordered_map<string, vector<ArchiveEntry*>>& index, const string& key, ArchiveEntry* entry)
+{
+	auto i = index.find(key);
+	if (i == index.end())
+		return;
+
+	auto& list = i->second;
+	list.erase(std::remove(list.begin(), list.end(), entry), list.end());
+	if (list.empty())
+		index.erase(i);
+}
+} // namespace
+
+
 // -----------------------------------------------------------------------------
 //
 // ArchiveDir Class Functions
@@ -102,49 +136,31 @@ void ArchiveDir::setArchive(Archive* archive)
 
 // -----------------------------------------------------------------------------
 // Returns the index of [entry] within this directory, or -1 if the entry
-// doesn't exist
+// doesn't exist (or is before [startfrom])
 // -----------------------------------------------------------------------------
 int ArchiveDir::entryIndex(ArchiveEntry* entry, size_t startfrom) const
 {
-	// Check entry was given
-	if (!entry)
+	// Check entry was given and is in this directory
+	if (!entry || entry->parent_ != this)
 		return -1;
 
-	// Search for it
-	const size_t size = entries_.size();
-	if (entry->index_guess_ < startfrom || entry->index_guess_ >= size)
-	{
-		for (auto a = startfrom; a < size; a++)
-		{
-			if (entries_[a].get() == entry)
-			{
-				entry->index_guess_ = a;
-				return (int)a;
-			}
-		}
-	}
-	else
+	// Renumber entries if the index isn't up to date
+	if (entry->index_ >= index_valid_)
+		updateIndices();
+
+	// Check the index is correct (it always should be)
+	auto index = entry->index_;
+	if (index >= entries_.size() || entries_[index].get() != entry)
 	{
-		for (auto a = entry->index_guess_; a < size; a++)
-		{
-			if (entries_[a].get() == entry)
-			{
-				entry->index_guess_ = a;
-				return (int)a;
-			}
-		}
-		for (auto a = startfrom; a < entry->index_guess_; a++)
-		{
-			if (entries_[a].get() == entry)
-			{
-				entry->index_guess_ = a;
-				return (int)a;
-			}
-		}
+		auto i = std::find_if(
+			entries_.begin(), entries_.end(), [entry](const shared_ptr<ArchiveEntry>& e) { return e.get() == entry; });
+		if (i == entries_.end())
+			return -1;
+
+		index = i - entries_.begin();
 	}
 
-	// Not found
-	return -1;
+	return index >= startfrom ? static_cast<int>(index) : -1;
 }
 
 // -----------------------------------------------------------------------------
@@ -206,16 +222,9 @@ ArchiveEntry* ArchiveDir::entry(string_view name, bool cut_ext) const
 	if (name.empty())
 		return nullptr;
 
-	// Go through entries
-	for (auto& entry : entries_)
-	{
-		// Check for (non-case-sensitive) name match
-		if (strutil::equalCI(cut_ext ? entry->nameNoExt() : entry->name(), name))
-			return entry.get();
-	}
-
-	// Not found
-	return nullptr;
+	// Get first entry with (non-case-sensitive) name match
+	auto& matches = entriesNamed(name, cut_ext);
+	return matches.empty() ? nullptr : matches[0];
 }
 
 // -----------------------------------------------------------------------------
@@ -224,20 +233,12 @@ ArchiveEntry* ArchiveDir::entry(string_view name, bool cut_ext) const
 // -----------------------------------------------------------------------------
 shared_ptr<ArchiveEntry> ArchiveDir::sharedEntry(string_view name, bool cut_ext) const
 {
-	// Check name was given
-	if (name.empty())
+	auto match = entry(name, cut_ext);
+	if (!match)
 		return nullptr;
 
-	// Go through entries
-	for (auto& entry : entries_)
-	{
-		// Check for (non-case-sensitive) name match
-		if (strutil::equalCI(cut_ext ? entry->nameNoExt() : entry->name(), name))
-			return entry;
-	}
-
-	// Not found
-	return nullptr;
+	auto index = entryIndex(match);
+	return index >= 0 ? entries_[index] : nullptr;
 }
 
 // -----------------------------------------------------------------------------
@@ -255,6 +256,24 @@ shared_ptr<ArchiveEntry> ArchiveDir::sharedEntry(ArchiveEntry* entry) const
 	return nullptr;
 }
 
+// -----------------------------------------------------------------------------
+// Returns all entries in this directory matching [name] (case-insensitive), in
+// directory order. If [cut_ext] is true, entry names are matched without their
+// extensions.
+// The returned list is only valid until the directory is next modified
+// -----------------------------------------------------------------------------
+const vector<ArchiveEntry*>& ArchiveDir::entriesNamed(string_view name, bool cut_ext) const
+{
+	static const vector<ArchiveEntry*> no_entries;
+
+	if (!name_index_built_)
+		buildNameIndex();
+
+	auto& index = cut_ext ? name_noext_index_ : name_index_;
+	auto  i     = index.find(strutil::upper(name));
+	return i == index.end() ? no_entries : i->second;
+}
+
 // -----------------------------------------------------------------------------
 // Returns the number of entries in this directory
 // -----------------------------------------------------------------------------
@@ -287,11 +306,25 @@ bool ArchiveDir::addEntry(shared_ptr<ArchiveEntry> entry, unsigned index)
 		entry->parent_->removeEntry(entry->index());
 	entry->parent_ = this;
 
+	// Update name index (needs to be done before inserting for ordering)
+	if (name_index_built_)
+		addToNameIndex(entry.get(), std::min<unsigned>(index, entries_.size()));
+
 	// Check index
 	if (index >= entries_.size())
-		entries_.push_back(entry); // 'Invalid' index, add to end of list
+	{
+		// 'Invalid' index, add to end of list
+		entry->index_ = entries_.size();
+		if (index_valid_ == entries_.size())
+			++index_valid_;
+		entries_.push_back(entry);
+	}
 	else
-		entries_.insert(entries_.begin() + index, entry); // Add it at index
+	{
+		// Add it at index (entries after it will need renumbering)
+		entries_.insert(entries_.begin() + index, entry);
+		index_valid_ = std::min<size_t>(index_valid_, index);
+	}
 
 	// Check entry name if duplicate names aren't allowed
 	if (!allow_duplicate_names_)
@@ -310,11 +343,16 @@ bool ArchiveDir::removeEntry(unsigned index)
 	if (index >= entries_.size())
 		return false;
 
+	// Remove from name index
+	if (name_index_built_)
+		removeFromNameIndex(entries_[index].get(), entries_[index]->upperName());
+
 	// De-parent entry
 	entries_[index]->parent_ = nullptr;
 
-	// Remove it from the entry list
+	// Remove it from the entry list (entries after it will need renumbering)
 	entries_.erase(entries_.begin() + index);
+	index_valid_ = std::min<size_t>(index_valid_, index);
 
 	return true;
 }
@@ -331,6 +369,21 @@ bool ArchiveDir::swapEntries(unsigned index1, unsigned index2)
 
 	// Swap entries
 	entries_[index1].swap(entries_[index2]);
+	if (index1 < index_valid_)
+		entries_[index1]->index_ = index1;
+	if (index2 < index_valid_)
+		entries_[index2]->index_ = index2;
+
+	// Re-add to name index so that order is correct for any duplicate names
+	if (name_index_built_)
+	{
+		auto entry1 = entries_[index1].get();
+		auto entry2 = entries_[index2].get();
+		removeFromNameIndex(entry1, entry1->upperName());
+		removeFromNameIndex(entry2, entry2->upperName());
+		addToNameIndex(entry1, index1);
+		addToNameIndex(entry2, index2);
+	}
 
 	return true;
 }
@@ -344,11 +397,17 @@ shared_ptr<ArchiveDir> ArchiveDir::subdir(string_view name)
 	if (name.back() == '/')
 		name.remove_suffix(1);
 
-	for (auto&& dir : subdirs_)
-		if (strutil::equalCI(dir->name(), name))
-			return dir;
+	// Build subdir index if needed
+	if (!subdir_index_built_)
+	{
+		subdir_index_.clear();
+		for (unsigned a = 0; a < subdirs_.size(); ++a)
+			subdir_index_.emplace(strutil::upper(subdirs_[a]->name()), a);
+		subdir_index_built_ = true;
+	}
 
-	return nullptr;
+	auto i = subdir_index_.find(strutil::upper(name));
+	return i != subdir_index_.end() ? subdirs_[i->second] : nullptr;
 }
 
 // -----------------------------------------------------------------------------
@@ -385,6 +444,7 @@ bool ArchiveDir::addSubdir(shared_ptr<ArchiveDir> subdir, unsigned index)
 		subdirs_.push_back(subdir);
 	else
 		subdirs_.insert(subdirs_.begin() + index, subdir);
+	subdir_index_built_ = false;
 
 	// Copy some properties to the subdir
 	subdir->archive_               = archive_;
@@ -407,6 +467,7 @@ shared_ptr<ArchiveDir> ArchiveDir::removeSubdir(string_view name)
 		{
 			removed = subdirs_[i];
 			subdirs_.erase(subdirs_.begin() + i);
+			subdir_index_built_ = false;
 			break;
 		}
 
@@ -424,6 +485,7 @@ shared_ptr<ArchiveDir> ArchiveDir::removeSubdirAt(unsigned index)
 
 	auto removed = subdirs_[index];
 	subdirs_.erase(subdirs_.begin() + index);
+	subdir_index_built_ = false;
 
 	return removed;
 }
@@ -434,7 +496,13 @@ shared_ptr<ArchiveDir> ArchiveDir::removeSubdirAt(unsigned index)
 void ArchiveDir::clear()
 {
 	entries_.clear();
+	index_valid_ = 0;
 	subdirs_.clear();
+	name_index_.clear();
+	name_noext_index_.clear();
+	subdir_index_.clear();
+	name_index_built_   = false;
+	subdir_index_built_ = false;
 }
 
 // -----------------------------------------------------------------------------
@@ -447,6 +515,7 @@ shared_ptr<ArchiveDir> ArchiveDir::clone(shared_ptr<ArchiveDir> parent)
 	// Create copy
 	auto copy        = std::make_shared<ArchiveDir>(name(), parent ? parent : parent_dir_.lock(), archive_);
 	copy->dir_entry_ = std::make_shared<ArchiveEntry>(*dir_entry_);
+	copy->dir_entry_->parent_ = copy->parent().get();
 
 	// Copy entries
 	for (auto& entry : entries_)
@@ -498,34 +567,107 @@ bool ArchiveDir::exportTo(string_view path)
 // -----------------------------------------------------------------------------
 void ArchiveDir::ensureUniqueName(ArchiveEntry* entry)
 {
-	unsigned      index     = 0;
-	unsigned      number    = 0;
-	const auto    n_entries = entries_.size();
+	unsigned      number = 0;
 	strutil::Path fn(entry->name());
 	auto          name = fn.fileName();
-	while (index < n_entries)
-	{
-		if (entries_[index].get() == entry)
-		{
-			index++;
-			continue;
-		}
 
-		if (strutil::equalCI(entries_[index]->name(), name))
-		{
-			fn.setFileName(fmt::format("{}{}", entry->nameNoExt(), ++number));
-			name  = fn.fileName();
-			index = 0;
-			continue;
-		}
+	// Returns true if any entry other than [entry] has name [name]
+	auto name_taken = [&]() {
+		for (auto other : entriesNamed(name))
+			if (other != entry)
+				return true;
+		return false;
+	};
 
-		index++;
+	while (name_taken())
+	{
+		fn.setFileName(fmt::format("{}{}", entry->nameNoExt(), ++number));
+		name = fn.fileName();
 	}
 
 	if (number > 0)
 		entry->rename(name);
 }
 
+// -----------------------------------------------------------------------------
+// Builds the name lookup indices for all entries in this directory
+// -----------------------------------------------------------------------------
+void ArchiveDir::buildNameIndex() const
+{
+	name_index_.clear();
+	name_noext_index_.clear();
+
+	for (auto& entry : entries_)
+	{
+		name_index_[entry->upperName()].push_back(entry.get());
+		name_noext_index_[string{ entry->upperNameNoExt() }].push_back(entry.get());
+	}
+
+	name_index_built_ = true;
+}
+
+// -----------------------------------------------------------------------------
+// Renumbers the indices of any entries that may have moved since they were
+// last numbered
+// -----------------------------------------------------------------------------
+void ArchiveDir::updateIndices() const
+{
+	for (auto a = index_valid_; a < entries_.size(); ++a)
+		entries_[a]->index_ = a;
+
+	index_valid_ = entries_.size();
+}
+
+// -----------------------------------------------------------------------------
+// Adds [entry] to the name lookup indices, where [index] is the position of
+// [entry] in the directory. Any other entries currently at or after [index]
+// are considered to come after [entry]
+// -----------------------------------------------------------------------------
+void ArchiveDir::addToNameIndex(ArchiveEntry* entry, unsigned index) const
+{
+	auto insert_ordered = [&](vector<ArchiveEntry*>& list) {
+		// Entries are most often added at the end, so search from the back
+		auto pos = list.end();
+		while (pos != list.begin() && entryIndex(*(pos - 1)) >= static_cast<int>(index))
+			--pos;
+		list.insert(pos, entry);
+	};
+
+	insert_ordered(name_index_[entry->upperName()]);
+	insert_ordered(name_noext_index_[string{ entry->upperNameNoExt() }]);
+}
+
+// -----------------------------------------------------------------------------
+// Removes [entry] from the name lookup indices, where [upper_name] is the
+// (uppercase) name it was indexed with
+// -----------------------------------------------------------------------------
+void ArchiveDir::removeFromNameIndex(ArchiveEntry* entry, string_view upper_name) const
+{
+	removeFromIndexList(name_index_, string{ upper_name }, entry);
+	removeFromIndexList(name_noext_index_, string{ nameNoExt(upper_name) }, entry);
+}
+
+// -----------------------------------------------------------------------------
+// Called when [entry] (in this directory) is renamed from [old_upper_name]
+// -----------------------------------------------------------------------------
+void ArchiveDir::entryRenamed(ArchiveEntry* entry, string_view old_upper_name)
+{
+	// Subdirectory renamed
+	if (entry->type_ == EntryType::folderType())
+		subdir_index_built_ = false;
+
+	if (!name_index_built_)
+		return;
+
+	// Ignore if the entry isn't indexed (eg. a subdirectory)
+	auto i = name_index_.find(string{ old_upper_name });
+	if (i == name_index_.end() || std::find(i->second.begin(), i->second.end(), entry) == i->second.end())
+		return;
+
+	removeFromNameIndex(entry, old_upper_name);
+	addToNameIndex(entry, entryIndex(entry));
+}
+
 
 // -----------------------------------------------------------------------------
 //
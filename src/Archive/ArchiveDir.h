@@ -1,12 +1,14 @@
 #pragma once
 
 #include "ArchiveEntry.h"
+#include <unordered_map>
 
 namespace slade
 {
 class ArchiveDir
 {
 	friend class Archive;
+	friend class ArchiveEntry;
 
 public:
 	ArchiveDir(string_view name, const shared_ptr<ArchiveDir>& parent = nullptr, Archive* archive = nullptr);
@@ -31,6 +33,7 @@ public:
 	ArchiveEntry*                    entry(string_view name, bool cut_ext = false) const;
 	shared_ptr<ArchiveEntry>         sharedEntry(string_view name, bool cut_ext = false) const;
 	shared_ptr<ArchiveEntry>         sharedEntry(ArchiveEntry* entry) const;
+	const vector<ArchiveEntry*>&     entriesNamed(string_view name, bool cut_ext = false) const;
 	unsigned                         numEntries(bool inc_subdirs = false) const;
 	int                              entryIndex(ArchiveEntry* entry, size_t startfrom = 0) const;
 	vector<shared_ptr<ArchiveEntry>> allEntries() const;
@@ -84,6 +87,23 @@ private:
 	vector<shared_ptr<ArchiveDir>>   subdirs_;
 	bool                             allow_duplicate_names_ = true;
 
+	// Entry indices (ArchiveEntry::index_) are renumbered lazily, all entries
+	// before this position have a valid index
+	mutable size_t index_valid_ = 0;
+
+	// Case-insensitive name lookup indices (built when first needed)
+	typedef std::unordered_map<string, vector<ArchiveEntry*>> NameIndex;
+	mutable NameIndex                               name_index_;       // Upper name -> entries (in dir order)
+	mutable NameIndex                               name_noext_index_; // Upper name without extension -> entries
+	mutable bool                                    name_index_built_ = false;
+	mutable std::unordered_map<string, unsigned>    subdir_index_; // Upper name -> index of first subdir with name
+	mutable bool                                    subdir_index_built_ = false;
+
 	void ensureUniqueName(ArchiveEntry* entry);
+	void updateIndices() const;
+	void buildNameIndex() const;
+	void addToNameIndex(ArchiveEntry* entry, unsigned index) const;
+	void removeFromNameIndex(ArchiveEntry* entry, string_view upper_name) const;
+	void entryRenamed(ArchiveEntry* entry, string_view old_upper_name);
 };
 } // namespace slade
@@ -83,7 +83,7 @@ ArchiveEntry::ArchiveEntry(ArchiveEntry& copy)
 	locked_      = false;
 	reliability_ = copy.reliability_;
 	encrypted_   = copy.encrypted_;
-	index_guess_ = 0;
+	index_       = 0;
 
 	// Copy data
 	data_.importMem(copy.rawData(true), copy.size());
@@ -164,8 +164,9 @@ string ArchiveEntry::path(bool include_name) const
 // -----------------------------------------------------------------------------
 const uint8_t* ArchiveEntry::rawData(bool allow_load)
 {
-	// Return entry data
-	return data(allow_load).data();
+	// Return entry data (read-only, so a view of the data isn't copied)
+	const auto& mc = data(allow_load);
+	return mc.data();
 }
 
 // -----------------------------------------------------------------------------
@@ -228,8 +229,13 @@ int ArchiveEntry::index()
 // -----------------------------------------------------------------------------
 void ArchiveEntry::setName(string_view name)
 {
-	name_       = name;
-	upper_name_ = strutil::upper(name);
+	auto old_upper_name = upper_name_;
+	name_               = name;
+	upper_name_         = strutil::upper(name_);
+
+	// Update parent dir name lookup
+	if (parent_ && upper_name_ != old_upper_name)
+		parent_->entryRenamed(this, old_upper_name);
 }
 
 // -----------------------------------------------------------------------------
@@ -300,17 +306,14 @@ void ArchiveEntry::unlock()
 // -----------------------------------------------------------------------------
 void ArchiveEntry::formatName(const ArchiveFormat& format)
 {
-	bool changed = false;
+	auto old_upper_name = upper_name_;
 
 	// Perform character substitution if needed
 	name_ = misc::fileNameToLumpName(name_);
 
 	// Max length
 	if (format.max_name_length > 0 && (int)name_.size() > format.max_name_length)
-	{
 		strutil::truncateIP(name_, format.max_name_length);
-		changed = true;
-	}
 
 	// Uppercase
 	if (format.prefer_uppercase && wad_force_uppercase)
@@ -318,10 +321,7 @@ void ArchiveEntry::formatName(const ArchiveFormat& format)
 
 	// Remove \ or / if the format supports folders
 	if (format.supports_dirs && name_.find('/') != string::npos || name_.find('\\') != string::npos)
-	{
-		name_   = misc::lumpNameToFileName(name_);
-		changed = true;
-	}
+		name_ = misc::lumpNameToFileName(name_);
 
 	// Remove extension if the format doesn't have them
 	if (!format.names_extensions)
@@ -329,8 +329,9 @@ void ArchiveEntry::formatName(const ArchiveFormat& format)
 			strutil::truncateIP(name_, pos);
 
 	// Update upper name
-	if (changed)
-		upper_name_ = strutil::upper(name_);
+	upper_name_ = strutil::upper(name_);
+	if (parent_ && upper_name_ != old_upper_name)
+		parent_->entryRenamed(this, old_upper_name);
 }
 
 // -----------------------------------------------------------------------------
@@ -441,6 +442,38 @@ bool ArchiveEntry::importMemChunk(MemChunk& mc)
 	return false;
 }
 
+// -----------------------------------------------------------------------------
+// Imports [size] bytes at [offset] in [mc] into the entry, clearing any
+// currently existing data. If [mc] is a view (eg. of a memory mapped file),
+// the entry data will reference the same memory rather than copying it (see
+// MemChunk::importView).
+// Returns false if the range is invalid, true otherwise
+// -----------------------------------------------------------------------------
+bool ArchiveEntry::importView(const MemChunk& mc, uint32_t offset, uint32_t size)
+{
+	// Check if locked
+	if (locked_)
+	{
+		global::error = "Entry is locked";
+		return false;
+	}
+
+	// Clear any current data
+	clearData();
+
+	// Import (or reference) the data
+	if (!data_.importView(mc, offset, size))
+		return false;
+
+	// Update attributes
+	size_ = size;
+	setLoaded();
+	setType(EntryType::unknownType());
+	setState(State::Modified);
+
+	return true;
+}
+
 // -----------------------------------------------------------------------------
 // Loads a portion of a file into the entry, overwriting any existing data
 // currently in the entry. A size of 0 means load from the offset to the end of
@@ -89,6 +89,7 @@ public:
 	// Data import
 	bool importMem(const void* data, uint32_t size);
 	bool importMemChunk(MemChunk& mc);
+	bool importView(const MemChunk& mc, uint32_t offset, uint32_t size);
 	bool importFile(string_view filename, uint32_t offset = 0, uint32_t size = 0);
 	bool importFileStream(wxFile& file, uint32_t len = 0);
 	bool importEntry(ArchiveEntry* entry);
@@ -130,6 +131,6 @@ private:
 
 	// Misc stuff
 	int    reliability_ = 0; // The reliability of the entry's identification
-	size_t index_guess_ = 0; // for speed
+	size_t index_       = 0; // Index within parent dir, only valid if below the dir's index_valid_
 };
 } // namespace slade
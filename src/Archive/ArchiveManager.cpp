@@ -186,6 +186,8 @@ bool ArchiveManager::addArchive(shared_ptr<Archive> archive)
 		n_archive.archive  = archive;
 		n_archive.resource = true;
 		open_archives_.push_back(n_archive);
+		if (archive_indices_valid_)
+			archive_indices_[archive.get()] = static_cast<int>(open_archives_.size()) - 1;
 
 		// Emit archive changed/saved signal when received from the archive
 		archive->signals().modified.connect(
@@ -345,8 +347,11 @@ shared_ptr<Archive> ArchiveManager::openArchive(string_view filename, bool manag
 
 	// If it opened successfully, add it to the list if needed & return it,
 	// Otherwise, delete it and return nullptr
+	EntryType::resetDetectionStats();
 	if (new_archive->open(filename))
 	{
+		EntryType::logDetectionStats(filename);
+
 		if (manage)
 		{
 			// Add the archive
@@ -450,8 +455,11 @@ shared_ptr<Archive> ArchiveManager::openArchive(ArchiveEntry* entry, bool manage
 
 	// If it opened successfully, add it to the list & return it,
 	// Otherwise, delete it and return nullptr
+	EntryType::resetDetectionStats();
 	if (new_archive->open(entry))
 	{
+		EntryType::logDetectionStats(entry->name());
+
 		if (manage)
 		{
 			// Add to parent's child list if parent is open in the manager (it should be)
@@ -626,6 +634,7 @@ bool ArchiveManager::closeArchive(int index)
 
 	// Remove the archive at index from the list
 	open_archives_.erase(open_archives_.begin() + index);
+	archive_indices_valid_ = false;
 
 	// Announce closed
 	signals_.archive_closed(index);
@@ -686,16 +695,19 @@ void ArchiveManager::closeAll()
 // -----------------------------------------------------------------------------
 int ArchiveManager::archiveIndex(Archive* archive)
 {
-	// Go through all open archives
-	for (size_t a = 0; a < open_archives_.size(); a++)
+	// Rebuild the archive index lookup if needed
+	if (!archive_indices_valid_)
 	{
-		// If the archive we're looking for is this one, return the index
-		if (open_archives_[a].archive.get() == archive)
-			return (int)a;
+		archive_indices_.clear();
+		for (size_t a = 0; a < open_archives_.size(); a++)
+			archive_indices_[open_archives_[a].archive.get()] = (int)a;
+
+		archive_indices_valid_ = true;
 	}
 
-	// If we get to here the archive wasn't found, so return -1
-	return -1;
+	// Look up the archive, -1 if it isn't open
+	auto i = archive_indices_.find(archive);
+	return i != archive_indices_.end() ? i->second : -1;
 }
 
 // -----------------------------------------------------------------------------
@@ -916,7 +928,9 @@ bool ArchiveManager::openBaseResource(int index)
 	{
 		base_resource = index;
 		ui::hideSplash();
-		app::resources().addArchive(base_resource_archive_.get());
+
+		// Index the base resource in the background, it can be large
+		app::resources().addArchive(base_resource_archive_.get(), true);
 		signals_.base_res_current_changed(index);
 		return true;
 	}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Archive.h"
+#include <unordered_map>
 
 namespace slade
 {
@@ -107,6 +108,11 @@ private:
 	vector<string>                 recent_files_;
 	vector<weak_ptr<ArchiveEntry>> bookmarks_;
 
+	// Index of each archive in open_archives_ (its priority), rebuilt on
+	// demand after an archive is removed
+	std::unordered_map<Archive*, int> archive_indices_;
+	bool                              archive_indices_valid_ = true;
+
 	// Signals
 	Signals signals_;
 
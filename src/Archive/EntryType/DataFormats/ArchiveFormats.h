@@ -12,7 +12,7 @@ public:
 class ZipDataFormat : public EntryDataFormat
 {
 public:
-	ZipDataFormat() : EntryDataFormat("archive_zip") {}
+	ZipDataFormat() : EntryDataFormat("archive_zip", "PK\x03\x04") {}
 	~ZipDataFormat() = default;
 
 	int isThisFormat(MemChunk& mc) override { return ZipArchive::isZipArchive(mc) ? MATCH_TRUE : MATCH_FALSE; }
@@ -5,7 +5,7 @@
 class PNGDataFormat : public EntryDataFormat
 {
 public:
-	PNGDataFormat() : EntryDataFormat("img_png") {}
+	PNGDataFormat() : EntryDataFormat("img_png", "\x89PNG\r\n\x1a\n") {}
 	~PNGDataFormat() = default;
 
 	int isThisFormat(MemChunk& mc) override
@@ -58,7 +58,7 @@ public:
 class GIFDataFormat : public EntryDataFormat
 {
 public:
-	GIFDataFormat() : EntryDataFormat("img_gif"){};
+	GIFDataFormat() : EntryDataFormat("img_gif", "GIF8"){};
 	~GIFDataFormat() = default;
 
 	int isThisFormat(MemChunk& mc) override
@@ -305,7 +305,7 @@ public:
 
 	int isThisFormat(MemChunk& mc) override
 	{
-		const uint8_t* data = mc.data();
+		const uint8_t* data = std::as_const(mc).data();
 
 		// Check size
 		if (mc.size() > sizeof(gfx::PatchHeader))
@@ -362,7 +362,7 @@ public:
 			if (mc[mc.size() - 1] != 0xFF)
 				return MATCH_FALSE;
 
-			const gfx::OldPatchHeader* header = (const gfx::OldPatchHeader*)mc.data();
+			const gfx::OldPatchHeader* header = (const gfx::OldPatchHeader*)std::as_const(mc).data();
 
 			// Check header values are 'sane'
 			if (header->width > 0 && header->height > 0)
@@ -415,7 +415,7 @@ public:
 		if (mc.size() <= sizeof(gfx::PatchHeader))
 			return MATCH_FALSE;
 
-		const uint8_t* data = mc.data();
+		const uint8_t* data = std::as_const(mc).data();
 
 		// Check that it ends on a FF byte.
 		if (mc[mc.size() - 1] != 0xFF)
@@ -491,7 +491,7 @@ public:
 		if (mc.size() < 6)
 			return MATCH_FALSE;
 
-		const uint8_t* data   = mc.data();
+		const uint8_t* data   = std::as_const(mc).data();
 		uint8_t        qwidth = data[0]; // quarter of width
 		uint8_t        height = data[1];
 		if (qwidth == 0 || height == 0
@@ -523,7 +523,7 @@ public:
 		if (mc.size() < sizeof(gfx::PatchHeader))
 			return MATCH_FALSE;
 
-		const uint8_t*          data   = mc.data();
+		const uint8_t*          data   = std::as_const(mc).data();
 		const gfx::PatchHeader* header = (const gfx::PatchHeader*)data;
 
 		// Check header values are 'sane'
@@ -552,7 +552,7 @@ public:
 		if (mc.size() < sizeof(gfx::JagPicHeader))
 			return MATCH_FALSE;
 
-		const uint8_t*           data   = mc.data();
+		const uint8_t*           data   = std::as_const(mc).data();
 		const gfx::JagPicHeader* header = (const gfx::JagPicHeader*)data;
 		int                      width, height, depth, size;
 		width  = wxINT16_SWAP_ON_LE(header->width);
@@ -591,7 +591,7 @@ public:
 			return MATCH_FALSE;
 
 		// Verify duplication of content
-		const uint8_t* data = mc.data();
+		const uint8_t* data = std::as_const(mc).data();
 		size_t         dupe = size - 320;
 		for (size_t p = 0; p < 320; ++p)
 		{
@@ -654,7 +654,7 @@ public:
 		if (mc.size() < sizeof(gfx::PSXPicHeader))
 			return MATCH_FALSE;
 
-		const uint8_t*           data   = mc.data();
+		const uint8_t*           data   = std::as_const(mc).data();
 		const gfx::PSXPicHeader* header = (const gfx::PSXPicHeader*)data;
 
 		// Check header values are 'sane'
@@ -674,7 +674,7 @@ public:
 class IMGZDataFormat : public EntryDataFormat
 {
 public:
-	IMGZDataFormat() : EntryDataFormat("img_imgz"){};
+	IMGZDataFormat() : EntryDataFormat("img_imgz", "IMGZ"){};
 	~IMGZDataFormat() = default;
 
 	int isThisFormat(MemChunk& mc) override
@@ -685,7 +685,7 @@ public:
 		if (size < sizeof(gfx::IMGZHeader))
 			return MATCH_FALSE;
 
-		const uint8_t*         data   = mc.data();
+		const uint8_t*         data   = std::as_const(mc).data();
 		const gfx::IMGZHeader* header = (const gfx::IMGZHeader*)data;
 
 		// Check signature
@@ -892,7 +892,7 @@ public:
 		if (mc.size() < sizeof(gfx::PatchHeader))
 			return MATCH_FALSE;
 
-		const uint8_t*          data   = mc.data();
+		const uint8_t*          data   = std::as_const(mc).data();
 		const gfx::PatchHeader* header = (const gfx::PatchHeader*)data;
 
 		// Check header values are 'sane'
@@ -1149,7 +1149,7 @@ public:
 
 	int isThisFormat(MemChunk& mc) override
 	{
-		const uint8_t* data = mc.data();
+		const uint8_t* data = std::as_const(mc).data();
 
 		// Check size
 		if (mc.size() > sizeof(gfx::ROTTPatchHeader))
@@ -1199,7 +1199,7 @@ public:
 
 	int isThisFormat(MemChunk& mc) override
 	{
-		const uint8_t* data = mc.data();
+		const uint8_t* data = std::as_const(mc).data();
 
 		// Check size
 		if (mc.size() > sizeof(gfx::ROTTPatchHeader))
@@ -1250,7 +1250,7 @@ public:
 
 	int isThisFormat(MemChunk& mc) override
 	{
-		const uint8_t* data = mc.data();
+		const uint8_t* data = std::as_const(mc).data();
 
 		// Check size
 		if (mc.size() > 800)
@@ -1279,7 +1279,7 @@ public:
 		if (mc.size() < sizeof(gfx::PatchHeader))
 			return MATCH_FALSE;
 
-		const uint8_t*          data   = mc.data();
+		const uint8_t*          data   = std::as_const(mc).data();
 		const gfx::PatchHeader* header = (const gfx::PatchHeader*)data;
 
 		// Check header values are 'sane'
@@ -1308,7 +1308,7 @@ public:
 		if (size < 8)
 			return MATCH_FALSE;
 
-		const uint8_t* data = mc.data();
+		const uint8_t* data = std::as_const(mc).data();
 		if (data[0] && data[1] && (size - 4 == (data[0] * data[1] * 4)) && data[size - 2] == 0 && data[size - 1] == 0)
 			return MATCH_TRUE;
 		return MATCH_FALSE;
@@ -1480,7 +1480,7 @@ public:
 		if (mc.size() <= 0x302)
 			return MATCH_FALSE;
 
-		const uint16_t* gfx_data = (const uint16_t*)mc.data();
+		const uint16_t* gfx_data = (const uint16_t*)std::as_const(mc).data();
 
 		size_t height = wxINT16_SWAP_ON_BE(gfx_data[0]);
 
@@ -1569,7 +1569,7 @@ public:
 		if (mc.size() <= 0x302)
 			return MATCH_FALSE;
 
-		const uint16_t* gfx_data = (const uint16_t*)mc.data();
+		const uint16_t* gfx_data = (const uint16_t*)std::as_const(mc).data();
 
 		size_t height = wxINT16_SWAP_ON_BE(gfx_data[0]);
 
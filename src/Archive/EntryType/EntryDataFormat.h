@@ -12,10 +12,11 @@ public:
 	static const int MATCH_PROBABLY = 192;
 	static const int MATCH_TRUE     = 255;
 
-	EntryDataFormat(string_view id) : id_{ id } {}
+	EntryDataFormat(string_view id, string_view magic = {}) : id_{ id }, magic_{ magic } {}
 	virtual ~EntryDataFormat() = default;
 
 	const string& id() const { return id_; }
+	const string& magic() const { return magic_; }
 
 	virtual int isThisFormat(MemChunk& mc);
 	void        copyToFormat(EntryDataFormat& target) const;
@@ -28,6 +29,7 @@ public:
 
 private:
 	string id_;
+	string magic_; // If not empty, data must begin with these bytes to be of this format
 
 	// Struct to specify an inclusive range for a byte (min <= valid <= max)
 	// If max == min, only 1 valid value
@@ -38,7 +38,9 @@
 #include "MainEditor/MainEditor.h"
 #include "Utility/Parser.h"
 #include "Utility/StringUtils.h"
+#include <atomic>
 #include <filesystem>
+#include <unordered_map>
 
 using namespace slade;
 
@@ -58,6 +60,54 @@ EntryType* etype_unknown = nullptr; // The default, 'unknown' entry type
 EntryType* etype_folder  = nullptr; // Folder entry type
 EntryType* etype_marker  = nullptr; // Marker entry type
 EntryType* etype_map     = nullptr; // Map marker type
+
+// Precompiled lookup of entry types by their (cheap to check) match criteria,
+// so that only plausible candidate types are tested when detecting an entry's
+// type. Each type is put into the bucket(s) for a criteria it *requires*, or
+// the 'general' list if it has none of them
+struct DetectionIndex
+{
+	bool                                      built = false;
+	std::unordered_map<unsigned, vector<int>> by_size;
+	std::unordered_map<string, vector<int>>   by_name;
+	std::unordered_map<string, vector<int>>   by_ext;
+	std::unordered_map<string, vector<int>>   by_archive;
+	vector<int>                               by_magic[256];
+	vector<int>                               general;
+};
+DetectionIndex detection_index;
+
+// Detection stats (atomic since detection can be done on multiple threads)
+std::atomic<unsigned> n_detect_entries{ 0 };
+std::atomic<unsigned> n_detect_checks{ 0 };
+std::atomic<unsigned> n_detect_skipped{ 0 };
+} // namespace
+
+
+// -----------------------------------------------------------------------------
+//
+// Functions
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// -----------------------------------------------------------------------------
+// Returns true if [name] contains no wildcard characters
+// -----------------------------------------------------------------------------
+bool isLiteralName(string_view name)
+{
+	return name.find_first_of("*?") == string_view::npos;
+}
+
+// -----------------------------------------------------------------------------
+// Appends the types in [map] matching [key] (if any) to [list]
+// -----------------------------------------------------------------------------
+template<typename K> void addCandidates(const std::unordered_map<K, vector<int>>& map, const K& key, vector<int>& list)
+{
+	auto i = map.find(key);
+	if (i != map.end())
+		list.insert(list.end(), i->second.begin(), i->second.end());
+}
 } // namespace
 
 
@@ -515,6 +565,9 @@ bool EntryType::readEntryTypeDefinition(MemChunk& mc, string_view source)
 		entry_types.push_back(std::move(ntype));
 	}
 
+	// Detection index needs to be rebuilt to include the new types
+	detection_index.built = false;
+
 	return true;
 }
 
@@ -578,6 +631,9 @@ bool EntryType::loadEntryTypes()
 		readEntryTypeDefinition(mc, path);
 	}
 
+	// Build detection index now that all types are loaded
+	buildDetectionIndex();
+
 	return true;
 }
 
@@ -600,31 +656,212 @@ bool EntryType::detectEntryType(ArchiveEntry& entry)
 	// Reset entry type
 	entry.setType(etype_unknown);
 
-	// Go through all registered types
-	size_t entry_types_size = entry_types.size();
-	for (size_t a = 0; a < entry_types_size; a++)
+	// Get the list of types to check, from the detection index if it's built
+	vector<int> candidates;
+	if (detection_index.built)
 	{
+		auto& index = detection_index;
+		candidates  = index.general;
+		addCandidates(index.by_size, entry.size(), candidates);
+		if (!index.by_name.empty() || !index.by_ext.empty())
+		{
+			string_view fn      = entry.upperName();
+			auto        ext_sep = fn.find_first_of('.', 0);
+			addCandidates(index.by_name, string{ fn.substr(0, ext_sep) }, candidates);
+			if (ext_sep != string_view::npos)
+				addCandidates(index.by_ext, string{ fn.substr(ext_sep + 1) }, candidates);
+		}
+		if (entry.parent())
+			addCandidates(index.by_archive, entry.parent()->formatDesc().entry_format, candidates);
+		auto& data = entry.data();
+		if (data.size() > 0)
+			candidates.insert(
+				candidates.end(), index.by_magic[data[0]].begin(), index.by_magic[data[0]].end());
+
+		// Check types in the same order as they were defined, as with the full list
+		std::sort(candidates.begin(), candidates.end());
+		candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+	}
+	else
+	{
+		candidates.resize(entry_types.size());
+		for (size_t a = 0; a < entry_types.size(); a++)
+			candidates[a] = a;
+	}
+
+	unsigned n_checks  = 0;
+	unsigned n_skipped = 0;
+
+	// Counts the types in [from, to) that weren't candidates but would have been
+	// checked with the full list (detectable and more reliable than the current
+	// type), ie. the checks removed by the detection index
+	auto count_skipped = [&](size_t from, size_t to)
+	{
+		for (auto t = from; t < to; ++t)
+			if (entry_types[t]->detectable_ && entry.typeReliability() < entry_types[t]->reliability())
+				++n_skipped;
+	};
+
+	// Go through candidate types
+	size_t next     = 0;
+	bool   complete = false;
+	for (auto a : candidates)
+	{
+		auto type = entry_types[a].get();
+		count_skipped(next, a);
+		next = a + 1;
+
 		// If the current type is more 'reliable' than this one, skip it
-		if (entry.typeReliability() >= entry_types[a]->reliability())
+		if (entry.typeReliability() >= type->reliability())
+			continue;
+
+		// Check the data begins with the format's magic bytes (if any)
+		auto& magic = type->format_->magic();
+		if (!magic.empty()
+			&& (entry.size() < magic.size() || memcmp(entry.rawData(), magic.data(), magic.size()) != 0))
 			continue;
 
 		// Check for possible type match
-		int r = entry_types[a]->isThisType(entry);
+		int r = type->isThisType(entry);
+		++n_checks;
 		if (r > 0)
 		{
 			// Type matches, set it
-			entry.setType(entry_types[a].get(), r);
+			entry.setType(type, r);
 
 			// No need to continue if the identification is 100% reliable
 			if (entry.typeReliability() >= 255)
-				return true;
+			{
+				complete = true;
+				break;
+			}
 		}
 	}
+	if (!complete)
+		count_skipped(next, entry_types.size());
+
+	// Update stats
+	++n_detect_entries;
+	n_detect_checks += n_checks;
+	n_detect_skipped += n_skipped;
 
 	// Return t/f depending on if a matching type was found
 	return entry.type() != etype_unknown;
 }
 
+// -----------------------------------------------------------------------------
+// Builds the detection index from all currently loaded entry types.
+// This should be called after all entry types have been loaded
+// -----------------------------------------------------------------------------
+void EntryType::buildDetectionIndex()
+{
+	detection_index = {};
+	auto& index     = detection_index;
+
+	for (const auto& type : entry_types)
+	{
+		// Non-detectable types can never match
+		if (!type->detectable_)
+			continue;
+
+		auto type_index  = type->index_;
+		bool names_exact = !type->match_name_.empty();
+		for (const auto& name : type->match_name_)
+			if (!isLiteralName(name))
+				names_exact = false;
+
+		// Exact size(s)
+		if (!type->match_size_.empty())
+		{
+			for (auto size : type->match_size_)
+				index.by_size[size].push_back(type_index);
+		}
+
+		// Name OR extension - needs to be in both buckets
+		else if (type->match_ext_or_name_ && !type->match_name_.empty() && !type->match_extension_.empty())
+		{
+			if (!names_exact)
+				index.general.push_back(type_index);
+			else
+			{
+				for (const auto& name : type->match_name_)
+					index.by_name[name].push_back(type_index);
+				for (const auto& ext : type->match_extension_)
+					index.by_ext[ext].push_back(type_index);
+			}
+		}
+
+		// Exact name(s)
+		else if (names_exact)
+		{
+			for (const auto& name : type->match_name_)
+				index.by_name[name].push_back(type_index);
+		}
+
+		// Extension(s)
+		else if (!type->match_extension_.empty())
+		{
+			for (const auto& ext : type->match_extension_)
+				index.by_ext[ext].push_back(type_index);
+		}
+
+		// Archive format(s)
+		else if (!type->match_archive_.empty())
+		{
+			for (const auto& archive : type->match_archive_)
+				index.by_archive[archive].push_back(type_index);
+		}
+
+		// Data format magic
+		else if (!type->format_->magic().empty())
+			index.by_magic[static_cast<uint8_t>(type->format_->magic()[0])].push_back(type_index);
+
+		// Anything else has to be checked for every entry
+		else
+			index.general.push_back(type_index);
+	}
+
+	index.built = true;
+
+	log::info(
+		2,
+		"Built entry type detection index: {} sizes, {} names, {} extensions, {} archive formats, {} general types",
+		index.by_size.size(),
+		index.by_name.size(),
+		index.by_ext.size(),
+		index.by_archive.size(),
+		index.general.size());
+}
+
+// -----------------------------------------------------------------------------
+// Resets the entry type detection stats
+// -----------------------------------------------------------------------------
+void EntryType::resetDetectionStats()
+{
+	n_detect_entries = 0;
+	n_detect_checks  = 0;
+	n_detect_skipped = 0;
+}
+
+// -----------------------------------------------------------------------------
+// Writes the entry type detection stats (since the last reset) to the log,
+// including the number of type checks avoided by the detection index (types
+// that would have been checked without it, not counting reliability skips)
+// -----------------------------------------------------------------------------
+void EntryType::logDetectionStats(string_view context)
+{
+	if (n_detect_entries == 0)
+		return;
+
+	log::info(
+		2,
+		"{}: detected {} entries, {} type checks done, {} type checks avoided",
+		context,
+		n_detect_entries.load(),
+		n_detect_checks.load(),
+		n_detect_skipped.load());
+}
+
 // -----------------------------------------------------------------------------
 // Returns the entry type with the given id, or etype_unknown if no id match is
 // found
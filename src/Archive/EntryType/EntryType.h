@@ -39,6 +39,9 @@ public:
 	static bool               readEntryTypeDefinition(MemChunk& mc, string_view source);
 	static bool               loadEntryTypes();
 	static bool               detectEntryType(ArchiveEntry& entry);
+	static void               buildDetectionIndex();
+	static void               resetDetectionStats();
+	static void               logDetectionStats(string_view context);
 	static EntryType*         fromId(string_view id);
 	static EntryType*         unknownType();
 	static EntryType*         folderType();
@@ -33,6 +33,9 @@
 #include "WadArchive.h"
 #include "General/Misc.h"
 #include "General/UI.h"
+#include "UI/WxUtils.h"
+#include "Utility/FileUtils.h"
+#include "Utility/Parallel.h"
 #include "Utility/StringUtils.h"
 #include "Utility/Tokenizer.h"
 #include "WadJArchive.h"
@@ -46,6 +49,7 @@ using namespace slade;
 //
 // -----------------------------------------------------------------------------
 CVAR(Bool, iwad_lock, true, CVar::Flag::Save)
+CVAR(Bool, wad_memory_map, true, CVar::Flag::Save)
 
 namespace
 {
@@ -313,6 +317,84 @@ bool WadArchive::hasFlatHack()
 	return false;
 }
 
+// -----------------------------------------------------------------------------
+// Memory maps the wad file at [filename], so that entry data can be accessed
+// directly from the mapping without being read into memory first.
+// Returns false if the file couldn't be mapped
+// -----------------------------------------------------------------------------
+bool WadArchive::mapFile(string_view filename)
+{
+	auto mapped = std::make_shared<MappedFile>(filename);
+	if (!mapped->isOpen())
+		return false;
+
+	mapped_data_.setView(mapped->data(), mapped->size(), mapped);
+	mapped_file_ = mapped;
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Releases the memory mapped wad file (if any). Any entries still viewing the
+// mapped data will keep it valid until their data is unloaded or modified
+// -----------------------------------------------------------------------------
+void WadArchive::unmapFile()
+{
+	mapped_data_.clear();
+	mapped_file_.reset();
+}
+
+// -----------------------------------------------------------------------------
+// Copies all entry data viewing a memory mapped file into memory, so that the
+// entries no longer reference the mapping.
+// Returns false if there wasn't enough memory
+// -----------------------------------------------------------------------------
+bool WadArchive::detachEntryData()
+{
+	for (uint32_t l = 0; l < numEntries(); l++)
+	{
+		if (!entryAt(l)->data(false).detach())
+		{
+			global::error = "Failed to allocate sufficient memory";
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Reads a wad file from disk.
+// If wad_memory_map is enabled, the file is memory mapped rather than read
+// into memory, and entry data will reference the mapped file directly until
+// modified
+// Returns true if successful, false otherwise
+// -----------------------------------------------------------------------------
+bool WadArchive::open(string_view filename)
+{
+	// Read the whole file into memory if mapping is disabled or fails
+	if (!wad_memory_map || !mapFile(filename))
+		return Archive::open(filename);
+
+	// Update filename before opening
+	auto backupname = filename_;
+	filename_       = filename;
+
+	// Load from mapped data
+	sf::Clock timer;
+	if (open(mapped_data_))
+	{
+		log::info(2, "Archive::open took {}ms", timer.getElapsedTime().asMilliseconds());
+		on_disk_ = true;
+		return true;
+	}
+	else
+	{
+		unmapFile();
+		filename_ = backupname;
+		return false;
+	}
+}
+
 // -----------------------------------------------------------------------------
 // Reads wad format data from a MemChunk
 // Returns true if successful, false otherwise
@@ -464,46 +546,60 @@ bool WadArchive::open(MemChunk& mc)
 	updateNamespaces();
 
 	// Detect all entry types
-	MemChunk edata;
+	// Each entry only reads its own part of the wad data (and the namespace
+	// list, which is complete at this point), so detection can be split across
+	// multiple threads. Entry state is locked while doing this so that no
+	// modification signals are emitted from worker threads
+	vector<uint8_t> decode_failed(numEntries(), 0);
 	ui::setSplashProgressMessage("Detecting entry types");
-	for (size_t a = 0; a < numEntries(); a++)
-	{
-		// Update splash window progress
-		ui::setSplashProgress((((float)a / (float)numEntries())));
-
-		// Get entry
-		auto entry = entryAt(a);
-
-		// Read entry data if it isn't zero-sized
-		if (entry->size() > 0)
-		{
-			// Read the entry data
-			mc.exportMemChunk(edata, getEntryOffset(entry), entry->size());
-			if (entry->encryption() != ArchiveEntry::Encryption::None)
+	parallel::forEach(
+		numEntries(),
+		[&](size_t a) {
+			auto entry = entryAt(a);
+			entry->lockState();
+
+			// Read entry data if it isn't zero-sized
+			if (entry->size() > 0)
 			{
-				if (entry->exProps().contains("FullSize")
-					&& (unsigned)(entry->exProp<int>("FullSize")) > entry->size())
-					edata.reSize((entry->exProp<int>("FullSize")), true);
-				if (!WadJArchive::jaguarDecode(edata))
-					log::warning(
-						"{}: {} (following {}), did not decode properly",
-						a,
-						entry->name(),
-						a > 0 ? entryAt(a - 1)->name() : "nothing");
+				if (entry->encryption() != ArchiveEntry::Encryption::None)
+				{
+					// Read and decode the entry data
+					MemChunk edata;
+					mc.exportMemChunk(edata, getEntryOffset(entry), entry->size());
+					if (entry->exProps().contains("FullSize")
+						&& (unsigned)(entry->exProp<int>("FullSize")) > entry->size())
+						edata.reSize((entry->exProp<int>("FullSize")), true);
+					if (!WadJArchive::jaguarDecode(edata))
+						decode_failed[a] = 1;
+					entry->importMemChunk(edata);
+				}
+				else
+				{
+					// Reference the entry data directly (no copy if [mc] is a
+					// view of a memory mapped file)
+					entry->importView(mc, getEntryOffset(entry), entry->size());
+				}
 			}
-			entry->importMemChunk(edata);
-		}
 
-		// Detect entry type
-		EntryType::detectEntryType(*entry);
+			// Detect entry type
+			EntryType::detectEntryType(*entry);
 
-		// Unload entry data if needed
-		if (!archive_load_data)
-			entry->unloadData();
+			// Unload entry data if needed
+			if (!archive_load_data)
+				entry->unloadData();
 
-		// Set entry to unchanged
-		entry->setState(ArchiveEntry::State::Unmodified);
-	}
+			entry->unlockState();
+		},
+		[&](size_t done) { ui::setSplashProgress((float)done / (float)numEntries()); });
+
+	// Log any entries that failed to decode (done here as logging isn't thread-safe)
+	for (size_t a = 0; a < decode_failed.size(); a++)
+		if (decode_failed[a])
+			log::warning(
+				"{}: {} (following {}), did not decode properly",
+				a,
+				entryAt(a)->name(),
+				a > 0 ? entryAt(a - 1)->name() : "nothing");
 
 	// Identify #included lumps (DECORATE, GLDEFS, etc.)
 	detectIncludes();
@@ -609,9 +705,34 @@ bool WadArchive::write(string_view filename, bool update)
 		return false;
 	}
 
+	// If the wad file is memory mapped, unmodified entry data is written directly
+	// from the mapping. So if the mapped file is being overwritten, write to a
+	// temporary file first and replace it afterwards
+	bool   was_mapped = mapped_data_.hasData();
+	string out_file{ filename };
+	bool   replace = was_mapped && wxFileName(out_file).SameAs(wxFileName(filename_));
+	if (replace)
+		out_file += ".tmp";
+
+	if (was_mapped)
+	{
+		// Can't trust (or safely access) the mapped data if something else has
+		// modified or truncated the file since it was mapped
+		if (mapped_file_->fileChanged())
+		{
+			global::error = "The wad file has been modified by another program, unable to save";
+			return false;
+		}
+
+		// Load any unloaded entries (as views of the mapped file) before their
+		// offsets are updated below
+		for (uint32_t l = 0; l < numEntries(); l++)
+			entryAt(l)->data();
+	}
+
 	// Open file for writing
 	wxFile file;
-	file.Open(wxString{ filename.data(), filename.size() }, wxFile::write);
+	file.Open(out_file, wxFile::write);
 	if (!file.IsOpened())
 	{
 		global::error = "Unable to open file for writing";
@@ -673,6 +794,41 @@ bool WadArchive::write(string_view filename, bool update)
 
 	file.Close();
 
+	if (replace)
+	{
+		// The mapped file may not be replaceable while it's mapped (eg. on
+		// Windows), if so copy all entry data into memory, unmap and try again
+		bool replaced = wxRenameFile(out_file, wxutil::strFromView(filename), true);
+		if (!replaced && detachEntryData())
+		{
+			unmapFile();
+			replaced = wxRenameFile(out_file, wxutil::strFromView(filename), true);
+		}
+
+		if (!replaced)
+		{
+			global::error = "Unable to replace existing file. Make sure it isn't in use by another program.";
+			fileutil::removeFile(out_file);
+			return false;
+		}
+	}
+
+	// Map the written file (the entry offsets now refer to it, even if the
+	// entries weren't updated), unmodified entry data can now be loaded from it
+	if (was_mapped)
+	{
+		unmapFile();
+		if (mapFile(filename))
+		{
+			for (uint32_t l = 0; l < num_lumps; l++)
+			{
+				entry = entryAt(l);
+				if (entry->data(false).isView() || !archive_load_data)
+					entry->unloadData();
+			}
+		}
+	}
+
 	return true;
 }
 
@@ -694,6 +850,29 @@ bool WadArchive::loadEntryData(ArchiveEntry* entry)
 		return true;
 	}
 
+	// Don't access the mapped file if something else has modified (and possibly
+	// truncated) it since it was mapped, read the entry from the file instead
+	if (mapped_file_ && mapped_file_->fileChanged())
+	{
+		log::warning("WadArchive::loadEntryData: Wadfile {} was modified externally, unmapping it", filename_);
+		unmapFile();
+	}
+
+	// Reference the data directly if the wad file is memory mapped
+	if (mapped_data_.hasData() && entry->encryption() == ArchiveEntry::Encryption::None)
+	{
+		if (!entry->importView(mapped_data_, getEntryOffset(entry), entry->size()))
+		{
+			log::error("WadArchive::loadEntryData: Entry {} is outside of the mapped wadfile", entry->name());
+			return false;
+		}
+
+		entry->setLoaded();
+		entry->setState(ArchiveEntry::State::Unmodified);
+
+		return true;
+	}
+
 	// Open wadfile
 	wxFile file(filename_);
 
@@ -4,6 +4,8 @@
 
 namespace slade
 {
+class MappedFile;
+
 class WadArchive : public TreelessArchive
 {
 public:
@@ -18,6 +20,8 @@ public:
 	void     updateNamespaces();
 
 	// Opening
+	using Archive::open;
+	bool open(string_view filename) override;
 	bool open(MemChunk& mc) override;
 
 	// Writing/Saving
@@ -90,5 +94,11 @@ private:
 
 	bool           iwad_ = false;
 	vector<NSPair> namespaces_;
+	MemChunk               mapped_data_; // View of the memory mapped wad file (if opened from a file)
+	shared_ptr<MappedFile> mapped_file_;
+
+	bool mapFile(string_view filename);
+	void unmapFile();
+	bool detachEntryData();
 };
 } // namespace slade
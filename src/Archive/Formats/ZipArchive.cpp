@@ -35,14 +35,28 @@
 #include "General/Misc.h"
 #include "General/UI.h"
 #include "UI/WxUtils.h"
+#include "Utility/Compression.h"
 #include "Utility/FileUtils.h"
+#include "Utility/Parallel.h"
 #include "Utility/StringUtils.h"
 #include "WadArchive.h"
+#include <ctime>
 #include <fstream>
+#include <zlib.h>
 
 using namespace slade;
 
 
+// -----------------------------------------------------------------------------
+//
+// Variables
+//
+// -----------------------------------------------------------------------------
+CVAR(Int, zip_detect_batch_mb, 64, CVar::Flag::Save) // 1-1024
+CVAR(Int, zip_compression_level, 9, CVar::Flag::Save) // 0 = store only, 1-9 = deflate level
+CVAR(Bool, zip_temp_copy, false, CVar::Flag::Save) // Read entry data from a temp copy rather than the zip file itself
+
+
 // -----------------------------------------------------------------------------
 //
 // External Variables
@@ -73,6 +87,132 @@ struct ZipFileHeader
 	uint16_t len_fn;
 	uint16_t len_extra;
 };
+
+// Zip record signatures
+constexpr uint32_t ZIP_SIG_LOCAL_HEADER   = 0x04034b50;
+constexpr uint32_t ZIP_SIG_CENTRAL_HEADER = 0x02014b50;
+constexpr uint32_t ZIP_SIG_END_OF_DIR     = 0x06054b50;
+
+// Fixed zip record sizes (not including variable length fields)
+constexpr unsigned ZIP_SIZE_LOCAL_HEADER   = 30;
+constexpr unsigned ZIP_SIZE_CENTRAL_HEADER = 46;
+constexpr unsigned ZIP_SIZE_END_OF_DIR     = 22;
+} // namespace
+
+
+// -----------------------------------------------------------------------------
+//
+// Functions
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// -----------------------------------------------------------------------------
+// Reads a little-endian 16bit value from [data]
+// -----------------------------------------------------------------------------
+uint16_t readU16(const uint8_t* data)
+{
+	return data[0] | (data[1] << 8);
+}
+
+// -----------------------------------------------------------------------------
+// Reads a little-endian 32bit value from [data]
+// -----------------------------------------------------------------------------
+uint32_t readU32(const uint8_t* data)
+{
+	return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+// -----------------------------------------------------------------------------
+// Appends a little-endian 16bit [value] to [out]
+// -----------------------------------------------------------------------------
+void writeU16(vector<uint8_t>& out, uint16_t value)
+{
+	out.push_back(value & 0xFF);
+	out.push_back(value >> 8);
+}
+
+// -----------------------------------------------------------------------------
+// Appends a little-endian 32bit [value] to [out]
+// -----------------------------------------------------------------------------
+void writeU32(vector<uint8_t>& out, uint32_t value)
+{
+	writeU16(out, value & 0xFFFF);
+	writeU16(out, value >> 16);
+}
+
+// -----------------------------------------------------------------------------
+// Returns [time] as MS-DOS format time and date values (as used in zip headers)
+// -----------------------------------------------------------------------------
+std::pair<uint16_t, uint16_t> dosTimeDate(std::time_t time)
+{
+	auto tm = std::localtime(&time);
+	if (!tm || tm->tm_year < 80)
+		return { 0, (1 << 5) | 1 }; // 1980-01-01
+
+	uint16_t dos_time = (tm->tm_hour << 11) | (tm->tm_min << 5) | (tm->tm_sec / 2);
+	uint16_t dos_date = ((tm->tm_year - 80) << 9) | ((tm->tm_mon + 1) << 5) | tm->tm_mday;
+	return { dos_time, dos_date };
+}
+
+// -----------------------------------------------------------------------------
+// Returns the name to use for [entry] within a zip file
+// -----------------------------------------------------------------------------
+string zipEntryName(ArchiveEntry* entry)
+{
+	string name;
+	if (entry->type() == EntryType::folderType())
+		name = entry->path(true) + "/";
+	else
+		name = entry->path() + misc::lumpNameToFileName(entry->name());
+
+	// Zip entry names don't begin with a /
+	while (!name.empty() && name[0] == '/')
+		name.erase(0, 1);
+
+	return name;
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if [name] contains any non-ASCII characters
+// -----------------------------------------------------------------------------
+bool hasNonAsciiChars(string_view name)
+{
+	for (auto c : name)
+		if (static_cast<uint8_t>(c) >= 0x80)
+			return true;
+
+	return false;
+}
+
+// -----------------------------------------------------------------------------
+// Compresses [in] to [out] as a raw deflate stream (as used for zip entries),
+// in a single deflate call into a buffer big enough for the worst case, which
+// is then shrunk to the compressed size.
+// Returns false if compression failed
+// -----------------------------------------------------------------------------
+bool deflateZipData(const MemChunk& in, MemChunk& out, int level)
+{
+	// Same parameters as compression::zipDeflate
+	z_stream stream{};
+	if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 9, Z_DEFAULT_STRATEGY) != Z_OK)
+		return false;
+
+	if (!out.reSize(deflateBound(&stream, in.size()), false))
+	{
+		deflateEnd(&stream);
+		return false;
+	}
+
+	stream.next_in   = const_cast<uint8_t*>(in.data()); // Not modified by zlib
+	stream.avail_in  = in.size();
+	stream.next_out  = out.data();
+	stream.avail_out = out.size();
+	auto result      = deflate(&stream, Z_FINISH);
+	deflateEnd(&stream);
+
+	return result == Z_STREAM_END && out.reSize(stream.total_out);
+}
 } // namespace
 
 
@@ -105,9 +245,8 @@ bool ZipArchive::open(string_view filename)
 		return false;
 	}
 
-	// Copy the zip to a temp file (for use when saving)
-	generateTempFileName(filename);
-	fileutil::copyFile(filename, temp_file_);
+	// Index entry locations in the zip, for loading entry data later
+	updateZipSource(filename);
 
 	// Open the file
 	wxFFileInputStream in(wxutil::strFromView(filename));
@@ -128,6 +267,25 @@ bool ZipArchive::open(string_view filename)
 	// Stop announcements (don't want to be announcing modification due to entries being added etc)
 	ArchiveModSignalBlocker sig_blocker{ *this };
 
+	// Entries are read from the zip sequentially, but type detection is done in
+	// parallel on batches of read entries (batches are limited by total data
+	// size so that the whole zip doesn't need to be in memory at once)
+	auto detect_batch_max = static_cast<size_t>(std::clamp<int>(zip_detect_batch_mb, 1, 1024)) * 1024 * 1024;
+	vector<ArchiveEntry*> detect_batch;
+	size_t                detect_batch_size = 0;
+	auto                  detect_types      = [&]() {
+		parallel::forEach(detect_batch.size(), [&](size_t a) {
+			auto entry = detect_batch[a];
+			entry->lockState();
+			EntryType::detectEntryType(*entry);
+			if (!archive_load_data)
+				entry->unloadData();
+			entry->unlockState();
+		});
+		detect_batch.clear();
+		detect_batch_size = 0;
+	};
+
 	// Go through all zip entries
 	int  entry_index = 0;
 	auto zip_entry   = zip.GetNextEntry();
@@ -170,12 +328,11 @@ bool ZipArchive::open(string_view filename)
 				}
 				new_entry->setLoaded(true);
 
-				// Determine its type
-				EntryType::detectEntryType(*new_entry);
-
-				// Unload data if needed
-				if (!archive_load_data)
-					new_entry->unloadData();
+				// Queue for type detection
+				detect_batch.push_back(new_entry.get());
+				detect_batch_size += ze_size;
+				if (detect_batch_size >= detect_batch_max)
+					detect_types();
 			}
 			else
 			{
@@ -195,8 +352,19 @@ bool ZipArchive::open(string_view filename)
 		zip_entry = zip.GetNextEntry();
 		entry_index++;
 	}
+
+	// Detect types of any remaining entries
+	ui::setSplashProgressMessage("Detecting entry types");
+	detect_types();
 	ui::updateSplash();
 
+	// Don't use the entry index if it doesn't match what was read
+	if (zip_index_.size() != (size_t)entry_index)
+	{
+		log::warning("Zip central directory doesn't match zip entries, entry index will not be used");
+		zip_index_.clear();
+	}
+
 	// Set all entries/directories to unmodified
 	vector<ArchiveEntry*> entry_list;
 	putEntryTreeAsList(entry_list);
@@ -222,17 +390,13 @@ bool ZipArchive::open(string_view filename)
 // -----------------------------------------------------------------------------
 bool ZipArchive::open(MemChunk& mc)
 {
-	// Write the MemChunk to a temp file
-	auto tempfile = app::path("slade-temp-open.zip", app::Dir::Temp);
-	mc.exportFile(tempfile);
+	// Write the MemChunk to a temp file (kept to read entry data from later)
+	if (temp_file_.empty())
+		temp_file_ = generateTempFileName("slade-temp-open.zip");
+	mc.exportFile(temp_file_);
 
 	// Load the file
-	bool success = open(tempfile);
-
-	// Clean up
-	fileutil::removeFile(tempfile);
-
-	return success;
+	return open(temp_file_);
 }
 
 // -----------------------------------------------------------------------------
@@ -244,15 +408,24 @@ bool ZipArchive::write(MemChunk& mc, bool update)
 	bool success = false;
 
 	// Write to a temporary file
-	auto tempfile = app::path("slade-temp-write.zip", app::Dir::Temp);
-	if (write(tempfile, true))
+	auto tempfile = generateTempFileName("slade-temp-write.zip");
+	if (writeZip(tempfile, update))
 	{
 		// Load file into MemChunk
 		success = mc.importFile(tempfile);
 	}
 
-	// Clean up
-	wxRemoveFile(tempfile);
+	// If entries were updated, keep the written file to read entry data from
+	if (success && update)
+	{
+		if (!temp_file_.empty())
+			fileutil::removeFile(temp_file_);
+		temp_file_   = tempfile;
+		source_file_ = tempfile;
+		readZipIndex(source_file_);
+	}
+	else
+		fileutil::removeFile(tempfile);
 
 	return success;
 }
@@ -262,6 +435,283 @@ bool ZipArchive::write(MemChunk& mc, bool update)
 // Returns true if successful, false otherwise
 // -----------------------------------------------------------------------------
 bool ZipArchive::write(string_view filename, bool update)
+{
+	// Unmodified entries are copied from the source zip, so if it's being
+	// overwritten write to a temporary file first and replace it afterwards
+	string out_file{ filename };
+	bool   replace = !source_file_.empty() && wxFileName(out_file).SameAs(wxFileName(source_file_));
+	if (replace)
+		out_file += ".tmp";
+
+	bool success = writeZip(out_file, update);
+	if (replace)
+	{
+		if (success && !wxRenameFile(out_file, wxutil::strFromView(filename), true))
+		{
+			global::error = "Unable to replace existing file. Make sure it isn't in use by another program.";
+			success       = false;
+		}
+		if (!success)
+			fileutil::removeFile(out_file);
+	}
+
+	if (!success)
+		return false;
+
+	// Update the file to read entry data from (only if entries were updated,
+	// otherwise their zip indices still refer to the old one)
+	if (update)
+		updateZipSource(filename);
+	else if (replace)
+	{
+		log::warning("Zip {} was overwritten without updating entries, entry data can no longer be loaded", filename);
+		zip_index_.clear();
+	}
+
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Writes the zip archive to a file at [filename], which must not be the source
+// zip file
+// Returns true if successful, false otherwise
+//
+// Modified entries are compressed in parallel, and unmodified entries are
+// copied as-is (still compressed) from the source zip file, located via the
+// central directory index. Zip64 isn't supported here, so archives with too
+// many entries or that are too large are written with writeZipStream
+// -----------------------------------------------------------------------------
+bool ZipArchive::writeZip(const string& filename, bool update)
+{
+	// Determine compression level
+	int level = std::clamp(static_cast<int>(zip_compression_level), 0, 9);
+
+	// Get a linear list of all entries in the archive
+	vector<ArchiveEntry*> entries;
+	putEntryTreeAsList(entries);
+	if (entries.size() >= 0xFFFF)
+		return writeZipStream(filename, update, level);
+
+	// Open the source zip to copy unmodified entries from
+	SFile src;
+	if (!zip_index_.empty())
+		src.open(source_file_);
+	if (src.isOpen() && zipSourceModified(src))
+		src.close();
+
+	// Setup zip entry info for each entry
+	struct WriteEntry
+	{
+		string       name;
+		ZipEntryInfo info;
+		int          copy_index = -1; // Index in zip_index_ to copy data from
+		uint32_t     copy_from  = 0;  // Offset of data to copy in the saved copy
+		MemChunk     data;            // Compressed data
+	};
+	vector<WriteEntry> wentries(entries.size());
+	vector<size_t>     to_compress;
+	auto [now_time, now_date] = dosTimeDate(std::time(nullptr));
+	for (size_t a = 0; a < entries.size(); a++)
+	{
+		auto  entry  = entries[a];
+		auto& wentry = wentries[a];
+		wentry.name  = zipEntryName(entry);
+
+		// Directories have no data
+		if (entry->type() == EntryType::folderType())
+		{
+			wentry.info.mod_time = now_time;
+			wentry.info.mod_date = now_date;
+			continue;
+		}
+
+		// Copy unmodified entries from the saved copy if possible
+		int index = entry->exProps().contains("ZipIndex") ? entry->exProp<int>("ZipIndex") : -1;
+		if (src.isOpen() && entry->state() == ArchiveEntry::State::Unmodified && index >= 0
+			&& index < static_cast<int>(zip_index_.size()))
+		{
+			auto& info = zip_index_[index];
+			if (auto offset = zipEntryDataOffset(src, info))
+			{
+				wentry.info       = info;
+				wentry.copy_index = index;
+				wentry.copy_from  = offset;
+				continue;
+			}
+		}
+
+		// Otherwise it needs (re)compressing, make sure the data is loaded first
+		// (can't be done from the compression threads)
+		if (!entry->isLoaded() && entry->size() > 0 && !entry->data().hasData())
+		{
+			global::error = fmt::format("Unable to load data for entry {}", entry->path(true));
+			return false;
+		}
+		wentry.info.mod_time = now_time;
+		wentry.info.mod_date = now_date;
+		to_compress.push_back(a);
+	}
+
+	// Compress entries
+	parallel::forEach(
+		to_compress.size(),
+		[&](size_t a) {
+			const auto& edata  = entries[to_compress[a]]->data(false);
+			auto&       wentry = wentries[to_compress[a]];
+
+			wentry.info.size_orig = edata.size();
+			wentry.info.crc       = crc32(0, edata.data(), edata.size());
+			wentry.info.method    = wxZIP_METHOD_STORE;
+
+			// Use deflate unless it doesn't make the data any smaller
+			if (level > 0 && edata.size() > 0 && deflateZipData(edata, wentry.data, level)
+				&& wentry.data.size() < edata.size())
+				wentry.info.method = wxZIP_METHOD_DEFLATE;
+			else
+				wentry.data.importMem(edata.data(), edata.size());
+
+			wentry.info.size_comp = wentry.data.size();
+		},
+		{},
+		1);
+
+	// Check the zip won't be too big without zip64
+	uint64_t total_size = ZIP_SIZE_END_OF_DIR;
+	for (auto& wentry : wentries)
+		total_size += ZIP_SIZE_LOCAL_HEADER + ZIP_SIZE_CENTRAL_HEADER + wentry.name.size() * 2
+					  + wentry.info.size_comp;
+	if (total_size > 0xFFFFFFFF)
+		return writeZipStream(filename, update, level);
+
+	// Open the file
+	SFile out(filename, SFile::Mode::Write);
+	if (!out.isOpen())
+	{
+		global::error = "Unable to open file for saving. Make sure it isn't in use by another program.";
+		return false;
+	}
+
+	// Write local headers and entry data
+	vector<uint8_t> header;
+	vector<uint8_t> copy_buffer;
+	uint32_t        offset = 0;
+	for (auto& wentry : wentries)
+	{
+		auto& info         = wentry.info;
+		info.header_offset = offset;
+
+		// Write local file header
+		header.clear();
+		writeU32(header, ZIP_SIG_LOCAL_HEADER);
+		writeU16(header, 20);                                         // Version needed
+		writeU16(header, hasNonAsciiChars(wentry.name) ? 0x0800 : 0); // Flags (UTF-8 name)
+		writeU16(header, info.method);
+		writeU16(header, info.mod_time);
+		writeU16(header, info.mod_date);
+		writeU32(header, info.crc);
+		writeU32(header, info.size_comp);
+		writeU32(header, info.size_orig);
+		writeU16(header, wentry.name.size());
+		writeU16(header, 0); // Extra field length
+		header.insert(header.end(), wentry.name.begin(), wentry.name.end());
+		bool ok = out.write(header.data(), header.size());
+
+		// Write data
+		if (wentry.copy_index >= 0)
+		{
+			// Copy compressed data directly from the saved copy
+			copy_buffer.resize(std::min<uint32_t>(info.size_comp, 1 << 20));
+			uint32_t left = info.size_comp;
+			ok            = ok && src.seekFromStart(wentry.copy_from);
+			while (ok && left > 0)
+			{
+				auto count = std::min<uint32_t>(left, copy_buffer.size());
+				ok         = src.read(copy_buffer.data(), count) && out.write(copy_buffer.data(), count);
+				left -= count;
+			}
+		}
+		else if (wentry.data.size() > 0)
+			ok = ok && out.write(wentry.data.data(), wentry.data.size());
+
+		if (!ok)
+		{
+			global::error = fmt::format("Error writing zip entry {}", wentry.name);
+			return false;
+		}
+
+		offset += header.size() + info.size_comp;
+		wentry.data.clear();
+	}
+
+	// Write central directory
+	uint32_t dir_offset = offset;
+	header.clear();
+	for (size_t a = 0; a < wentries.size(); a++)
+	{
+		auto& wentry = wentries[a];
+		auto& info   = wentry.info;
+		bool  is_dir = entries[a]->type() == EntryType::folderType();
+
+		writeU32(header, ZIP_SIG_CENTRAL_HEADER);
+		writeU16(header, 20);                                         // Version made by
+		writeU16(header, 20);                                         // Version needed
+		writeU16(header, hasNonAsciiChars(wentry.name) ? 0x0800 : 0); // Flags (UTF-8 name)
+		writeU16(header, info.method);
+		writeU16(header, info.mod_time);
+		writeU16(header, info.mod_date);
+		writeU32(header, info.crc);
+		writeU32(header, info.size_comp);
+		writeU32(header, info.size_orig);
+		writeU16(header, wentry.name.size());
+		writeU16(header, 0);               // Extra field length
+		writeU16(header, 0);               // Comment length
+		writeU16(header, 0);               // Disk number
+		writeU16(header, 0);               // Internal attributes
+		writeU32(header, is_dir ? 0x10 : 0); // External attributes (MS-DOS directory flag)
+		writeU32(header, info.header_offset);
+		header.insert(header.end(), wentry.name.begin(), wentry.name.end());
+	}
+
+	// Write end of central directory record
+	uint32_t dir_size = header.size();
+	writeU32(header, ZIP_SIG_END_OF_DIR);
+	writeU16(header, 0); // Disk number
+	writeU16(header, 0); // Disk with central directory
+	writeU16(header, wentries.size());
+	writeU16(header, wentries.size());
+	writeU32(header, dir_size);
+	writeU32(header, dir_offset);
+	writeU16(header, 0); // Comment length
+	if (!out.write(header.data(), header.size()))
+	{
+		global::error = "Error writing zip central directory";
+		return false;
+	}
+	out.close();
+	src.close();
+
+	// Update entry info
+	if (update)
+	{
+		for (size_t a = 0; a < entries.size(); a++)
+		{
+			entries[a]->setState(ArchiveEntry::State::Unmodified);
+			if (entries[a]->type() != EntryType::folderType())
+				entries[a]->exProp("ZipIndex") = static_cast<int>(a);
+		}
+	}
+
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Writes the zip archive to a file using wxZipOutputStream, compressing
+// modified entries at [level].
+// This is only used for archives too large for ZipArchive::write (which
+// doesn't support zip64)
+// Returns true if successful, false otherwise
+// -----------------------------------------------------------------------------
+bool ZipArchive::writeZipStream(string_view filename, bool update, int level)
 {
 	// Open the file
 	wxFFileOutputStream out(wxutil::strFromView(filename));
@@ -272,23 +722,23 @@ bool ZipArchive::write(string_view filename, bool update)
 	}
 
 	// Open as zip for writing
-	wxZipOutputStream zip(out, 9);
+	wxZipOutputStream zip(out, level);
 	if (!zip.IsOk())
 	{
 		global::error = "Unable to create zip for saving";
 		return false;
 	}
 
-	// Open old zip for copying, from the temp file that was copied on opening.
+	// Open old zip for copying, from the source zip file.
 	// This is used to copy any entries that have been previously saved/compressed
 	// and are unmodified, to greatly speed up zip file saving by not having to
 	// recompress unchanged entries
 	unique_ptr<wxFFileInputStream> in;
 	unique_ptr<wxZipInputStream>   inzip;
 	vector<wxZipEntry*>            c_entries;
-	if (fileutil::fileExists(temp_file_))
+	if (fileutil::fileExists(source_file_))
 	{
-		in    = std::make_unique<wxFFileInputStream>(temp_file_);
+		in    = std::make_unique<wxFFileInputStream>(source_file_);
 		inzip = std::make_unique<wxZipInputStream>(*in);
 
 		if (inzip->IsOk())
@@ -356,18 +806,13 @@ bool ZipArchive::write(string_view filename, bool update)
 	zip.Close();
 	out.Close();
 
-	// Update the temp file
-	if (temp_file_.empty())
-		generateTempFileName(filename);
-	fileutil::copyFile(filename, temp_file_);
-
 	return true;
 }
 
 // -----------------------------------------------------------------------------
-// Loads an entry's data from the saved copy of the archive if any.
+// Loads an entry's data from the source zip file of the archive.
 // Returns false if the entry is invalid, doesn't belong to the archive or
-// doesn't exist in the saved copy, true otherwise.
+// doesn't exist in the source zip (or it was modified), true otherwise.
 // -----------------------------------------------------------------------------
 bool ZipArchive::loadEntryData(ArchiveEntry* entry)
 {
@@ -396,11 +841,42 @@ bool ZipArchive::loadEntryData(ArchiveEntry* entry)
 		return false;
 	}
 
+	// Check the source zip is still the same as when the entries were read
+	SFile file(source_file_);
+	if (!file.isOpen())
+	{
+		log::error("ZipArchive::loadEntryData: Unable to open zip file \"{}\"!", source_file_);
+		return false;
+	}
+	if (zipSourceModified(file))
+	{
+		log::error("ZipArchive::loadEntryData: Zip file \"{}\" was modified externally!", source_file_);
+		return false;
+	}
+
+	// If the entry is in the index, read its data directly
+	if (zip_index >= 0 && zip_index < (int)zip_index_.size())
+	{
+		MemChunk data;
+		if (readZipEntryData(file, zip_index_[zip_index], data))
+		{
+			entry->lockState();
+			entry->importMemChunk(data);
+			entry->setLoaded();
+			entry->unlockState();
+
+			return true;
+		}
+
+		log::warning("ZipArchive::loadEntryData: Unable to read entry {} from index, rescanning zip", entry->name());
+	}
+
 	// Open the file
-	wxFFileInputStream in(filename_);
+	file.close();
+	wxFFileInputStream in(source_file_);
 	if (!in.IsOk())
 	{
-		log::error("ZipArchive::loadEntryData: Unable to open zip file \"{}\"!", filename_);
+		log::error("ZipArchive::loadEntryData: Unable to open zip file \"{}\"!", source_file_);
 		return false;
 	}
 
@@ -408,13 +884,10 @@ bool ZipArchive::loadEntryData(ArchiveEntry* entry)
 	wxZipInputStream zip(in);
 	if (!zip.IsOk())
 	{
-		log::error("ZipArchive::loadEntryData: Invalid zip file \"{}\"!", filename_);
+		log::error("ZipArchive::loadEntryData: Invalid zip file \"{}\"!", source_file_);
 		return false;
 	}
 
-	// Lock entry state
-	entry->lockState();
-
 	// Skip to correct entry in zip
 	auto zentry = zip.GetNextEntry();
 	for (long a = 0; a < zip_index; a++)
@@ -430,6 +903,9 @@ bool ZipArchive::loadEntryData(ArchiveEntry* entry)
 		return false;
 	}
 
+	// Lock entry state
+	entry->lockState();
+
 	// Read the data
 	vector<uint8_t> data(zentry->GetSize());
 	zip.Read(data.data(), zentry->GetSize());
@@ -638,27 +1114,251 @@ vector<ArchiveEntry*> ZipArchive::findAll(SearchOptions& options)
 }
 
 // -----------------------------------------------------------------------------
-// Generates the temp file path to use, from [filename].
+// Generates and returns a temp file path to use, from [filename].
 // The temp file will be in the configured temp folder
 // -----------------------------------------------------------------------------
-void ZipArchive::generateTempFileName(string_view filename)
+string ZipArchive::generateTempFileName(string_view filename) const
 {
 	strutil::Path tfn(filename);
-	temp_file_ = app::path(tfn.fileName(), app::Dir::Temp);
-	if (wxFileExists(temp_file_))
+	auto          temp_file = app::path(tfn.fileName(), app::Dir::Temp);
+	if (wxFileExists(temp_file))
 	{
 		// Make sure we don't overwrite an existing temp file
 		// (in case there are multiple zips open with the same name)
 		int n = 1;
 		while (true)
 		{
-			temp_file_ = app::path(fmt::format("{}.{}", tfn.fileName(), n), app::Dir::Temp);
-			if (!wxFileExists(temp_file_))
+			temp_file = app::path(fmt::format("{}.{}", tfn.fileName(), n), app::Dir::Temp);
+			if (!wxFileExists(temp_file))
 				break;
 
 			n++;
 		}
 	}
+
+	return temp_file;
+}
+
+// -----------------------------------------------------------------------------
+// Sets the source zip file that entry data is read (and copied when saving)
+// from to [filename], and reads its entry index.
+// If zip_temp_copy is enabled, a temporary copy of the file is used instead
+// -----------------------------------------------------------------------------
+void ZipArchive::updateZipSource(string_view filename)
+{
+	if (zip_temp_copy)
+	{
+		if (temp_file_.empty())
+			temp_file_ = generateTempFileName(filename);
+		if (temp_file_ != filename)
+			fileutil::copyFile(filename, temp_file_);
+		source_file_ = temp_file_;
+	}
+	else
+		source_file_ = filename;
+
+	readZipIndex(source_file_);
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if the source zip (opened as [file]) has been modified since
+// its entry index was read.
+// The file size and modification time are checked first - if they differ, the
+// central directory is re-read and compared with the indexed one, so that
+// changes that don't affect the zip contents (eg. touching the file) are
+// accepted
+// -----------------------------------------------------------------------------
+bool ZipArchive::zipSourceModified(SFile& file)
+{
+	auto mtime = fileutil::fileModifiedTime(source_file_);
+	if (file.size() == source_info_.size && mtime == source_info_.mtime)
+		return false;
+
+	// Compare central directory
+	vector<ZipEntryInfo> index;
+	uint32_t             dir_crc = 0;
+	if (readCentralDirectory(file, index, dir_crc) && dir_crc == source_info_.dir_crc)
+	{
+		source_info_.size  = file.size();
+		source_info_.mtime = mtime;
+		return false;
+	}
+
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Reads the central directory of the zip [file] into [index], and sets
+// [dir_crc] to the CRC of the central directory data.
+// Zip64 archives aren't supported.
+// Returns false if the central directory couldn't be read
+// -----------------------------------------------------------------------------
+bool ZipArchive::readCentralDirectory(SFile& file, vector<ZipEntryInfo>& index, uint32_t& dir_crc) const
+{
+	index.clear();
+	if (file.size() < ZIP_SIZE_END_OF_DIR)
+		return false;
+
+	// Find the end of central directory record, searching back from the end of
+	// the file (it can be followed by a comment of up to 64kb)
+	unsigned        tail_size = std::min<unsigned>(file.size(), ZIP_SIZE_END_OF_DIR + 0xFFFF);
+	vector<uint8_t> tail(tail_size);
+	if (!file.seekFromStart(file.size() - tail_size) || !file.read(tail.data(), tail_size))
+		return false;
+	const uint8_t* end_of_dir = nullptr;
+	for (int a = tail_size - ZIP_SIZE_END_OF_DIR; a >= 0; --a)
+		if (readU32(tail.data() + a) == ZIP_SIG_END_OF_DIR)
+		{
+			end_of_dir = tail.data() + a;
+			break;
+		}
+	if (!end_of_dir)
+		return false;
+
+	// Read central directory info
+	auto num_entries = readU16(end_of_dir + 10);
+	auto dir_size    = readU32(end_of_dir + 12);
+	auto dir_offset  = readU32(end_of_dir + 16);
+	if (num_entries == 0xFFFF || dir_offset == 0xFFFFFFFF || (uint64_t)dir_offset + dir_size > file.size())
+		return false;
+
+	// Read the central directory
+	vector<uint8_t> dir(dir_size);
+	if (dir_size > 0 && (!file.seekFromStart(dir_offset) || !file.read(dir.data(), dir_size)))
+		return false;
+	dir_crc = crc32(0, dir.data(), dir_size);
+
+	// Read entry info from each central directory header
+	index.reserve(num_entries);
+	size_t pos = 0;
+	for (unsigned a = 0; a < num_entries; ++a)
+	{
+		auto header = dir.data() + pos;
+		if (pos + ZIP_SIZE_CENTRAL_HEADER > dir.size() || readU32(header) != ZIP_SIG_CENTRAL_HEADER)
+		{
+			index.clear();
+			return false;
+		}
+
+		ZipEntryInfo info;
+		info.method        = readU16(header + 10);
+		info.mod_time      = readU16(header + 12);
+		info.mod_date      = readU16(header + 14);
+		info.crc           = readU32(header + 16);
+		info.size_comp     = readU32(header + 20);
+		info.size_orig     = readU32(header + 24);
+		info.header_offset = readU32(header + 42);
+		index.push_back(info);
+
+		// Skip filename, extra field and comment
+		pos += ZIP_SIZE_CENTRAL_HEADER + readU16(header + 28) + readU16(header + 30) + readU16(header + 32);
+	}
+
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Reads the central directory of the zip file at [filename] into the entry
+// index, so that entry data can be read directly without scanning through the
+// zip. Also records the file info used to detect external modification.
+// Returns false if the central directory couldn't be read (the index will be
+// empty)
+// -----------------------------------------------------------------------------
+bool ZipArchive::readZipIndex(const string& filename)
+{
+	zip_index_.clear();
+	source_info_ = {};
+
+	SFile file(filename);
+	if (!file.isOpen())
+		return false;
+
+	source_info_.size  = file.size();
+	source_info_.mtime = fileutil::fileModifiedTime(filename);
+
+	return readCentralDirectory(file, zip_index_, source_info_.dir_crc);
+}
+
+// -----------------------------------------------------------------------------
+// Returns the offset in [file] of the (compressed) data for the zip entry
+// described by [info], or 0 if its local file header is invalid
+// -----------------------------------------------------------------------------
+uint32_t ZipArchive::zipEntryDataOffset(SFile& file, const ZipEntryInfo& info) const
+{
+	// Read the local file header, the filename and extra field lengths here can
+	// differ from the central directory so they are needed to find the data
+	uint8_t header[ZIP_SIZE_LOCAL_HEADER];
+	if (!file.seekFromStart(info.header_offset) || !file.read(header, ZIP_SIZE_LOCAL_HEADER)
+		|| readU32(header) != ZIP_SIG_LOCAL_HEADER)
+		return 0;
+
+	auto data_offset = info.header_offset + ZIP_SIZE_LOCAL_HEADER + readU16(header + 26) + readU16(header + 28);
+	if (static_cast<uint64_t>(data_offset) + info.size_comp > file.size())
+		return 0;
+
+	return data_offset;
+}
+
+// -----------------------------------------------------------------------------
+// Reads and decompresses the data for the zip entry described by [info] from
+// [file] into [out].
+// Returns false if the data couldn't be read or decompressed
+// -----------------------------------------------------------------------------
+bool ZipArchive::readZipEntryData(SFile& file, const ZipEntryInfo& info, MemChunk& out) const
+{
+	auto data_offset = zipEntryDataOffset(file, info);
+	if (data_offset == 0)
+		return false;
+
+	if (info.size_orig == 0)
+	{
+		out.clear();
+		return true;
+	}
+
+	if (!file.seekFromStart(data_offset))
+		return false;
+
+	if (info.method == wxZIP_METHOD_STORE)
+	{
+		// Stored, just read the data
+		if (!file.read(out, info.size_orig) || out.size() != info.size_orig)
+			return false;
+	}
+	else if (info.method == wxZIP_METHOD_DEFLATE)
+	{
+		// Deflated, read and inflate directly into the output (its size is known)
+		MemChunk comp;
+		if (info.size_comp == 0 || !file.read(comp, info.size_comp) || !out.reSize(info.size_orig, false))
+			return false;
+
+		z_stream stream{};
+		stream.next_in   = comp.data();
+		stream.avail_in  = comp.size();
+		stream.next_out  = out.data();
+		stream.avail_out = out.size();
+		if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+			return false;
+
+		auto result = inflate(&stream, Z_FINISH);
+		inflateEnd(&stream);
+		if (result != Z_STREAM_END || stream.total_out != info.size_orig)
+		{
+			log::warning("Zip entry data inflated to {} bytes, expected {}", stream.total_out, info.size_orig);
+			return false;
+		}
+	}
+	else
+		return false;
+
+	// Check the data is intact
+	if (crc32(0, out.data(), out.size()) != info.crc)
+	{
+		log::warning("Zip entry data CRC mismatch");
+		return false;
+	}
+
+	return true;
 }
 
 
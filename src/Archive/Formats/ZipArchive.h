@@ -4,6 +4,8 @@
 
 namespace slade
 {
+class SFile;
+
 class ZipArchive : public Archive
 {
 public:
@@ -38,8 +40,40 @@ public:
 	static bool isZipArchive(const string& filename);
 
 private:
-	string temp_file_;
+	// Location and compression info for an entry in the zip file, read from
+	// its central directory
+	struct ZipEntryInfo
+	{
+		uint32_t header_offset = 0; // Offset of the local file header
+		uint32_t size_comp     = 0;
+		uint32_t size_orig     = 0;
+		uint32_t crc           = 0;
+		uint16_t method        = 0;
+		uint16_t mod_time      = 0;
+		uint16_t mod_date      = 0;
+	};
+
+	// Info used to detect if the source zip file was modified externally
+	struct ZipSourceInfo
+	{
+		unsigned size    = 0;
+		time_t   mtime   = 0;
+		uint32_t dir_crc = 0; // CRC of the central directory
+	};
+
+	string               temp_file_;
+	string               source_file_; // Zip file that entry data is read/copied from
+	ZipSourceInfo        source_info_;
+	vector<ZipEntryInfo> zip_index_;               // Indexed by entry "ZipIndex" property
 
-	void generateTempFileName(string_view filename);
+	string   generateTempFileName(string_view filename) const;
+	void     updateZipSource(string_view filename);
+	bool     zipSourceModified(SFile& file);
+	bool     readCentralDirectory(SFile& file, vector<ZipEntryInfo>& index, uint32_t& dir_crc) const;
+	bool     readZipIndex(const string& filename);
+	uint32_t zipEntryDataOffset(SFile& file, const ZipEntryInfo& info) const;
+	bool     readZipEntryData(SFile& file, const ZipEntryInfo& info, MemChunk& out) const;
+	bool     writeZip(const string& filename, bool update);
+	bool     writeZipStream(string_view filename, bool update, int level);
 };
 } // namespace slade
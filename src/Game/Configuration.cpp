@@ -1795,15 +1795,25 @@ void Configuration::cleanObjectUDMFProps(MapObject* object)
 	else
 		return;
 
-	// Go through properties
-	for (const auto& i : *map)
+	// Go through the object's properties (copied since some may be removed).
+	// Objects generally have far fewer properties set than are defined in the
+	// configuration, so this is much quicker than checking each defined
+	// property on the object
+	auto props = object->props().properties();
+	for (const auto& prop : props)
 	{
-		const auto& name      = i.first;
-		const auto& udmf_prop = i.second;
+		// Check the property has a value
+		if (!hasValue(prop.value))
+			continue;
 
-		// Check if the object even has this property
-		if (!object->hasProp(name))
+		// Find the property definition
+		const auto& name = prop.name();
+		auto        i    = map->find(name);
+		if (i == map->end())
+			i = map->find(strutil::lower(name));
+		if (i == map->end())
 			continue;
+		const auto& udmf_prop = i->second;
 
 		// Remove the property from the object if it is the default value
 		const auto& default_val = udmf_prop.defaultValue();
@@ -1811,19 +1821,19 @@ void Configuration::cleanObjectUDMFProps(MapObject* object)
 		{
 		case ValueType::Bool:
 			if (udmf_prop.isDefault<bool>(object->boolProperty(name)))
-				object->props().remove(name);
+				object->props().remove(prop.key);
 			break;
 		case ValueType::Int:
 			if (udmf_prop.isDefault<int>(object->intProperty(name)))
-				object->props().remove(name);
+				object->props().remove(prop.key);
 			break;
 		case ValueType::Float:
 			if (udmf_prop.isDefault<double>(object->floatProperty(name)))
-				object->props().remove(name);
+				object->props().remove(prop.key);
 			break;
 		case ValueType::String:
 			if (udmf_prop.isDefault<string>(object->stringProperty(name)))
-				object->props().remove(name);
+				object->props().remove(prop.key);
 			break;
 		default: break;
 		}
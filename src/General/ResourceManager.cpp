@@ -37,6 +37,7 @@
 #include "General/Console.h"
 #include "Graphics/CTexture/CTexture.h"
 #include "Graphics/CTexture/TextureXList.h"
+#include "Utility/Parallel.h"
 #include "Utility/StringUtils.h"
 
 using namespace slade;
@@ -69,15 +70,83 @@ void removeArchiveFromMap(EntryResourceMap& map, Archive* archive)
 // ----------------------------------------------------------------------------
 // Removes [entry] from resource [map].
 // If [full_check] is true, all resources in the map are checked for the entry,
-// otherwise only the resource [name] is checked
+// otherwise only the resource [name] is checked. The names of any resources
+// the entry was removed from are added to [changed]
 // ----------------------------------------------------------------------------
-void removeEntryFromMap(EntryResourceMap& map, const string& name, shared_ptr<ArchiveEntry>& entry, bool full_check)
+void removeEntryFromMap(
+	EntryResourceMap&         map,
+	const string&             name,
+	shared_ptr<ArchiveEntry>& entry,
+	bool                      full_check,
+	const ResourceChanges&    changes,
+	std::set<string>&         changed)
 {
 	if (full_check)
+	{
 		for (auto& i : map)
-			i.second.remove(entry);
-	else
-		map[name].remove(entry);
+			if (i.second.remove(entry))
+				changes.add(changed, i.first);
+	}
+	else if (auto i = map.find(name); i != map.end() && i->second.remove(entry))
+		changes.add(changed, name);
+}
+
+// ----------------------------------------------------------------------------
+// Returns the resource [name] in [map], or nullptr if it doesn't exist (this
+// won't add an empty resource to the map like operator[] would)
+// ----------------------------------------------------------------------------
+template<typename T> T* findResource(std::unordered_map<string, T>& map, const string& name)
+{
+	auto i = map.find(name);
+	return i != map.end() ? &i->second : nullptr;
+}
+
+// ----------------------------------------------------------------------------
+// As findResource, but looks up [name] in uppercase. The uppercase name is
+// built in a reused per-thread buffer so that lookups don't allocate
+// ----------------------------------------------------------------------------
+template<typename T> T* findResourceUpper(std::unordered_map<string, T>& map, string_view name)
+{
+	thread_local string name_upper;
+	name_upper.assign(name.data(), name.size());
+	return findResource(map, strutil::upperIP(name_upper));
+}
+
+// ----------------------------------------------------------------------------
+// Returns all resources in [map], sorted by name
+// ----------------------------------------------------------------------------
+template<typename T> vector<std::pair<const string, T>*> sortedResources(std::unordered_map<string, T>& map)
+{
+	vector<std::pair<const string, T>*> sorted;
+	sorted.reserve(map.size());
+	for (auto& i : map)
+		sorted.push_back(&i);
+
+	std::sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+
+	return sorted;
+}
+
+// ----------------------------------------------------------------------------
+// Returns the approximate memory used by resource [map] (in bytes)
+// ----------------------------------------------------------------------------
+template<typename T> size_t mapMemoryUsage(const std::unordered_map<string, T>& map)
+{
+	static const auto sso_capacity = string{}.capacity();
+
+	// Buckets, plus each node (value, next pointer and cached hash)
+	auto bytes = map.bucket_count() * sizeof(void*);
+	bytes += map.size() * (sizeof(std::pair<const string, T>) + sizeof(void*) + sizeof(size_t));
+
+	// Names and resources
+	for (const auto& i : map)
+	{
+		if (i.first.capacity() > sso_capacity)
+			bytes += i.first.capacity() + 1;
+		bytes += i.second.memoryUsage();
+	}
+
+	return bytes;
 }
 } // namespace
 
@@ -99,18 +168,25 @@ void EntryResource::add(shared_ptr<ArchiveEntry>& entry)
 }
 
 // -----------------------------------------------------------------------------
-// Removes matching [entry] from the resource
+// Removes matching [entry] from the resource.
+// Returns true if the entry was found and removed
 // -----------------------------------------------------------------------------
-void EntryResource::remove(shared_ptr<ArchiveEntry>& entry)
+bool EntryResource::remove(shared_ptr<ArchiveEntry>& entry)
 {
-	unsigned a = 0;
+	bool     removed = false;
+	unsigned a       = 0;
 	while (a < entries_.size())
 	{
 		if (entries_[a].lock() == entry)
+		{
 			entries_.erase(entries_.begin() + a);
+			removed = true;
+		}
 		else
 			++a;
 	}
+
+	return removed;
 }
 
 // ----------------------------------------------------------------------------
@@ -234,38 +310,89 @@ void TextureResource::remove(Archive* parent)
 
 
 // -----------------------------------------------------------------------------
-// Adds an archive to be managed
+// ResourceManager class destructor
+// -----------------------------------------------------------------------------
+ResourceManager::~ResourceManager()
+{
+	// Cancel any background indexing and wait for the worker threads to finish,
+	// since they reference this
+	for (auto& job : index_jobs_)
+		job->cancelled = true;
+	for (auto& job : index_jobs_)
+		if (job->thread.joinable())
+			job->thread.join();
+}
+
+// -----------------------------------------------------------------------------
+// Adds an archive to be managed.
+// Entries are classified across multiple threads before being added to the
+// resource maps. If [background] is true, this is done on a worker thread and
+// the archive's resources are added later on the main thread (via the event
+// loop), so the UI isn't blocked while a large archive is indexed
 // -----------------------------------------------------------------------------
-void ResourceManager::addArchive(Archive* archive)
+void ResourceManager::addArchive(Archive* archive, bool background)
 {
 	// Check archive was given
 	if (!archive)
 		return;
 
-	// Go through entries
-	vector<shared_ptr<ArchiveEntry>> entries;
-	archive->putEntryTreeAsList(entries);
-	for (auto& entry : entries)
-		addEntry(entry);
+	// Get all entries to classify. Any entry types and indices (used for
+	// namespace detection) need to be up to date before classifying, since
+	// they can't be updated from multiple threads at once
+	auto job = std::make_shared<IndexJob>();
+	{
+		vector<shared_ptr<ArchiveEntry>> entries;
+		archive->putEntryTreeAsList(entries);
+		job->entries.resize(entries.size());
+		for (unsigned a = 0; a < entries.size(); a++)
+		{
+			if (entries[a]->type() == EntryType::unknownType())
+				EntryType::detectEntryType(*entries[a]);
+			entries[a]->index();
 
-	// Update entries from the archive when changed (added/removed/modified)
-	archive->signals().entry_added.connect([this](Archive&, ArchiveEntry& e) { updateEntry(e, false, true); });
-	archive->signals().entry_removed.connect(
-		[this](Archive&, ArchiveDir&, ArchiveEntry& e) { updateEntry(e, true, false); });
-	archive->signals().entry_state_changed.connect([this](Archive&, ArchiveEntry& e) { updateEntry(e, true, true); });
+			job->entries[a].entry = std::move(entries[a]);
+		}
+	}
 
-	// Update entries from the archive when renamed
-	archive->signals().entry_renamed.connect([this](Archive&, ArchiveEntry& entry, string_view prev_name) {
-		auto prev_upper   = strutil::upper(prev_name);
-		auto entry_shared = entry.getShared();
-		removeEntry(entry_shared, prev_upper);
-		addEntry(entry_shared);
+	// Classify entries (in parallel), skipping the rest if the job is cancelled
+	auto classify = [](IndexJob& job) {
+		sf::Clock timer;
+		parallel::forEach(
+			job.entries.size(),
+			[&job](size_t a) {
+				if (!job.cancelled)
+					classifyEntry(job.entries[a]);
+			},
+			{},
+			64);
+		job.time_ms = timer.getElapsedTime().asMilliseconds();
+	};
+
+	// Keep the archive alive while it is being indexed in the background
+	if (background && wxTheApp)
+		job->archive = app::archiveManager().shareArchive(archive);
+
+	// Not in the background, classify and add now
+	if (!job->archive)
+	{
+		classify(*job);
+		addIndexedArchive(archive, job->entries, job->time_ms);
+		return;
+	}
 
-		signals_.resources_updated();
+	// Classify on a worker thread, and add the resources from the main thread
+	// when done. The thread is joined when the job is finished, or when the
+	// resource manager is destroyed (in which case the thread won't be
+	// joinable by the time the queued call runs)
+	index_jobs_.push_back(job);
+	job->thread = std::thread([this, job, classify]() {
+		classify(*job);
+		if (wxTheApp)
+			wxTheApp->CallAfter([this, job]() {
+				if (job->thread.joinable())
+					finishIndexJob(job);
+			});
 	});
-
-	// Announce resource update
-	signals_.resources_updated();
 }
 
 // -----------------------------------------------------------------------------
@@ -277,6 +404,11 @@ void ResourceManager::removeArchive(Archive* archive)
 	if (!archive)
 		return;
 
+	// Cancel indexing the archive if it is still in progress
+	for (auto& job : index_jobs_)
+		if (job->archive.get() == archive)
+			job->cancelled = true;
+
 	// Remove from palettes
 	removeArchiveFromMap(palettes_, archive);
 
@@ -299,7 +431,8 @@ void ResourceManager::removeArchive(Archive* archive)
 		i.second.remove(archive);
 
 	// Announce resource update
-	signals_.resources_updated();
+	changes_.all = true;
+	queueChanges();
 }
 
 // -----------------------------------------------------------------------------
@@ -331,102 +464,143 @@ void ResourceManager::addEntry(shared_ptr<ArchiveEntry>& entry)
 	if (entry->type() == EntryType::unknownType())
 		EntryType::detectEntryType(*entry);
 
-	// Get entry type
-	auto* type = entry->type();
+	EntryInfo info;
+	info.entry = entry;
+	classifyEntry(info);
+
+	log::debug("Adding entry {} to resource manager", info.path);
+
+	addEntry(info);
+}
+
+// -----------------------------------------------------------------------------
+// Determines which resources the entry in [info] should be added as.
+// This only reads from the entry and its parent archive, so can be called for
+// multiple entries at once from different threads
+// -----------------------------------------------------------------------------
+void ResourceManager::classifyEntry(EntryInfo& info)
+{
+	auto& entry = info.entry;
+	auto* type  = entry->type();
 
 	// Get resource name (extension cut, uppercase)
-	auto lname = entry->upperNameNoExt();
-	auto name  = strutil::truncate(lname, 8);
+	auto lname     = entry->upperNameNoExt();
+	info.name      = strutil::truncate(lname, 8);
+	info.long_name = lname.size() > 8;
 	// Talon1024 - Get resource path (uppercase, without leading slash)
-	auto path = entry->path(true);
-	strutil::upperIP(path);
-	path.erase(0, 1);
-
-	log::debug("Adding entry {} to resource manager", path);
+	info.path = entry->path(true);
+	strutil::upperIP(info.path);
+	info.path.erase(0, 1);
 
 	// Check for palette entry
-	if (type->id() == "palette")
-		palettes_[name].add(entry);
+	info.palette = type->id() == "palette";
 
 	// Check for various image entries, so only accept images
-	if (type->editor() == "gfx")
+	if (type->editor() == "gfx" && entry->parent())
 	{
+		// Detect the entry's namespace once, rather than for each check
+		// (see ArchiveEntry::isInNamespace)
+		auto ns        = entry->parent()->detectNamespace(entry.get());
+		bool is_wad    = entry->parent()->formatId() == "wad";
+		auto in_nspace = [&](string_view check) { return ns == (check == "graphics" && is_wad ? "global" : check); };
+
 		// Reject graphics that are not in a valid namespace:
 		// Patches in wads can be in the global namespace as well, and
 		// ZDoom textures can use sprites and graphics as patches
-		if (!entry->isInNamespace("global") && !entry->isInNamespace("patches") && !entry->isInNamespace("sprites")
-			&& !entry->isInNamespace("graphics") &&
+		if (!in_nspace("global") && !in_nspace("patches") && !in_nspace("sprites") && !in_nspace("graphics") &&
 			// Stand-alone textures can also be found in the hires namespace
-			!entry->isInNamespace("hires") && !entry->isInNamespace("textures") &&
+			!in_nspace("hires") && !in_nspace("textures") &&
 			// Flats are kinda boring in comparison
-			!entry->isInNamespace("flats"))
+			!in_nspace("flats"))
 			return;
 
-		bool addToFpOnly = true;
-
 		// Check for patch entry
-		if (type->extraProps().contains("patch") || entry->isInNamespace("patches") || entry->isInNamespace("sprites"))
-		{
-			if (patches_[name].length() == 0)
-			{
-				addToFpOnly = false;
-			}
-			patches_[name].add(entry);
-			if (!entry->parent()->isTreeless())
-			{
-				patches_fp_[path].add(entry);
-				if ((lname.size() > 8 || patches_[name].length() > 0) && addToFpOnly)
-				{
-					patches_fp_only_[path].add(entry);
-				}
-			}
-		}
-
-		addToFpOnly = true;
+		info.patch = type->extraProps().contains("patch") || in_nspace("patches") || in_nspace("sprites");
 
 		// Check for flat entry
-		if (type->id() == "gfx_flat" || entry->isInNamespace("flats"))
+		info.flat = type->id() == "gfx_flat" || in_nspace("flats");
+
+		// Check for stand-alone texture entry
+		info.texture = in_nspace("textures") || in_nspace("hires");
+	}
+
+	// Check for TEXTUREx entry
+	if (type->id() == "texturex")
+		info.texturex = 1;
+	else if (type->id() == "zdtextures")
+		info.texturex = 2;
+}
+
+// -----------------------------------------------------------------------------
+// Adds the entry in [info] to the resources it was classified as
+// -----------------------------------------------------------------------------
+void ResourceManager::addEntry(const EntryInfo& info)
+{
+	auto  entry    = info.entry;
+	auto& name     = info.name;
+	auto& path     = info.path;
+	bool  treeless = !entry->parent() || entry->parent()->isTreeless();
+
+	// Palette
+	if (info.palette)
+	{
+		palettes_[name].add(entry);
+		changes_.add(changes_.palettes, name);
+	}
+
+	// Patch
+	if (info.patch)
+	{
+		auto& res         = patches_[name];
+		bool  addToFpOnly = res.length() > 0;
+		res.add(entry);
+		changes_.add(changes_.patches, name);
+		if (!treeless)
 		{
-			if (flats_[name].length() == 0)
-			{
-				addToFpOnly = false;
-			}
-			flats_[name].add(entry);
-			if (!entry->parent()->isTreeless())
-			{
-				flats_fp_[path].add(entry);
-				if ((lname.size() > 8 || flats_[name].length() > 0) && addToFpOnly)
-				{
-					flats_fp_only_[path].add(entry);
-				}
-			}
+			patches_fp_[path].add(entry);
+			changes_.add(changes_.patches, path);
+			if ((info.long_name || res.length() > 0) && addToFpOnly)
+				patches_fp_only_[path].add(entry);
 		}
+	}
 
-		// Check for stand-alone texture entry
-		if (entry->isInNamespace("textures") || entry->isInNamespace("hires"))
+	// Flat
+	if (info.flat)
+	{
+		auto& res         = flats_[name];
+		bool  addToFpOnly = res.length() > 0;
+		res.add(entry);
+		changes_.add(changes_.flats, name);
+		if (!treeless)
 		{
-			satextures_[name].add(entry);
-			if (!entry->parent()->isTreeless())
-			{
-				satextures_fp_[path].add(entry);
-			}
+			flats_fp_[path].add(entry);
+			changes_.add(changes_.flats, path);
+			if ((info.long_name || res.length() > 0) && addToFpOnly)
+				flats_fp_only_[path].add(entry);
+		}
+	}
 
-			// Add name to hash table
-			doom64_hash_table_[getTextureHash(name)] = name;
+	// Stand-alone texture
+	if (info.texture)
+	{
+		satextures_[name].add(entry);
+		changes_.add(changes_.textures, name);
+		if (!treeless)
+		{
+			satextures_fp_[path].add(entry);
+			changes_.add(changes_.textures, path);
 		}
+
+		// Add name to hash table
+		doom64_hash_table_[getTextureHash(name)] = name;
 	}
 
-	// Check for TEXTUREx entry
-	int txentry = 0;
-	if (type->id() == "texturex")
-		txentry = 1;
-	else if (type->id() == "zdtextures")
-		txentry = 2;
-	if (txentry > 0)
+	// TEXTUREx entry
+	if (info.texturex > 0)
 	{
 		// Load patch table if needed
 		PatchTable ptable;
-		if (txentry == 1)
+		if (info.texturex == 1)
 		{
 			Archive::SearchOptions opt;
 			opt.match_type = EntryType::fromId("pnames");
@@ -436,7 +610,7 @@ void ResourceManager::addEntry(shared_ptr<ArchiveEntry>& entry)
 
 		// Read texture list
 		TextureXList tx;
-		if (txentry == 1)
+		if (info.texturex == 1)
 			tx.readTEXTUREXData(entry.get(), ptable);
 		else
 			tx.readTEXTURESData(entry.get());
@@ -447,10 +621,73 @@ void ResourceManager::addEntry(shared_ptr<ArchiveEntry>& entry)
 		{
 			tex = tx.texture(a);
 			textures_[tex->name()].add(tex, entry->parent());
+			changes_.add(changes_.textures, strutil::upper(tex->name()));
 		}
 	}
 }
 
+// -----------------------------------------------------------------------------
+// Adds all classified [entries] in [archive] to the resource maps, and starts
+// keeping them up to date with any changes to the archive
+// -----------------------------------------------------------------------------
+void ResourceManager::addIndexedArchive(Archive* archive, const vector<EntryInfo>& entries, int time_ms)
+{
+	sf::Clock timer;
+
+	// Everything could be affected (by priority etc.), no need to record names
+	changes_.all = true;
+
+	// Add entries
+	for (const auto& info : entries)
+		addEntry(info);
+
+	log::info(
+		2,
+		"Indexed {} resource entries in {} ({}ms classify, {}ms add), resources now use ~{}kb",
+		entries.size(),
+		archive->filename(false),
+		time_ms,
+		timer.getElapsedTime().asMilliseconds(),
+		memoryUsage() / 1024);
+
+	// Update entries from the archive when changed (added/removed/modified)
+	archive->signals().entry_added.connect([this](Archive&, ArchiveEntry& e) { updateEntry(e, false, true); });
+	archive->signals().entry_removed.connect(
+		[this](Archive&, ArchiveDir&, ArchiveEntry& e) { updateEntry(e, true, false); });
+	archive->signals().entry_state_changed.connect([this](Archive&, ArchiveEntry& e) { updateEntry(e, true, true); });
+
+	// Update entries from the archive when renamed
+	archive->signals().entry_renamed.connect([this](Archive&, ArchiveEntry& entry, string_view prev_name) {
+		auto prev_upper   = strutil::upper(prev_name);
+		auto entry_shared = entry.getShared();
+		removeEntry(entry_shared, prev_upper);
+		addEntry(entry_shared);
+
+		changes_.added_removed = true;
+		queueChanges();
+	});
+
+	// Announce resource update
+	queueChanges();
+}
+
+// -----------------------------------------------------------------------------
+// Adds the resources from a finished background indexing [job] (unless it was
+// cancelled in the meantime)
+// -----------------------------------------------------------------------------
+void ResourceManager::finishIndexJob(const shared_ptr<IndexJob>& job)
+{
+	job->thread.join();
+	index_jobs_.erase(std::remove(index_jobs_.begin(), index_jobs_.end(), job), index_jobs_.end());
+
+	if (!job->cancelled)
+		addIndexedArchive(job->archive.get(), job->entries, job->time_ms);
+
+	// Release the archive and entries here rather than on the worker thread
+	job->entries.clear();
+	job->archive.reset();
+}
+
 // ----------------------------------------------------------------------------
 // Removes a managed entry
 // -----------------------------------------------------------------------------
@@ -468,21 +705,21 @@ void ResourceManager::removeEntry(shared_ptr<ArchiveEntry>& entry, string_view e
 	log::debug("Removing entry {} from resource manager", path);
 
 	// Remove from palettes
-	removeEntryFromMap(palettes_, name, entry, full_check);
+	removeEntryFromMap(palettes_, name, entry, full_check, changes_, changes_.palettes);
 
 	// Remove from patches
-	removeEntryFromMap(patches_, name, entry, full_check);
-	removeEntryFromMap(patches_fp_, path, entry, full_check);
-	removeEntryFromMap(patches_fp_only_, path, entry, full_check);
+	removeEntryFromMap(patches_, name, entry, full_check, changes_, changes_.patches);
+	removeEntryFromMap(patches_fp_, path, entry, full_check, changes_, changes_.patches);
+	removeEntryFromMap(patches_fp_only_, path, entry, full_check, changes_, changes_.patches);
 
 	// Remove from flats
-	removeEntryFromMap(flats_, name, entry, full_check);
-	removeEntryFromMap(flats_fp_, path, entry, full_check);
-	removeEntryFromMap(flats_fp_only_, path, entry, full_check);
+	removeEntryFromMap(flats_, name, entry, full_check, changes_, changes_.flats);
+	removeEntryFromMap(flats_fp_, path, entry, full_check, changes_, changes_.flats);
+	removeEntryFromMap(flats_fp_only_, path, entry, full_check, changes_, changes_.flats);
 
 	// Remove from stand-alone textures
-	removeEntryFromMap(satextures_, name, entry, full_check);
-	removeEntryFromMap(satextures_fp_, path, entry, full_check);
+	removeEntryFromMap(satextures_, name, entry, full_check, changes_, changes_.textures);
+	removeEntryFromMap(satextures_fp_, path, entry, full_check, changes_, changes_.textures);
 
 	// Check for TEXTUREx entry
 	int txentry = 0;
@@ -502,7 +739,11 @@ void ResourceManager::removeEntry(shared_ptr<ArchiveEntry>& entry, string_view e
 
 		// Remove all texture resources
 		for (unsigned a = 0; a < tx.size(); a++)
-			textures_[tx.texture(a)->name()].remove(entry->parent());
+		{
+			if (auto* res = findResource(textures_, tx.texture(a)->name()))
+				res->remove(entry->parent());
+			changes_.add(changes_.textures, strutil::upper(tx.texture(a)->name()));
+		}
 	}
 }
 
@@ -511,12 +752,12 @@ void ResourceManager::removeEntry(shared_ptr<ArchiveEntry>& entry, string_view e
 // -----------------------------------------------------------------------------
 void ResourceManager::listAllPatches()
 {
-	for (auto& i : patches_)
+	for (auto* i : sortedResources(patches_))
 	{
-		if (i.second.length() == 0)
+		if (i->second.length() == 0)
 			continue;
 
-		log::info("{} ({})", i.first, i.second.length());
+		log::info("{} ({})", i->first, i->second.length());
 	}
 }
 
@@ -525,9 +766,9 @@ void ResourceManager::listAllPatches()
 // -----------------------------------------------------------------------------
 void ResourceManager::putAllPatchEntries(vector<ArchiveEntry*>& list, Archive* priority, bool fullPath)
 {
-	for (auto& i : patches_)
+	for (auto* i : sortedResources(patches_))
 	{
-		auto* entry = i.second.getEntry(priority);
+		auto* entry = i->second.getEntry(priority);
 		if (entry)
 			list.push_back(entry);
 	}
@@ -535,9 +776,9 @@ void ResourceManager::putAllPatchEntries(vector<ArchiveEntry*>& list, Archive* p
 	if (!fullPath)
 		return;
 
-	for (auto& i : patches_fp_only_)
+	for (auto* i : sortedResources(patches_fp_only_))
 	{
-		auto* entry = i.second.getEntry(priority);
+		auto* entry = i->second.getEntry(priority);
 		if (entry)
 			list.push_back(entry);
 	}
@@ -549,13 +790,13 @@ void ResourceManager::putAllPatchEntries(vector<ArchiveEntry*>& list, Archive* p
 void ResourceManager::putAllTextures(vector<TextureResource::Texture*>& list, Archive* priority, Archive* ignore)
 {
 	// Add all primary textures to the list
-	for (auto& i : textures_)
+	for (auto* i : sortedResources(textures_))
 	{
 		// Skip if no entries
-		if (i.second.length() == 0)
+		if (i->second.length() == 0)
 			continue;
 
-		const auto& tex_res = i.second;
+		const auto& tex_res = i->second;
 
 		// Go through resource textures
 		auto* best_res = tex_res.textures_[0].get();
@@ -593,9 +834,12 @@ void ResourceManager::putAllTextures(vector<TextureResource::Texture*>& list, Ar
 void ResourceManager::putAllTextureNames(vector<string>& list)
 {
 	// Add all primary textures to the list
+	auto start = list.size();
 	for (auto& i : textures_)
 		if (i.second.length() > 0) // Ignore if no entries
 			list.push_back(i.first);
+
+	std::sort(list.begin() + start, list.end());
 }
 
 // -----------------------------------------------------------------------------
@@ -603,9 +847,9 @@ void ResourceManager::putAllTextureNames(vector<string>& list)
 // -----------------------------------------------------------------------------
 void ResourceManager::putAllFlatEntries(vector<ArchiveEntry*>& list, Archive* priority, bool fullPath)
 {
-	for (auto& i : flats_)
+	for (auto* i : sortedResources(flats_))
 	{
-		auto* entry = i.second.getEntry(priority);
+		auto* entry = i->second.getEntry(priority);
 		if (entry)
 			list.push_back(entry);
 	}
@@ -613,9 +857,9 @@ void ResourceManager::putAllFlatEntries(vector<ArchiveEntry*>& list, Archive* pr
 	if (!fullPath)
 		return;
 
-	for (auto& i : flats_fp_only_)
+	for (auto* i : sortedResources(flats_fp_only_))
 	{
-		auto* entry = i.second.getEntry(priority);
+		auto* entry = i->second.getEntry(priority);
 		if (entry)
 			list.push_back(entry);
 	}
@@ -627,9 +871,12 @@ void ResourceManager::putAllFlatEntries(vector<ArchiveEntry*>& list, Archive* pr
 void ResourceManager::putAllFlatNames(vector<string>& list)
 {
 	// Add all primary flats to the list
+	auto start = list.size();
 	for (auto& i : flats_)
 		if (i.second.length() > 0) // Ignore if no entries
 			list.push_back(i.first);
+
+	std::sort(list.begin() + start, list.end());
 }
 
 // -----------------------------------------------------------------------------
@@ -638,7 +885,8 @@ void ResourceManager::putAllFlatNames(vector<string>& list)
 // -----------------------------------------------------------------------------
 ArchiveEntry* ResourceManager::getPaletteEntry(string_view palette, Archive* priority)
 {
-	return palettes_[strutil::upper(palette)].getEntry(priority);
+	auto* res = findResourceUpper(palettes_, palette);
+	return res ? res->getEntry(priority) : nullptr;
 }
 
 // -----------------------------------------------------------------------------
@@ -655,14 +903,13 @@ ArchiveEntry* ResourceManager::getPatchEntry(string_view patch, string_view nspa
 	if (strutil::equalCI(nspace, "textures"))
 		return getTextureEntry(patch, "textures", priority);
 
-	auto  patch_upper = strutil::upper(patch);
-	auto* entry       = patches_[patch_upper].getEntry(priority, nspace, true);
-	if (entry)
-		return entry;
+	if (auto* res = findResourceUpper(patches_, patch))
+		if (auto* entry = res->getEntry(priority, nspace, true))
+			return entry;
 
-	entry = patches_fp_[patch_upper].getEntry(priority, nspace, true);
-	if (entry)
-		return entry;
+	if (auto* res = findResourceUpper(patches_fp_, patch))
+		if (auto* entry = res->getEntry(priority, nspace, true))
+			return entry;
 
 	return nullptr;
 }
@@ -673,18 +920,14 @@ ArchiveEntry* ResourceManager::getPatchEntry(string_view patch, string_view nspa
 // -----------------------------------------------------------------------------
 ArchiveEntry* ResourceManager::getFlatEntry(string_view flat, Archive* priority)
 {
-	// Check resource with matching name exists
-	auto  flat_upper = strutil::upper(flat);
-	auto& res        = flats_[flat_upper];
+	// Check resource with matching name exists, and return its most relevant entry
+	if (auto* res = findResourceUpper(flats_, flat))
+		if (auto* entry = res->getEntry(priority))
+			return entry;
 
-	// Return most relevant entry
-	auto* entry = res.getEntry(priority);
-	if (entry)
-		return entry;
-
-	entry = flats_fp_[flat_upper].getEntry(priority, "flats", true);
-	if (entry)
-		return entry;
+	if (auto* res = findResourceUpper(flats_fp_, flat))
+		if (auto* entry = res->getEntry(priority, "flats", true))
+			return entry;
 
 	return nullptr;
 }
@@ -695,14 +938,13 @@ ArchiveEntry* ResourceManager::getFlatEntry(string_view flat, Archive* priority)
 // -----------------------------------------------------------------------------
 ArchiveEntry* ResourceManager::getTextureEntry(string_view texture, string_view nspace, Archive* priority)
 {
-	auto  tex_upper = strutil::upper(texture);
-	auto* entry     = satextures_[tex_upper].getEntry(priority, nspace, true);
-	if (entry)
-		return entry;
+	if (auto* res = findResourceUpper(satextures_, texture))
+		if (auto* entry = res->getEntry(priority, nspace, true))
+			return entry;
 
-	entry = satextures_fp_[tex_upper].getEntry(priority, nspace, true);
-	if (entry)
-		return entry;
+	if (auto* res = findResourceUpper(satextures_fp_, texture))
+		if (auto* entry = res->getEntry(priority, nspace, true))
+			return entry;
 
 	return nullptr;
 }
@@ -714,14 +956,16 @@ ArchiveEntry* ResourceManager::getTextureEntry(string_view texture, string_view
 CTexture* ResourceManager::getTexture(string_view texture, Archive* priority, Archive* ignore)
 {
 	// Check texture resource with matching name exists
-	auto& res = textures_[strutil::upper(texture)];
-	if (res.textures_.empty())
+	auto* res = findResourceUpper(textures_, texture);
+	if (!res || res->textures_.empty())
 		return nullptr;
 
 	// Go through resource textures
-	auto* tex    = &res.textures_[0]->tex;
-	auto* parent = res.textures_[0]->parent.lock().get();
-	for (auto& res_tex : res.textures_)
+	auto& archives     = app::archiveManager();
+	auto* tex          = &res->textures_[0]->tex;
+	auto* parent       = res->textures_[0]->parent.lock().get();
+	auto  parent_index = archives.archiveIndex(parent);
+	for (auto& res_tex : res->textures_)
 	{
 		// Skip if it's in the 'ignore' archive
 		auto* rt_parent = res_tex->parent.lock().get();
@@ -733,10 +977,12 @@ CTexture* ResourceManager::getTexture(string_view texture, Archive* priority, Ar
 			return &res_tex->tex;
 
 		// Otherwise, if it's in a 'later' archive than the current resource entry, set it
-		if (app::archiveManager().archiveIndex(parent) <= app::archiveManager().archiveIndex(rt_parent))
+		auto rt_index = archives.archiveIndex(rt_parent);
+		if (parent_index <= rt_index)
 		{
-			tex    = &res_tex->tex;
-			parent = rt_parent;
+			tex          = &res_tex->tex;
+			parent       = rt_parent;
+			parent_index = rt_index;
 		}
 	}
 
@@ -747,6 +993,69 @@ CTexture* ResourceManager::getTexture(string_view texture, Archive* priority, Ar
 		return nullptr;
 }
 
+// -----------------------------------------------------------------------------
+// Returns the composite texture [texture] defined in [archive], or nullptr if
+// [archive] doesn't define it
+// -----------------------------------------------------------------------------
+CTexture* ResourceManager::getArchiveTexture(string_view texture, Archive* archive)
+{
+	auto* res = findResourceUpper(textures_, texture);
+	if (!res)
+		return nullptr;
+
+	for (auto& res_tex : res->textures_)
+		if (res_tex->parent.lock().get() == archive)
+			return &res_tex->tex;
+
+	return nullptr;
+}
+
+// -----------------------------------------------------------------------------
+// Returns the approximate amount of memory used by all managed resources (in
+// bytes)
+// -----------------------------------------------------------------------------
+size_t ResourceManager::memoryUsage() const
+{
+	return mapMemoryUsage(palettes_) + mapMemoryUsage(patches_) + mapMemoryUsage(patches_fp_)
+		   + mapMemoryUsage(patches_fp_only_) + mapMemoryUsage(graphics_) + mapMemoryUsage(flats_)
+		   + mapMemoryUsage(flats_fp_) + mapMemoryUsage(flats_fp_only_) + mapMemoryUsage(satextures_)
+		   + mapMemoryUsage(satextures_fp_) + mapMemoryUsage(textures_);
+}
+
+// -----------------------------------------------------------------------------
+// Ends a bulk update (see ResourceBulkUpdate), sending any changes made during
+// it if it was the outermost one
+// -----------------------------------------------------------------------------
+void ResourceManager::endBulkUpdate()
+{
+	if (bulk_updates_ > 0)
+		--bulk_updates_;
+
+	if (bulk_updates_ == 0)
+		flushChanges();
+}
+
+// -----------------------------------------------------------------------------
+// Sends any pending resource changes now
+// -----------------------------------------------------------------------------
+void ResourceManager::flushChanges()
+{
+	flush_queued_ = false;
+	if (bulk_updates_ > 0 || changes_.empty())
+		return;
+
+	// Clear pending changes first in case any handlers cause more
+	auto changes = std::move(changes_);
+	changes_.clear();
+
+	signals_.resources_changed(changes);
+	signals_.resources_updated();
+}
+
+// -----------------------------------------------------------------------------
+// Updates [entry] in the resource manager, after it was added, removed or
+// modified
+// -----------------------------------------------------------------------------
 void ResourceManager::updateEntry(ArchiveEntry& entry, bool remove, bool add)
 {
 	auto sptr = entry.getShared();
@@ -755,7 +1064,29 @@ void ResourceManager::updateEntry(ArchiveEntry& entry, bool remove, bool add)
 	if (add)
 		addEntry(sptr);
 
-	signals_.resources_updated();
+	if (remove != add)
+		changes_.added_removed = true;
+
+	queueChanges();
+}
+
+// -----------------------------------------------------------------------------
+// Queues sending any pending resource changes on the next event loop iteration
+// (or at the end of the current bulk update)
+// -----------------------------------------------------------------------------
+void ResourceManager::queueChanges()
+{
+	if (bulk_updates_ > 0 || flush_queued_ || changes_.empty())
+		return;
+
+	if (!wxTheApp)
+	{
+		flushChanges();
+		return;
+	}
+
+	flush_queued_ = true;
+	wxTheApp->CallAfter([this]() { flushChanges(); });
 }
 
 
@@ -771,6 +1102,11 @@ CONSOLE_COMMAND(list_res_patches, 0, false)
 	app::resources().listAllPatches();
 }
 
+CONSOLE_COMMAND(res_memory, 0, false)
+{
+	log::console(fmt::format("Resources use ~{}kb", app::resources().memoryUsage() / 1024));
+}
+
 #include "App.h"
 CONSOLE_COMMAND(test_res_speed, 0, false)
 {
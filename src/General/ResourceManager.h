@@ -2,6 +2,9 @@
 
 #include "Archive/Archive.h"
 #include "Graphics/CTexture/CTexture.h"
+#include <atomic>
+#include <thread>
+#include <unordered_map>
 
 namespace slade
 {
@@ -16,7 +19,8 @@ public:
 	Resource(string_view type) : type_{ type } {}
 	virtual ~Resource() = default;
 
-	virtual int length() const { return 0; }
+	virtual int    length() const { return 0; }
+	virtual size_t memoryUsage() const { return 0; }
 
 private:
 	string type_;
@@ -31,10 +35,11 @@ public:
 	virtual ~EntryResource() = default;
 
 	void add(shared_ptr<ArchiveEntry>& entry);
-	void remove(shared_ptr<ArchiveEntry>& entry);
+	bool remove(shared_ptr<ArchiveEntry>& entry);
 	void removeArchive(Archive* archive);
 
-	int length() const override { return entries_.size(); }
+	int    length() const override { return entries_.size(); }
+	size_t memoryUsage() const override { return entries_.capacity() * sizeof(weak_ptr<ArchiveEntry>); }
 
 	ArchiveEntry* getEntry(Archive* priority = nullptr, string_view nspace = "", bool ns_required = false);
 
@@ -61,23 +66,53 @@ public:
 	void add(CTexture* tex, Archive* parent);
 	void remove(Archive* parent);
 
-	int length() const override { return textures_.size(); }
+	int    length() const override { return textures_.size(); }
+	size_t memoryUsage() const override
+	{
+		return textures_.capacity() * sizeof(unique_ptr<Texture>) + textures_.size() * sizeof(Texture);
+	}
 
 private:
 	vector<unique_ptr<Texture>> textures_;
 };
 
-typedef std::map<string, EntryResource>   EntryResourceMap;
-typedef std::map<string, TextureResource> TextureResourceMap;
+// Resources are keyed by uppercase name (or full path). Note that iteration
+// order is unspecified, anything listing resources should sort them by name
+typedef std::unordered_map<string, EntryResource>   EntryResourceMap;
+typedef std::unordered_map<string, TextureResource> TextureResourceMap;
+
+// Describes which resources changed in a batch of updates. Names are uppercase,
+// and patch/flat/texture names include both the short name and full path
+struct ResourceChanges
+{
+	bool             all           = false; // Anything may have changed (eg. an archive was added or removed)
+	bool             added_removed = false; // Resources were added, removed or renamed (not just modified)
+	std::set<string> palettes;
+	std::set<string> patches; // Includes sprites
+	std::set<string> flats;
+	std::set<string> textures; // Stand-alone and composite (TEXTUREx etc.) textures
+
+	bool empty() const
+	{
+		return !all && palettes.empty() && patches.empty() && flats.empty() && textures.empty();
+	}
+	void add(std::set<string>& names, string_view name) const
+	{
+		if (!all)
+			names.emplace(name);
+	}
+	void clear() { *this = {}; }
+};
 
 class ResourceManager
 {
 public:
-	ResourceManager()  = default;
-	~ResourceManager() = default;
+	ResourceManager() = default;
+	~ResourceManager();
 
-	void addArchive(Archive* archive);
+	void addArchive(Archive* archive, bool background = false);
 	void removeArchive(Archive* archive);
+	bool indexing() const { return !index_jobs_.empty(); }
 
 	void addEntry(shared_ptr<ArchiveEntry>& entry);
 	void removeEntry(shared_ptr<ArchiveEntry>& entry, string_view entry_name = {}, bool full_check = false);
@@ -96,18 +131,52 @@ public:
 	ArchiveEntry* getFlatEntry(string_view flat, Archive* priority = nullptr);
 	ArchiveEntry* getTextureEntry(string_view texture, string_view nspace = "textures", Archive* priority = nullptr);
 	CTexture*     getTexture(string_view texture, Archive* priority = nullptr, Archive* ignore = nullptr);
+	CTexture*     getArchiveTexture(string_view texture, Archive* archive);
 	uint16_t      getTextureHash(string_view name) const;
+	size_t        memoryUsage() const;
+
+	// Change notifications are batched, and sent on the next event loop
+	// iteration (or at the end of a bulk update, see ResourceBulkUpdate)
+	void beginBulkUpdate() { ++bulk_updates_; }
+	void endBulkUpdate();
+	void flushChanges();
 
 	// Signals
 	struct Signals
 	{
-		sigslot::signal<> resources_updated;
+		sigslot::signal<>                       resources_updated; // Sent after resources_changed
+		sigslot::signal<const ResourceChanges&> resources_changed;
 	};
 	Signals& signals() { return signals_; }
 
 	static string doom64TextureName(uint16_t hash) { return doom64_hash_table_[hash]; }
 
 private:
+	// Where an entry belongs in the resource maps, determined up-front so that
+	// entries can be classified on worker threads before being added
+	struct EntryInfo
+	{
+		shared_ptr<ArchiveEntry> entry;
+		string                   name; // Uppercase, extension cut, max 8 characters
+		string                   path; // Uppercase full path, without leading slash
+		bool                     long_name = false;
+		bool                     palette   = false;
+		bool                     patch     = false;
+		bool                     flat      = false;
+		bool                     texture   = false; // Stand-alone texture
+		int                      texturex  = 0;     // 1 = TEXTUREx, 2 = TEXTURES
+	};
+
+	// An archive being indexed on a worker thread
+	struct IndexJob
+	{
+		shared_ptr<Archive> archive;
+		vector<EntryInfo>   entries;
+		int                 time_ms = 0;
+		std::atomic<bool>   cancelled{ false };
+		std::thread         thread;
+	};
+
 	EntryResourceMap palettes_;
 	EntryResourceMap patches_;
 	EntryResourceMap patches_fp_;      // Full path
@@ -122,8 +191,32 @@ private:
 	TextureResourceMap textures_; // Composite textures (defined in a TEXTUREx/TEXTURES lump)
 	Signals            signals_;
 
+	// Pending change notifications
+	ResourceChanges changes_;
+	int             bulk_updates_ = 0;
+	bool            flush_queued_ = false;
+
+	vector<shared_ptr<IndexJob>> index_jobs_;
+
 	static string doom64_hash_table_[65536];
 
-	void updateEntry(ArchiveEntry& entry, bool remove, bool add);
+	static void classifyEntry(EntryInfo& info);
+	void        addEntry(const EntryInfo& info);
+	void        addIndexedArchive(Archive* archive, const vector<EntryInfo>& entries, int time_ms);
+	void        finishIndexJob(const shared_ptr<IndexJob>& job);
+	void        updateEntry(ArchiveEntry& entry, bool remove, bool add);
+	void        queueChanges();
+};
+
+// Simple class that batches all resource change notifications until it goes
+// out of scope, via RAII
+class ResourceBulkUpdate
+{
+public:
+	ResourceBulkUpdate(ResourceManager& resources) : resources_{ &resources } { resources_->beginBulkUpdate(); }
+	~ResourceBulkUpdate() { resources_->endBulkUpdate(); }
+
+private:
+	ResourceManager* resources_;
 };
 } // namespace slade
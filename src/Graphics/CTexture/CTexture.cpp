@@ -34,9 +34,9 @@
 #include "CTexture.h"
 #include "App.h"
 #include "Archive/ArchiveManager.h"
-#include "General/Misc.h"
 #include "General/ResourceManager.h"
 #include "Graphics/SImage/SImage.h"
+#include "TextureCache.h"
 #include "TextureXList.h"
 #include "Utility/StringUtils.h"
 #include "Utility/Tokenizer.h"
@@ -813,6 +813,16 @@ bool CTexture::convertRegular()
 // -----------------------------------------------------------------------------
 bool CTexture::toImage(SImage& image, Archive* parent, Palette* pal, bool force_rgba)
 {
+	// Check for cached image ('define' textures are just a single patch, and
+	// also update the texture size so aren't cached)
+	string cache_key;
+	if (!defined_)
+	{
+		cache_key = cacheKey(parent, pal, force_rgba);
+		if (texturecache::getComposite(cache_key, image))
+			return true;
+	}
+
 	// Init image
 	image.clear();
 	image.resize(size_.x, size_.y);
@@ -837,13 +847,16 @@ bool CTexture::toImage(SImage& image, Archive* parent, Palette* pal, bool force_
 		// Extended texture
 
 		// Add each patch to image
+		bool uses_textures = false;
 		for (unsigned a = 0; a < patches_.size(); a++)
 		{
 			auto patch = dynamic_cast<CTPatchEx*>(patches_[a].get());
 
 			// Load patch entry
-			if (!loadPatchImage(a, p_img, parent, pal))
+			bool is_texture = false;
+			if (!loadPatchImage(a, p_img, parent, pal, is_texture))
 				continue;
+			uses_textures |= is_texture;
 
 			// Handle offsets
 			int ofs_x = patch->xOffset();
@@ -909,6 +922,11 @@ bool CTexture::toImage(SImage& image, Archive* parent, Palette* pal, bool force_
 			// Add patch to texture image
 			image.drawImage(p_img, ofs_x, ofs_y, dp, pal, pal);
 		}
+
+		// Textures-as-patches can change without any resource updates (eg. when
+		// editing the texture list we're in), so don't cache
+		if (uses_textures)
+			cache_key.clear();
 	}
 	else
 	{
@@ -917,11 +935,15 @@ bool CTexture::toImage(SImage& image, Archive* parent, Palette* pal, bool force_
 		// Add each patch to image
 		for (auto& patch : patches_)
 		{
-			if (misc::loadImageFromEntry(&p_img, patch->patchEntry(parent)))
+			if (texturecache::loadPatchImage(p_img, patch->patchEntry(parent)))
 				image.drawImage(p_img, patch->xOffset(), patch->yOffset(), dp, pal, pal);
 		}
 	}
 
+	// Add to cache
+	if (!cache_key.empty())
+		texturecache::addComposite(cache_key, image);
+
 	return true;
 }
 
@@ -931,6 +953,18 @@ bool CTexture::toImage(SImage& image, Archive* parent, Palette* pal, bool force_
 // -----------------------------------------------------------------------------
 bool CTexture::loadPatchImage(unsigned pindex, SImage& image, Archive* parent, Palette* pal)
 {
+	bool is_texture;
+	return loadPatchImage(pindex, image, parent, pal, is_texture);
+}
+
+// -----------------------------------------------------------------------------
+// Loads the image for the patch at [pindex] into [image].
+// [is_texture] is set to true if the patch was loaded from a texture
+// -----------------------------------------------------------------------------
+bool CTexture::loadPatchImage(unsigned pindex, SImage& image, Archive* parent, Palette* pal, bool& is_texture)
+{
+	is_texture = false;
+
 	// Check patch index
 	if (pindex >= patches_.size())
 		return false;
@@ -956,6 +990,7 @@ bool CTexture::loadPatchImage(unsigned pindex, SImage& image, Archive* parent, P
 				if (strutil::equalCI(tex->name(), patch->name()))
 				{
 					// Load texture to image
+					is_texture = true;
 					return tex->toImage(image, parent, pal);
 				}
 			}
@@ -965,7 +1000,10 @@ bool CTexture::loadPatchImage(unsigned pindex, SImage& image, Archive* parent, P
 		// TODO: Something has to be ignored here. The entire archive or just the current list?
 		auto tex = app::resources().getTexture(patch->name(), parent);
 		if (tex)
+		{
+			is_texture = true;
 			return tex->toImage(image, parent, pal);
+		}
 	}
 
 	// Get patch entry
@@ -973,13 +1011,36 @@ bool CTexture::loadPatchImage(unsigned pindex, SImage& image, Archive* parent, P
 
 	// Load entry to image if valid
 	if (entry)
-		return misc::loadImageFromEntry(&image, entry);
+		return texturecache::loadPatchImage(image, entry);
 
 	// Maybe it's a texture?
 	entry = app::resources().getTextureEntry(patch->name(), "", parent);
 
 	if (entry)
-		return misc::loadImageFromEntry(&image, entry);
+		return texturecache::loadPatchImage(image, entry);
 
 	return false;
 }
+
+// -----------------------------------------------------------------------------
+// Returns a key identifying the image this texture would produce from toImage
+// with the given [parent], [pal] and [force_rgba], for use with the composite
+// texture cache
+// -----------------------------------------------------------------------------
+string CTexture::cacheKey(Archive* parent, Palette* pal, bool force_rgba)
+{
+	auto key = fmt::format(
+		"{}:{}:{}\n", static_cast<void*>(parent), texturecache::paletteKey(pal), force_rgba ? "rgba" : "");
+
+	// Texture definition
+	if (extended_)
+		key += asText();
+	else
+	{
+		key += fmt::format("{} {} {}\n", name_, size_.x, size_.y);
+		for (auto& patch : patches_)
+			key += fmt::format("{} {} {}\n", patch->name(), patch->xOffset(), patch->yOffset());
+	}
+
+	return key;
+}
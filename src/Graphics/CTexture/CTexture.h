@@ -210,5 +210,8 @@ private:
 
 	// Signals
 	Signals signals_;
+
+	bool   loadPatchImage(unsigned pindex, SImage& image, Archive* parent, Palette* pal, bool& is_texture);
+	string cacheKey(Archive* parent, Palette* pal, bool force_rgba);
 };
 } // namespace slade
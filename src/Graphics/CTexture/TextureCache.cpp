@@ -0,0 +1,309 @@
+// -----------------------------------------------------------------------------
+// SLADE - It's a Doom Editor
+// Copyright(C) 2008 - 2020 Simon Judd
+//
+// Email:       sirjuddington@gmail.com
+// Web:         http://slade.mancubus.net
+// Filename:    TextureCache.cpp
+// Description: Caches of decoded patch images and composited texture images,
+//              used by CTexture::toImage so that patches shared between many
+//              textures only need to be loaded once
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation; either version 2 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+//
+// Includes
+//
+// -----------------------------------------------------------------------------
+#include "Main.h"
+#include "TextureCache.h"
+#include "App.h"
+#include "Archive/Archive.h"
+#include "General/Misc.h"
+#include "General/ResourceManager.h"
+#include "General/Sigslot.h"
+#include "Graphics/SImage/SImage.h"
+#include <list>
+#include <unordered_map>
+
+using namespace slade;
+
+
+// -----------------------------------------------------------------------------
+//
+// Variables
+//
+// -----------------------------------------------------------------------------
+CVAR(Int, texture_patch_cache_size, 64, CVar::Flag::Save)     // In MB, 0 to disable
+CVAR(Int, texture_composite_cache_size, 64, CVar::Flag::Save) // In MB, 0 to disable
+
+
+// -----------------------------------------------------------------------------
+//
+// ImageLRU Struct
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// A cache of images with a memory limit, where the least recently used images
+// are removed first once the limit is reached
+template<typename K> struct ImageLRU
+{
+	struct Item
+	{
+		K                      key;
+		SImage                 image;
+		weak_ptr<ArchiveEntry> entry; // Source entry (patch cache only)
+		size_t                 size = 0;
+	};
+
+	std::list<Item>                                           items; // Most recently used first
+	std::unordered_map<K, typename std::list<Item>::iterator> lookup;
+	size_t                                                    mem_used = 0;
+
+	// Returns the item with [key] (and marks it as most recently used), or
+	// nullptr if it isn't cached
+	Item* get(const K& key)
+	{
+		auto i = lookup.find(key);
+		if (i == lookup.end())
+			return nullptr;
+
+		items.splice(items.begin(), items, i->second);
+		return &items.front();
+	}
+
+	// Adds a copy of [image] with [key], removing the least recently used
+	// items if the cache is now larger than [max_mem] bytes
+	Item& add(const K& key, SImage& image, size_t max_mem)
+	{
+		remove(key);
+
+		auto& item = items.emplace_front();
+		item.key   = key;
+		item.image.copyImage(&image);
+		item.size = image.width() * image.height() * image.bpp();
+		if (image.type() == SImage::Type::PalMask)
+			item.size += image.width() * image.height(); // Mask
+		lookup[key] = items.begin();
+		mem_used += item.size;
+
+		// Always keep the item just added
+		while (mem_used > max_mem && items.size() > 1)
+			remove(items.back().key);
+
+		return item;
+	}
+
+	// Removes the item with [key], if it is cached
+	void remove(const K& key)
+	{
+		auto i = lookup.find(key);
+		if (i == lookup.end())
+			return;
+
+		mem_used -= i->second->size;
+		items.erase(i->second);
+		lookup.erase(i);
+	}
+
+	void clear()
+	{
+		items.clear();
+		lookup.clear();
+		mem_used = 0;
+	}
+};
+
+ImageLRU<ArchiveEntry*> patch_cache;
+ImageLRU<string>        composite_cache;
+
+// Signal connections for archives containing cached patches
+std::unordered_map<Archive*, ScopedConnectionList> archive_connections;
+sigslot::scoped_connection                         sc_resources_updated;
+} // namespace
+
+
+// -----------------------------------------------------------------------------
+//
+// Functions
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// -----------------------------------------------------------------------------
+// Removes all cached patches from [archive]
+// -----------------------------------------------------------------------------
+void removeArchivePatches(Archive* archive)
+{
+	vector<ArchiveEntry*> remove;
+	for (auto& item : patch_cache.items)
+	{
+		auto entry = item.entry.lock();
+		if (!entry || entry->parent() == archive)
+			remove.push_back(item.key);
+	}
+
+	for (auto key : remove)
+		patch_cache.remove(key);
+}
+
+// -----------------------------------------------------------------------------
+// Removes [entry] from the patch cache (if cached). Cached composite textures
+// are always cleared, since any of them may have used it (even if its patch
+// image isn't cached, eg. if it was evicted or the patch cache is disabled)
+// -----------------------------------------------------------------------------
+void entryChanged(ArchiveEntry& entry)
+{
+	patch_cache.remove(&entry);
+	composite_cache.clear();
+}
+
+// -----------------------------------------------------------------------------
+// Connects to signals from [archive] (if not already connected) so that any
+// cached patches and composite textures using it are removed when modified
+// -----------------------------------------------------------------------------
+void watchArchive(Archive* archive)
+{
+	// Check if already connected (and that it isn't a different archive that
+	// happens to have the same address as a previously deleted one)
+	auto& connections = archive_connections[archive].connections;
+	if (!connections.empty() && connections.front().connected())
+		return;
+
+	connections.clear();
+	auto& signals = archive->signals();
+	connections.emplace_back(
+		signals.entry_state_changed.connect([](Archive&, ArchiveEntry& entry) { entryChanged(entry); }));
+	connections.emplace_back(
+		signals.entry_removed.connect([](Archive&, ArchiveDir&, ArchiveEntry& entry) { entryChanged(entry); }));
+	connections.emplace_back(signals.closed.connect([](Archive& archive) {
+		removeArchivePatches(&archive);
+		composite_cache.clear();
+		archive_connections.erase(&archive);
+	}));
+}
+} // namespace
+
+
+// -----------------------------------------------------------------------------
+//
+// TextureCache Namespace Functions
+//
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+// Loads the image from [entry] into [image], using the cached image if the
+// entry has been loaded previously
+// -----------------------------------------------------------------------------
+bool texturecache::loadPatchImage(SImage& image, ArchiveEntry* entry)
+{
+	if (!entry)
+		return false;
+
+	// Check cache
+	if (auto item = patch_cache.get(entry))
+	{
+		// Make sure it's the same entry and not a new one with the same
+		// address as a previously deleted one
+		if (item->entry.lock().get() == entry)
+			return image.copyImage(&item->image);
+
+		patch_cache.remove(entry);
+	}
+
+	// Load image
+	if (!misc::loadImageFromEntry(&image, entry))
+		return false;
+
+	// Watch the entry's archive for changes, composite textures using it may be
+	// cached even if its patch image isn't
+	auto shared = entry->getShared();
+	auto parent = entry->parent();
+	if (parent)
+		watchArchive(parent);
+
+	// Add to cache (if it's in an archive)
+	if (texture_patch_cache_size > 0 && shared && parent)
+		patch_cache.add(entry, image, static_cast<size_t>(texture_patch_cache_size) * 1024 * 1024).entry = shared;
+
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Loads the cached composite texture image with [key] into [image].
+// Returns false if no texture with [key] is cached
+// -----------------------------------------------------------------------------
+bool texturecache::getComposite(const string& key, SImage& image)
+{
+	auto item = composite_cache.get(key);
+	if (!item)
+		return false;
+
+	return image.copyImage(&item->image);
+}
+
+// -----------------------------------------------------------------------------
+// Adds [image] to the composite texture cache with [key]
+// -----------------------------------------------------------------------------
+void texturecache::addComposite(const string& key, SImage& image)
+{
+	if (texture_composite_cache_size <= 0)
+		return;
+
+	// Composited textures depend on which patches the resource manager finds,
+	// so clear them whenever resources are updated
+	if (!sc_resources_updated.connected())
+		sc_resources_updated = app::resources().signals().resources_updated.connect(
+			[]() { composite_cache.clear(); });
+
+	composite_cache.add(key, image, static_cast<size_t>(texture_composite_cache_size) * 1024 * 1024);
+}
+
+// -----------------------------------------------------------------------------
+// Returns a string identifying the contents of [pal], for use in composite
+// texture cache keys
+// -----------------------------------------------------------------------------
+string texturecache::paletteKey(const Palette* pal)
+{
+	if (!pal)
+		return "none";
+
+	// FNV-1a hash of all colours
+	uint64_t hash = 14695981039346656037ull;
+	for (const auto& col : pal->colours())
+	{
+		for (auto c : { col.r, col.g, col.b, col.a })
+		{
+			hash ^= c;
+			hash *= 1099511628211ull;
+		}
+	}
+
+	return fmt::format("{:016x}", hash);
+}
+
+// -----------------------------------------------------------------------------
+// Clears all cached patch and composite texture images
+// -----------------------------------------------------------------------------
+void texturecache::clear()
+{
+	patch_cache.clear();
+	composite_cache.clear();
+}
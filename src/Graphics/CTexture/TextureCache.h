@@ -0,0 +1,21 @@
+#pragma once
+
+namespace slade
+{
+class SImage;
+class ArchiveEntry;
+class Palette;
+
+namespace texturecache
+{
+	// Decoded patch images
+	bool loadPatchImage(SImage& image, ArchiveEntry* entry);
+
+	// Composited texture images
+	bool   getComposite(const string& key, SImage& image);
+	void   addComposite(const string& key, SImage& image);
+	string paletteKey(const Palette* pal);
+
+	void clear();
+} // namespace texturecache
+} // namespace slade
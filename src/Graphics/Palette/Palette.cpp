@@ -57,6 +57,19 @@ EXTERN_CVAR(Float, col_greyscale_r)
 EXTERN_CVAR(Float, col_greyscale_g)
 EXTERN_CVAR(Float, col_greyscale_b)
 
+namespace
+{
+// Lookup cube used by nearestColour for the RGB-space match methods: 5 bits per
+// component, giving 32768 cells that each cover 8x8x8 colours
+constexpr unsigned NEAREST_CELL_BITS      = 5;
+constexpr unsigned NEAREST_CELLS          = 1 << (NEAREST_CELL_BITS * 3);
+constexpr unsigned NEAREST_MAX_CANDIDATES = 16; // Stored as 8 per uint64_t
+constexpr uint8_t  NEAREST_CELL_FULL_SCAN = 0xFF;
+
+// Number of results remembered by nearestColour for other match methods
+constexpr unsigned NEAREST_MEMO_SIZE = 65536;
+} // namespace
+
 
 // -----------------------------------------------------------------------------
 //
@@ -80,6 +93,23 @@ Palette::Palette(unsigned size) : colours_{ size }, colours_hsl_{ size }, colour
 	}
 }
 
+// -----------------------------------------------------------------------------
+// Palette class copy assignment operator
+// -----------------------------------------------------------------------------
+Palette& Palette::operator=(const Palette& pal)
+{
+	if (&pal == this)
+		return *this;
+
+	colours_     = pal.colours_;
+	colours_hsl_ = pal.colours_hsl_;
+	colours_lab_ = pal.colours_lab_;
+	index_trans_ = pal.index_trans_;
+	clearNearestCache();
+
+	return *this;
+}
+
 // -----------------------------------------------------------------------------
 // Reads colour information from raw data (MemChunk)
 // -----------------------------------------------------------------------------
@@ -111,6 +141,8 @@ bool Palette::loadMem(MemChunk& mc)
 	}
 	mc.seek(0, SEEK_SET);
 
+	clearNearestCache();
+
 	return true;
 }
 
@@ -137,6 +169,8 @@ bool Palette::loadMem(const uint8_t* data, uint32_t size)
 			break;
 	}
 
+	clearNearestCache();
+
 	return true;
 }
 
@@ -430,6 +464,8 @@ void Palette::setColour(uint8_t index, const ColRGBA& col)
 	colours_[index].index = index;
 	colours_lab_[index]   = colours_[index].asLAB();
 	colours_hsl_[index]   = colours_[index].asHSL();
+
+	clearNearestCache();
 }
 
 // -----------------------------------------------------------------------------
@@ -440,6 +476,8 @@ void Palette::setColourR(uint8_t index, uint8_t val)
 	colours_[index].r   = val;
 	colours_lab_[index] = colours_[index].asLAB();
 	colours_hsl_[index] = colours_[index].asHSL();
+
+	clearNearestCache();
 }
 
 // -----------------------------------------------------------------------------
@@ -450,6 +488,8 @@ void Palette::setColourG(uint8_t index, uint8_t val)
 	colours_[index].g   = val;
 	colours_lab_[index] = colours_[index].asLAB();
 	colours_hsl_[index] = colours_[index].asHSL();
+
+	clearNearestCache();
 }
 
 // -----------------------------------------------------------------------------
@@ -460,6 +500,8 @@ void Palette::setColourB(uint8_t index, uint8_t val)
 	colours_[index].b   = val;
 	colours_lab_[index] = colours_[index].asLAB();
 	colours_hsl_[index] = colours_[index].asHSL();
+
+	clearNearestCache();
 }
 
 // -----------------------------------------------------------------------------
@@ -495,6 +537,8 @@ void Palette::setGradient(uint8_t startIndex, uint8_t endIndex, const ColRGBA& s
 			a + startIndex);
 		colours_[a + startIndex].set(gradCol);
 	}
+
+	clearNearestCache();
 }
 
 // -----------------------------------------------------------------------------
@@ -573,22 +617,97 @@ double Palette::colourDiff(const ColRGBA& rgb, const ColHSL& hsl, const ColLAB&
 
 // -----------------------------------------------------------------------------
 // Returns the index of the closest colour in the palette to [colour]
+//
+// For the Old and RGB match methods (distances in RGB space) the colour space
+// is split into a cube of 32768 cells, each holding the few palette colours
+// that could possibly be nearest to any colour within it. Only those need to be
+// checked, giving exactly the same result as searching the whole palette.
+// The other methods don't map onto RGB space this way, so their results are
+// remembered in a fixed-size direct-mapped table instead.
+//
+// Either way the memory used is bounded, and lookups from multiple threads are
+// safe as long as the palette isn't modified at the same time
 // -----------------------------------------------------------------------------
 short Palette::nearestColour(const ColRGBA& colour, ColourMatch match)
 {
-	double min_d = 999999;
-	short  index = 0;
-	ColHSL chsl  = colour.asHSL();
-	ColLAB clab  = colour.asLAB();
-
 	// Be nice if there was an easier way to convert from int -> enum class,
 	// but then that's kind of the point of them I guess
 	static vector<ColourMatch> cm_convert = {
 		ColourMatch::Default, ColourMatch::Old, ColourMatch::RGB, ColourMatch::HSL,
 		ColourMatch::C76,     ColourMatch::C94, ColourMatch::C2K, ColourMatch::Stop,
 	};
-	if (match == ColourMatch::Default)
+	if (match == ColourMatch::Default && col_match >= 0 && col_match < static_cast<int>(cm_convert.size()))
 		match = cm_convert[col_match];
+	if (match == ColourMatch::Default || match == ColourMatch::Stop)
+		match = ColourMatch::Old;
+
+	auto cache = nearestCache(match);
+
+	if (match == ColourMatch::Old || match == ColourMatch::RGB)
+	{
+		// Get the candidates for the cell containing the colour, working them
+		// out if this is the first lookup within it
+		unsigned cell  = ((colour.r >> 3) << 10) | ((colour.g >> 3) << 5) | (colour.b >> 3);
+		auto     count = cache->cell_count[cell].load(std::memory_order_acquire);
+		if (count == 0)
+			count = buildNearestCell(*cache, cell, match);
+		if (count == NEAREST_CELL_FULL_SCAN)
+			return findNearestColour(colour, match);
+
+		uint64_t candidates[2] = { cache->cell_candidates[cell * 2].load(std::memory_order_relaxed),
+								   cache->cell_candidates[cell * 2 + 1].load(std::memory_order_relaxed) };
+
+		// Find the closest candidate (these are in palette order, so ties go to
+		// the lowest index as with a full search)
+		ColHSL chsl;
+		ColLAB clab;
+		double min_d = 999999;
+		short  index = 0;
+		for (unsigned a = 0; a < count; a++)
+		{
+			auto   candidate = static_cast<short>((candidates[a >> 3] >> ((a & 7) * 8)) & 0xFF);
+			double delta     = colourDiff(colour, chsl, clab, candidate, match);
+			if (delta < min_d)
+			{
+				min_d = delta;
+				index = candidate;
+			}
+		}
+
+		return index;
+	}
+
+	// Look up the colour in the memo table. The slot and tag come from a
+	// bijective hash of the colour, so a matching tag means the same colour
+	uint32_t hash  = (((colour.r << 16) | (colour.g << 8) | colour.b) * 0x9E3779B1u) & 0xFFFFFF;
+	auto&    slot  = cache->memo[hash >> 8];
+	uint32_t tag   = 0x10000 | ((hash & 0xFF) << 8);
+	auto     entry = slot.load(std::memory_order_relaxed);
+	if ((entry & 0x1FF00) == tag)
+		return static_cast<short>(entry & 0xFF);
+
+	auto index = findNearestColour(colour, match);
+	slot.store(tag | index, std::memory_order_relaxed);
+
+	return index;
+}
+
+// -----------------------------------------------------------------------------
+// Searches all colours in the palette for the closest to [colour], using the
+// colour matching method specified in [match]
+// -----------------------------------------------------------------------------
+short Palette::findNearestColour(const ColRGBA& colour, ColourMatch match)
+{
+	double min_d = 999999;
+	short  index = 0;
+
+	// Only convert the colour to HSL/LAB if the match method needs it
+	ColHSL chsl;
+	ColLAB clab;
+	if (match == ColourMatch::HSL)
+		chsl = colour.asHSL();
+	else if (match == ColourMatch::C76 || match == ColourMatch::C94 || match == ColourMatch::C2K)
+		clab = colour.asLAB();
 
 	double delta;
 	for (short a = 0; a < 256; a++)
@@ -608,6 +727,154 @@ short Palette::nearestColour(const ColRGBA& colour, ColourMatch match)
 	return index;
 }
 
+// -----------------------------------------------------------------------------
+// Returns the nearestColour lookup cache for [match], creating it if it doesn't
+// exist yet or the weights used for the match method have changed since it was
+// created
+// -----------------------------------------------------------------------------
+Palette::NearestCache* Palette::nearestCache(ColourMatch match)
+{
+	float weights[3] = { 0.f, 0.f, 0.f };
+	if (match == ColourMatch::RGB)
+	{
+		weights[0] = col_match_r;
+		weights[1] = col_match_g;
+		weights[2] = col_match_b;
+	}
+	else if (match == ColourMatch::HSL)
+	{
+		weights[0] = col_match_h;
+		weights[1] = col_match_s;
+		weights[2] = col_match_l;
+	}
+	auto valid = [&weights](const NearestCache* cache)
+	{
+		return cache && cache->weights[0] == weights[0] && cache->weights[1] == weights[1]
+			   && cache->weights[2] == weights[2];
+	};
+
+	auto& current = nearest_cache_[static_cast<int>(match)];
+	auto  cache   = current.load(std::memory_order_acquire);
+	if (valid(cache))
+		return cache;
+
+	std::lock_guard<std::mutex> lock(nearest_cache_mutex_);
+	cache = current.load(std::memory_order_acquire);
+	if (valid(cache))
+		return cache;
+
+	// Create a new cache. Any previous one is kept until clearNearestCache is
+	// called, since other threads may still be reading from it
+	auto new_cache = std::make_unique<NearestCache>();
+	for (unsigned a = 0; a < 3; a++)
+		new_cache->weights[a] = weights[a];
+	if (match == ColourMatch::Old || match == ColourMatch::RGB)
+	{
+		new_cache->cell_count      = vector<std::atomic<uint8_t>>(NEAREST_CELLS);
+		new_cache->cell_candidates = vector<std::atomic<uint64_t>>(NEAREST_CELLS * 2);
+	}
+	else
+		new_cache->memo = vector<std::atomic<uint32_t>>(NEAREST_MEMO_SIZE);
+
+	cache = new_cache.get();
+	nearest_caches_.push_back(std::move(new_cache));
+	current.store(cache, std::memory_order_release);
+
+	return cache;
+}
+
+// -----------------------------------------------------------------------------
+// Works out the palette colours that could be nearest to any colour within
+// [cell] of the nearestColour lookup cube in [cache], and returns how many
+// there are (or NEAREST_CELL_FULL_SCAN if there are too many to store)
+// -----------------------------------------------------------------------------
+uint8_t Palette::buildNearestCell(NearestCache& cache, unsigned cell, ColourMatch match)
+{
+	// Get the range of each component within the cell
+	int lo[3] = { static_cast<int>(cell >> 10) << 3,
+				  static_cast<int>((cell >> 5) & 31) << 3,
+				  static_cast<int>(cell & 31) << 3 };
+	int hi[3] = { lo[0] + 7, lo[1] + 7, lo[2] + 7 };
+
+	// Get the smallest and largest possible difference between each palette
+	// colour and any colour within the cell. The colour differences only grow
+	// with the distance along each component, so these are at the cell colours
+	// closest to and furthest from the palette colour
+	ColHSL chsl;
+	ColLAB clab;
+	double min_diff[256];
+	double bound = std::numeric_limits<double>::max();
+	for (int a = 0; a < 256; a++)
+	{
+		int     pc[3] = { colours_[a].r, colours_[a].g, colours_[a].b };
+		uint8_t closest[3], furthest[3];
+		for (unsigned c = 0; c < 3; c++)
+		{
+			closest[c]  = std::clamp(pc[c], lo[c], hi[c]);
+			furthest[c] = pc[c] - lo[c] > hi[c] - pc[c] ? lo[c] : hi[c];
+		}
+
+		min_diff[a] = colourDiff({ closest[0], closest[1], closest[2] }, chsl, clab, a, match);
+		bound       = std::min(bound, colourDiff({ furthest[0], furthest[1], furthest[2] }, chsl, clab, a, match));
+	}
+
+	// Every colour within the cell is at most [bound] from some palette colour,
+	// so only palette colours that can be closer than that are candidates.
+	// Duplicate colours are skipped since only the first of them can be nearest
+	uint8_t  list[NEAREST_MAX_CANDIDATES];
+	unsigned count = 0;
+	for (int a = 0; a < 256; a++)
+	{
+		if (min_diff[a] > bound)
+			continue;
+
+		bool duplicate = false;
+		for (unsigned c = 0; c < count; c++)
+			if (colours_[list[c]].r == colours_[a].r && colours_[list[c]].g == colours_[a].g
+				&& colours_[list[c]].b == colours_[a].b)
+			{
+				duplicate = true;
+				break;
+			}
+		if (duplicate)
+			continue;
+
+		if (count == NEAREST_MAX_CANDIDATES)
+		{
+			count = NEAREST_CELL_FULL_SCAN;
+			break;
+		}
+		list[count++] = a;
+	}
+
+	// Publish the candidates, the count is stored last so other threads only
+	// see it once the candidates are in place
+	if (count != NEAREST_CELL_FULL_SCAN)
+	{
+		uint64_t candidates[2] = { 0, 0 };
+		for (unsigned c = 0; c < count; c++)
+			candidates[c >> 3] |= static_cast<uint64_t>(list[c]) << ((c & 7) * 8);
+		cache.cell_candidates[cell * 2].store(candidates[0], std::memory_order_relaxed);
+		cache.cell_candidates[cell * 2 + 1].store(candidates[1], std::memory_order_relaxed);
+	}
+	cache.cell_count[cell].store(count, std::memory_order_release);
+
+	return count;
+}
+
+// -----------------------------------------------------------------------------
+// Clears all cached nearestColour results, must be called whenever any colour
+// in the palette is changed (and so never while nearestColour is in use on
+// another thread)
+// -----------------------------------------------------------------------------
+void Palette::clearNearestCache()
+{
+	std::lock_guard<std::mutex> lock(nearest_cache_mutex_);
+	for (auto& cache : nearest_cache_)
+		cache.store(nullptr, std::memory_order_relaxed);
+	nearest_caches_.clear();
+}
+
 // -----------------------------------------------------------------------------
 // Returns the number of unique colors in a palette
 // -----------------------------------------------------------------------------
@@ -776,6 +1043,8 @@ void Palette::saturate(float amount, int start, int end)
 		colours_[i]     = colours_hsl_[i].asRGB();
 		colours_lab_[i] = colours_[i].asLAB();
 	}
+
+	clearNearestCache();
 }
 
 // -----------------------------------------------------------------------------
@@ -804,6 +1073,8 @@ void Palette::illuminate(float amount, int start, int end)
 		colours_[i]     = colours_hsl_[i].asRGB();
 		colours_lab_[i] = colours_[i].asLAB();
 	}
+
+	clearNearestCache();
 }
 
 // -----------------------------------------------------------------------------
@@ -832,6 +1103,8 @@ void Palette::shift(float amount, int start, int end)
 		colours_[i]     = colours_hsl_[i].asRGB();
 		colours_lab_[i] = colours_[i].asLAB();
 	}
+
+	clearNearestCache();
 }
 
 // -----------------------------------------------------------------------------
@@ -1,5 +1,7 @@
 #pragma once
 #include "Utility/Colour.h"
+#include <atomic>
+#include <mutex>
 
 namespace slade
 {
@@ -32,6 +34,8 @@ public:
 	Palette(const Palette& pal) : Palette(pal.colours_.size()) { copyPalette(&pal); }
 	~Palette() = default;
 
+	Palette& operator=(const Palette& pal);
+
 	const vector<ColRGBA>& colours() const { return colours_; }
 	ColRGBA                colour(uint8_t index) const { return colours_[index]; }
 	short                  transIndex() const { return index_trans_; }
@@ -74,6 +78,25 @@ private:
 	vector<ColLAB>  colours_lab_;
 	short           index_trans_;
 
-	double colourDiff(const ColRGBA& rgb, const ColHSL& hsl, const ColLAB& lab, int index, ColourMatch match);
+	// Lookup structures used to speed up nearestColour for a single ColourMatch
+	// mode. Once published a cache is only ever read or updated atomically, so
+	// nearestColour can be called from multiple threads at once (but not while
+	// the palette itself is being modified). See Palette.cpp for details
+	struct NearestCache
+	{
+		float                         weights[3] = { 0.f, 0.f, 0.f };
+		vector<std::atomic<uint8_t>>  cell_count;
+		vector<std::atomic<uint64_t>> cell_candidates;
+		vector<std::atomic<uint32_t>> memo;
+	};
+	std::atomic<NearestCache*>       nearest_cache_[static_cast<int>(ColourMatch::Stop)] = {};
+	vector<unique_ptr<NearestCache>> nearest_caches_;
+	std::mutex                       nearest_cache_mutex_;
+
+	double        colourDiff(const ColRGBA& rgb, const ColHSL& hsl, const ColLAB& lab, int index, ColourMatch match);
+	short         findNearestColour(const ColRGBA& colour, ColourMatch match);
+	NearestCache* nearestCache(ColourMatch match);
+	uint8_t       buildNearestCell(NearestCache& cache, unsigned cell, ColourMatch match);
+	void          clearNearestCache();
 };
 } // namespace slade
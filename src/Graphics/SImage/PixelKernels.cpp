@@ -0,0 +1,512 @@
+// -----------------------------------------------------------------------------
+// SLADE - It's a Doom Editor
+// Copyright(C) 2008 - 2020 Simon Judd
+//
+// Email:       sirjuddington@gmail.com
+// Web:         https://slade.mancubus.net
+// Filename:    PixelKernels.cpp
+// Description: Row-level pixel processing functions (palette expansion,
+//              blending, mirroring, rotation etc.) used by SImage, with SSE2
+//              implementations where supported
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation; either version 2 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+//
+// Includes
+//
+// -----------------------------------------------------------------------------
+#include "Main.h"
+#include "PixelKernels.h"
+#include "General/Console.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PIXEL_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace slade;
+using BlendType = SImage::BlendType;
+
+
+// -----------------------------------------------------------------------------
+//
+// Functions
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// -----------------------------------------------------------------------------
+// Returns the alpha value to draw a source pixel with [src_a] alpha, using the
+// draw properties [alpha] and [src_alpha] (see SImage::drawPixel). Fully
+// transparent source pixels are never drawn, so 0 is always returned for them
+// -----------------------------------------------------------------------------
+inline uint8_t drawAlpha(uint8_t src_a, float alpha, bool src_alpha)
+{
+	if (src_a == 0)
+		return 0;
+
+	return src_alpha ? static_cast<uint8_t>(src_a * alpha) : static_cast<uint8_t>(255 * alpha);
+}
+
+// -----------------------------------------------------------------------------
+// Returns [x] / 255, rounded to the nearest integer. [x] must be within
+// 0-65025 (ie. the product of two 8-bit values)
+// -----------------------------------------------------------------------------
+inline int div255(int x)
+{
+	x += 128;
+	return (x + (x >> 8)) >> 8;
+}
+
+// -----------------------------------------------------------------------------
+// Blends [count] RGBA pixels from [src] onto [dest] with the blend type
+// [blend], one pixel at a time. All calculations are done with integers, so
+// the results are identical to the SSE2 implementation
+// -----------------------------------------------------------------------------
+template<BlendType blend>
+void blendRowScalar(uint8_t* dest, const uint8_t* src, unsigned count, float alpha, bool src_alpha)
+{
+	for (unsigned i = 0; i < count; ++i, src += 4, dest += 4)
+	{
+		// Skip if fully transparent
+		int a = drawAlpha(src[3], alpha, src_alpha);
+		if (a == 0)
+			continue;
+
+		// Simple case (normal blending, no transparency involved)
+		if (blend == BlendType::Normal && a == 255)
+		{
+			memcpy(dest, src, 3);
+			dest[3] = 255;
+			continue;
+		}
+
+		for (unsigned c = 0; c < 3; ++c)
+		{
+			int s = src[c];
+			int d = dest[c];
+			int v;
+			switch (blend)
+			{
+			case BlendType::Add: v = std::min<int>(d + div255(s * a), 255); break;
+			case BlendType::Subtract: v = std::max<int>(d - div255(s * a), 0); break;
+			case BlendType::ReverseSubtract: v = std::max<int>(div255(s * a) - d, 0); break;
+			case BlendType::Modulate: v = div255(s * d); break;
+			default: v = div255(d * (255 - a) + s * a); break;
+			}
+			dest[c] = static_cast<uint8_t>(v);
+		}
+		dest[3] = std::min(dest[3] + a, 255);
+	}
+}
+
+#ifdef PIXEL_KERNELS_SSE2
+// -----------------------------------------------------------------------------
+// Returns each 16-bit value in [x] divided by 255, rounded to the nearest
+// integer (same as div255 above)
+// -----------------------------------------------------------------------------
+inline __m128i div255(__m128i x)
+{
+	x = _mm_add_epi16(x, _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+// -----------------------------------------------------------------------------
+// Blends the source [s] and destination [d] channel values (as 16-bit lanes)
+// with the blend type [blend], using the draw alpha values in [a]. The results
+// may be above 255 (Add only), and are saturated when packed back to 8 bits
+// -----------------------------------------------------------------------------
+template<BlendType blend> inline __m128i blendLanes(__m128i s, __m128i d, __m128i a)
+{
+	switch (blend)
+	{
+	case BlendType::Add: return _mm_add_epi16(d, div255(_mm_mullo_epi16(s, a)));
+	case BlendType::Subtract: return _mm_subs_epu16(d, div255(_mm_mullo_epi16(s, a)));
+	case BlendType::ReverseSubtract: return _mm_subs_epu16(div255(_mm_mullo_epi16(s, a)), d);
+	case BlendType::Modulate: return div255(_mm_mullo_epi16(s, d));
+	default:
+		return div255(
+			_mm_add_epi16(_mm_mullo_epi16(d, _mm_sub_epi16(_mm_set1_epi16(255), a)), _mm_mullo_epi16(s, a)));
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Blends [count] RGBA pixels from [src] onto [dest] with the blend type
+// [blend], 4 pixels at a time in 16-bit integer lanes. Any remaining pixels
+// are blended with blendRowScalar
+// -----------------------------------------------------------------------------
+template<BlendType blend>
+void blendRowSSE2(uint8_t* dest, const uint8_t* src, unsigned count, float alpha, bool src_alpha)
+{
+	const auto zero       = _mm_setzero_si128();
+	const auto alpha_mask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+
+	unsigned i = 0;
+	for (; i + 4 <= count; i += 4, src += 16, dest += 16)
+	{
+		// Get the draw alpha of each pixel, skipping if all are fully transparent
+		uint32_t alphas = 0;
+		for (unsigned p = 0; p < 4; ++p)
+			alphas |= static_cast<uint32_t>(drawAlpha(src[p * 4 + 3], alpha, src_alpha)) << (p * 8);
+		if (alphas == 0)
+			continue;
+
+		// Repeat each pixel's draw alpha for all its channels
+		auto a = _mm_cvtsi32_si128(static_cast<int>(alphas));
+		a      = _mm_unpacklo_epi8(a, a);
+		a      = _mm_unpacklo_epi16(a, a);
+
+		// Blend (2 pixels per 16-bit vector)
+		auto s  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+		auto d  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dest));
+		auto lo = blendLanes<blend>(
+			_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(a, zero));
+		auto hi = blendLanes<blend>(
+			_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(a, zero));
+		auto result = _mm_packus_epi16(lo, hi);
+
+		// Alpha is the destination alpha plus the draw alpha
+		result = _mm_or_si128(_mm_andnot_si128(alpha_mask, result), _mm_and_si128(alpha_mask, _mm_adds_epu8(d, a)));
+
+		// Leave fully transparent pixels as they were
+		auto skip = _mm_cmpeq_epi8(a, zero);
+		result    = _mm_or_si128(_mm_and_si128(skip, d), _mm_andnot_si128(skip, result));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), result);
+	}
+
+	blendRowScalar<blend>(dest, src, count - i, alpha, src_alpha);
+}
+#endif
+
+// -----------------------------------------------------------------------------
+// Blends [count] RGBA pixels from [src] onto [dest] with the blend type
+// [blend], using SSE2 if available
+// -----------------------------------------------------------------------------
+template<BlendType blend> void blendRowImpl(uint8_t* dest, const uint8_t* src, unsigned count, float alpha, bool src_alpha)
+{
+#ifdef PIXEL_KERNELS_SSE2
+	blendRowSSE2<blend>(dest, src, count, alpha, src_alpha);
+#else
+	blendRowScalar<blend>(dest, src, count, alpha, src_alpha);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Writes the [count] pixels of size T from [src] to [dest] in reverse order
+// -----------------------------------------------------------------------------
+template<typename T> void reverseRowScalar(const uint8_t* src, uint8_t* dest, unsigned count)
+{
+	for (unsigned i = 0; i < count; ++i)
+		memcpy(dest + i * sizeof(T), src + (count - 1 - i) * sizeof(T), sizeof(T));
+}
+
+// -----------------------------------------------------------------------------
+// Rotates [src] ([width]x[height] pixels of size T) into [dest] by [angle]
+// degrees anticlockwise (90 or 270)
+// -----------------------------------------------------------------------------
+template<typename T> void rotateImpl(const uint8_t* src, uint8_t* dest, int width, int height, int angle)
+{
+	const auto px = sizeof(T);
+
+	// Rows in the source become columns in the destination, so each row is
+	// written with a fixed step through the destination
+	int new_width = height;
+	for (int y = 0; y < height; ++y)
+	{
+		auto row = src + y * width * px;
+		if (angle == 90)
+		{
+			// First pixel goes to the bottom of column [y]
+			auto out = dest + ((width - 1) * new_width + y) * px;
+			for (int x = 0; x < width; ++x, out -= new_width * px)
+				memcpy(out, row + x * px, px);
+		}
+		else
+		{
+			// First pixel goes to the top of column [height - 1 - y]
+			auto out = dest + (new_width - 1 - y) * px;
+			for (int x = 0; x < width; ++x, out += new_width * px)
+				memcpy(out, row + x * px, px);
+		}
+	}
+}
+} // namespace
+
+
+// -----------------------------------------------------------------------------
+//
+// Pixel Namespace Functions
+//
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+// Writes the colours of [pal] as 256 RGBA values to [table] (which must be at
+// least 1024 bytes). If [opaque] is true, all alpha values are set to 255
+// -----------------------------------------------------------------------------
+void pixel::paletteTable(const Palette& pal, uint8_t* table, bool opaque)
+{
+	const auto& colours = pal.colours();
+	for (unsigned a = 0; a < 256; ++a)
+	{
+		auto col = a < colours.size() ? colours[a] : ColRGBA{ 0, 0, 0, 255 };
+		if (opaque)
+			col.a = 255;
+		col.write(table + a * 4);
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Expands [count] palette indices in [src] to RGBA pixels in [dest], using the
+// colours in [table] (see paletteTable). If [mask] is given, it is used for the
+// alpha values of the pixels, otherwise the palette alpha values are used
+// -----------------------------------------------------------------------------
+void pixel::expandPaletted(const uint8_t* src, const uint8_t* mask, const uint8_t* table, uint8_t* dest, unsigned count)
+{
+	if (mask)
+	{
+		for (unsigned a = 0; a < count; ++a, dest += 4)
+		{
+			memcpy(dest, table + src[a] * 4, 3);
+			dest[3] = mask[a];
+		}
+	}
+	else
+	{
+		for (unsigned a = 0; a < count; ++a, dest += 4)
+			memcpy(dest, table + src[a] * 4, 4);
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Expands [count] alpha map values in [src] to greyscale RGBA pixels (with
+// alpha also set to the value) in [dest]
+// -----------------------------------------------------------------------------
+void pixel::expandAlphaMap(const uint8_t* src, uint8_t* dest, unsigned count)
+{
+	unsigned a = 0;
+#ifdef PIXEL_KERNELS_SSE2
+	// 16 pixels at a time
+	for (; a + 16 <= count; a += 16, dest += 64)
+	{
+		auto v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + a));
+		auto lo = _mm_unpacklo_epi8(v, v);
+		auto hi = _mm_unpackhi_epi8(v, v);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_unpacklo_epi16(lo, lo));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 16), _mm_unpackhi_epi16(lo, lo));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 32), _mm_unpacklo_epi16(hi, hi));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 48), _mm_unpackhi_epi16(hi, hi));
+	}
+#endif
+	for (; a < count; ++a, dest += 4)
+		memset(dest, src[a], 4);
+}
+
+// -----------------------------------------------------------------------------
+// Draws [count] RGBA pixels from [src] on to [dest] (also RGBA), blending them
+// according to [props]. The result for each pixel is identical to
+// SImage::drawPixel on an RGBA image
+// -----------------------------------------------------------------------------
+void pixel::blendRow(uint8_t* dest, const uint8_t* src, unsigned count, const SImage::DrawProps& props)
+{
+	switch (props.blend)
+	{
+	case BlendType::Add: blendRowImpl<BlendType::Add>(dest, src, count, props.alpha, props.src_alpha); break;
+	case BlendType::Subtract: blendRowImpl<BlendType::Subtract>(dest, src, count, props.alpha, props.src_alpha); break;
+	case BlendType::ReverseSubtract:
+		blendRowImpl<BlendType::ReverseSubtract>(dest, src, count, props.alpha, props.src_alpha);
+		break;
+	case BlendType::Modulate: blendRowImpl<BlendType::Modulate>(dest, src, count, props.alpha, props.src_alpha); break;
+	default: blendRowImpl<BlendType::Normal>(dest, src, count, props.alpha, props.src_alpha); break;
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Writes the [count] pixels ([bpp] bytes each) in [src] to [dest] in reverse
+// order. [src] and [dest] must not overlap
+// -----------------------------------------------------------------------------
+void pixel::reverseRow(const uint8_t* src, uint8_t* dest, unsigned count, unsigned bpp)
+{
+	if (bpp == 4)
+	{
+		unsigned a = 0;
+#ifdef PIXEL_KERNELS_SSE2
+		// 4 pixels at a time
+		for (; a + 4 <= count; a += 4)
+		{
+			auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (count - a - 4) * 4));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + a * 4), _mm_shuffle_epi32(v, 0x1B));
+		}
+#endif
+		reverseRowScalar<uint32_t>(src, dest + a * 4, count - a);
+	}
+	else if (bpp == 1)
+	{
+		unsigned a = 0;
+#ifdef PIXEL_KERNELS_SSE2
+		// 16 pixels at a time
+		for (; a + 16 <= count; a += 16)
+		{
+			auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (count - a - 16)));
+			v      = _mm_shuffle_epi32(v, 0x4E);
+			v      = _mm_shufflelo_epi16(v, 0x1B);
+			v      = _mm_shufflehi_epi16(v, 0x1B);
+			v      = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + a), v);
+		}
+#endif
+		reverseRowScalar<uint8_t>(src, dest + a, count - a);
+	}
+	else
+	{
+		for (unsigned a = 0; a < count; ++a)
+			memcpy(dest + a * bpp, src + (count - 1 - a) * bpp, bpp);
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Rotates the [width]x[height] image [src] into [dest] by [angle] degrees
+// anticlockwise. [angle] must be 90, 180 or 270, and [bpp] must be 1 or 4
+// -----------------------------------------------------------------------------
+void pixel::rotate(const uint8_t* src, uint8_t* dest, int width, int height, unsigned bpp, int angle)
+{
+	// 180 degrees is a vertical flip with each row reversed
+	if (angle == 180)
+	{
+		auto row_bytes = width * bpp;
+		for (int y = 0; y < height; ++y)
+			reverseRow(src + y * row_bytes, dest + (height - 1 - y) * row_bytes, width, bpp);
+		return;
+	}
+
+	if (bpp == 4)
+		rotateImpl<uint32_t>(src, dest, width, height, angle);
+	else
+		rotateImpl<uint8_t>(src, dest, width, height, angle);
+}
+
+// -----------------------------------------------------------------------------
+// Colourises [count] RGBA pixels in [rgba] to [colour], using [grey_r],
+// [grey_g] and [grey_b] as the weights for greyscale conversion
+// -----------------------------------------------------------------------------
+void pixel::colouriseRow(uint8_t* rgba, unsigned count, const ColRGBA& colour, double grey_r, double grey_g, double grey_b)
+{
+	for (unsigned a = 0; a < count; ++a, rgba += 4)
+	{
+		float grey = (rgba[0] * grey_r + rgba[1] * grey_g + rgba[2] * grey_b) / 255.0f;
+		if (grey > 1.0)
+			grey = 1.0;
+		rgba[0] = colour.r * grey;
+		rgba[1] = colour.g * grey;
+		rgba[2] = colour.b * grey;
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Tints [count] RGBA pixels in [rgba] to [colour] by [amount]
+// -----------------------------------------------------------------------------
+void pixel::tintRow(uint8_t* rgba, unsigned count, const ColRGBA& colour, float amount)
+{
+	float inv_amt = 1.0f - amount;
+	for (unsigned a = 0; a < count; ++a, rgba += 4)
+	{
+		rgba[0] = rgba[0] * inv_amt + colour.r * amount;
+		rgba[1] = rgba[1] * inv_amt + colour.g * amount;
+		rgba[2] = rgba[2] * inv_amt + colour.b * amount;
+	}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+// Console Commands
+//
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+// Checks that the SSE2 and scalar blendRow implementations give identical
+// results for every blend type, draw alpha and source/destination value
+// -----------------------------------------------------------------------------
+CONSOLE_COMMAND(test_pixel_kernels, 0, false)
+{
+#ifdef PIXEL_KERNELS_SSE2
+	// Each row has every source/destination value combination for the red
+	// channel, with the other channels and destination alpha varied as well
+	vector<uint8_t> src(65536 * 4), dest(65536 * 4), dest_sse(65536 * 4), dest_scalar(65536 * 4);
+	for (unsigned a = 0; a < 65536; ++a)
+	{
+		uint8_t s = a >> 8;
+		uint8_t d = a & 0xFF;
+		uint8_t src_px[4]  = { s, d, static_cast<uint8_t>(s ^ d), 0 };
+		uint8_t dest_px[4] = { d, s, static_cast<uint8_t>(s + d), static_cast<uint8_t>(a * 7) };
+		memcpy(src.data() + a * 4, src_px, 4);
+		memcpy(dest.data() + a * 4, dest_px, 4);
+	}
+
+	BlendType blends[] = {
+		BlendType::Normal, BlendType::Add, BlendType::Subtract, BlendType::ReverseSubtract, BlendType::Modulate
+	};
+	unsigned errors = 0;
+	for (auto blend : blends)
+	{
+		for (unsigned src_a = 0; src_a < 256; ++src_a)
+		{
+			for (unsigned a = 0; a < 65536; ++a)
+				src[a * 4 + 3] = (a % 5 == 0) ? 0 : src_a; // Include some fully transparent pixels
+
+			dest_sse    = dest;
+			dest_scalar = dest;
+			switch (blend)
+			{
+			case BlendType::Add:
+				blendRowSSE2<BlendType::Add>(dest_sse.data(), src.data(), 65536, 1.0f, true);
+				blendRowScalar<BlendType::Add>(dest_scalar.data(), src.data(), 65536, 1.0f, true);
+				break;
+			case BlendType::Subtract:
+				blendRowSSE2<BlendType::Subtract>(dest_sse.data(), src.data(), 65536, 1.0f, true);
+				blendRowScalar<BlendType::Subtract>(dest_scalar.data(), src.data(), 65536, 1.0f, true);
+				break;
+			case BlendType::ReverseSubtract:
+				blendRowSSE2<BlendType::ReverseSubtract>(dest_sse.data(), src.data(), 65536, 1.0f, true);
+				blendRowScalar<BlendType::ReverseSubtract>(dest_scalar.data(), src.data(), 65536, 1.0f, true);
+				break;
+			case BlendType::Modulate:
+				blendRowSSE2<BlendType::Modulate>(dest_sse.data(), src.data(), 65536, 1.0f, true);
+				blendRowScalar<BlendType::Modulate>(dest_scalar.data(), src.data(), 65536, 1.0f, true);
+				break;
+			default:
+				blendRowSSE2<BlendType::Normal>(dest_sse.data(), src.data(), 65536, 1.0f, true);
+				blendRowScalar<BlendType::Normal>(dest_scalar.data(), src.data(), 65536, 1.0f, true);
+				break;
+			}
+
+			if (dest_sse != dest_scalar)
+				++errors;
+		}
+	}
+
+	if (errors == 0)
+		log::console("SSE2 and scalar blending results are identical");
+	else
+		log::console(fmt::format("SSE2 and scalar blending results differ in {} of 1280 tests", errors));
+#else
+	log::console("SSE2 is not available, nothing to compare");
+#endif
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "SImage.h"
+
+// Row-level pixel processing functions used by SImage. Each function handles a
+// whole row (or span) of pixels at once, so per-pixel decisions (pixel format,
+// blend type etc.) only need to be made once per row. Where available, SSE2 is
+// used, otherwise a plain scalar implementation is used.
+namespace slade::pixel
+{
+void paletteTable(const Palette& pal, uint8_t* table, bool opaque = false);
+void expandPaletted(const uint8_t* src, const uint8_t* mask, const uint8_t* table, uint8_t* dest, unsigned count);
+void expandAlphaMap(const uint8_t* src, uint8_t* dest, unsigned count);
+void blendRow(uint8_t* dest, const uint8_t* src, unsigned count, const SImage::DrawProps& props);
+void reverseRow(const uint8_t* src, uint8_t* dest, unsigned count, unsigned bpp);
+void rotate(const uint8_t* src, uint8_t* dest, int width, int height, unsigned bpp, int angle);
+void colouriseRow(uint8_t* rgba, unsigned count, const ColRGBA& colour, double grey_r, double grey_g, double grey_b);
+void tintRow(uint8_t* rgba, unsigned count, const ColRGBA& colour, float amount);
+} // namespace slade::pixel
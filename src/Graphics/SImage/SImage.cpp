@@ -34,6 +34,7 @@
 #include "Main.h"
 #include "SImage.h"
 #include "Graphics/Translation.h"
+#include "PixelKernels.h"
 #include "SIFormat.h"
 #include "Utility/MathStuff.h"
 #undef BOOL
@@ -103,39 +104,17 @@ bool SImage::putRGBAData(MemChunk& mc, Palette* pal) const
 		// Get palette to use
 		const auto& palette = (has_palette_ || !pal) ? palette_ : *pal;
 
-		uint8_t rgba[4];
-		for (int a = 0; a < width_ * height_; a++)
-		{
-			// Get colour
-			ColRGBA col = palette.colour(data_[a]);
-
-			// Set alpha
-			if (mask_.data())
-				col.a = mask_[a];
-			else
-				col.a = 255;
-
-			col.write(rgba);   // Write colour to array
-			mc.write(rgba, 4); // Write array to MemChunk
-		}
+		// Expand to RGBA
+		uint8_t table[1024];
+		pixel::paletteTable(palette, table, true);
+		pixel::expandPaletted(data_.data(), mask_.data(), table, mc.data(), width_ * height_);
 
 		return true;
 	}
 
 	// Convert if alpha map
 	else if (type_ == Type::AlphaMap)
-	{
-		uint8_t rgba[4];
-		ColRGBA col;
-		for (int a = 0; a < width_ * height_; a++)
-		{
-			// Get pixel as colour (greyscale)
-			col.set(data_[a], data_[a], data_[a], data_[a]);
-
-			col.write(rgba);   // Write colour to array
-			mc.write(rgba, 4); // Write array to MemChunk
-		}
-	}
+		pixel::expandAlphaMap(data_.data(), mc.data(), width_ * height_);
 
 	return false; // Invalid image type
 }
@@ -438,8 +417,9 @@ void SImage::fillAlpha(uint8_t alpha)
 	if (type_ == Type::RGBA)
 	{
 		// RGBA format, set alpha values to given one
+		auto pixels = data_.data();
 		for (int a = 3; a < width_ * height_ * 4; a += 4)
-			data_[a] = alpha;
+			pixels[a] = alpha;
 	}
 	else if (type_ == Type::PalMask)
 	{
@@ -548,8 +528,9 @@ void SImage::shrinkPalette(Palette* pal)
 	}
 
 	// Remap image to new palette indices
+	auto pixels = data_.data();
 	for (int c = 0; c < width_ * height_; ++c)
-		data_[c] = remap[data_[c]];
+		pixels[c] = remap[pixels[c]];
 
 	pal->copyPalette(&newpal);
 }
@@ -665,9 +646,10 @@ bool SImage::convertPaletted(Palette* pal_target, Palette* pal_current)
 		mask_.reSize(width_ * height_);
 
 		// Get values from alpha channel
-		int c = 0;
+		auto mask = mask_.data();
+		int  c    = 0;
 		for (int a = 3; a < width_ * height_ * 4; a += 4)
-			mask_[c++] = rgba_data[a];
+			mask[c++] = rgba_data[a];
 	}
 
 	// Load given palette
@@ -678,14 +660,15 @@ bool SImage::convertPaletted(Palette* pal_target, Palette* pal_current)
 
 	// Do conversion
 	data_.reSize(width_ * height_);
-	unsigned i = 0;
+	auto     pixels = data_.data();
+	unsigned i      = 0;
 	ColRGBA  col;
 	for (int a = 0; a < width_ * height_; a++)
 	{
-		col.r    = rgba_data[i++];
-		col.g    = rgba_data[i++];
-		col.b    = rgba_data[i++];
-		data_[a] = palette_.nearestColour(col);
+		col.r     = rgba_data[i++];
+		col.g     = rgba_data[i++];
+		col.b     = rgba_data[i++];
+		pixels[a] = palette_.nearestColour(col);
 		i++; // Skip alpha
 	}
 
@@ -714,7 +697,8 @@ bool SImage::convertAlphaMap(AlphaSource alpha_source, Palette* pal)
 	create(width_, height_, Type::AlphaMap);
 
 	// Generate alpha mask
-	unsigned c = 0;
+	auto     pixels = data_.data();
+	unsigned c      = 0;
 	for (int a = 0; a < width_ * height_; a++)
 	{
 		// Determine alpha for this pixel
@@ -725,7 +709,7 @@ bool SImage::convertAlphaMap(AlphaSource alpha_source, Palette* pal)
 			alpha = rgba[c + 3];
 
 		// Set pixel
-		data_[a] = alpha;
+		pixels[a] = alpha;
 
 		// Next RGBA pixel
 		c += 4;
@@ -750,26 +734,28 @@ bool SImage::maskFromColour(ColRGBA colour, Palette* pal)
 			pal = &palette_;
 
 		// Palette+Mask type, go through the mask
+		auto mask = mask_.data();
 		for (int a = 0; a < width_ * height_; a++)
 		{
 			if (pal->colour(data_[a]).equals(colour))
-				mask_[a] = 0;
+				mask[a] = 0;
 			else
-				mask_[a] = 255;
+				mask[a] = 255;
 		}
 	}
 	else if (type_ == Type::RGBA)
 	{
 		// RGBA type, go through alpha channel
-		uint32_t c = 0;
+		auto     pixels = data_.data();
+		uint32_t c      = 0;
 		for (int a = 0; a < width_ * height_; a++)
 		{
-			ColRGBA pix_col(data_[c], data_[c + 1], data_[c + 2], 255);
+			ColRGBA pix_col(pixels[c], pixels[c + 1], pixels[c + 2], 255);
 
 			if (pix_col.equals(colour))
-				data_[c + 3] = 0;
+				pixels[c + 3] = 0;
 			else
-				data_[c + 3] = 255;
+				pixels[c + 3] = 255;
 
 			// Skip to next pixel
 			c += 4;
@@ -797,21 +783,23 @@ bool SImage::maskFromBrightness(Palette* pal)
 			pal = &palette_;
 
 		// Go through pixel data
+		auto mask = mask_.data();
 		for (int a = 0; a < width_ * height_; a++)
 		{
 			// Set mask from pixel colour brightness value
 			ColRGBA col = pal->colour(data_[a]);
-			mask_[a]    = ((double)col.r * 0.3) + ((double)col.g * 0.59) + ((double)col.b * 0.11);
+			mask[a]     = ((double)col.r * 0.3) + ((double)col.g * 0.59) + ((double)col.b * 0.11);
 		}
 	}
 	else if (type_ == Type::RGBA)
 	{
 		// Go through pixel data
-		unsigned c = 0;
+		auto     pixels = data_.data();
+		unsigned c      = 0;
 		for (int a = 0; a < width_ * height_; a++)
 		{
 			// Set alpha from pixel colour brightness value
-			data_[c + 3] = (double)data_[c] * 0.3 + (double)data_[c + 1] * 0.59 + (double)data_[c + 2] * 0.11;
+			pixels[c + 3] = (double)pixels[c] * 0.3 + (double)pixels[c + 1] * 0.59 + (double)pixels[c + 2] * 0.11;
 			// Skip alpha
 			c += 4;
 		}
@@ -834,35 +822,37 @@ bool SImage::cutoffMask(uint8_t threshold)
 	if (type_ == Type::PalMask)
 	{
 		// Paletted, go through mask
+		auto mask = mask_.data();
 		for (int a = 0; a < width_ * height_; a++)
 		{
-			if (mask_[a] > threshold)
-				mask_[a] = 255;
+			if (mask[a] > threshold)
+				mask[a] = 255;
 			else
-				mask_[a] = 0;
+				mask[a] = 0;
 		}
 	}
 	else if (type_ == Type::RGBA)
 	{
 		// RGBA format, go through alpha channel
-		uint32_t c = 0;
+		auto pixels = data_.data();
 		for (int a = 3; a < width_ * height_ * 4; a += 4)
 		{
-			if (data_[a] > threshold)
-				data_[a] = 255;
+			if (pixels[a] > threshold)
+				pixels[a] = 255;
 			else
-				data_[a] = 0;
+				pixels[a] = 0;
 		}
 	}
 	else if (type_ == Type::AlphaMap)
 	{
 		// Alpha map, go through pixels
+		auto pixels = data_.data();
 		for (int a = 0; a < width_ * height_; a++)
 		{
-			if (data_[a] > threshold)
-				data_[a] = 255;
+			if (pixels[a] > threshold)
+				pixels[a] = 255;
 			else
-				data_[a] = 0;
+				pixels[a] = 0;
 		}
 	}
 	else
@@ -896,14 +886,14 @@ bool SImage::setPixel(int x, int y, ColRGBA colour, Palette* pal)
 		// Get color index to use (the ColRGBA's index if defined, nearest colour otherwise)
 		uint8_t index = (colour.index == -1) ? pal->nearestColour(colour) : colour.index;
 
-		data_[y * width_ + x] = index;
+		data_.data()[y * width_ + x] = index;
 		if (mask_.hasData())
-			mask_[y * width_ + x] = colour.a;
+			mask_.data()[y * width_ + x] = colour.a;
 	}
 	else if (type_ == Type::AlphaMap)
 	{
 		// Just use colour alpha
-		data_[y * width_ + x] = colour.a;
+		data_.data()[y * width_ + x] = colour.a;
 	}
 
 	// Announce
@@ -936,16 +926,16 @@ bool SImage::setPixel(int x, int y, uint8_t pal_index, uint8_t alpha)
 	else if (type_ == Type::PalMask)
 	{
 		// Set the pixel
-		data_[y * width_ + x] = pal_index;
+		data_.data()[y * width_ + x] = pal_index;
 		if (mask_.hasData())
-			mask_[y * width_ + x] = alpha;
+			mask_.data()[y * width_ + x] = alpha;
 	}
 
 	// Alpha map
 	else if (type_ == Type::AlphaMap)
 	{
 		// Set the pixel
-		data_[y * width_ + x] = alpha;
+		data_.data()[y * width_ + x] = alpha;
 	}
 
 	// Invalid type
@@ -1005,6 +995,8 @@ bool SImage::rotate(int angle)
 		angle += 360;
 	angle %= 360;
 	angle = 360 - angle;
+	if (angle != 90 && angle != 180 && angle != 270)
+		return false;
 
 	// Compute new dimensions and numbers of pixels and bytes
 	int new_width, new_height;
@@ -1033,30 +1025,10 @@ bool SImage::rotate(int angle)
 	if (mask_.hasData())
 		new_mask.resize(numpixels * numbpp, 0);
 
-	// Remapping loop
-	int i, j, k;
-	for (i = 0; i < numpixels; ++i)
-	{
-		switch (angle)
-		{
-			// Urgh maths...
-		case 90: j = (((new_height - 1) - (i % width_)) * new_width) + (i / width_); break;
-		case 180: j = (numpixels - 1) - i; break;
-		case 270: j = ((i % width_) * new_width) + ((new_width - 1) - (i / width_)); break;
-		default: return false;
-		}
-		if (j >= numpixels)
-		{
-			log::error("Pixel {} remapped to {}, how did this even happen?", i, j);
-			return false;
-		}
-		for (k = 0; k < numbpp; ++k)
-		{
-			new_data[(j * numbpp) + k] = data_[(i * numbpp) + k];
-			if (mask_.hasData())
-				new_mask[(j * numbpp) + k] = mask_[(i * numbpp) + k];
-		}
-	}
+	// Remap pixels
+	pixel::rotate(data_.data(), new_data.data(), width_, height_, numbpp, angle);
+	if (mask_.hasData())
+		pixel::rotate(mask_.data(), new_mask.data(), width_, height_, numbpp, angle);
 
 	// It worked, yay
 	clearData();
@@ -1092,24 +1064,23 @@ bool SImage::mirror(bool vertical)
 	if (mask_.hasData())
 		new_mask.resize(numpixels * numbpp);
 
-	// Remapping loop
-	int i, j, k;
-	for (i = 0; i < numpixels; ++i)
+	// Remap pixels row by row
+	unsigned row_bytes = width_ * numbpp;
+	for (int y = 0; y < height_; ++y)
 	{
+		unsigned src = y * row_bytes;
 		if (vertical)
-			j = (((height_ - 1) - (i / width_)) * width_) + (i % width_);
-		else // horizontal
-			j = ((i / width_) * width_) + ((width_ - 1) - (i % width_));
-		if (j >= numpixels)
 		{
-			log::error("Pixel {} remapped to {}, how did this even happen?", i, j);
-			return false;
+			unsigned dest = (height_ - 1 - y) * row_bytes;
+			memcpy(new_data.data() + dest, data_.data() + src, row_bytes);
+			if (mask_.hasData())
+				memcpy(new_mask.data() + dest, mask_.data() + src, row_bytes);
 		}
-		for (k = 0; k < numbpp; ++k)
+		else // horizontal
 		{
-			new_data[(j * numbpp) + k] = data_[(i * numbpp) + k];
+			pixel::reverseRow(data_.data() + src, new_data.data() + src, width_, numbpp);
 			if (mask_.hasData())
-				new_mask[(j * numbpp) + k] = mask_[(i * numbpp) + k];
+				pixel::reverseRow(mask_.data() + src, new_mask.data() + src, width_, numbpp);
 		}
 	}
 
@@ -1339,7 +1310,7 @@ bool SImage::applyTranslation(Translation* tr, Palette* pal, bool truecolor)
 			newdata[q + 3] = mask_.hasData() ? mask_[p] : col.a;
 		}
 		else
-			data_[p] = col.index;
+			newdata[p] = col.index;
 	}
 
 	if (truecolor && type_ == Type::PalMask)
@@ -1399,82 +1370,38 @@ bool SImage::drawPixel(int x, int y, ColRGBA colour, DrawProps& properties, Pale
 			colour.write(data_.data() + p);
 		else
 		{
-			data_[p] = pal->nearestColour(colour);
-			mask_[p] = colour.a;
+			data_.data()[p] = pal->nearestColour(colour);
+			mask_.data()[p] = colour.a;
 		}
 
 		return true;
 	}
 
-	// Not-so-simple case, do full processing
-	ColRGBA d_colour;
+	// Not-so-simple case, blend with the destination as RGBA. Alpha is already
+	// applied to [colour], so it is drawn as-is
+	DrawProps blend_props;
+	blend_props.blend = properties.blend;
+	uint8_t s_rgba[4] = { colour.r, colour.g, colour.b, colour.a };
+	uint8_t d_rgba[4];
 	if (type_ == Type::PalMask)
-		d_colour = pal->colour(data_[p]);
-	else
-		d_colour.set(data_[p], data_[p + 1], data_[p + 2], data_[p + 3]);
-	float alpha = (float)colour.a / 255.0f;
-
-	// Additive blending
-	if (properties.blend == BlendType::Add)
-	{
-		d_colour.set(
-			math::clamp(d_colour.r + colour.r * alpha, 0, 255),
-			math::clamp(d_colour.g + colour.g * alpha, 0, 255),
-			math::clamp(d_colour.b + colour.b * alpha, 0, 255),
-			math::clamp(d_colour.a + colour.a, 0, 255));
-	}
-
-	// Subtractive blending
-	else if (properties.blend == BlendType::Subtract)
-	{
-		d_colour.set(
-			math::clamp(d_colour.r - colour.r * alpha, 0, 255),
-			math::clamp(d_colour.g - colour.g * alpha, 0, 255),
-			math::clamp(d_colour.b - colour.b * alpha, 0, 255),
-			math::clamp(d_colour.a + colour.a, 0, 255));
-	}
-
-	// Reverse-Subtractive blending
-	else if (properties.blend == BlendType::ReverseSubtract)
-	{
-		d_colour.set(
-			math::clamp((-d_colour.r) + colour.r * alpha, 0, 255),
-			math::clamp((-d_colour.g) + colour.g * alpha, 0, 255),
-			math::clamp((-d_colour.b) + colour.b * alpha, 0, 255),
-			math::clamp(d_colour.a + colour.a, 0, 255));
-	}
-
-	// 'Modulate' blending
-	else if (properties.blend == BlendType::Modulate)
-	{
-		d_colour.set(
-			math::clamp(colour.r * (double)d_colour.r / 255., 0, 255),
-			math::clamp(colour.g * (double)d_colour.g / 255., 0, 255),
-			math::clamp(colour.b * (double)d_colour.b / 255., 0, 255),
-			math::clamp(d_colour.a + colour.a, 0, 255));
-	}
-
-	// Normal blending (or unknown blend type)
+		pal->colour(data_[p]).write(d_rgba);
+	else if (type_ == Type::RGBA)
+		memcpy(d_rgba, data_.data() + p, 4);
 	else
-	{
-		float inv_alpha = 1.0f - alpha;
-		d_colour.set(
-			d_colour.r * inv_alpha + colour.r * alpha,
-			d_colour.g * inv_alpha + colour.g * alpha,
-			d_colour.b * inv_alpha + colour.b * alpha,
-			math::clamp(d_colour.a + colour.a, 0, 255));
-	}
+		memset(d_rgba, data_[p], 4);
+	pixel::blendRow(d_rgba, s_rgba, 1, blend_props);
+	ColRGBA d_colour(d_rgba[0], d_rgba[1], d_rgba[2], d_rgba[3]);
 
 	// Apply new colour
 	if (type_ == Type::PalMask)
 	{
-		data_[p] = pal->nearestColour(d_colour);
-		mask_[p] = d_colour.a;
+		data_.data()[p] = pal->nearestColour(d_colour);
+		mask_.data()[p] = d_colour.a;
 	}
 	else if (type_ == Type::RGBA)
 		d_colour.write(data_.data() + p);
 	else if (type_ == Type::AlphaMap)
-		data_[p] = d_colour.a;
+		data_.data()[p] = d_colour.a;
 
 	return true;
 }
@@ -1496,57 +1423,102 @@ bool SImage::drawImage(SImage& img, int x_pos, int y_pos, DrawProps& properties,
 	if (has_palette_ || !pal_dest)
 		pal_dest = &palette_;
 
-	// Go through pixels
-	unsigned s_stride = img.stride();
-	uint8_t  s_bpp    = img.bpp();
-	unsigned sp       = 0;
-	for (int y = y_pos; y < y_pos + img.height_; y++) // Rows
+	// Determine the area of the source image within this image
+	int x_start = std::max(x_pos, 0);
+	int x_end   = std::min(x_pos + img.width_, width_);
+	int y_start = std::max(y_pos, 0);
+	int y_end   = std::min(y_pos + img.height_, height_);
+	if (x_start >= x_end || y_start >= y_end)
+		return true;
+	unsigned count = x_end - x_start;
+
+	// Setup palette lookup tables
+	uint8_t src_table[1024], dest_table[1024];
+	if (img.type_ == Type::PalMask)
+		pixel::paletteTable(*pal_src, src_table);
+	if (type_ == Type::PalMask)
+		pixel::paletteTable(*pal_dest, dest_table);
+
+	// Nearest palette indices of recently drawn colours when converting blended
+	// pixels back to the destination palette, since the same colours tend to be
+	// repeated many times (0xFFFFFFFF is never a valid colour)
+	uint32_t recent_rgb[256];
+	uint8_t  recent_index[256];
+	if (type_ == Type::PalMask)
+		std::fill_n(recent_rgb, 256, 0xFFFFFFFF);
+
+	// Go through rows
+	vector<uint8_t> src_row(count * 4);
+	vector<uint8_t> dest_row(count * 4);
+	unsigned        s_stride = img.stride();
+	uint8_t         s_bpp    = img.bpp();
+	unsigned        d_stride = stride();
+	uint8_t         d_bpp    = bpp();
+	uint8_t*        d_data   = data_.data();
+	uint8_t*        d_mask   = mask_.data();
+	for (int y = y_start; y < y_end; y++)
 	{
-		// Skip out-of-bounds rows
-		if (y < 0 || y >= height_)
+		// Get source row as RGBA
+		unsigned       sp = (y - y_pos) * s_stride + (x_start - x_pos) * s_bpp;
+		const uint8_t* src;
+		if (img.type_ == Type::RGBA)
+			src = img.data_.data() + sp;
+		else if (img.type_ == Type::PalMask)
 		{
-			sp += s_stride;
-			continue;
+			const uint8_t* mask = img.mask_.hasData() ? img.mask_.data() + sp : nullptr;
+			pixel::expandPaletted(img.data_.data() + sp, mask, src_table, src_row.data(), count);
+			src = src_row.data();
+		}
+		else if (img.type_ == Type::AlphaMap)
+		{
+			pixel::expandAlphaMap(img.data_.data() + sp, src_row.data(), count);
+			src = src_row.data();
 		}
+		else
+			return true;
 
-		for (int x = x_pos; x < x_pos + img.width_; x++) // Columns
+		// Draw row
+		unsigned dp = y * d_stride + x_start * d_bpp;
+		if (type_ == Type::RGBA)
+			pixel::blendRow(d_data + dp, src, count, properties);
+		else if (type_ == Type::PalMask)
 		{
-			// Skip out-of-bounds columns
-			if (x < 0 || x >= width_)
-			{
-				sp += s_bpp;
-				continue;
-			}
+			// Blend with the destination as RGBA
+			pixel::expandPaletted(d_data + dp, nullptr, dest_table, dest_row.data(), count);
+			pixel::blendRow(dest_row.data(), src, count, properties);
 
-			// Skip if source pixel is fully transparent
-			if ((img.type_ == Type::PalMask && img.mask_[sp] == 0)
-				|| (img.type_ == Type::AlphaMap && img.data_[sp] == 0)
-				|| (img.type_ == Type::RGBA && img.data_[sp + 3] == 0))
+			// Convert drawn pixels back to the palette
+			for (unsigned a = 0; a < count; ++a)
 			{
-				sp += s_bpp;
-				continue;
+				uint8_t s_alpha = src[a * 4 + 3];
+				if (properties.src_alpha)
+					s_alpha = s_alpha == 0 ? 0 : static_cast<uint8_t>(s_alpha * properties.alpha);
+				else if (s_alpha != 0)
+					s_alpha = static_cast<uint8_t>(255 * properties.alpha);
+				if (s_alpha == 0)
+					continue;
+
+				auto     d    = dest_row.data() + a * 4;
+				uint32_t rgb  = (d[0] << 16) | (d[1] << 8) | d[2];
+				auto     slot = (rgb * 0x9E3779B1u) >> 24;
+				if (recent_rgb[slot] != rgb)
+				{
+					recent_rgb[slot]   = rgb;
+					recent_index[slot] = pal_dest->nearestColour(ColRGBA(d[0], d[1], d[2], d[3]));
+				}
+				d_data[dp + a] = recent_index[slot];
+				d_mask[dp + a] = d[3];
 			}
-
-			// Draw pixel
-			if (img.type_ == Type::PalMask)
+		}
+		else
+		{
+			// Alpha maps can't be blended a row at a time
+			for (unsigned a = 0; a < count; ++a)
 			{
-				ColRGBA col = pal_src->colour(img.data_[sp]);
-				col.a       = img.mask_[sp];
-				drawPixel(x, y, col, properties, pal_dest);
+				auto c = src + a * 4;
+				if (c[3] > 0)
+					drawPixel(x_start + a, y, ColRGBA(c[0], c[1], c[2], c[3]), properties, pal_dest);
 			}
-			else if (img.type_ == Type::RGBA)
-				drawPixel(
-					x,
-					y,
-					ColRGBA(img.data_[sp], img.data_[sp + 1], img.data_[sp + 2], img.data_[sp + 3]),
-					properties,
-					pal_dest);
-			else if (img.type_ == Type::AlphaMap)
-				drawPixel(
-					x, y, ColRGBA(img.data_[sp], img.data_[sp], img.data_[sp], img.data_[sp]), properties, pal_dest);
-
-			// Go to next source pixel
-			sp += s_bpp;
 		}
 	}
 
@@ -1568,39 +1540,40 @@ bool SImage::colourise(ColRGBA colour, Palette* pal, int start, int stop)
 	if (has_palette_ || !pal)
 		pal = &palette_;
 
-	// Go through all pixels
-	uint8_t bpp = this->bpp();
-	ColRGBA col;
-	for (int a = 0; a < width_ * height_ * bpp; a += bpp)
+	// Colourise RGBA rows directly
+	if (type_ == Type::RGBA)
+	{
+		for (int y = 0; y < height_; ++y)
+			pixel::colouriseRow(
+				data_.data() + y * stride(), width_, colour, col_greyscale_r, col_greyscale_g, col_greyscale_b);
+
+		return true;
+	}
+
+	// For paletted images, the result only depends on the pixel's palette
+	// index, so work out the new index for each palette colour first
+	bool    check_range = start >= 0 && stop >= start && stop < 256;
+	uint8_t remap[256];
+	uint8_t rgba[4];
+	for (int a = 0; a < 256; a++)
 	{
 		// Skip colors out of range if desired
-		if (type_ == Type::PalMask && start >= 0 && stop >= start && stop < 256)
+		if (check_range && (a < start || a > stop))
 		{
-			if (data_[a] < start || data_[a] > stop)
-				continue;
+			remap[a] = a;
+			continue;
 		}
 
-		// Get current pixel colour
-		if (type_ == Type::RGBA)
-			col.set(data_[a], data_[a + 1], data_[a + 2], data_[a + 3]);
-		else
-			col.set(pal->colour(data_[a]));
-
-		// Colourise it
-		float grey = (col.r * col_greyscale_r + col.g * col_greyscale_g + col.b * col_greyscale_b) / 255.0f;
-		if (grey > 1.0)
-			grey = 1.0;
-		col.r = colour.r * grey;
-		col.g = colour.g * grey;
-		col.b = colour.b * grey;
-
-		// Set pixel colour
-		if (type_ == Type::RGBA)
-			col.write(data_.data() + a);
-		else
-			data_[a] = pal->nearestColour(col);
+		pal->colour(a).write(rgba);
+		pixel::colouriseRow(rgba, 1, colour, col_greyscale_r, col_greyscale_g, col_greyscale_b);
+		remap[a] = pal->nearestColour(ColRGBA(rgba[0], rgba[1], rgba[2], rgba[3]));
 	}
 
+	// Remap pixels
+	auto pixels = data_.data();
+	for (int a = 0; a < width_ * height_; a++)
+		pixels[a] = remap[pixels[a]];
+
 	return true;
 }
 
@@ -1619,39 +1592,39 @@ bool SImage::tint(ColRGBA colour, float amount, Palette* pal, int start, int sto
 	if (has_palette_ || !pal)
 		pal = &palette_;
 
-	// Go through all pixels
-	uint8_t bpp = this->bpp();
-	ColRGBA col;
-	for (int a = 0; a < width_ * height_ * bpp; a += bpp)
+	// Tint RGBA rows directly
+	if (type_ == Type::RGBA)
+	{
+		for (int y = 0; y < height_; ++y)
+			pixel::tintRow(data_.data() + y * stride(), width_, colour, amount);
+
+		return true;
+	}
+
+	// For paletted images, the result only depends on the pixel's palette
+	// index, so work out the new index for each palette colour first
+	bool    check_range = start >= 0 && stop >= start && stop < 256;
+	uint8_t remap[256];
+	uint8_t rgba[4];
+	for (int a = 0; a < 256; a++)
 	{
 		// Skip colors out of range if desired
-		if (type_ == Type::PalMask && start >= 0 && stop >= start && stop < 256)
+		if (check_range && (a < start || a > stop))
 		{
-			if (data_[a] < start || data_[a] > stop)
-				continue;
+			remap[a] = a;
+			continue;
 		}
 
-		// Get current pixel colour
-		if (type_ == Type::RGBA)
-			col.set(data_[a], data_[a + 1], data_[a + 2], data_[a + 3]);
-		else
-			col.set(pal->colour(data_[a]));
-
-		// Tint it
-		float inv_amt = 1.0f - amount;
-		col.set(
-			col.r * inv_amt + colour.r * amount,
-			col.g * inv_amt + colour.g * amount,
-			col.b * inv_amt + colour.b * amount,
-			col.a);
-
-		// Set pixel colour
-		if (type_ == Type::RGBA)
-			col.write(data_.data() + a);
-		else
-			data_[a] = pal->nearestColour(col);
+		pal->colour(a).write(rgba);
+		pixel::tintRow(rgba, 1, colour, amount);
+		remap[a] = pal->nearestColour(ColRGBA(rgba[0], rgba[1], rgba[2], rgba[3]));
 	}
 
+	// Remap pixels
+	auto pixels = data_.data();
+	for (int a = 0; a < width_ * height_; a++)
+		pixels[a] = remap[pixels[a]];
+
 	return true;
 }
 
@@ -97,14 +97,16 @@ bool SImage::loadFont0(const uint8_t* gfx_data, int size)
 	mask_.fillData(0xFF);
 
 	// Data is in column-major format, convert to row-major
-	size_t p = 0;
+	auto   img_data = data_.data();
+	auto   img_mask = mask_.data();
+	size_t p        = 0;
 	for (size_t i = 0; i < datasize; ++i)
 	{
-		data_[p] = r[i];
+		img_data[p] = r[i];
 
 		// Index 0 is transparent
-		if (data_[p] == 0)
-			mask_[p] = 0;
+		if (img_data[p] == 0)
+			img_mask[p] = 0;
 
 		// Move to next column
 		p += width_;
@@ -194,9 +196,10 @@ bool SImage::loadFont1(const uint8_t* gfx_data, int size)
 	}
 	delete[] tempdata;
 	// Add transparency to mask
+	auto img_mask = mask_.data();
 	for (size_t i = 0; i < (unsigned)(width_ * height_); ++i)
 		if (data_[i] == 0)
-			mask_[i] = 0x00;
+			img_mask[i] = 0x00;
 
 	// Announce change and return success
 	signals_.image_changed();
@@ -371,9 +374,10 @@ bool SImage::loadFont2(const uint8_t* gfx_data, int size)
 	// Now transparency for the mask
 	mask_.reSize(width_ * height_);
 	mask_.fillData(0xFF);
+	auto img_mask = mask_.data();
 	for (size_t i = 0; i < (unsigned)(width_ * height_); ++i)
 		if (data_[i] == 0)
-			mask_[i] = 0;
+			img_mask[i] = 0;
 
 	// Announce change and return success
 	signals_.image_changed();
@@ -542,6 +546,8 @@ bool SImage::loadBMF(const uint8_t* gfx_data, int size)
 	mask_.reSize(pixels);
 	data_.fillData(0x00);
 	mask_.fillData(0x00);
+	auto img_data = data_.data();
+	auto img_mask = mask_.data();
 
 	// Start processing each character, painting it on the empty canvas
 	int startx = (mf.chars[0].offsy < 0 ? 0 : mf.chars[0].offsy);
@@ -563,8 +569,8 @@ bool SImage::loadBMF(const uint8_t* gfx_data, int size)
 					if ((mc->cdata + pixela < eod) && (mc->cdata + pixela < mf.chars[i + 1].cdata - 6)
 						&& mc->cdata[pixela] && pixelb < pixels)
 					{
-						data_[pixelb] = mc->cdata[pixela];
-						mask_[pixelb] = 0xFF;
+						img_data[pixelb] = mc->cdata[pixela];
+						img_mask[pixelb] = 0xFF;
 					}
 				}
 			}
@@ -612,10 +618,11 @@ bool SImage::loadFontM(const uint8_t* gfx_data, int size)
 	imgindex_  = 0;
 
 	// Each pixel is described as a single bit, either on or off
+	auto img_mask = mask_.data();
 	for (size_t i = 0; i < (unsigned)size; ++i)
 	{
 		for (size_t p = 0; p < 8; ++p)
-			mask_[(i * 8) + p] = ((gfx_data[i] >> (7 - p)) & 1) * 255;
+			img_mask[(i * 8) + p] = ((gfx_data[i] >> (7 - p)) & 1) * 255;
 	}
 	// Announce change and return success
 	signals_.image_changed();
@@ -667,6 +674,8 @@ bool SImage::loadWolfFont(const uint8_t* gfx_data, int size)
 	mask_.reSize(datasize);
 	mask_.fillData(0xFF);
 	data_.fillData(*r);
+	auto img_data = data_.data();
+	auto img_mask = mask_.data();
 
 	size_t p = 0; // Previous width
 	size_t w = 0; // This character's width
@@ -683,10 +692,10 @@ bool SImage::loadWolfFont(const uint8_t* gfx_data, int size)
 			// Compute source and destination offsets
 			size_t s = o + i;
 			size_t d = ((i / w) * width_) + (i % w) + p;
-			data_[d] = gfx_data[s];
+			img_data[d] = gfx_data[s];
 			// Index 0 is transparent
-			if (data_[d] == 0)
-				mask_[d] = 0;
+			if (img_data[d] == 0)
+				img_mask[d] = 0;
 		}
 	}
 	// Announce change and return success
@@ -759,9 +768,10 @@ bool SImage::loadJediFNT(const uint8_t* gfx_data, int size)
 	}
 
 	// Make index 0 transparent
+	auto img_mask = mask_.data();
 	for (int i = 0; i < width_ * height_; ++i)
 		if (data_[i] == 0)
-			mask_[i] = 0;
+			img_mask[i] = 0;
 
 	// Convert from column-major to row-major
 	rotate(90);
@@ -814,16 +824,17 @@ bool SImage::loadJediFONT(const uint8_t* gfx_data, int size)
 	int bpc = width_ / 8;
 
 	// Each pixel is described as a single bit, either on or off
+	auto img_mask = mask_.data();
 	for (int i = 0; i < height_; ++i)
 	{
 		for (int p = 0; p < width_; ++p)
 		{
 			switch (bpc)
 			{
-			case 1: mask_[(i * width_) + p] = ((gfx_data[o + i] >> (7 - p)) & 1) * 255; break;
-			case 2: mask_[(i * width_) + p] = ((memory::readB16(gfx_data, o + (i * 2)) >> (15 - p)) & 1) * 255; break;
-			case 3: mask_[(i * width_) + p] = ((memory::readB24(gfx_data, o + (i * 3)) >> (23 - p)) & 1) * 255; break;
-			case 4: mask_[(i * width_) + p] = ((memory::readB32(gfx_data, o + (i * 4)) >> (31 - p)) & 1) * 255; break;
+			case 1: img_mask[(i * width_) + p] = ((gfx_data[o + i] >> (7 - p)) & 1) * 255; break;
+			case 2: img_mask[(i * width_) + p] = ((memory::readB16(gfx_data, o + (i * 2)) >> (15 - p)) & 1) * 255; break;
+			case 3: img_mask[(i * width_) + p] = ((memory::readB24(gfx_data, o + (i * 3)) >> (23 - p)) & 1) * 255; break;
+			case 4: img_mask[(i * width_) + p] = ((memory::readB32(gfx_data, o + (i * 4)) >> (31 - p)) & 1) * 255; break;
 			default:
 				clearData();
 				global::error = "Jedi FONT: Weird word width";
@@ -893,6 +904,8 @@ bool SImage::loadJaguarSprite(const uint8_t* header, int hdr_size, const uint8_t
 	}
 
 	// Okay, so it's finally time to read some pixel data
+	auto img_data = data_.data();
+	auto img_mask = mask_.data();
 	for (int w = 0; w < width_; ++w)
 	{
 		int post_p = col_offsets[w];
@@ -912,8 +925,8 @@ bool SImage::loadJaguarSprite(const uint8_t* header, int hdr_size, const uint8_t
 			for (int p = 0; p < len; ++p)
 			{
 				size_t pos = w + width_ * (top + p);
-				data_[pos] = gfx_data[pixel_p + p];
-				mask_[pos] = 0xFF;
+				img_data[pos] = gfx_data[pixel_p + p];
+				img_mask[pos] = 0xFF;
 			}
 			post_p += 4;
 		}
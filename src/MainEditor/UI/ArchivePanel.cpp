@@ -51,6 +51,7 @@
 #include "General/Executables.h"
 #include "General/KeyBind.h"
 #include "General/Misc.h"
+#include "General/ResourceManager.h"
 #include "General/UI.h"
 #include "Graphics/Icons.h"
 #include "Graphics/Palette/PaletteManager.h"
@@ -987,6 +988,9 @@ bool ArchivePanel::importFiles()
 		// Begin recording undo level
 		undo_manager_->beginRecord("Import Files");
 
+		// Send resource changes once all files are imported
+		ResourceBulkUpdate bulk_update{ app::resources() };
+
 		// Go through the list of files
 		bool ok = false;
 		entry_tree_->Freeze();
@@ -1329,6 +1333,7 @@ bool ArchivePanel::deleteEntry(bool confirm)
 	undo_manager_->beginRecord("Delete Entry");
 
 	// Go through the selected entries
+	ResourceBulkUpdate bulk_update{ app::resources() };
 	entry_tree_->Freeze();
 	for (int a = selected_entries.size() - 1; a >= 0; a--)
 	{
@@ -2062,7 +2067,8 @@ bool ArchivePanel::pasteEntry() const
 	// Go through all clipboard items
 	auto panel = theMainWindow->archiveManagerPanel();
 	panel->disableArchiveListUpdate();
-	bool pasted = false;
+	bool               pasted = false;
+	ResourceBulkUpdate bulk_update{ app::resources() };
 	undo_manager_->beginRecord("Paste Entry");
 	entry_tree_->Freeze();
 	for (unsigned a = 0; a < app::clipboard().size(); a++)
@@ -207,11 +207,24 @@ TextureXEditor::TextureXEditor(wxWindow* parent) : wxPanel(parent, -1)
 	// Bind events
 	Bind(wxEVT_SHOW, &TextureXEditor::onShow, this);
 
-	// Update patch browser & palette when resources are updated or the patch table is modified
-	sc_resources_updated_ = app::resources().signals().resources_updated.connect([this]() {
-		pb_update_ = true;
-		updateTexturePalette();
-	});
+	// Update patch browser & palette when resources are updated or the patch table is modified.
+	// If resources were only modified, just reload the affected patch browser items
+	sc_resources_updated_ = app::resources().signals().resources_changed.connect(
+		[this](const ResourceChanges& changes) {
+			if (changes.all || changes.added_removed || !changes.palettes.empty())
+			{
+				pb_update_ = true;
+				updateTexturePalette();
+				return;
+			}
+
+			if (!pb_update_)
+			{
+				patch_browser_->reloadItems(changes.patches);
+				patch_browser_->reloadItems(changes.flats);
+				patch_browser_->reloadItems(changes.textures);
+			}
+		});
 	sc_ptable_modified_   = patch_table_.signals().modified.connect([this]() {
         pb_update_ = true;
         updateTexturePalette();
@@ -32,13 +32,15 @@
 #include "Main.h"
 #include "MapBackupManager.h"
 #include "App.h"
-#include "Archive/Formats/ZipArchive.h"
-#include "General/Misc.h"
+#include "Archive/Formats/WadArchive.h"
 #include "MapEditor.h"
 #include "UI/MapBackupPanel.h"
 #include "UI/SDialog.h"
 #include "UI/WxUtils.h"
+#include "Utility/Compression.h"
+#include "Utility/FileUtils.h"
 #include "Utility/StringUtils.h"
+#include <unordered_set>
 
 using namespace slade;
 
@@ -57,6 +59,228 @@ string mb_ignore_entries[] = { "NODES",    "SSECTORS", "ZNODES",  "SEGS",     "R
 } // namespace
 
 
+// -----------------------------------------------------------------------------
+//
+// Functions
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// -----------------------------------------------------------------------------
+// Returns the base name for backup files of [archive_name]
+// -----------------------------------------------------------------------------
+string backupName(string_view archive_name)
+{
+	string fname{ archive_name };
+	std::replace(fname.begin(), fname.end(), '.', '_');
+	return fmt::format("{}/{}_backup", app::path("backups", app::Dir::User), fname);
+}
+
+// -----------------------------------------------------------------------------
+// Returns the path to the manifest for [map_name] in the backup [store]
+// -----------------------------------------------------------------------------
+string manifestPath(const string& store, string_view map_name)
+{
+	return fmt::format("{}/{}.manifest", store, map_name);
+}
+
+// -----------------------------------------------------------------------------
+// Returns the path to the data blob [key] in the backup [store]
+// -----------------------------------------------------------------------------
+string blobPath(const string& store, string_view key)
+{
+	return fmt::format("{}/blobs/{}", store, key);
+}
+
+// -----------------------------------------------------------------------------
+// Returns the blob key for [data] (a 64-bit FNV-1a hash of the data followed by
+// its size, in hex)
+// -----------------------------------------------------------------------------
+string blobKey(const MemChunk& data)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (unsigned a = 0; a < data.size(); ++a)
+	{
+		hash ^= data[a];
+		hash *= 1099511628211ull;
+	}
+
+	return fmt::format("{:016x}{:08x}", hash, data.size());
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if [key] is a valid blob key: 24 hex digits, optionally followed
+// by '-' and a number if the key had to be changed due to a hash collision
+// -----------------------------------------------------------------------------
+bool validBlobKey(string_view key)
+{
+	if (key.size() < 24)
+		return false;
+
+	for (unsigned a = 0; a < 24; ++a)
+		if (!isxdigit(static_cast<unsigned char>(key[a])))
+			return false;
+
+	if (key.size() == 24)
+		return true;
+
+	if (key[24] != '-' || key.size() == 25)
+		return false;
+	for (unsigned a = 25; a < key.size(); ++a)
+		if (!isdigit(static_cast<unsigned char>(key[a])))
+			return false;
+
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Returns all backups listed in the manifest at [path], oldest first.
+// Any incomplete or malformed backup (eg. if writing it was interrupted) is
+// ignored
+// -----------------------------------------------------------------------------
+vector<MapBackupManager::Backup> readManifest(const string& path)
+{
+	vector<MapBackupManager::Backup> backups;
+
+	string manifest;
+	if (!fileutil::fileExists(path) || !fileutil::readFileToString(path, manifest))
+		return backups;
+
+	MapBackupManager::Backup current;
+	bool                     in_backup = false;
+	for (auto line : strutil::splitV(manifest, '\n'))
+	{
+		if (!line.empty() && line.back() == '\r')
+			line.remove_suffix(1);
+
+		if (line.empty())
+			continue;
+
+		auto space   = line.find(' ');
+		auto keyword = line.substr(0, space);
+		auto value   = space == string_view::npos ? string_view{} : line.substr(space + 1);
+
+		// Start of backup (discards any unfinished backup before it)
+		if (keyword == "backup")
+		{
+			current   = { string{ value }, {} };
+			in_backup = true;
+		}
+
+		// Outside of a backup, ignore anything else
+		else if (!in_backup)
+			continue;
+
+		// Lump (blob key then name)
+		else if (keyword == "lump")
+		{
+			space = value.find(' ');
+			if (space == string_view::npos || !validBlobKey(value.substr(0, space)))
+			{
+				log::warning("Ignoring map backup {} in {}: invalid lump \"{}\"", current.timestamp, path, line);
+				in_backup = false;
+				continue;
+			}
+
+			current.lumps.push_back({ string{ value.substr(space + 1) }, string{ value.substr(0, space) } });
+		}
+
+		// End of backup
+		else if (keyword == "end" && value.empty())
+		{
+			backups.push_back(std::move(current));
+			in_backup = false;
+		}
+
+		// Anything else means the backup is corrupt
+		else
+		{
+			log::warning("Ignoring map backup {} in {}: invalid line \"{}\"", current.timestamp, path, line);
+			in_backup = false;
+		}
+	}
+
+	return backups;
+}
+
+// -----------------------------------------------------------------------------
+// Returns [backup] written in manifest format
+// -----------------------------------------------------------------------------
+string manifestBlock(const MapBackupManager::Backup& backup)
+{
+	auto block = fmt::format("backup {}\n", backup.timestamp);
+	for (const auto& lump : backup.lumps)
+		block += fmt::format("lump {} {}\n", lump.blob, lump.name);
+	block += "end\n";
+
+	return block;
+}
+
+// -----------------------------------------------------------------------------
+// Writes [data] to the blob [key] in the backup [store] if it doesn't already
+// exist. If a different blob already exists with the same key (a hash
+// collision), [key] is changed to a free one and the data written there.
+// Blobs in [known_keys] (used by previous backups of the map) are assumed to
+// match without being checked, unless a collision has been found for the key
+// before
+// -----------------------------------------------------------------------------
+bool writeBlob(const string& store, string& key, MemChunk& data, const std::unordered_set<string>& known_keys)
+{
+	auto base_key = key.substr(0, 24);
+	auto path     = blobPath(store, key);
+	if (known_keys.count(key) > 0 && fileutil::fileExists(path)
+		&& !fileutil::fileExists(blobPath(store, base_key + "-1")))
+		return true;
+
+	for (unsigned n = 1; fileutil::fileExists(path); ++n)
+	{
+		// Check the existing blob has the same data
+		MemChunk existing, existing_data;
+		if (existing.importFile(path) && compression::zlibInflate(existing, existing_data)
+			&& existing_data.size() == data.size()
+			&& (data.size() == 0 || memcmp(existing_data.data(), std::as_const(data).data(), data.size()) == 0))
+			return true;
+
+		log::warning("Map backup data blob {} doesn't match, trying another key", key);
+		key  = fmt::format("{}-{}", base_key, n);
+		path = blobPath(store, key);
+	}
+
+	MemChunk compressed;
+	if (!compression::zlibDeflate(data, compressed))
+		return false;
+
+	// Write to a temp file first so an interrupted write can't leave a
+	// partial blob
+	auto temp = path + ".tmp";
+	if (!compressed.exportFile(temp))
+		return false;
+
+	return wxRenameFile(temp, path, true);
+}
+
+// -----------------------------------------------------------------------------
+// Deletes any blobs in [keys] from the backup [store] that aren't used by any
+// map manifest in the store
+// -----------------------------------------------------------------------------
+void removeUnusedBlobs(const string& store, std::unordered_set<string>& keys)
+{
+	for (const auto& file : fileutil::allFilesInDir(store))
+	{
+		if (!strutil::endsWith(file, ".manifest"))
+			continue;
+
+		for (const auto& backup : readManifest(file))
+			for (const auto& lump : backup.lumps)
+				keys.erase(lump.blob);
+	}
+
+	for (const auto& key : keys)
+		fileutil::removeFile(blobPath(store, key));
+}
+} // namespace
+
+
 // -----------------------------------------------------------------------------
 //
 // MapBackupManager Class Functions
@@ -73,20 +297,15 @@ bool MapBackupManager::writeBackup(
 	std::string_view                  archive_name,
 	std::string_view                  map_name) const
 {
-	// Create backup directory if needed
+	// Create backup directories if needed
 	auto backup_dir = app::path("backups", app::Dir::User);
-	if (!wxDirExists(backup_dir))
-		wxMkdir(backup_dir);
-
-	// Open or create backup zip
-	shared_ptr<Archive> backup = std::make_shared<ZipArchive>();
-	string              fname{ archive_name };
-	std::replace(fname.begin(), fname.end(), '.', '_');
-	auto backup_file = fmt::format("{}/{}_backup.zip", backup_dir, fname);
-	if (!backup->open(backup_file))
-		backup->setFilename(backup_file);
+	auto store      = backupName(archive_name);
+	for (const auto& dir : { backup_dir, store, store + "/blobs" })
+		if (!wxDirExists(dir))
+			wxMkdir(dir);
 
-	// Filter ignored entries
+	// Filter ignored entries and get the blob key for each
+	Backup                backup;
 	vector<ArchiveEntry*> backup_entries;
 	for (auto& entry : map_data)
 	{
@@ -102,38 +321,21 @@ bool MapBackupManager::writeBackup(
 		}
 
 		if (!ignored)
+		{
+			backup.lumps.push_back({ entry->name(), blobKey(entry->data()) });
 			backup_entries.push_back(entry.get());
+		}
 	}
 
 	// Compare with last backup (if any)
-	auto map_dir = backup->dirAtPath(map_name);
-	if (map_dir && map_dir->numSubdirs() > 0)
+	auto manifest = manifestPath(store, map_name);
+	auto backups  = readManifest(manifest);
+	if (!backups.empty())
 	{
-		auto last_backup = map_dir->subdirAt(map_dir->numSubdirs() - 1);
-		bool same        = true;
-		if (last_backup->numEntries() != backup_entries.size())
-			same = false;
-		else
-		{
-			for (unsigned a = 0; a < last_backup->numEntries(); a++)
-			{
-				auto e1 = backup_entries[a];
-				auto e2 = last_backup->entryAt(a);
-				if (e1->size() != e2->size())
-				{
-					same = false;
-					break;
-				}
-
-				uint32_t crc1 = misc::crc(e1->rawData(), e1->size());
-				uint32_t crc2 = misc::crc(e2->rawData(), e2->size());
-				if (crc1 != crc2)
-				{
-					same = false;
-					break;
-				}
-			}
-		}
+		const auto& last = backups.back().lumps;
+		bool        same = last.size() == backup.lumps.size();
+		for (unsigned a = 0; same && a < last.size(); a++)
+			same = last[a].name == backup.lumps[a].name && last[a].blob == backup.lumps[a].blob;
 
 		if (same)
 		{
@@ -142,31 +344,75 @@ bool MapBackupManager::writeBackup(
 		}
 	}
 
-	// Add map data to backup
-	auto timestamp = wxDateTime::Now().FormatISOCombined('_').ToStdString();
-	strutil::replaceIP(timestamp, ":", "");
-	auto dir = fmt::format("{}/{}", map_name, timestamp);
-	for (auto& entry : backup_entries)
-		backup->addEntry(std::make_shared<ArchiveEntry>(*entry), dir);
+	// Write data blobs (only for lumps that have changed since any previous
+	// backup)
+	std::unordered_set<string> known_keys;
+	for (const auto& b : backups)
+		for (const auto& l : b.lumps)
+			known_keys.insert(l.blob);
+	for (unsigned a = 0; a < backup_entries.size(); a++)
+	{
+		if (!writeBlob(store, backup.lumps[a].blob, backup_entries[a]->data(), known_keys))
+		{
+			log::error("Unable to write map backup data for {}", backup.lumps[a].name);
+			return false;
+		}
+	}
+
+	// Add backup to manifest
+	backup.timestamp = wxDateTime::Now().FormatISOCombined('_').ToStdString();
+	strutil::replaceIP(backup.timestamp, ":", "");
+	backups.push_back(backup);
+
+	// Check for max backups & remove old ones if over (rewrites the manifest),
+	// otherwise just append the new backup to it
+	if ((int)backups.size() > max_map_backups && max_map_backups > 0)
+	{
+		auto n_remove = backups.size() - max_map_backups;
+
+		// Get blobs that were only used by the removed backups
+		std::unordered_set<string> unused;
+		for (unsigned a = 0; a < n_remove; a++)
+			for (const auto& l : backups[a].lumps)
+				unused.insert(l.blob);
+		backups.erase(backups.begin(), backups.begin() + n_remove);
+		for (const auto& b : backups)
+			for (const auto& l : b.lumps)
+				unused.erase(l.blob);
 
-	// Check for max backups & remove old ones if over
-	map_dir = backup->dirAtPath(map_name);
-	while ((int)map_dir->numSubdirs() > max_map_backups)
-		backup->removeDir(map_dir->subdirAt(0)->name(), map_dir);
+		// Write new manifest
+		string content;
+		for (const auto& b : backups)
+			content += manifestBlock(b);
+		auto  temp = manifest + ".tmp";
+		SFile file(temp, SFile::Mode::Write);
+		if (!file.isOpen() || !file.writeStr(content))
+			return false;
+		file.close();
+		if (!wxRenameFile(temp, manifest, true))
+			return false;
 
-	// Save backup file
-	Archive::save_backup = false;
-	bool ok              = backup->save();
-	Archive::save_backup = true;
+		// Remove unused blobs (checking other maps' manifests first)
+		if (!unused.empty())
+			removeUnusedBlobs(store, unused);
+	}
+	else
+	{
+		// Start on a new line, in case a previous append was interrupted
+		// partway through a line
+		SFile file(manifest, SFile::Mode::Append);
+		if (!file.isOpen() || !file.writeStr("\n" + manifestBlock(backup)))
+			return false;
+	}
 
-	return ok;
+	return true;
 }
 
 // -----------------------------------------------------------------------------
 // Shows the map backups for [map_name] in [archive_name], returns the selected
 // map backup data in a WadArchive
 // -----------------------------------------------------------------------------
-Archive* MapBackupManager::openBackup(string_view archive_name, string_view map_name) const
+unique_ptr<Archive> MapBackupManager::openBackup(string_view archive_name, string_view map_name) const
 {
 	SDialog dlg(mapeditor::windowWx(), fmt::format("Restore {} backup", map_name), "map_backup", 500, 400);
 	auto    sizer = new wxBoxSizer(wxVERTICAL);
@@ -180,7 +426,7 @@ Archive* MapBackupManager::openBackup(string_view archive_name, string_view map_
 	if (panel_backup->loadBackups(wxutil::strFromView(archive_name), wxutil::strFromView(map_name)))
 	{
 		if (dlg.ShowModal() == wxID_OK)
-			return panel_backup->selectedMapData();
+			return panel_backup->takeMapData();
 	}
 	else
 		wxMessageBox(
@@ -191,3 +437,46 @@ Archive* MapBackupManager::openBackup(string_view archive_name, string_view map_
 
 	return nullptr;
 }
+
+// -----------------------------------------------------------------------------
+// Returns all backups of [map_name] in [archive_name], oldest first.
+// This only reads the map's manifest, no backup data is loaded
+// -----------------------------------------------------------------------------
+vector<MapBackupManager::Backup> MapBackupManager::backups(string_view archive_name, string_view map_name) const
+{
+	return readManifest(manifestPath(backupName(archive_name), map_name));
+}
+
+// -----------------------------------------------------------------------------
+// Loads the map data for [backup] of a map in [archive_name] into a new
+// WadArchive. Returns nullptr if any of the data couldn't be loaded
+// -----------------------------------------------------------------------------
+unique_ptr<Archive> MapBackupManager::loadBackup(string_view archive_name, const Backup& backup) const
+{
+	auto store   = backupName(archive_name);
+	auto archive = std::make_unique<WadArchive>();
+	for (const auto& lump : backup.lumps)
+	{
+		MemChunk compressed, data;
+		if (!compressed.importFile(blobPath(store, lump.blob)) || !compression::zlibInflate(compressed, data))
+		{
+			log::error("Unable to read map backup data for {} ({})", lump.name, lump.blob);
+			return nullptr;
+		}
+
+		auto entry = std::make_shared<ArchiveEntry>(lump.name);
+		entry->importMemChunk(data);
+		archive->addEntry(entry, "");
+	}
+
+	return archive;
+}
+
+// -----------------------------------------------------------------------------
+// Returns the path to the backup zip for [archive_name] written by previous
+// versions (all backups were kept in a single zip)
+// -----------------------------------------------------------------------------
+string MapBackupManager::legacyBackupFile(string_view archive_name)
+{
+	return backupName(archive_name) + ".zip";
+}
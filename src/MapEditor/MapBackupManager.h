@@ -4,13 +4,38 @@ namespace slade
 {
 class ArchiveEntry;
 class Archive;
+
+// Map backups are kept in a content-addressed store for each archive: each map
+// lump's data is stored once as a (compressed) blob named by a hash of its
+// content, and each map has a manifest listing its backups and the blobs for
+// each lump. Writing a backup only writes blobs for lumps that have changed
+// and appends to the manifest
 class MapBackupManager
 {
 public:
+	// A map lump in a backup, and the key of the blob containing its data
+	struct Lump
+	{
+		string name;
+		string blob;
+	};
+
+	// A single backup of a map, as listed in its manifest
+	struct Backup
+	{
+		string       timestamp; // YYYY-MM-DD_HHMMSS
+		vector<Lump> lumps;
+	};
+
 	MapBackupManager()  = default;
 	~MapBackupManager() = default;
 
 	bool writeBackup(vector<unique_ptr<ArchiveEntry>>& map_data, string_view archive_name, string_view map_name) const;
-	Archive* openBackup(string_view archive_name, string_view map_name) const;
+	unique_ptr<Archive> openBackup(string_view archive_name, string_view map_name) const;
+
+	vector<Backup>      backups(string_view archive_name, string_view map_name) const;
+	unique_ptr<Archive> loadBackup(string_view archive_name, const Backup& backup) const;
+
+	static string legacyBackupFile(string_view archive_name);
 };
 } // namespace slade
@@ -78,6 +78,56 @@ std::map<MapCheck::StandardCheck, StandardCheckInfo> std_checks = {
 } // namespace
 
 
+// -----------------------------------------------------------------------------
+//
+// Functions
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// Bounding box of an object to check for overlaps with others, [index] is the
+// object's index in the list being checked
+struct Bounds
+{
+	unsigned index;
+	double   left, right, top, bottom;
+};
+
+// -----------------------------------------------------------------------------
+// Returns the index pairs of all overlapping boxes in [bounds], sorted by
+// index (lowest first in each pair).
+// The boxes are sorted and swept along the x axis so that only boxes that
+// overlap on that axis are compared, rather than every possible pair
+// -----------------------------------------------------------------------------
+vector<std::pair<unsigned, unsigned>> overlappingPairs(vector<Bounds>& bounds)
+{
+	std::sort(
+		bounds.begin(), bounds.end(), [](const Bounds& left, const Bounds& right) { return left.left < right.left; });
+
+	vector<std::pair<unsigned, unsigned>> pairs;
+	for (unsigned a = 0; a < bounds.size(); a++)
+	{
+		auto& b1 = bounds[a];
+
+		// Go through boxes starting before this one ends
+		for (unsigned b = a + 1; b < bounds.size() && bounds[b].left <= b1.right; b++)
+		{
+			auto& b2 = bounds[b];
+
+			// Check y overlap
+			if (b2.top > b1.bottom || b2.bottom < b1.top)
+				continue;
+
+			pairs.emplace_back(std::min(b1.index, b2.index), std::max(b1.index, b2.index));
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end());
+	return pairs;
+}
+} // namespace
+
+
 // -----------------------------------------------------------------------------
 // MissingTextureCheck Class
 //
@@ -493,43 +543,43 @@ class LinesIntersectCheck : public MapCheck
 public:
 	LinesIntersectCheck(SLADEMap* map) : MapCheck(map) {}
 
-	void checkIntersections(vector<MapLine*> lines)
+	void checkIntersections(const vector<MapLine*>& lines)
 	{
-		Vec2d    pos;
-		MapLine* line1;
-		MapLine* line2;
+		Vec2d pos;
 
 		// Clear existing intersections
 		intersections_.clear();
 
-		// Go through lines
+		// Get line bounding boxes, sorted by left edge
+		vector<Bounds> bounds;
+		bounds.reserve(lines.size());
 		for (unsigned a = 0; a < lines.size(); a++)
 		{
-			line1 = lines[a];
+			auto seg = lines[a]->seg();
+			bounds.push_back({ a, seg.left(), seg.right(), seg.top(), seg.bottom() });
+		}
 
-			// Go through uncompared lines
-			for (unsigned b = a + 1; b < lines.size(); b++)
-			{
-				line2 = lines[b];
+		// Only lines with overlapping bounding boxes can intersect
+		auto pairs = overlappingPairs(bounds);
 
-				// Check intersection
-				if (line1->intersects(line2, pos))
-					intersections_.emplace_back(line1, line2, pos.x, pos.y);
-			}
+		// Check intersections
+		for (auto& pair : pairs)
+		{
+			auto line1 = lines[pair.first];
+			auto line2 = lines[pair.second];
+			if (line1->intersects(line2, pos))
+				intersections_.emplace_back(line1, line2, pos.x, pos.y);
 		}
 	}
 
 	void doCheck() override
 	{
-		// Get all map lines
-		vector<MapLine*> all_lines;
-		for (unsigned a = 0; a < map_->nLines(); a++)
-			all_lines.push_back(map_->line(a));
-
-		// Check for intersections
-		checkIntersections(all_lines);
+		// Check all map lines for intersections
+		checkIntersections(map_->lines().all());
 	}
 
+	bool threadSafe() override { return true; }
+
 	unsigned nProblems() override { return intersections_.size(); }
 
 	string problemDesc(unsigned index) override
@@ -642,24 +692,34 @@ public:
 
 	void doCheck() override
 	{
-		// Go through lines
+		// Group lines by their vertices (in either direction)
+		std::map<std::pair<MapVertex*, MapVertex*>, vector<MapLine*>> vertex_lines;
 		for (unsigned a = 0; a < map_->nLines(); a++)
 		{
-			auto line1 = map_->line(a);
-
-			// Go through uncompared lines
-			for (unsigned b = a + 1; b < map_->nLines(); b++)
-			{
-				auto line2 = map_->line(b);
+			auto line = map_->line(a);
+			auto v1   = std::min(line->v1(), line->v2());
+			auto v2   = std::max(line->v1(), line->v2());
+			vertex_lines[{ v1, v2 }].push_back(line);
+		}
 
-				// Check for overlap (both vertices shared)
-				if ((line1->v1() == line2->v1() && line1->v2() == line2->v2())
-					|| (line1->v2() == line2->v1() && line1->v1() == line2->v2()))
-					overlaps_.emplace_back(line1, line2);
-			}
+		// Lines in the same group overlap (both vertices shared)
+		vector<std::pair<unsigned, unsigned>> pairs;
+		for (auto& group : vertex_lines)
+		{
+			auto& lines = group.second;
+			for (unsigned a = 0; a < lines.size(); a++)
+				for (unsigned b = a + 1; b < lines.size(); b++)
+					pairs.emplace_back(lines[a]->index(), lines[b]->index());
 		}
+
+		// Add overlaps in line order
+		std::sort(pairs.begin(), pairs.end());
+		for (auto& pair : pairs)
+			overlaps_.emplace_back(map_->line(pair.first), map_->line(pair.second));
 	}
 
+	bool threadSafe() override { return true; }
+
 	unsigned nProblems() override { return overlaps_.size(); }
 
 	string problemDesc(unsigned index) override
@@ -747,151 +807,28 @@ public:
 
 	void doCheck() override
 	{
-		double r1, r2;
-
-		// Go through things
+		// Get bounding boxes of all solid things with a radius
+		vector<Bounds> bounds;
 		for (unsigned a = 0; a < map_->nThings(); a++)
 		{
-			auto  thing1 = map_->thing(a);
-			auto& tt1    = game::configuration().thingType(thing1->type());
-			r1           = tt1.radius() - 1;
+			auto   thing = map_->thing(a);
+			auto&  tt    = game::configuration().thingType(thing->type());
+			double r     = tt.radius() - 1;
 
 			// Ignore if no radius
-			if (r1 < 0 || !tt1.solid())
+			if (r < 0 || !tt.solid())
 				continue;
 
-			// Go through uncompared things
-			auto map_format = map_->currentFormat();
-			bool udmf_zdoom =
-				(map_format == MapFormat::UDMF && strutil::equalCI(game::configuration().udmfNamespace(), "zdoom"));
-			bool udmf_eternity =
-				(map_format == MapFormat::UDMF && strutil::equalCI(game::configuration().udmfNamespace(), "eternity"));
-			int min_skill = udmf_zdoom || udmf_eternity ? 1 : 2;
-			int max_skill = udmf_zdoom ? 17 : 5;
-			int max_class = udmf_zdoom ? 17 : 4;
-
-			for (unsigned b = a + 1; b < map_->nThings(); b++)
-			{
-				auto  thing2 = map_->thing(b);
-				auto& tt2    = game::configuration().thingType(thing2->type());
-				r2           = tt2.radius() - 1;
-
-				// Ignore if no radius
-				if (r2 < 0 || !tt2.solid())
-					continue;
-
-				// Check flags
-				// Case #1: different skill levels
-				bool shareflag = false;
-				for (int s = min_skill; s < max_skill; ++s)
-				{
-					auto skill = fmt::format("skill{}", s);
-					if (game::configuration().thingBasicFlagSet(skill, thing1, map_format)
-						&& game::configuration().thingBasicFlagSet(skill, thing2, map_format))
-					{
-						shareflag = true;
-						s         = max_skill;
-					}
-				}
-				if (!shareflag)
-					continue;
-
-				// Booleans for single, coop, deathmatch, and teamgame status for each thing
-				bool s1, s2, c1, c2, d1, d2, t1, t2;
-				s1 = game::configuration().thingBasicFlagSet("single", thing1, map_format);
-				s2 = game::configuration().thingBasicFlagSet("single", thing2, map_format);
-				c1 = game::configuration().thingBasicFlagSet("coop", thing1, map_format);
-				c2 = game::configuration().thingBasicFlagSet("coop", thing2, map_format);
-				d1 = game::configuration().thingBasicFlagSet("dm", thing1, map_format);
-				d2 = game::configuration().thingBasicFlagSet("dm", thing2, map_format);
-				t1 = t2 = false;
-
-				// Player starts
-				// P1 are automatically S and C; P2+ are automatically C;
-				// Deathmatch starts are automatically D, and team start are T.
-				if (tt1.flags() & game::ThingType::Flags::CoOpStart)
-				{
-					c1 = true;
-					d1 = t1 = false;
-					if (thing1->type() == 1)
-						s1 = true;
-					else
-						s1 = false;
-				}
-				else if (tt1.flags() & game::ThingType::Flags::DMStart)
-				{
-					s1 = c1 = t1 = false;
-					d1           = true;
-				}
-				else if (tt1.flags() & game::ThingType::Flags::TeamStart)
-				{
-					s1 = c1 = d1 = false;
-					t1           = true;
-				}
-				if (tt2.flags() & game::ThingType::Flags::CoOpStart)
-				{
-					c2 = true;
-					d2 = t2 = false;
-					if (thing2->type() == 1)
-						s2 = true;
-					else
-						s2 = false;
-				}
-				else if (tt2.flags() & game::ThingType::Flags::DMStart)
-				{
-					s2 = c2 = t2 = false;
-					d2           = true;
-				}
-				else if (tt2.flags() & game::ThingType::Flags::TeamStart)
-				{
-					s2 = c2 = d2 = false;
-					t2           = true;
-				}
-
-				// Case #2: different game modes (single, coop, dm)
-				shareflag = false;
-				if ((c1 && c2) || (d1 && d2) || (t1 && t2))
-				{
-					shareflag = true;
-				}
-				if (!shareflag && s1 && s2)
-				{
-					// Case #3: things flagged for single player with different class filters
-					for (int c = 1; c < max_class; ++c)
-					{
-						auto pclass = fmt::format("class{}", c);
-						if (game::configuration().thingBasicFlagSet(pclass, thing1, map_format)
-							&& game::configuration().thingBasicFlagSet(pclass, thing2, map_format))
-						{
-							shareflag = true;
-							c         = max_class;
-						}
-					}
-				}
-				if (!shareflag)
-					continue;
-
-				// Also check player start spots in Hexen-style hubs
-				shareflag = false;
-				if (tt1.flags() & game::ThingType::Flags::CoOpStart && tt2.flags() & game::ThingType::Flags::CoOpStart)
-				{
-					if (thing1->arg(0) == thing2->arg(0))
-						shareflag = true;
-				}
-				if (!shareflag)
-					continue;
-
-				// Check x non-overlap
-				if (thing2->xPos() + r2 < thing1->xPos() - r1 || thing2->xPos() - r2 > thing1->xPos() + r1)
-					continue;
-
-				// Check y non-overlap
-				if (thing2->yPos() + r2 < thing1->yPos() - r1 || thing2->yPos() - r2 > thing1->yPos() + r1)
-					continue;
+			bounds.push_back({ a, thing->xPos() - r, thing->xPos() + r, thing->yPos() - r, thing->yPos() + r });
+		}
 
-				// Overlap detected
+		// Check flags of things with overlapping bounding boxes
+		for (auto& pair : overlappingPairs(bounds))
+		{
+			auto thing1 = map_->thing(pair.first);
+			auto thing2 = map_->thing(pair.second);
+			if (canOverlap(thing1, thing2))
 				overlaps_.emplace_back(thing1, thing2);
-			}
 		}
 	}
 
@@ -965,6 +902,123 @@ public:
 	}
 
 private:
+	// Returns true if [thing1] and [thing2] can both be present in the same game
+	// (skill levels, game modes, classes etc.)
+	bool canOverlap(MapThing* thing1, MapThing* thing2) const
+	{
+		auto& tt1 = game::configuration().thingType(thing1->type());
+		auto& tt2 = game::configuration().thingType(thing2->type());
+
+		auto map_format = map_->currentFormat();
+		bool udmf_zdoom =
+			(map_format == MapFormat::UDMF && strutil::equalCI(game::configuration().udmfNamespace(), "zdoom"));
+		bool udmf_eternity =
+			(map_format == MapFormat::UDMF && strutil::equalCI(game::configuration().udmfNamespace(), "eternity"));
+		int min_skill = udmf_zdoom || udmf_eternity ? 1 : 2;
+		int max_skill = udmf_zdoom ? 17 : 5;
+		int max_class = udmf_zdoom ? 17 : 4;
+
+		// Check flags
+		// Case #1: different skill levels
+		bool shareflag = false;
+		for (int s = min_skill; s < max_skill; ++s)
+		{
+			auto skill = fmt::format("skill{}", s);
+			if (game::configuration().thingBasicFlagSet(skill, thing1, map_format)
+				&& game::configuration().thingBasicFlagSet(skill, thing2, map_format))
+			{
+				shareflag = true;
+				s         = max_skill;
+			}
+		}
+		if (!shareflag)
+			return false;
+
+		// Booleans for single, coop, deathmatch, and teamgame status for each thing
+		bool s1, s2, c1, c2, d1, d2, t1, t2;
+		s1 = game::configuration().thingBasicFlagSet("single", thing1, map_format);
+		s2 = game::configuration().thingBasicFlagSet("single", thing2, map_format);
+		c1 = game::configuration().thingBasicFlagSet("coop", thing1, map_format);
+		c2 = game::configuration().thingBasicFlagSet("coop", thing2, map_format);
+		d1 = game::configuration().thingBasicFlagSet("dm", thing1, map_format);
+		d2 = game::configuration().thingBasicFlagSet("dm", thing2, map_format);
+		t1 = t2 = false;
+
+		// Player starts
+		// P1 are automatically S and C; P2+ are automatically C;
+		// Deathmatch starts are automatically D, and team start are T.
+		if (tt1.flags() & game::ThingType::Flags::CoOpStart)
+		{
+			c1 = true;
+			d1 = t1 = false;
+			if (thing1->type() == 1)
+				s1 = true;
+			else
+				s1 = false;
+		}
+		else if (tt1.flags() & game::ThingType::Flags::DMStart)
+		{
+			s1 = c1 = t1 = false;
+			d1           = true;
+		}
+		else if (tt1.flags() & game::ThingType::Flags::TeamStart)
+		{
+			s1 = c1 = d1 = false;
+			t1           = true;
+		}
+		if (tt2.flags() & game::ThingType::Flags::CoOpStart)
+		{
+			c2 = true;
+			d2 = t2 = false;
+			if (thing2->type() == 1)
+				s2 = true;
+			else
+				s2 = false;
+		}
+		else if (tt2.flags() & game::ThingType::Flags::DMStart)
+		{
+			s2 = c2 = t2 = false;
+			d2           = true;
+		}
+		else if (tt2.flags() & game::ThingType::Flags::TeamStart)
+		{
+			s2 = c2 = d2 = false;
+			t2           = true;
+		}
+
+		// Case #2: different game modes (single, coop, dm)
+		shareflag = false;
+		if ((c1 && c2) || (d1 && d2) || (t1 && t2))
+		{
+			shareflag = true;
+		}
+		if (!shareflag && s1 && s2)
+		{
+			// Case #3: things flagged for single player with different class filters
+			for (int c = 1; c < max_class; ++c)
+			{
+				auto pclass = fmt::format("class{}", c);
+				if (game::configuration().thingBasicFlagSet(pclass, thing1, map_format)
+					&& game::configuration().thingBasicFlagSet(pclass, thing2, map_format))
+				{
+					shareflag = true;
+					c         = max_class;
+				}
+			}
+		}
+		if (!shareflag)
+			return false;
+
+		// Also check player start spots in Hexen-style hubs
+		shareflag = false;
+		if (tt1.flags() & game::ThingType::Flags::CoOpStart && tt2.flags() & game::ThingType::Flags::CoOpStart)
+		{
+			if (thing1->arg(0) == thing2->arg(0))
+				shareflag = true;
+		}
+		return shareflag;
+	}
+
 	struct Overlap
 	{
 		MapThing* thing1;
@@ -1624,6 +1678,8 @@ public:
 		}
 	}
 
+	bool threadSafe() override { return true; }
+
 	unsigned nProblems() override { return lines_.size(); }
 
 	string problemDesc(unsigned index) override
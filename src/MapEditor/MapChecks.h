@@ -42,6 +42,10 @@ public:
 	virtual string     progressText() { return "Checking..."; }
 	virtual string     fixText(unsigned fix_type, unsigned index) { return ""; }
 
+	// Returns true if doCheck can be run on a worker thread (ie. it only reads
+	// map data, and doesn't use the game configuration, textures or UI)
+	virtual bool threadSafe() { return false; }
+
 	static unique_ptr<MapCheck> standardCheck(StandardCheck type, SLADEMap* map, MapTextureManager* texman = nullptr);
 	static unique_ptr<MapCheck> standardCheck(string_view type_id, SLADEMap* map, MapTextureManager* texman = nullptr);
 	static string               standardCheckDesc(StandardCheck type);
@@ -34,6 +34,7 @@
 #include "Main.h"
 #include "MapEditContext.h"
 #include "App.h"
+#include "Archive/Formats/WadArchive.h"
 #include "Game/Configuration.h"
 #include "General/Clipboard.h"
 #include "General/Console.h"
@@ -47,6 +48,7 @@
 #include "MapEditor/UI/Dialogs/SectorSpecialDialog.h"
 #include "MapEditor/UI/Dialogs/ShowItemDialog.h"
 #include "MapTextureManager.h"
+#include "SLADEMap/MapFormat/MapFormatHandler.h"
 #include "UI/MapCanvas.h"
 #include "UI/MapEditorWindow.h"
 #include "UndoSteps.h"
@@ -80,6 +82,9 @@ CVAR(Bool, hilight_smooth, true, CVar::Flag::Save)
 // -----------------------------------------------------------------------------
 EXTERN_CVAR(Int, flat_drawtype)
 EXTERN_CVAR(Bool, thing_preview_lights)
+EXTERN_CVAR(Bool, map_spatial_index)
+EXTERN_CVAR(Bool, map_udmf_stream_read)
+EXTERN_CVAR(Bool, map_udmf_parallel_read)
 
 
 // -----------------------------------------------------------------------------
@@ -1345,14 +1350,8 @@ void MapEditContext::beginUndoRecord(string_view name, bool mod, bool create, bo
 	// Begin recording
 	manager->beginRecord(name);
 
-	// Init map/objects for recording
-	if (undo_modified_)
-		MapObject::beginPropBackup(app::runTimer());
-	if (undo_deleted_ || undo_created_)
-		us_create_delete_ = std::make_unique<mapeditor::MapObjectCreateDeleteUS>();
-
-	// Make sure all modified objects will be picked up
-	wxMilliSleep(5);
+	// Begin journalling map changes
+	map_.undoJournal().begin(undo_modified_);
 
 	last_undo_level_ = "";
 }
@@ -1381,24 +1380,23 @@ void MapEditContext::endUndoRecord(bool success)
 
 	if (manager->currentlyRecording())
 	{
-		// Record necessary undo steps
-		MapObject::beginPropBackup(-1);
-		bool modified        = false;
-		bool created_deleted = false;
+		// Record necessary undo steps from the changes journalled since
+		// recording began
+		auto& journal         = map_.undoJournal();
+		bool  modified        = false;
+		bool  created_deleted = false;
 		if (undo_modified_)
-			modified = manager->recordUndoStep(std::make_unique<mapeditor::MultiMapObjectPropertyChangeUS>());
+			modified = manager->recordUndoStep(
+				std::make_unique<mapeditor::MultiMapObjectPropertyChangeUS>(journal.modifiedObjects()));
 		if (undo_created_ || undo_deleted_)
-		{
-			auto ustep = dynamic_cast<mapeditor::MapObjectCreateDeleteUS*>(us_create_delete_.get());
-			ustep->checkChanges();
-			created_deleted = manager->recordUndoStep(std::move(us_create_delete_));
-		}
+			created_deleted = manager->recordUndoStep(
+				std::make_unique<mapeditor::MapObjectCreateDeleteUS>(journal.listChanges()));
 
 		// End recording
 		manager->endRecord(success && (modified || created_deleted));
 	}
+	map_.undoJournal().end();
 	updateThingLists();
-	us_create_delete_.reset(nullptr);
 	map_.recomputeSpecials();
 }
 
@@ -2480,6 +2478,120 @@ CONSOLE_COMMAND(m_test_sector, 0, false)
 	log::info("Took {}ms", ms);
 }
 
+CONSOLE_COMMAND(m_test_hilight, 0, false)
+{
+	SLADEMap& map      = mapeditor::editContext().map();
+	auto      bbox     = map.bounds(false);
+	int       n_points = args.empty() ? 10000 : strutil::asInt(args[0]);
+
+	// Generate random points within the map
+	vector<Vec2d> points(std::max(n_points, 0));
+	for (auto& point : points)
+		point.set(
+			bbox.min.x + (bbox.max.x - bbox.min.x) * (rand() / static_cast<double>(RAND_MAX)),
+			bbox.min.y + (bbox.max.y - bbox.min.y) * (rand() / static_cast<double>(RAND_MAX)));
+
+	// Run the same queries as are used for hilighting, with and without the
+	// spatial index
+	bool index_enabled = map_spatial_index;
+	for (bool use_index : { false, true })
+	{
+		map_spatial_index = use_index;
+
+		// Include building the index in the total time
+		sf::Clock total_clock;
+		if (use_index)
+			map.spatialIndex().update();
+
+		sf::Clock clock;
+		for (const auto& point : points)
+			map.vertices().nearest(point);
+		auto t_vertices = clock.restart().asMicroseconds();
+		for (const auto& point : points)
+			map.lines().nearest(point);
+		auto t_lines = clock.restart().asMicroseconds();
+		for (const auto& point : points)
+			map.sectors().atPos(point);
+		auto t_sectors = clock.restart().asMicroseconds();
+
+		log::info(
+			"{}: {} points, vertices {}ms, lines {}ms, sectors {}ms, total {}ms",
+			use_index ? "Spatial index" : "Brute force",
+			points.size(),
+			t_vertices / 1000.,
+			t_lines / 1000.,
+			t_sectors / 1000.,
+			total_clock.getElapsedTime().asMicroseconds() / 1000.);
+	}
+
+	map_spatial_index = index_enabled;
+}
+
+CONSOLE_COMMAND(m_test_udmf_read, 0, false)
+{
+	auto map_desc = mapeditor::editContext().mapDesc();
+
+	// Check for map archive
+	WadArchive tempwad;
+	auto       m_head = map_desc.head.lock();
+	if (map_desc.archive && m_head)
+	{
+		tempwad.open(m_head->data());
+		auto amaps = tempwad.detectMaps();
+		if (!amaps.empty())
+			map_desc = amaps[0];
+	}
+
+	if (map_desc.format != MapFormat::UDMF || !map_desc.head.lock())
+	{
+		log::info("Current map isn't a saved UDMF map");
+		return;
+	}
+
+	// Read the map's TEXTMAP with the parse tree, streaming and parallel
+	// streaming readers
+	struct Method
+	{
+		string name;
+		bool   stream;
+		bool   parallel;
+	};
+	const vector<Method> methods = {
+		{ "Parse tree", false, false },
+		{ "Streaming", true, false },
+		{ "Streaming (parallel)", true, true },
+	};
+	bool stream_read   = map_udmf_stream_read;
+	bool parallel_read = map_udmf_parallel_read;
+	for (const auto& method : methods)
+	{
+		map_udmf_stream_read   = method.stream;
+		map_udmf_parallel_read = method.parallel;
+
+		MapObjectCollection map_data;
+		PropertyList        map_props;
+		auto                handler = MapFormatHandler::get(MapFormat::UDMF);
+
+		sf::Clock clock;
+		auto      ok = handler->readMap(map_desc, map_data, map_props);
+		auto      ms = clock.getElapsedTime().asMilliseconds();
+
+		log::info(
+			"{}: {}ms{}, {} vertices, {} lines, {} sides, {} sectors, {} things",
+			method.name,
+			ms,
+			ok ? "" : " (failed)",
+			map_data.vertices().size(),
+			map_data.lines().size(),
+			map_data.sides().size(),
+			map_data.sectors().size(),
+			map_data.things().size());
+	}
+
+	map_udmf_stream_read   = stream_read;
+	map_udmf_parallel_read = parallel_read;
+}
+
 CONSOLE_COMMAND(m_test_mobj_backup, 0, false)
 {
 	sf::Clock clock;
@@ -157,8 +157,7 @@ private:
 	long             next_frame_length_ = 0;
 
 	// Undo/Redo stuff
-	unique_ptr<UndoManager> undo_manager_     = nullptr;
-	unique_ptr<UndoStep>    us_create_delete_ = nullptr;
+	unique_ptr<UndoManager> undo_manager_ = nullptr;
 
 	// Editor state
 	mapeditor::Mode       edit_mode_      = mapeditor::Mode::Lines;
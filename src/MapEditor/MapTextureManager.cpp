@@ -62,6 +62,49 @@ MapTextureManager::Texture tex_invalid;
 CVAR(Int, map_tex_filter, 0, CVar::Flag::Save)
 
 
+// -----------------------------------------------------------------------------
+//
+// Functions
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// -----------------------------------------------------------------------------
+// Gets the [category] composite texture [tex] is listed under, and whether it
+// is listed as a [flat]. Returns false if it isn't listed at all
+// -----------------------------------------------------------------------------
+bool compositeCategory(const CTexture& tex, MapTextureManager::Category& category, bool& flat)
+{
+	using Category = MapTextureManager::Category;
+
+	flat = false;
+	if (!tex.isExtended())
+		category = Category::TextureX;
+	else if (strutil::equalCI(tex.type(), "texture") || strutil::equalCI(tex.type(), "walltexture"))
+		category = Category::ZDTextures;
+	else if (strutil::equalCI(tex.type(), "define"))
+		category = Category::HiRes;
+	else if (strutil::equalCI(tex.type(), "flat"))
+	{
+		category = Category::ZDTextures;
+		flat     = true;
+	}
+	else
+		return false; // Ignore graphics, patches and sprites
+
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Returns the index composite texture [tex] is listed with
+// -----------------------------------------------------------------------------
+unsigned compositeIndex(const CTexture& tex)
+{
+	return tex.isExtended() ? tex.index() : tex.index() + 1;
+}
+} // namespace
+
+
 // -----------------------------------------------------------------------------
 //
 // MapTextureManager Class Functions
@@ -80,7 +123,8 @@ MapTextureManager::MapTextureManager(shared_ptr<Archive> archive) : archive_{ ar
 void MapTextureManager::init()
 {
 	// Refresh when resources are updated or the main palette is changed
-	sc_resources_updated_ = app::resources().signals().resources_updated.connect([this]() { refreshResources(); });
+	sc_resources_updated_ = app::resources().signals().resources_changed.connect(
+		[this](const ResourceChanges& changes) { refreshResources(changes); });
 	sc_palette_changed_   = theMainWindow->paletteChooser()->signals().palette_changed.connect(
         [this]() { refreshResources(); });
 
@@ -546,6 +590,71 @@ void MapTextureManager::refreshResources()
 	buildTexInfoList();
 }
 
+// -----------------------------------------------------------------------------
+// Unloads any cached textures, flats and sprites affected by [changes]
+// -----------------------------------------------------------------------------
+void MapTextureManager::refreshResources(const ResourceChanges& changes)
+{
+	// A palette change affects everything
+	if (changes.all || !changes.palettes.empty())
+	{
+		refreshResources();
+		return;
+	}
+
+	auto changed = [](const std::set<string>& names, const string& name) { return names.count(name) > 0; };
+
+	// Textures (can also be flats if mixed, or composites of changed patches)
+	auto archive = archive_.lock().get();
+	for (auto i = textures_.begin(); i != textures_.end();)
+	{
+		bool affected = changed(changes.textures, i->first) || changed(changes.flats, i->first)
+						|| changed(changes.patches, i->first);
+		if (!affected && !changes.patches.empty())
+		{
+			if (auto ctex = app::resources().getTexture(i->first, archive))
+				for (size_t p = 0; p < ctex->nPatches() && !affected; ++p)
+					affected = changed(changes.patches, strutil::upper(ctex->patch(p)->name()));
+		}
+
+		if (affected)
+			i = textures_.erase(i);
+		else
+			++i;
+	}
+
+	// Flats (can also be textures if mixed)
+	for (auto i = flats_.begin(); i != flats_.end();)
+	{
+		if (changed(changes.flats, i->first) || changed(changes.textures, i->first))
+			i = flats_.erase(i);
+		else
+			++i;
+	}
+
+	// Sprites (cached by name + translation + palette, and can be mirrored or
+	// looked up by wildcard, so just compare the sprite name prefix)
+	std::set<string> sprite_prefixes;
+	for (const auto& name : changes.patches)
+		sprite_prefixes.insert(name.substr(0, 4));
+	for (const auto& name : changes.textures)
+		sprite_prefixes.insert(name.substr(0, 4));
+	for (auto i = sprites_.begin(); i != sprites_.end();)
+	{
+		if (sprite_prefixes.count(i->first.substr(0, 4)) > 0)
+			i = sprites_.erase(i);
+		else
+			++i;
+	}
+
+	mapeditor::forceRefresh(true);
+
+	// Nothing was added, removed or renamed, so the texture/flat lists can be
+	// updated in place unless the set of composite textures changed
+	if (changes.added_removed || !updateTexInfo(changes.textures))
+		buildTexInfoList();
+}
+
 // -----------------------------------------------------------------------------
 // (Re)builds lists with information about all currently available resource
 // textures and flats
@@ -568,21 +677,15 @@ void MapTextureManager::buildTexInfoList()
 		if (!parent)
 			continue;
 
+		Category category;
+		bool     flat;
+		if (!compositeCategory(*tex, category, flat))
+			continue;
+
 		auto long_name = tex->name();
 		auto path      = strutil::contains(long_name, '/') ? strutil::beforeLast(long_name, '/') : strutil::EMPTY;
-
-		if (tex->isExtended())
-		{
-			if (strutil::equalCI(tex->type(), "texture") || strutil::equalCI(tex->type(), "walltexture"))
-				tex_info_.emplace_back(long_name, Category::ZDTextures, parent, path, tex->index(), long_name);
-			else if (strutil::equalCI(tex->type(), "define"))
-				tex_info_.emplace_back(long_name, Category::HiRes, parent, path, tex->index(), long_name);
-			else if (strutil::equalCI(tex->type(), "flat"))
-				flat_info_.emplace_back(long_name, Category::ZDTextures, parent, path, tex->index(), long_name);
-			// Ignore graphics, patches and sprites
-		}
-		else
-			tex_info_.emplace_back(long_name, Category::TextureX, parent, path, tex->index() + 1, long_name);
+		auto& list     = flat ? flat_info_ : tex_info_;
+		list.emplace_back(long_name, category, parent, path, compositeIndex(*tex), long_name);
 	}
 
 	// Texture namespace patches (TX_)
@@ -620,6 +723,60 @@ void MapTextureManager::buildTexInfoList()
 	}
 }
 
+// -----------------------------------------------------------------------------
+// Updates the listed composite textures named in [names] (uppercase) in place,
+// after they were modified. Returns false if any were added, removed or moved
+// between the texture and flat lists, in which case the lists need rebuilding
+// -----------------------------------------------------------------------------
+bool MapTextureManager::updateTexInfo(const std::set<string>& names)
+{
+	if (names.empty())
+		return true;
+
+	// Update listed textures
+	std::set<string> listed;
+	for (auto* list : { &tex_info_, &flat_info_ })
+	{
+		for (auto& info : *list)
+		{
+			if (info.category == Category::Tx || info.category == Category::None)
+				continue;
+
+			auto name = strutil::upper(info.long_name);
+			if (names.count(name) == 0)
+				continue;
+
+			auto* tex = app::resources().getArchiveTexture(name, info.archive);
+			if (!tex)
+				return false;
+
+			Category category;
+			bool     flat;
+			if (!compositeCategory(*tex, category, flat) || category != info.category
+				|| flat != (list == &flat_info_))
+				return false;
+
+			info.index = compositeIndex(*tex);
+			listed.insert(name);
+		}
+	}
+
+	// Check for composite textures that should be listed but aren't yet
+	for (const auto& name : names)
+	{
+		if (listed.count(name) > 0)
+			continue;
+
+		Category category;
+		bool     flat;
+		auto*    tex = app::resources().getTexture(name);
+		if (tex && compositeCategory(*tex, category, flat))
+			return false;
+	}
+
+	return true;
+}
+
 // -----------------------------------------------------------------------------
 // Sets the current archive to [archive], and refreshes all resources
 // -----------------------------------------------------------------------------
@@ -7,6 +7,7 @@ namespace slade
 class ArchiveDir;
 class Archive;
 class Palette;
+struct ResourceChanges;
 
 class MapTextureManager
 {
@@ -62,6 +63,7 @@ public:
 	void init();
 	void setArchive(shared_ptr<Archive> archive);
 	void refreshResources();
+	void refreshResources(const ResourceChanges& changes);
 	void buildTexInfoList();
 
 	Palette*       resourcePalette() const;
@@ -90,5 +92,6 @@ private:
 	sigslot::scoped_connection sc_palette_changed_;
 
 	void importEditorImages(MapTexHashMap& map, ArchiveDir* dir, string_view path) const;
+	bool updateTexInfo(const std::set<string>& names);
 };
 } // namespace slade
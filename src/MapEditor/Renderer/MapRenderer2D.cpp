@@ -42,6 +42,7 @@
 #include "OpenGL/Drawing.h"
 #include "OpenGL/GLTexture.h"
 #include "OpenGL/OpenGL.h"
+#include "SLADEMap/MapSpatialIndex.h"
 #include "SLADEMap/SLADEMap.h"
 #include "Utility/Polygon2D.h"
 
@@ -84,6 +85,47 @@ namespace
 {
 // Texture coordinates for rendering square things (since we can't just rotate these)
 float sq_thing_tc[] = { 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f };
+
+constexpr double LINE_TILE_SIZE = 1024.;
+} // namespace
+
+
+// -----------------------------------------------------------------------------
+//
+// Functions
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// -----------------------------------------------------------------------------
+// Returns true if bounding boxes [a] and [b] overlap
+// -----------------------------------------------------------------------------
+bool bboxOverlaps(const BBox& a, const BBox& b)
+{
+	return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y;
+}
+
+// -----------------------------------------------------------------------------
+// Extends [bbox] to include [point]. Unlike BBox::extend, this doesn't treat a
+// box at the origin as being reset
+// -----------------------------------------------------------------------------
+void bboxInclude(BBox& bbox, Vec2d point)
+{
+	bbox.min.x = std::min(bbox.min.x, point.x);
+	bbox.min.y = std::min(bbox.min.y, point.y);
+	bbox.max.x = std::max(bbox.max.x, point.x);
+	bbox.max.y = std::max(bbox.max.y, point.y);
+}
+
+// -----------------------------------------------------------------------------
+// Returns the key of the line tile containing [point]
+// -----------------------------------------------------------------------------
+i64 lineTileKey(Vec2d point)
+{
+	auto x = static_cast<int>(std::floor(std::clamp(point.x / LINE_TILE_SIZE, -1e9, 1e9)));
+	auto y = static_cast<int>(std::floor(std::clamp(point.y / LINE_TILE_SIZE, -1e9, 1e9)));
+	return static_cast<i64>(static_cast<u64>(static_cast<u32>(x)) << 32 | static_cast<u32>(y));
+}
 } // namespace
 
 
@@ -486,10 +528,34 @@ void MapRenderer2D::renderLinesVBO(bool show_direction, float alpha)
 	glColorPointer(4, GL_FLOAT, 24, ((char*)nullptr + 8));
 
 	// Render the VBO
-	if (show_direction)
-		glDrawArrays(GL_LINES, 0, map_->nLines() * 4);
+	int vpl = show_direction ? 4 : 2;
+	if (!view_set_)
+		glDrawArrays(GL_LINES, 0, map_->nLines() * vpl);
 	else
-		glDrawArrays(GL_LINES, 0, map_->nLines() * 2);
+	{
+		// Only draw the tiles overlapping the view, merging adjacent tiles
+		// into a single draw call
+		unsigned first = 0;
+		unsigned count = 0;
+		for (const auto& tile : line_tiles_)
+		{
+			if (tile.count == 0 || !bboxOverlaps(tile.bounds, view_bounds_))
+				continue;
+
+			if (count > 0 && tile.first == first + count)
+			{
+				count += tile.count;
+				continue;
+			}
+
+			if (count > 0)
+				glDrawArrays(GL_LINES, first * vpl, count * vpl);
+			first = tile.first;
+			count = tile.count;
+		}
+		if (count > 0)
+			glDrawArrays(GL_LINES, first * vpl, count * vpl);
+	}
 
 	// Clean state
 	glDisableClientState(GL_VERTEX_ARRAY);
@@ -1248,11 +1314,8 @@ void MapRenderer2D::renderThingsImmediate(float alpha)
 				point = true;
 			}
 
-			for (unsigned a = 0; a < map_->nThings(); a++)
+			for (auto a : vis_things_)
 			{
-				if (vis_t_[a] > 0)
-					continue;
-
 				// No shadow if filtered
 				thing = map_->thing(a);
 				if (thing->isFiltered())
@@ -1303,11 +1366,8 @@ void MapRenderer2D::renderThingsImmediate(float alpha)
 
 	// Draw things
 	double talpha;
-	for (unsigned a = 0; a < map_->nThings(); a++)
+	for (auto a : vis_things_)
 	{
-		if (vis_t_[a] > 0)
-			continue;
-
 		// Get thing info
 		thing = map_->thing(a);
 		x     = thing->xPos();
@@ -1356,11 +1416,8 @@ void MapRenderer2D::renderThingsImmediate(float alpha)
 	{
 		glEnable(GL_TEXTURE_2D);
 
-		for (unsigned a = 0; a < map_->nThings(); a++)
+		for (auto a : vis_things_)
 		{
-			if (vis_t_[a] > 0)
-				continue;
-
 			// Get thing info
 			thing    = map_->thing(a);
 			auto& tt = game::configuration().thingType(thing->type());
@@ -1995,14 +2052,10 @@ void MapRenderer2D::renderFlatsImmediate(int type, bool texture, float alpha)
 	// Go through sectors
 	unsigned tex_last = 0;
 	unsigned tex      = 0;
-	for (unsigned a = 0; a < map_->nSectors(); a++)
+	for (auto a : vis_sectors_)
 	{
 		auto sector = map_->sector(a);
 
-		// Skip if sector is out of view
-		if (vis_s_[a] > 0)
-			continue;
-
 		const MapTextureManager::Texture* map_tex_props = nullptr;
 		if (texture)
 		{
@@ -2131,8 +2184,10 @@ void MapRenderer2D::renderFlatsVBO(int type, bool texture, float alpha)
 		last_flat_type_ = type;
 	}
 
-	// First, check if any polygon vertex data has changed (in this case we need to refresh the entire vbo)
-	for (unsigned a = 0; a < map_->nSectors(); a++)
+	// First, check if any visible polygon vertex data has changed (in this case
+	// we need to refresh the entire vbo). Polygons out of view keep their
+	// existing data in the vbo until they come into view
+	for (auto a : vis_sectors_)
 	{
 		auto poly = map_->sector(a)->polygon();
 		if (poly && poly->vboUpdate() > 1)
@@ -2162,14 +2217,10 @@ void MapRenderer2D::renderFlatsVBO(int type, bool texture, float alpha)
 	unsigned tex      = 0;
 	bool     first    = true;
 	unsigned update   = 0;
-	for (unsigned a = 0; a < map_->nSectors(); a++)
+	for (auto a : vis_sectors_)
 	{
 		auto sector = map_->sector(a);
 
-		// Skip if sector is out of view
-		if (vis_s_[a] > 0)
-			continue;
-
 		first                                           = false;
 		const MapTextureManager::Texture* map_tex_props = nullptr;
 		if (texture)
@@ -3051,25 +3102,75 @@ void MapRenderer2D::updateLinesVBO(bool show_direction, float base_alpha)
 	if (show_direction)
 		vpl = 4;
 
+	// Sort lines into tiles by their midpoint. Lines too long to fit within a
+	// tile all go in the first tile, which is kept separate
+	auto             n_lines = map_->nLines();
+	vector<unsigned> line_tile(n_lines);
+	std::unordered_map<i64, unsigned> tile_keys;
+	line_tiles_.clear();
+	line_tiles_.emplace_back();
+	for (unsigned a = 0; a < n_lines; a++)
+	{
+		auto line = map_->line(a);
+		if (std::abs(line->x2() - line->x1()) > LINE_TILE_SIZE || std::abs(line->y2() - line->y1()) > LINE_TILE_SIZE)
+		{
+			line_tile[a] = 0;
+			line_tiles_[0].count++;
+			continue;
+		}
+
+		auto key  = lineTileKey(line->getPoint(MapObject::Point::Mid));
+		auto tile = tile_keys.find(key);
+		if (tile == tile_keys.end())
+		{
+			tile = tile_keys.emplace(key, line_tiles_.size()).first;
+			line_tiles_.emplace_back();
+		}
+		line_tile[a] = tile->second;
+		line_tiles_[tile->second].count++;
+	}
+
+	// Determine where each tile starts in the VBO
+	unsigned first = 0;
+	for (auto& tile : line_tiles_)
+	{
+		tile.first = first;
+		first += tile.count;
+		tile.count = 0;
+	}
+
 	// Fill lines VBO
-	int            nverts = map_->nLines() * vpl;
+	int            nverts = n_lines * vpl;
 	vector<GLVert> lines(nverts);
-	unsigned       v = 0;
 	ColRGBA        col;
 	float          alpha;
-	for (unsigned a = 0; a < map_->nLines(); a++)
+	for (unsigned a = 0; a < n_lines; a++)
 	{
-		auto line = map_->line(a);
+		auto  line = map_->line(a);
+		auto& tile = line_tiles_[line_tile[a]];
+		auto  v    = (tile.first + tile.count) * vpl;
+
+		// Update tile bounds
+		Vec2d v1{ line->x1(), line->y1() };
+		Vec2d v2{ line->x2(), line->y2() };
+		if (tile.count == 0)
+		{
+			tile.bounds.min = v1;
+			tile.bounds.max = v1;
+		}
+		bboxInclude(tile.bounds, v1);
+		bboxInclude(tile.bounds, v2);
+		tile.count++;
 
 		// Get line colour
 		col   = lineColour(line);
 		alpha = base_alpha * col.fa();
 
 		// Set line vertices
-		lines[v].x     = line->v1()->xPos();
-		lines[v].y     = line->v1()->yPos();
-		lines[v + 1].x = line->v2()->xPos();
-		lines[v + 1].y = line->v2()->yPos();
+		lines[v].x     = v1.x;
+		lines[v].y     = v1.y;
+		lines[v + 1].x = v2.x;
+		lines[v + 1].y = v2.y;
 
 		// Set line colour(s)
 		lines[v].r = lines[v + 1].r = col.fr();
@@ -3086,6 +3187,7 @@ void MapRenderer2D::updateLinesVBO(bool show_direction, float base_alpha)
 			lines[v + 2].y = mid.y;
 			lines[v + 3].x = tab.x;
 			lines[v + 3].y = tab.y;
+			bboxInclude(tile.bounds, tab);
 
 			// Colours
 			lines[v + 2].r = lines[v + 3].r = col.fr();
@@ -3093,9 +3195,6 @@ void MapRenderer2D::updateLinesVBO(bool show_direction, float base_alpha)
 			lines[v + 2].b = lines[v + 3].b = col.fb();
 			lines[v + 2].a = lines[v + 3].a = alpha * 0.6f;
 		}
-
-		// Next line
-		v += vpl;
 	}
 	glBindBuffer(GL_ARRAY_BUFFER, vbo_lines_);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(GLVert) * nverts, lines.data(), GL_STATIC_DRAW);
@@ -3103,7 +3202,7 @@ void MapRenderer2D::updateLinesVBO(bool show_direction, float base_alpha)
 	// Clean up
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-	n_lines_       = map_->nLines();
+	n_lines_       = n_lines;
 	lines_updated_ = app::runTimer();
 }
 
@@ -3152,61 +3251,136 @@ void MapRenderer2D::updateFlatsVBO()
 // -----------------------------------------------------------------------------
 void MapRenderer2D::updateVisibility(Vec2d view_tl, Vec2d view_br)
 {
-	// Sector visibility
+	view_bounds_.min.set(std::min(view_tl.x, view_br.x), std::min(view_tl.y, view_br.y));
+	view_bounds_.max.set(std::max(view_tl.x, view_br.x), std::max(view_tl.y, view_br.y));
+	view_set_ = true;
+
+	// Reset visibility arrays if the number of sectors/things changed,
+	// otherwise just reset the objects checked last time
 	if (map_->nSectors() != vis_s_.size())
-	{
-		// Number of sectors changed, reset array
-		vis_s_.clear();
-		for (unsigned a = 0; a < map_->nSectors(); a++)
-			vis_s_.push_back(0);
-	}
-	for (unsigned a = 0; a < map_->nSectors(); a++)
-	{
-		// Check against sector bounding box
-		auto bbox = map_->sector(a)->boundingBox();
-		vis_s_[a] = 0;
-		if (bbox.max.x < view_tl.x)
-			vis_s_[a] = VIS_LEFT;
-		if (bbox.max.y < view_tl.y)
-			vis_s_[a] = VIS_ABOVE;
-		if (bbox.min.x > view_br.x)
-			vis_s_[a] = VIS_RIGHT;
-		if (bbox.min.y > view_br.y)
-			vis_s_[a] = VIS_BELOW;
+		vis_s_.assign(map_->nSectors(), VIS_OUT);
+	else
+		for (auto index : vis_sectors_checked_)
+			vis_s_[index] = VIS_OUT;
+	if (map_->nThings() != vis_t_.size())
+		vis_t_.assign(map_->nThings(), VIS_OUT);
+	else
+		for (auto index : vis_things_checked_)
+			vis_t_[index] = VIS_OUT;
 
-		// Check if the sector is worth drawing
-		if ((bbox.max.x - bbox.min.x) * view_scale_ < 4 || (bbox.max.y - bbox.min.y) * view_scale_ < 4)
-			vis_s_[a] = VIS_SMALL;
-	}
+	vis_sectors_.clear();
+	vis_things_.clear();
+	vis_sectors_checked_.clear();
+	vis_things_checked_.clear();
 
-	// Thing visibility
-	if (map_->nThings() != vis_t_.size())
+	// Without the spatial index, check everything
+	if (!MapSpatialIndex::enabled())
 	{
-		// Number of things changed, reset array
-		vis_t_.clear();
+		for (unsigned a = 0; a < map_->nSectors(); a++)
+			checkSectorVisibility(a, view_bounds_);
 		for (unsigned a = 0; a < map_->nThings(); a++)
-			vis_t_.push_back(0);
+			checkThingVisibility(a, view_bounds_);
+
+		return;
 	}
-	double x, y;
-	double radius;
-	for (unsigned a = 0; a < vis_t_.size(); a++)
-	{
-		vis_t_[a] = 0;
-		x         = map_->thing(a)->xPos();
-		y         = map_->thing(a)->yPos();
 
-		// Get thing type properties from game configuration
-		auto& tt = game::configuration().thingType(map_->thing(a)->type());
-		radius   = tt.radius() * 1.3;
+	// Sector visibility
+	auto& index = map_->spatialIndex();
+	for (auto sector : index.sectorsIn(view_bounds_))
+		checkSectorVisibility(sector->index(), view_bounds_);
+
+	// Thing visibility (expand the view by the largest thing radius to
+	// include things positioned just outside it)
+	auto radius = thingRadiusMax() * 1.3;
+	auto area   = view_bounds_;
+	area.min.x -= radius;
+	area.min.y -= radius;
+	area.max.x += radius;
+	area.max.y += radius;
+	for (auto thing : index.thingsIn(area))
+		checkThingVisibility(thing->index(), view_bounds_);
+}
+
+// -----------------------------------------------------------------------------
+// Updates visibility info for the sector at [index] within [view]
+// -----------------------------------------------------------------------------
+void MapRenderer2D::checkSectorVisibility(unsigned index, const BBox& view)
+{
+	vis_sectors_checked_.push_back(index);
+
+	// Check against sector bounding box
+	auto bbox     = map_->sector(index)->boundingBox();
+	vis_s_[index] = 0;
+	if (bbox.max.x < view.min.x)
+		vis_s_[index] = VIS_LEFT;
+	if (bbox.max.y < view.min.y)
+		vis_s_[index] = VIS_ABOVE;
+	if (bbox.min.x > view.max.x)
+		vis_s_[index] = VIS_RIGHT;
+	if (bbox.min.y > view.max.y)
+		vis_s_[index] = VIS_BELOW;
+
+	// Check if the sector is worth drawing
+	if ((bbox.max.x - bbox.min.x) * view_scale_ < 4 || (bbox.max.y - bbox.min.y) * view_scale_ < 4)
+		vis_s_[index] = VIS_SMALL;
+
+	if (vis_s_[index] == 0)
+		vis_sectors_.push_back(index);
+}
 
-		// Ignore if outside of screen
-		if (x + radius < view_tl.x || x - radius > view_br.x || y + radius < view_tl.y || y - radius > view_br.y)
-			vis_t_[a] = 1;
+// -----------------------------------------------------------------------------
+// Updates visibility info for the thing at [index] within [view]
+// -----------------------------------------------------------------------------
+void MapRenderer2D::checkThingVisibility(unsigned index, const BBox& view)
+{
+	vis_things_checked_.push_back(index);
 
-		// Check if the thing is worth drawing
-		else if (radius * view_scale_ < 2)
-			vis_t_[a] = VIS_SMALL;
-	}
+	auto thing    = map_->thing(index);
+	auto x        = thing->xPos();
+	auto y        = thing->yPos();
+	auto radius   = thingRadius(thing->type()) * 1.3;
+	vis_t_[index] = 0;
+
+	// Ignore if outside of screen
+	if (x + radius < view.min.x || x - radius > view.max.x || y + radius < view.min.y || y - radius > view.max.y)
+		vis_t_[index] = 1;
+
+	// Check if the thing is worth drawing
+	else if (radius * view_scale_ < 2)
+		vis_t_[index] = VIS_SMALL;
+
+	if (vis_t_[index] == 0)
+		vis_things_.push_back(index);
+}
+
+// -----------------------------------------------------------------------------
+// Returns the radius of thing [type], from the game configuration
+// -----------------------------------------------------------------------------
+double MapRenderer2D::thingRadius(int type)
+{
+	auto cached = thing_radius_.find(type);
+	if (cached != thing_radius_.end())
+		return cached->second;
+
+	double radius       = game::configuration().thingType(type).radius();
+	thing_radius_[type] = radius;
+	return radius;
+}
+
+// -----------------------------------------------------------------------------
+// Returns the largest radius of any thing type in the game configuration
+// -----------------------------------------------------------------------------
+double MapRenderer2D::thingRadiusMax()
+{
+	if (thing_radius_max_ >= 0.)
+		return thing_radius_max_;
+
+	thing_radius_max_ = game::ThingType::unknown().radius();
+	for (const auto& type : game::configuration().allThingTypes())
+		if (type.second.defined())
+			thing_radius_max_ = std::max<double>(thing_radius_max_, type.second.radius());
+
+	return thing_radius_max_;
 }
 
 // -----------------------------------------------------------------------------
@@ -3219,6 +3393,8 @@ void MapRenderer2D::forceUpdate(float line_alpha)
 	tex_flats_.clear();
 	thing_sprites_.clear();
 	thing_paths_.clear();
+	thing_radius_.clear();
+	thing_radius_max_ = -1.;
 
 	if (gl::vboSupport())
 	{
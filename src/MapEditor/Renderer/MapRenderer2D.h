@@ -3,6 +3,7 @@
 #include "MapEditor/MapEditor.h"
 #include "SLADEMap/MapObject/MapObject.h"
 #include "Utility/Colour.h"
+#include <unordered_map>
 
 namespace slade
 {
@@ -134,6 +135,9 @@ public:
 	bool   visOK() const;
 	void   clearTextureCache() { tex_flats_.clear(); }
 
+	const vector<unsigned>& visibleSectors() const { return vis_sectors_; }
+	const vector<unsigned>& visibleThings() const { return vis_things_; }
+
 private:
 	SLADEMap* map_ = nullptr;
 	// unsigned  tex_last_         = 0;
@@ -158,11 +162,32 @@ private:
 		VIS_ABOVE = 4,
 		VIS_BELOW = 8,
 		VIS_SMALL = 16,
+		VIS_OUT   = 32, // Outside the view (not checked in detail)
+	};
+	vector<uint8_t>  vis_v_;
+	vector<uint8_t>  vis_l_;
+	vector<uint8_t>  vis_t_;
+	vector<uint8_t>  vis_s_;
+	vector<unsigned> vis_sectors_;         // Indices of sectors to draw, sorted
+	vector<unsigned> vis_things_;          // Indices of things to draw, sorted
+	vector<unsigned> vis_sectors_checked_; // Indices of sectors checked in the last update
+	vector<unsigned> vis_things_checked_;  // Indices of things checked in the last update
+	BBox             view_bounds_;
+	bool             view_set_ = false;
+
+	// Lines VBO tiles. The lines VBO is ordered by tile so that the lines
+	// within view can be drawn as a few contiguous ranges
+	struct LineTile
+	{
+		BBox     bounds;
+		unsigned first = 0; // First line in the VBO
+		unsigned count = 0;
 	};
-	vector<uint8_t> vis_v_;
-	vector<uint8_t> vis_l_;
-	vector<uint8_t> vis_t_;
-	vector<uint8_t> vis_s_;
+	vector<LineTile> line_tiles_;
+
+	// Thing type radius cache
+	std::unordered_map<int, double> thing_radius_;
+	double                          thing_radius_max_ = -1.;
 
 	// Structs
 	struct GLVert
@@ -206,5 +231,10 @@ private:
 	};
 	vector<ThingPath> thing_paths_;
 	long              thing_paths_updated_ = 0;
+
+	void   checkSectorVisibility(unsigned index, const BBox& view);
+	void   checkThingVisibility(unsigned index, const BBox& view);
+	double thingRadius(int type);
+	double thingRadiusMax();
 };
 } // namespace slade
@@ -45,6 +45,7 @@
 #include "UI/Controls/PaletteChooser.h"
 #include "Utility/MathStuff.h"
 #include "Utility/StringUtils.h"
+#include <numeric>
 
 using namespace slade;
 
@@ -474,6 +475,8 @@ void MapRenderer3D::setupView(int width, int height)
 	// Calculate aspect ratio
 	float aspect = (1.6f / 1.333333f) * ((float)width / (float)height);
 	float fovy   = 2 * math::radToDeg(atan(tan(math::degToRad(render_fov) / 2) / aspect));
+	fov_h_       = math::degToRad(render_fov) * 0.5;
+	fov_v_       = math::degToRad(fovy) * 0.5;
 
 	// Setup projection
 	glMatrixMode(GL_PROJECTION);
@@ -619,6 +622,10 @@ void MapRenderer3D::renderMap()
 	// Build lists of quads and flats to render
 	checkVisibleFlats();
 	checkVisibleQuads();
+	auto& stats       = frame_stats_[frame_stats_next_];
+	stats.vis_time    = clock.getElapsedTime().asMicroseconds() / 1000.f;
+	stats.vis_sectors = vis_sectors_.size();
+	stats.vis_lines   = vis_lines_.size();
 
 	// Render sky
 	if (render_3d_sky)
@@ -652,6 +659,10 @@ void MapRenderer3D::renderMap()
 	// Render transparent stuff
 	renderTransparentWalls();
 
+	// Record frame time
+	stats.time        = clock.getElapsedTime().asMicroseconds() / 1000.f;
+	frame_stats_next_ = (frame_stats_next_ + 1) % FRAME_HISTORY;
+
 	// Check elapsed time
 	if (render_max_dist_adaptive)
 	{
@@ -2599,17 +2610,61 @@ void MapRenderer3D::updateFlatsVBO()
 void MapRenderer3D::updateWallsVBO() const {}
 
 // -----------------------------------------------------------------------------
-// Runs a quick check of all sector bounding boxes against the current view to
-// hide any that are outside it
+// Determines which sectors and lines are potentially visible from the camera.
+// If the camera is within a sector, this floods out through the portal graph
+// from it, otherwise it runs a quick check of all sector bounding boxes
+// against the current view to hide any that are outside it
 // -----------------------------------------------------------------------------
 void MapRenderer3D::quickVisDiscard()
 {
-	// Create sector distance array if needed
-	if (dist_sectors_.size() != map_->nSectors())
-		dist_sectors_.resize(map_->nSectors());
+	// Rebuild the portal graph if the map geometry has changed, and reset
+	// everything to invisible if anything was resized or re-indexed
+	bool reset = visibility_.update();
+	if (dist_sectors_.size() != map_->nSectors() || vis_n_lines_ != lines_.size() || reset)
+	{
+		dist_sectors_.assign(map_->nSectors(), -1.0f);
+		for (auto& line : lines_)
+			line.visible = false;
+		vis_n_lines_ = lines_.size();
+		vis_sectors_.clear();
+		vis_lines_.clear();
+	}
+
+	// Hide everything visible last frame
+	for (auto index : vis_sectors_)
+		dist_sectors_[index] = -1.0f;
+	for (auto index : vis_lines_)
+		lines_[index].visible = false;
+
+	// Flood from the camera sector through the portal graph
+	auto cam = cam_position_.get2d();
+	if (MapVisibility3D::enabled())
+	{
+		MapVisibility3D::View view;
+		view.position  = cam;
+		view.direction = cam_direction_;
+		view.pitch     = cam_pitch_;
+		view.fov_h     = fov_h_;
+		view.fov_v     = fov_v_;
+		view.max_dist  = render_max_dist;
+		vis_portal_    = visibility_.flood(view);
+	}
+	else
+		vis_portal_ = false;
+
+	if (vis_portal_)
+	{
+		vis_sectors_ = visibility_.visibleSectors();
+		vis_lines_   = visibility_.visibleLines();
+		for (auto index : vis_sectors_)
+			dist_sectors_[index] = 0.0f;
+		for (auto index : vis_lines_)
+			lines_[index].visible = true;
+
+		return;
+	}
 
-	// Go through all sectors
-	auto   cam = cam_position_.get2d();
+	// Camera is outside the map, go through all sectors
 	double min_dist, dist;
 	Seg2d  strafe(cam, cam + cam_strafe_.get2d());
 	for (unsigned a = 0; a < map_->nSectors(); a++)
@@ -2666,6 +2721,12 @@ void MapRenderer3D::quickVisDiscard()
 		else
 			lines_[map_->side(a)->parentLine()->index()].visible = true;
 	}
+
+	// All sectors and lines need checking
+	vis_sectors_.resize(map_->nSectors());
+	std::iota(vis_sectors_.begin(), vis_sectors_.end(), 0);
+	vis_lines_.resize(lines_.size());
+	std::iota(vis_lines_.begin(), vis_lines_.end(), 0);
 }
 
 // -----------------------------------------------------------------------------
@@ -2699,7 +2760,7 @@ void MapRenderer3D::checkVisibleQuads()
 	unsigned updates = 0;
 	bool     update  = false;
 	Seg2d    strafe(cam_position_.get2d(), (cam_position_ + cam_strafe_).get2d());
-	for (unsigned a = 0; a < lines_.size(); a++)
+	for (auto a : vis_lines_)
 	{
 		line = map_->line(a);
 
@@ -2781,7 +2842,7 @@ void MapRenderer3D::checkVisibleFlats()
 	n_flats_ = 0;
 	float alpha;
 	auto  cam = cam_position_.get2d();
-	for (unsigned a = 0; a < map_->nSectors(); a++)
+	for (auto a : vis_sectors_)
 	{
 		sector = map_->sector(a);
 
@@ -2818,7 +2879,7 @@ void MapRenderer3D::checkVisibleFlats()
 		// Add floor flat
 		flats_[n_flats_++] = &(floors_[a]);
 	}
-	for (unsigned a = 0; a < map_->nSectors(); a++)
+	for (auto a : vis_sectors_)
 	{
 		// Skip if invisible
 		if (dist_sectors_[a] < 0)
@@ -2844,13 +2905,12 @@ mapeditor::Item MapRenderer3D::determineHilight()
 		|| things_.size() != map_->nThings())
 		return current;
 
-	// Check lines
+	// Checks line [a] for the closest hit
 	double height, dist;
-	for (unsigned a = 0; a < map_->nLines(); a++)
-	{
+	auto   check_line = [&](unsigned a) {
 		// Ignore if not visible
 		if (!lines_[a].visible)
-			continue;
+			return;
 
 		auto line = map_->line(a);
 
@@ -2860,7 +2920,7 @@ mapeditor::Item MapRenderer3D::determineHilight()
 
 		// Ignore if no intersection or something was closer
 		if (dist < 0 || dist >= min_dist)
-			continue;
+			return;
 
 		// Find quad intersect if any
 		auto intersection = cam_position_ + cam_dir3d_ * dist;
@@ -2903,14 +2963,13 @@ mapeditor::Item MapRenderer3D::determineHilight()
 				min_dist = dist;
 			}
 		}
-	}
+	};
 
-	// Check sectors
-	for (unsigned a = 0; a < map_->nSectors(); a++)
-	{
+	// Checks the floor and ceiling of sector [a] for the closest hit
+	auto check_sector = [&](unsigned a) {
 		// Ignore if not visible
 		if (dist_sectors_[a] < 0)
-			continue;
+			return;
 
 		// Check distance to floor plane
 		dist = math::distanceRayPlane(cam_position_, cam_dir3d_, floors_[a].plane);
@@ -2945,6 +3004,27 @@ mapeditor::Item MapRenderer3D::determineHilight()
 				}
 			}
 		}
+	};
+
+	if (vis_portal_)
+	{
+		// Walk the sectors along the view ray through the portal graph,
+		// checking each sector's lines and flats until the closest hit is
+		// found
+		visibility_.traceRay(cam_position_.get2d(), cam_dir3d_.get2d(), [&](unsigned sector) {
+			for (auto line : visibility_.sectorLines(sector))
+				check_line(line);
+			check_sector(sector);
+			return min_dist;
+		});
+	}
+	else
+	{
+		// Check all lines and sectors
+		for (unsigned a = 0; a < map_->nLines(); a++)
+			check_line(a);
+		for (unsigned a = 0; a < map_->nSectors(); a++)
+			check_sector(a);
 	}
 
 	// Update item distance
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "MapEditor/Edit/Edit3D.h"
+#include "MapVisibility3D.h"
 #include "SLADEMap/SLADEMap.h"
 
 namespace slade
@@ -73,6 +74,13 @@ public:
 		unsigned               sprite       = 0;
 		long                   updated_time = 0;
 	};
+	struct FrameStats
+	{
+		float    time        = 0.f; // Total render time (ms)
+		float    vis_time    = 0.f; // Visibility checking time (ms)
+		unsigned vis_sectors = 0;
+		unsigned vis_lines   = 0;
+	};
 	struct Flat
 	{
 		uint8_t    flags = 0;
@@ -98,6 +106,14 @@ public:
 	void enableHilight(bool render) { render_hilight_ = render; }
 	void enableSelection(bool render) { render_selection_ = render; }
 
+	// Frame stats for the last FRAME_HISTORY frames, oldest first
+	static constexpr unsigned FRAME_HISTORY = 120;
+	const FrameStats&         frameStats(unsigned index) const
+	{
+		return frame_stats_[(frame_stats_next_ + index) % FRAME_HISTORY];
+	}
+	double visBuildTime() const { return visibility_.buildTime(); }
+
 	bool init();
 	void refresh();
 	void refreshTextures();
@@ -196,7 +212,18 @@ private:
 	float     fog_depth_last_ = 0.f;
 
 	// Visibility
-	vector<float> dist_sectors_;
+	vector<float>    dist_sectors_;
+	MapVisibility3D  visibility_{ map_ };
+	bool             vis_portal_  = false; // True if the portal graph was used for the current frame
+	unsigned         vis_n_lines_ = 0;
+	vector<unsigned> vis_sectors_;
+	vector<unsigned> vis_lines_;
+	double           fov_h_ = 0.; // Horizontal/vertical view half-angles (radians)
+	double           fov_v_ = 0.;
+
+	// Frame stats
+	FrameStats frame_stats_[FRAME_HISTORY];
+	unsigned   frame_stats_next_ = 0;
 
 	// Camera
 	Vec3d  cam_position_;
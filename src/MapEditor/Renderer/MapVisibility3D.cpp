@@ -0,0 +1,388 @@
+
+// -----------------------------------------------------------------------------
+// SLADE - It's a Doom Editor
+// Copyright(C) 2008 - 2020 Simon Judd
+//
+// Email:       sirjuddington@gmail.com
+// Web:         http://slade.mancubus.net
+// Filename:    MapVisibility3D.cpp
+// Description: MapVisibility3D class - a sector-portal graph used to determine
+//              potentially visible sectors and lines in the 3d view, and to
+//              walk sectors along a ray for hilighting
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation; either version 2 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+//
+// Includes
+//
+// -----------------------------------------------------------------------------
+#include "Main.h"
+#include "MapVisibility3D.h"
+#include "App.h"
+#include "SLADEMap/SLADEMap.h"
+#include "Utility/MathStuff.h"
+#include <queue>
+
+using namespace slade;
+
+
+// -----------------------------------------------------------------------------
+//
+// Variables
+//
+// -----------------------------------------------------------------------------
+CVAR(Bool, render_3d_portal_vis, true, CVar::Flag::Save)
+
+namespace
+{
+constexpr double   NEAR_DIST    = 0.1;  // Portals are clipped to this distance in front of the camera
+constexpr double   ON_PORTAL    = 1.0;  // Portals closer than this to the camera don't narrow the view
+constexpr double   ANGLE_MARGIN = 0.05; // Extra view angle (radians) to allow for rounding
+constexpr unsigned MAX_VISITS   = 16;   // Max times a sector's view range can be widened
+} // namespace
+
+
+// -----------------------------------------------------------------------------
+//
+// Functions
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// -----------------------------------------------------------------------------
+// Returns the dot product of [v1] and [v2]
+// -----------------------------------------------------------------------------
+double dot(Vec2d v1, Vec2d v2)
+{
+	return v1.x * v2.x + v1.y * v2.y;
+}
+
+// -----------------------------------------------------------------------------
+// Returns the angle of [point] from [view] position, relative to the view
+// direction (positive is to the left)
+// -----------------------------------------------------------------------------
+double viewAngle(const MapVisibility3D::View& view, Vec2d point)
+{
+	auto v = point - view.position;
+	return std::atan2(view.direction.x * v.y - view.direction.y * v.x, dot(view.direction, v));
+}
+} // namespace
+
+
+// -----------------------------------------------------------------------------
+//
+// MapVisibility3D Class Functions
+//
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+// Rebuilds the portal graph if the map geometry has changed since it was last
+// built. Returns true if it was rebuilt
+// -----------------------------------------------------------------------------
+bool MapVisibility3D::update()
+{
+	if (map_->geometryUpdated() < built_ && map_->nSectors() == n_sectors_ && map_->nLines() == n_lines_
+		&& map_->nSides() == n_sides_)
+		return false;
+
+	build();
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Determines the potentially visible sectors and lines from [view], by
+// flooding out through open portals from the sector the view is in.
+// Returns false if the view isn't within any sector, in which case the
+// results are left empty
+// -----------------------------------------------------------------------------
+bool MapVisibility3D::flood(const View& view)
+{
+	visible_sectors_.clear();
+	visible_lines_.clear();
+
+	auto start = map_->sectors().atPos(view.position);
+	if (!start)
+		return false;
+
+	nextStamp();
+
+	// Determine the horizontal view range. When pitched up or down, the
+	// corners of the view frustum are further to either side, and if it
+	// covers more than 180 degrees everything around the camera is checked
+	Window full{ -math::PI, math::PI };
+	auto   pitch       = std::abs(view.pitch) + view.fov_v;
+	bool   full_window = pitch >= math::PI * 0.5 - ANGLE_MARGIN;
+	if (!full_window)
+	{
+		auto half   = std::atan(std::tan(view.fov_h) / std::cos(pitch)) + ANGLE_MARGIN;
+		full_window = half >= math::PI * 0.5;
+		full        = { -half, half };
+	}
+
+	// Flood through portals
+	std::queue<unsigned> queue;
+	auto                 visit = [&](unsigned sector, const Window& window) {
+		if (sector_stamp_[sector] != stamp_)
+		{
+			sector_stamp_[sector]  = stamp_;
+			sector_window_[sector] = window;
+			sector_visits_[sector] = 0;
+			visible_sectors_.push_back(sector);
+			queue.push(sector);
+			return;
+		}
+
+		// Already visited, widen the view range if needed and process the
+		// sector again
+		auto& current = sector_window_[sector];
+		if (full_window || (window.min >= current.min && window.max <= current.max))
+			return;
+		if (++sector_visits_[sector] > MAX_VISITS)
+			current = full;
+		else
+			current = { std::min(current.min, window.min), std::max(current.max, window.max) };
+		queue.push(sector);
+	};
+	visit(start->index(), full);
+	while (!queue.empty())
+	{
+		auto sector = queue.front();
+		queue.pop();
+		auto window = sector_window_[sector];
+
+		for (auto index : sectorLines(sector))
+		{
+			auto& line = lines_[index];
+			if (line_stamp_[index] != stamp_)
+			{
+				line_stamp_[index] = stamp_;
+				visible_lines_.push_back(index);
+			}
+
+			// Check for a portal into another sector
+			int other = line.front == static_cast<int>(sector) ? line.back : line.front;
+			if (other < 0 || other == static_cast<int>(sector))
+				continue;
+
+			// Check distance
+			double dist = math::distanceToLine(view.position, { line.start, line.end });
+			if (view.max_dist > 0 && dist > view.max_dist)
+				continue;
+
+			// Check the portal isn't closed
+			if (!portalOpen(line))
+				continue;
+
+			// Any portal is visible if the view range is unrestricted, or
+			// if the camera is (near enough) on it
+			if (full_window || dist < ON_PORTAL)
+			{
+				visit(other, window);
+				continue;
+			}
+
+			// Clip portal to the front of the camera
+			auto   p1 = line.start;
+			auto   p2 = line.end;
+			double d1 = dot(view.direction, p1 - view.position);
+			double d2 = dot(view.direction, p2 - view.position);
+			if (d1 < NEAR_DIST && d2 < NEAR_DIST)
+				continue;
+			if (d1 < NEAR_DIST)
+				p1 = p1 + (p2 - p1) * ((NEAR_DIST - d1) / (d2 - d1));
+			else if (d2 < NEAR_DIST)
+				p2 = p2 + (p1 - p2) * ((NEAR_DIST - d2) / (d1 - d2));
+
+			// Narrow the view range to the portal
+			double a1 = viewAngle(view, p1);
+			double a2 = viewAngle(view, p2);
+			Window portal{ std::max(window.min, std::min(a1, a2)), std::min(window.max, std::max(a1, a2)) };
+			if (portal.min <= portal.max)
+				visit(other, portal);
+		}
+	}
+
+	std::sort(visible_sectors_.begin(), visible_sectors_.end());
+	std::sort(visible_lines_.begin(), visible_lines_.end());
+
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Walks the sectors crossed by the ray from [origin] along [direction], in
+// order of distance along the ray (in units of [direction]). [check_sector]
+// is called for each sector reached, and returns the distance to the closest
+// hit found so far. Sectors further than that are not walked.
+// Nothing is walked if [origin] isn't within any sector
+// -----------------------------------------------------------------------------
+void MapVisibility3D::traceRay(Vec2d origin, Vec2d direction, const std::function<double(unsigned)>& check_sector)
+{
+	auto start = map_->sectors().atPos(origin);
+	if (!start)
+		return;
+
+	nextStamp();
+
+	using Entry = std::pair<double, unsigned>;
+	std::priority_queue<Entry, vector<Entry>, std::greater<>> queue;
+	bool                                                      crosses = direction.magnitude() > 0.000001;
+	queue.push({ 0., start->index() });
+	while (!queue.empty())
+	{
+		auto sector = queue.top().second;
+		queue.pop();
+		if (sector_stamp_[sector] == stamp_)
+			continue;
+		sector_stamp_[sector] = stamp_;
+
+		double min_dist = check_sector(sector);
+		if (!crosses)
+			break;
+
+		// Add sectors on the other side of any lines crossed before the
+		// closest hit
+		for (auto index : sectorLines(sector))
+		{
+			auto& line  = lines_[index];
+			int   other = line.front == static_cast<int>(sector) ? line.back : line.front;
+			if (other < 0 || sector_stamp_[other] == stamp_)
+				continue;
+
+			double dist = math::distanceRayLine(origin, origin + direction, line.start, line.end);
+			if (dist >= 0 && dist < min_dist)
+				queue.push({ dist, static_cast<unsigned>(other) });
+		}
+
+		// Stop if the next sector is beyond the closest hit
+		while (!queue.empty() && queue.top().first >= min_dist)
+			queue.pop();
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Returns the indices of all lines with a side in [sector]
+// -----------------------------------------------------------------------------
+MapVisibility3D::Range MapVisibility3D::sectorLines(unsigned sector) const
+{
+	if (sector + 1 >= sector_lines_start_.size())
+		return {};
+
+	return { sector_lines_.data() + sector_lines_start_[sector],
+			 sector_lines_.data() + sector_lines_start_[sector + 1] };
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if the portal graph should be used for 3d view visibility
+// -----------------------------------------------------------------------------
+bool MapVisibility3D::enabled()
+{
+	return render_3d_portal_vis;
+}
+
+// -----------------------------------------------------------------------------
+// Builds the portal graph for the map
+// -----------------------------------------------------------------------------
+void MapVisibility3D::build()
+{
+	sf::Clock clock;
+
+	built_     = app::runTimer();
+	n_sectors_ = map_->nSectors();
+	n_lines_   = map_->nLines();
+	n_sides_   = map_->nSides();
+
+	// Lines
+	lines_.resize(n_lines_);
+	vector<unsigned> count(n_sectors_ + 1, 0);
+	for (unsigned a = 0; a < n_lines_; a++)
+	{
+		auto  line  = map_->line(a);
+		auto& gline = lines_[a];
+		auto  front = line->frontSector();
+		auto  back  = line->backSector();
+		gline.start = line->start();
+		gline.end   = line->end();
+		gline.front = front ? static_cast<int>(front->index()) : -1;
+		gline.back  = back ? static_cast<int>(back->index()) : -1;
+
+		if (gline.front >= 0)
+			count[gline.front]++;
+		if (gline.back >= 0 && gline.back != gline.front)
+			count[gline.back]++;
+	}
+
+	// Sector line lists
+	sector_lines_start_.assign(n_sectors_ + 1, 0);
+	for (unsigned a = 0; a < n_sectors_; a++)
+		sector_lines_start_[a + 1] = sector_lines_start_[a] + count[a];
+	sector_lines_.resize(sector_lines_start_[n_sectors_]);
+	std::fill(count.begin(), count.end(), 0);
+	for (unsigned a = 0; a < n_lines_; a++)
+	{
+		auto& gline = lines_[a];
+		if (gline.front >= 0)
+			sector_lines_[sector_lines_start_[gline.front] + count[gline.front]++] = a;
+		if (gline.back >= 0 && gline.back != gline.front)
+			sector_lines_[sector_lines_start_[gline.back] + count[gline.back]++] = a;
+	}
+
+	// Reset flood/trace state
+	stamp_ = 0;
+	sector_stamp_.assign(n_sectors_, 0);
+	line_stamp_.assign(n_lines_, 0);
+	sector_window_.resize(n_sectors_);
+	sector_visits_.resize(n_sectors_);
+	visible_sectors_.clear();
+	visible_lines_.clear();
+
+	build_time_ = clock.getElapsedTime().asMicroseconds() / 1000.;
+}
+
+// -----------------------------------------------------------------------------
+// Begins a new flood/trace, so that all sectors and lines are unvisited
+// -----------------------------------------------------------------------------
+void MapVisibility3D::nextStamp()
+{
+	if (++stamp_ == 0)
+	{
+		std::fill(sector_stamp_.begin(), sector_stamp_.end(), 0);
+		std::fill(line_stamp_.begin(), line_stamp_.end(), 0);
+		stamp_ = 1;
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if there is a gap between the floors and ceilings either side
+// of [line] at either end of it
+// -----------------------------------------------------------------------------
+bool MapVisibility3D::portalOpen(const Line& line) const
+{
+	auto front = map_->sector(line.front);
+	auto back  = map_->sector(line.back);
+
+	for (auto point : { line.start, line.end })
+	{
+		double bottom = std::max(front->floor().plane.heightAt(point), back->floor().plane.heightAt(point));
+		double top    = std::min(front->ceiling().plane.heightAt(point), back->ceiling().plane.heightAt(point));
+		if (top > bottom)
+			return true;
+	}
+
+	return false;
+}
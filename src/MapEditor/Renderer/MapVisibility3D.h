@@ -0,0 +1,94 @@
+#pragma once
+
+namespace slade
+{
+class SLADEMap;
+
+// A sector-portal graph for the 3d view, used to determine which sectors and
+// lines are potentially visible from the camera, and to walk the sectors
+// along a ray (for hilighting).
+//
+// The graph links each sector to its neighbours through the two-sided lines
+// (portals) between them. It is rebuilt whenever the map geometry changes.
+// Visibility is determined by flooding out from the sector containing the
+// camera, through any open portals within the view, narrowing the horizontal
+// view angle range at each portal passed through. Everything found is
+// potentially (not definitely) visible
+class MapVisibility3D
+{
+public:
+	struct View
+	{
+		Vec2d  position;
+		Vec2d  direction; // Normalized
+		double pitch    = 0.;
+		double fov_h    = 0.; // Half-angles, in radians
+		double fov_v    = 0.;
+		double max_dist = 0.; // <= 0 means unlimited
+	};
+
+	struct Range
+	{
+		const unsigned* first = nullptr;
+		const unsigned* last  = nullptr;
+
+		const unsigned* begin() const { return first; }
+		const unsigned* end() const { return last; }
+	};
+
+	MapVisibility3D(SLADEMap* map = nullptr) : map_{ map } {}
+
+	bool   update();
+	bool   flood(const View& view);
+	void   traceRay(Vec2d origin, Vec2d direction, const std::function<double(unsigned)>& check_sector);
+	Range  sectorLines(unsigned sector) const;
+	double buildTime() const { return build_time_; }
+
+	// Results of the last flood (sorted by index)
+	const vector<unsigned>& visibleSectors() const { return visible_sectors_; }
+	const vector<unsigned>& visibleLines() const { return visible_lines_; }
+
+	static bool enabled();
+
+private:
+	// A line in the graph, with the sectors on each side (-1 for none)
+	struct Line
+	{
+		Vec2d start;
+		Vec2d end;
+		int   front = -1;
+		int   back  = -1;
+	};
+
+	// The horizontal view angle range a sector is visible within, relative
+	// to the view direction
+	struct Window
+	{
+		double min = 0.;
+		double max = 0.;
+	};
+
+	SLADEMap*        map_        = nullptr;
+	long             built_      = -1;
+	unsigned         n_sectors_  = 0;
+	unsigned         n_lines_    = 0;
+	unsigned         n_sides_    = 0;
+	double           build_time_ = 0.;
+	vector<Line>     lines_;
+	vector<unsigned> sector_lines_start_; // Index into sector_lines_ for each sector (plus one at the end)
+	vector<unsigned> sector_lines_;
+
+	// Flood/trace state
+	unsigned         stamp_ = 0;
+	vector<unsigned> sector_stamp_;
+	vector<unsigned> line_stamp_;
+	vector<Window>   sector_window_;
+	vector<unsigned> sector_visits_;
+	vector<unsigned> visible_sectors_;
+	vector<unsigned> visible_lines_;
+
+	void build();
+	void nextStamp();
+	bool portalOpen(const Line& line) const;
+};
+} // namespace slade
@@ -62,6 +62,8 @@ CVAR(Int, grid_64_style, 1, CVar::Flag::Save)
 CVAR(Bool, grid_show_origin, true, CVar::Flag::Save)
 CVAR(Bool, scroll_smooth, true, CVar::Flag::Save)
 CVAR(Bool, map_showfps, false, CVar::Flag::Save)
+CVAR(Bool, map_show_specials_stats, false, CVar::Flag::Save)
+CVAR(Bool, render_3d_frame_graph, false, CVar::Flag::Save)
 CVAR(Bool, camera_3d_gravity, true, CVar::Flag::Save)
 CVAR(Int, camera_3d_crosshair_size, 6, CVar::Flag::Save)
 CVAR(Bool, camera_3d_show_distance, false, CVar::Flag::Save)
@@ -572,6 +574,92 @@ void Renderer::drawEditorMessages() const
 	drawing::enableTextStateReset(true);
 }
 
+// -----------------------------------------------------------------------------
+// Draws the time taken (and number of sectors/specials processed) by the last
+// map specials update, in the top-right corner
+// -----------------------------------------------------------------------------
+void Renderer::drawSpecialsStats() const
+{
+	auto& stats = context_.map().mapSpecials()->lastUpdateStats();
+
+	drawing::setTextState(true);
+	drawing::setTextOutline(1.0f, colourconfig::colour("map_editor_message_outline"));
+	drawing::drawText(
+		fmt::format(
+			"Specials ({}): {:1.2f}ms, {} sectors, {} specials",
+			stats.full ? "full" : "incremental",
+			stats.time,
+			stats.sectors,
+			stats.specials),
+		view_.size().x - 4,
+		0,
+		colourconfig::colour("map_editor_message"),
+		drawing::Font::Bold,
+		drawing::Align::Right);
+	drawing::setTextOutline(0);
+	drawing::setTextState(false);
+}
+
+// -----------------------------------------------------------------------------
+// Draws a graph of recent 3d view render times (total and visibility
+// checking), along with the current visibility stats
+// -----------------------------------------------------------------------------
+void Renderer::drawFrameTimeGraph() const
+{
+	constexpr double width   = 240.;
+	constexpr double height  = 80.;
+	constexpr double max_ms  = 33.3;
+	double           left    = view_.size().x - width - 8;
+	double           top     = 24.;
+	double           bottom  = top + height;
+	double           x_scale = width / (MapRenderer3D::FRAME_HISTORY - 1);
+	auto             y_pos   = [&](float ms) { return bottom - std::min<double>(ms / max_ms, 1.) * height; };
+
+	// Background and 60fps line
+	glDisable(GL_TEXTURE_2D);
+	glLineWidth(1.0f);
+	drawing::drawBorderedRect(left, top, left + width, bottom, { 0, 0, 0, 160 }, { 255, 255, 255, 100 });
+	gl::setColour(255, 255, 0, 100);
+	drawing::drawLine(left, y_pos(16.7f), left + width, y_pos(16.7f));
+
+	// Total frame time
+	gl::setColour(ColRGBA::WHITE);
+	glBegin(GL_LINE_STRIP);
+	for (unsigned a = 0; a < MapRenderer3D::FRAME_HISTORY; a++)
+		glVertex2d(left + a * x_scale, y_pos(renderer_3d_.frameStats(a).time));
+	glEnd();
+
+	// Visibility checking time
+	gl::setColour(80, 255, 80);
+	glBegin(GL_LINE_STRIP);
+	for (unsigned a = 0; a < MapRenderer3D::FRAME_HISTORY; a++)
+		glVertex2d(left + a * x_scale, y_pos(renderer_3d_.frameStats(a).vis_time));
+	glEnd();
+
+	// Stats for the last frame
+	auto& last = renderer_3d_.frameStats(MapRenderer3D::FRAME_HISTORY - 1);
+	drawing::setTextState(true);
+	drawing::setTextOutline(1.0f, ColRGBA::BLACK);
+	drawing::drawText(
+		fmt::format("Frame: {:1.2f}ms, vis: {:1.2f}ms", last.time, last.vis_time),
+		left,
+		bottom + 2,
+		ColRGBA::WHITE,
+		drawing::Font::Small);
+	drawing::drawText(
+		fmt::format(
+			"{} sectors, {} lines visible (graph built in {:1.2f}ms)",
+			last.vis_sectors,
+			last.vis_lines,
+			renderer_3d_.visBuildTime()),
+		left,
+		bottom + 16,
+		ColRGBA::WHITE,
+		drawing::Font::Small);
+	drawing::setTextOutline(0);
+	drawing::setTextState(false);
+}
+
 // -----------------------------------------------------------------------------
 // Draws any feature help text currently showing
 // -----------------------------------------------------------------------------
@@ -1338,6 +1426,14 @@ void Renderer::draw()
 	// test
 	// Drawing::drawText(fmt::format("Render distance: {:1.2f}", (double)render_max_dist), 0, 100);
 
+	// Map specials update stats
+	if (map_show_specials_stats)
+		drawSpecialsStats();
+
+	// 3d view frame time graph
+	if (render_3d_frame_graph && context_.editMode() == Mode::Visual)
+		drawFrameTimeGraph();
+
 	// Editor messages
 	drawEditorMessages();
 
@@ -78,6 +78,8 @@ namespace mapeditor
 		void drawGrid() const;
 		void drawEditorMessages() const;
 		void drawFeatureHelpText() const;
+		void drawSpecialsStats() const;
+		void drawFrameTimeGraph() const;
 		void drawSelectionNumbers() const;
 		void drawThingQuickAngleLines() const;
 		void drawLineLength(Vec2d p1, Vec2d p2, ColRGBA col) const;
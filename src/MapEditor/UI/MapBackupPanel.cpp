@@ -34,6 +34,7 @@
 #include "App.h"
 #include "Archive/Formats/WadArchive.h"
 #include "Archive/Formats/ZipArchive.h"
+#include "MapEditor/MapEditor.h"
 #include "UI/Canvas/MapPreviewCanvas.h"
 #include "UI/Lists/ListView.h"
 #include "UI/WxUtils.h"
@@ -70,20 +71,31 @@ MapBackupPanel::MapBackupPanel(wxWindow* parent) : wxPanel{ parent, -1 }, archiv
 }
 
 // -----------------------------------------------------------------------------
-// Opens the map backup file for [map_name] in [archive_name] and populates the
-// list
+// Loads the list of backups for [map_name] in [archive_name] and populates the
+// list. Only the map's backup manifest is read, backup data is loaded when a
+// backup is selected
 // -----------------------------------------------------------------------------
 bool MapBackupPanel::loadBackups(wxString archive_name, const wxString& map_name)
 {
-	// Open backup file
-	archive_name.Replace(".", "_");
-	auto backup_file = app::path("backups", app::Dir::User) + "/" + archive_name.ToStdString() + "_backup.zip";
-	if (!archive_backups_->open(backup_file))
-		return false;
+	items_.clear();
+	archive_name_ = archive_name.ToStdString();
+
+	// Get backups from the map's manifest
+	backups_ = mapeditor::backupManager().backups(archive_name_, map_name.ToStdString());
+	for (int a = backups_.size() - 1; a >= 0; a--)
+		items_.push_back({ backups_[a].timestamp, a, nullptr });
+
+	// Get backups from the legacy backup zip, if it exists (these are all older)
+	auto legacy_file = MapBackupManager::legacyBackupFile(archive_name_);
+	if (wxFileExists(legacy_file) && archive_backups_->open(legacy_file))
+	{
+		auto dir = archive_backups_->dirAtPath(map_name.ToStdString());
+		if (dir && dir != archive_backups_->rootDir().get())
+			for (int a = dir->numSubdirs() - 1; a >= 0; a--)
+				items_.push_back({ dir->subdirAt(a)->name(), -1, dir->subdirAt(a).get() });
+	}
 
-	// Get backup dir for map
-	dir_current_ = archive_backups_->dirAtPath(map_name.ToStdString());
-	if (dir_current_ == archive_backups_->rootDir().get() || !dir_current_)
+	if (items_.empty())
 		return false;
 
 	// Populate backups list
@@ -92,9 +104,9 @@ bool MapBackupPanel::loadBackups(wxString archive_name, const wxString& map_name
 	list_backups_->AppendColumn("Time");
 
 	int index = 0;
-	for (int a = dir_current_->numSubdirs() - 1; a >= 0; a--)
+	for (const auto& item : items_)
 	{
-		wxString      timestamp = dir_current_->subdirAt(a)->name();
+		wxString      timestamp = item.timestamp;
 		wxArrayString cols;
 
 		// Date
@@ -125,15 +137,28 @@ void MapBackupPanel::updateMapPreview()
 	// Check for selection
 	if (list_backups_->selectedItems().IsEmpty())
 		return;
-	int selection = (list_backups_->GetItemCount() - 1) - list_backups_->selectedItems()[0];
+	auto selection = list_backups_->selectedItems()[0];
+	if (selection < 0 || selection >= (int)items_.size())
+		return;
+	const auto& item = items_[selection];
 
-	// Load map data to temporary wad
-	archive_mapdata_ = std::make_unique<WadArchive>();
-	auto dir         = dir_current_->subdirAt(selection);
-	for (unsigned a = 0; a < dir->numEntries(); a++)
-		archive_mapdata_->addEntry(std::make_shared<ArchiveEntry>(*dir->entryAt(a)), "");
+	// Load map data
+	if (item.manifest_index >= 0)
+	{
+		// From manifest
+		archive_mapdata_ = mapeditor::backupManager().loadBackup(archive_name_, backups_[item.manifest_index]);
+	}
+	else
+	{
+		// From legacy backup zip
+		archive_mapdata_ = std::make_unique<WadArchive>();
+		for (unsigned a = 0; a < item.legacy_dir->numEntries(); a++)
+			archive_mapdata_->addEntry(std::make_shared<ArchiveEntry>(*item.legacy_dir->entryAt(a)), "");
+	}
 
 	// Open map preview
+	if (!archive_mapdata_)
+		return;
 	auto maps = archive_mapdata_->detectMaps();
 	if (!maps.empty())
 		canvas_map_->openMap(maps[0]);
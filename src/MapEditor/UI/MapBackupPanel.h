@@ -1,5 +1,7 @@
 #pragma once
 
+#include "MapEditor/MapBackupManager.h"
+
 namespace slade
 {
 class MapPreviewCanvas;
@@ -14,16 +16,28 @@ public:
 	MapBackupPanel(wxWindow* parent);
 	~MapBackupPanel() = default;
 
-	Archive* selectedMapData() const { return archive_mapdata_.get(); }
+	Archive*            selectedMapData() const { return archive_mapdata_.get(); }
+	unique_ptr<Archive> takeMapData() { return std::move(archive_mapdata_); }
 
 	bool loadBackups(wxString archive_name, const wxString& map_name);
 	void updateMapPreview();
 
 private:
-	MapPreviewCanvas*      canvas_map_   = nullptr;
-	ListView*              list_backups_ = nullptr;
-	unique_ptr<ZipArchive> archive_backups_;
-	unique_ptr<Archive>    archive_mapdata_;
-	ArchiveDir*            dir_current_ = nullptr;
+	// A backup in the list, either from the map's backup manifest or (for
+	// backups made by previous versions) from the legacy backup zip
+	struct BackupItem
+	{
+		string      timestamp;
+		int         manifest_index = -1;
+		ArchiveDir* legacy_dir     = nullptr;
+	};
+
+	MapPreviewCanvas*                canvas_map_   = nullptr;
+	ListView*                        list_backups_ = nullptr;
+	string                           archive_name_;
+	vector<MapBackupManager::Backup> backups_;
+	vector<BackupItem>               items_; // In list order (newest first)
+	unique_ptr<ZipArchive>           archive_backups_;
+	unique_ptr<Archive>              archive_mapdata_;
 };
 } // namespace slade
@@ -38,6 +38,7 @@
 #include "MapEditor/MapEditor.h"
 #include "SLADEMap/SLADEMap.h"
 #include "UI/WxUtils.h"
+#include "Utility/Parallel.h"
 #include "Utility/SFileDialog.h"
 
 using namespace slade;
@@ -129,6 +130,17 @@ void MapChecksPanel::updateStatusText(const wxString& text)
 	Refresh();
 }
 
+// -----------------------------------------------------------------------------
+// Sets the label of the check at [index] in the checks list to [label]
+// -----------------------------------------------------------------------------
+void MapChecksPanel::setCheckLabel(unsigned index, const wxString& label) const
+{
+	// Changing the label can reset the checked state on some platforms
+	bool checked = clb_active_checks_->IsChecked(index);
+	clb_active_checks_->SetString(index, label);
+	clb_active_checks_->Check(index, checked);
+}
+
 // -----------------------------------------------------------------------------
 // Shows the selected problem on the map view and sets up fix buttons
 // -----------------------------------------------------------------------------
@@ -323,28 +335,62 @@ void MapChecksPanel::onBtnCheck(wxCommandEvent& e)
 	active_checks_.clear();
 
 	// Setup checks
+	vector<unsigned> check_ids;
 	for (auto a = 0u; a < std_checks.size(); ++a)
 	{
+		// Clear previous timing
+		setCheckLabel(a, std_checks[a].second);
+
 		if (clb_active_checks_->IsChecked(a))
 		{
 			active_checks_.emplace_back(
 				MapCheck::standardCheck(static_cast<MapCheck::StandardCheck>(a), map_, &mapeditor::textureManager()));
+			check_ids.push_back(a);
 		}
 	}
 
-	// Run checks
-	for (auto& check : active_checks_)
+	// Runs the check at [index] and records how long it took
+	vector<long> check_times(active_checks_.size());
+	auto         run_check = [&](size_t index) {
+		sf::Clock clock;
+		active_checks_[index]->doCheck();
+		check_times[index] = clock.getElapsedTime().asMilliseconds();
+	};
+
+	// Run thread-safe checks in parallel
+	vector<size_t> parallel_checks;
+	for (auto a = 0u; a < active_checks_.size(); ++a)
+		if (active_checks_[a]->threadSafe())
+			parallel_checks.push_back(a);
+	if (!parallel_checks.empty())
 	{
-		// Check
-		updateStatusText(check->progressText());
-		check->doCheck();
+		updateStatusText("Checking...");
+		parallel::forEach(parallel_checks.size(), [&](size_t a) { run_check(parallel_checks[a]); }, {}, 1);
+	}
 
-		// Add results to list
+	// Run other checks
+	for (auto a = 0u; a < active_checks_.size(); ++a)
+	{
+		if (!active_checks_[a]->threadSafe())
+		{
+			updateStatusText(active_checks_[a]->progressText());
+			run_check(a);
+		}
+	}
+
+	// Add results to list
+	for (auto a = 0u; a < active_checks_.size(); ++a)
+	{
+		auto& check = active_checks_[a];
 		for (unsigned b = 0; b < check->nProblems(); b++)
 		{
 			lb_errors_->Append(check->problemDesc(b));
 			check_items_.emplace_back(check.get(), b);
 		}
+
+		// Show time taken next to the check
+		setCheckLabel(
+			check_ids[a], wxString::Format("%s (%ldms)", std_checks[check_ids[a]].second, check_times[a]));
 	}
 
 	lb_errors_->Show(true);
@@ -46,6 +46,8 @@ private:
 	};
 	vector<CheckItem> check_items_;
 
+	void setCheckLabel(unsigned index, const wxString& label) const;
+
 	// Events
 	void onBtnCheck(wxCommandEvent& e);
 	void onListBoxItem(wxCommandEvent& e);
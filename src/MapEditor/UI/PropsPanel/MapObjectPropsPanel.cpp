@@ -971,18 +971,18 @@ void MapObjectPropsPanel::openObjects(vector<MapObject*>& objects)
 			for (auto& prop : objprops)
 			{
 				// Ignore side property
-				if (strutil::startsWith(prop.name, "side1.") || strutil::startsWith(prop.name, "side2."))
+				if (strutil::startsWith(prop.name(), "side1.") || strutil::startsWith(prop.name(), "side2."))
 					continue;
 
 				// Check if hidden
-				if (VECTOR_EXISTS(hide_props_, prop.name))
+				if (VECTOR_EXISTS(hide_props_, prop.name()))
 					continue;
 
 				// Check if property is already on the list
 				bool exists = false;
 				for (auto& property : properties_)
 				{
-					if (property->propName() == prop.name)
+					if (property->propName() == prop.name())
 					{
 						exists = true;
 						break;
@@ -998,10 +998,10 @@ void MapObjectPropsPanel::openObjects(vector<MapObject*>& objects)
 					// Add property
 					switch (property::valueType(prop.value))
 					{
-					case property::ValueType::Bool: addBoolProperty(group_custom_, prop.name, prop.name); break;
-					case property::ValueType::Int: addIntProperty(group_custom_, prop.name, prop.name); break;
-					case property::ValueType::Float: addFloatProperty(group_custom_, prop.name, prop.name); break;
-					default: addStringProperty(group_custom_, prop.name, prop.name); break;
+					case property::ValueType::Bool: addBoolProperty(group_custom_, prop.name(), prop.name()); break;
+					case property::ValueType::Int: addIntProperty(group_custom_, prop.name(), prop.name()); break;
+					case property::ValueType::Float: addFloatProperty(group_custom_, prop.name(), prop.name()); break;
+					default: addStringProperty(group_custom_, prop.name(), prop.name()); break;
 					}
 				}
 			}
@@ -38,200 +38,55 @@ bool PropertyChangeUS::doRedo()
 }
 
 
-MapObjectCreateDeleteUS::MapObjectCreateDeleteUS()
+MapObjectCreateDeleteUS::MapObjectCreateDeleteUS(const vector<MapUndoJournal::ListChange>& changes) :
+	changes_{ changes }
 {
-	auto map = undoredo::currentMap();
-	map->mapData().putObjectIdList(MapObject::Type::Vertex, vertices_);
-	map->mapData().putObjectIdList(MapObject::Type::Line, lines_);
-	map->mapData().putObjectIdList(MapObject::Type::Side, sides_);
-	map->mapData().putObjectIdList(MapObject::Type::Sector, sectors_);
-	map->mapData().putObjectIdList(MapObject::Type::Thing, things_);
 }
 
-void MapObjectCreateDeleteUS::swapLists()
+void MapObjectCreateDeleteUS::applyChanges(bool undo) const
 {
-	// Backup
-	vector<unsigned> vertices;
-	vector<unsigned> lines;
-	vector<unsigned> sides;
-	vector<unsigned> sectors;
-	vector<unsigned> things;
-	auto             map = undoredo::currentMap();
-	if (isValid(vertices_))
-		map->mapData().putObjectIdList(MapObject::Type::Vertex, vertices);
-	if (isValid(lines_))
-		map->mapData().putObjectIdList(MapObject::Type::Line, lines);
-	if (isValid(sides_))
-		map->mapData().putObjectIdList(MapObject::Type::Side, sides);
-	if (isValid(sectors_))
-		map->mapData().putObjectIdList(MapObject::Type::Sector, sectors);
-	if (isValid(things_))
-		map->mapData().putObjectIdList(MapObject::Type::Thing, things);
+	auto map           = undoredo::currentMap();
+	bool geometry_edit = false;
+
+	auto apply = [&](const MapUndoJournal::ListChange& change) {
+		map->applyListChange(change, undo);
+		if (change.type == MapObject::Type::Vertex || change.type == MapObject::Type::Line)
+			geometry_edit = true;
+	};
+
+	// Changes have to be reversed in the opposite order they were made
+	if (undo)
+		std::for_each(changes_.rbegin(), changes_.rend(), apply);
+	else
+		std::for_each(changes_.begin(), changes_.end(), apply);
 
-	// Restore
-	if (isValid(vertices_))
-	{
-		map->restoreObjectIdList(MapObject::Type::Vertex, vertices_);
-		vertices_ = vertices;
-		map->updateGeometryInfo(0);
-	}
-	if (isValid(lines_))
-	{
-		map->restoreObjectIdList(MapObject::Type::Line, lines_);
-		lines_ = lines;
+	if (geometry_edit)
 		map->updateGeometryInfo(0);
-	}
-	if (isValid(sides_))
-	{
-		map->restoreObjectIdList(MapObject::Type::Side, sides_);
-		sides_ = sides;
-	}
-	if (isValid(sectors_))
-	{
-		map->restoreObjectIdList(MapObject::Type::Sector, sectors_);
-		sectors_ = sectors;
-	}
-	if (isValid(things_))
-	{
-		map->restoreObjectIdList(MapObject::Type::Thing, things_);
-		things_ = things;
-	}
 }
 
 bool MapObjectCreateDeleteUS::doUndo()
 {
-	swapLists();
+	applyChanges(true);
 	return true;
 }
 
 bool MapObjectCreateDeleteUS::doRedo()
 {
-	swapLists();
+	applyChanges(false);
 	return true;
 }
 
-void MapObjectCreateDeleteUS::checkChanges()
-{
-	auto map = undoredo::currentMap();
-
-	// Check vertices changed
-	bool vertices_changed = false;
-	if (map->nVertices() != vertices_.size())
-		vertices_changed = true;
-	else
-		for (unsigned a = 0; a < map->nVertices(); a++)
-			if (map->vertex(a)->objId() != vertices_[a])
-			{
-				vertices_changed = true;
-				break;
-			}
-	if (!vertices_changed)
-	{
-		// No change, clear
-		vertices_.clear();
-		vertices_.push_back(0);
-		log::info(3, "MapObjectCreateDeleteUS: No vertices added/deleted");
-	}
-
-	// Check lines changed
-	bool lines_changed = false;
-	if (map->nLines() != lines_.size())
-		lines_changed = true;
-	else
-		for (unsigned a = 0; a < map->nLines(); a++)
-			if (map->line(a)->objId() != lines_[a])
-			{
-				lines_changed = true;
-				break;
-			}
-	if (!lines_changed)
-	{
-		// No change, clear
-		lines_.clear();
-		lines_.push_back(0);
-		log::info(3, "MapObjectCreateDeleteUS: No lines added/deleted");
-	}
-
-	// Check sides changed
-	bool sides_changed = false;
-	if (map->nSides() != sides_.size())
-		sides_changed = true;
-	else
-		for (unsigned a = 0; a < map->nSides(); a++)
-			if (map->side(a)->objId() != sides_[a])
-			{
-				sides_changed = true;
-				break;
-			}
-	if (!sides_changed)
-	{
-		// No change, clear
-		sides_.clear();
-		sides_.push_back(0);
-		log::info(3, "MapObjectCreateDeleteUS: No sides added/deleted");
-	}
-
-	// Check sectors changed
-	bool sectors_changed = false;
-	if (map->nSectors() != sectors_.size())
-		sectors_changed = true;
-	else
-		for (unsigned a = 0; a < map->nSectors(); a++)
-			if (map->sector(a)->objId() != sectors_[a])
-			{
-				sectors_changed = true;
-				break;
-			}
-	if (!sectors_changed)
-	{
-		// No change, clear
-		sectors_.clear();
-		sectors_.push_back(0);
-		log::info(3, "MapObjectCreateDeleteUS: No sectors added/deleted");
-	}
-
-	// Check things changed
-	bool things_changed = false;
-	if (map->nThings() != things_.size())
-		things_changed = true;
-	else
-		for (unsigned a = 0; a < map->nThings(); a++)
-			if (map->thing(a)->objId() != things_[a])
-			{
-				things_changed = true;
-				break;
-			}
-	if (!things_changed)
-	{
-		// No change, clear
-		things_.clear();
-		things_.push_back(0);
-		log::info(3, "MapObjectCreateDeleteUS: No things added/deleted");
-	}
-}
-
-bool MapObjectCreateDeleteUS::isOk()
-{
-	// Check for any changes at all
-	return !(
-		vertices_.size() == 1 && vertices_[0] == 0 && lines_.size() == 1 && lines_[0] == 0 && sides_.size() == 1
-		&& sides_[0] == 0 && sectors_.size() == 1 && sectors_[0] == 0 && things_.size() == 1 && things_[0] == 0);
-}
-
 
 
-MultiMapObjectPropertyChangeUS::MultiMapObjectPropertyChangeUS()
+MultiMapObjectPropertyChangeUS::MultiMapObjectPropertyChangeUS(vector<MapObject*> objects)
 {
-	// Get backups of recently modified map objects
-	auto objects = undoredo::currentMap()->mapData().allModifiedObjects(MapObject::propBackupTime());
+	// Get backups of the modified map objects, in id order
+	std::sort(objects.begin(), objects.end(), [](MapObject* a, MapObject* b) { return a->objId() < b->objId(); });
 	for (auto& object : objects)
 	{
 		auto bak = object->backup(true);
 		if (bak)
-		{
 			backups_.emplace_back(bak);
-			// log::info(1, "%s #%d modified", objects[a]->getTypeName(), objects[a]->getIndex());
-		}
 	}
 
 	if (log::verbosity() >= 2)
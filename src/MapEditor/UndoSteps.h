@@ -2,6 +2,7 @@
 
 #include "General/UndoRedo.h"
 #include "SLADEMap/MapObject/MapObject.h"
+#include "SLADEMap/MapUndoJournal.h"
 
 namespace slade::mapeditor
 {
@@ -24,29 +25,24 @@ private:
 class MapObjectCreateDeleteUS : public UndoStep
 {
 public:
-	MapObjectCreateDeleteUS();
+	MapObjectCreateDeleteUS(const vector<MapUndoJournal::ListChange>& changes);
 	~MapObjectCreateDeleteUS() = default;
 
-	bool isValid(vector<unsigned>& list) const { return !(list.size() == 1 && list[0] == 0); }
-	void swapLists();
 	bool doUndo() override;
 	bool doRedo() override;
-	void checkChanges();
-	bool isOk() override;
+	bool isOk() override { return !changes_.empty(); }
 
 private:
-	vector<unsigned> vertices_;
-	vector<unsigned> lines_;
-	vector<unsigned> sides_;
-	vector<unsigned> sectors_;
-	vector<unsigned> things_;
+	vector<MapUndoJournal::ListChange> changes_;
+
+	void applyChanges(bool undo) const;
 };
 
 // UndoStep for when multiple MapObjects have properties changed
 class MultiMapObjectPropertyChangeUS : public UndoStep
 {
 public:
-	MultiMapObjectPropertyChangeUS();
+	MultiMapObjectPropertyChangeUS(vector<MapObject*> objects);
 	~MultiMapObjectPropertyChangeUS() = default;
 
 	void doSwap(MapObject* obj, unsigned index);
@@ -0,0 +1,603 @@
+// -----------------------------------------------------------------------------
+// SLADE - It's a Doom Editor
+// Copyright(C) 2008 - 2020 Simon Judd
+//
+// Email:       sirjuddington@gmail.com
+// Web:         http://slade.mancubus.net
+// Filename:    UDMFReader.cpp
+// Description: Reads UDMF definitions directly from TEXTMAP text, without
+//              building a parse tree for the whole map first
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation; either version 2 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+//
+// Includes
+//
+// -----------------------------------------------------------------------------
+#include "Main.h"
+#include "UDMFReader.h"
+#include <cerrno>
+#include <charconv>
+
+using namespace slade;
+
+
+// -----------------------------------------------------------------------------
+//
+// Functions
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// The same whitespace, special characters and comments as the default
+// Tokenizer settings used by Parser
+enum class Comment
+{
+	None,
+	CStyle,     // /* */
+	CPPStyle,   // //
+	DoubleHash, // ##
+};
+
+// -----------------------------------------------------------------------------
+// Returns true if [c] is a whitespace character
+// -----------------------------------------------------------------------------
+bool isWhitespace(char c)
+{
+	return c == '\n' || c == '\r' || c == ' ' || c == '\t';
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if [c] is a special character (always read as a single token)
+// -----------------------------------------------------------------------------
+bool isSpecialCharacter(char c)
+{
+	return c == ';' || c == ',' || c == ':' || c == '|' || c == '=' || c == '{' || c == '}' || c == '/';
+}
+
+// -----------------------------------------------------------------------------
+// Returns the type of comment beginning at [pos], if any
+// -----------------------------------------------------------------------------
+Comment commentBegin(const char* pos, const char* end)
+{
+	if (pos + 1 >= end)
+		return Comment::None;
+
+	if (pos[0] == '/' && pos[1] == '*')
+		return Comment::CStyle;
+	if (pos[0] == '/' && pos[1] == '/')
+		return Comment::CPPStyle;
+	if (pos[0] == '#' && pos[1] == '#')
+		return Comment::DoubleHash;
+
+	return Comment::None;
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if [c] is a decimal digit
+// -----------------------------------------------------------------------------
+bool isDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if [str] is one or more decimal digits
+// -----------------------------------------------------------------------------
+bool isDigits(string_view str)
+{
+	return !str.empty() && std::all_of(str.begin(), str.end(), isDigit);
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if [str] is a valid integer (see strutil::isInteger)
+// -----------------------------------------------------------------------------
+bool isInteger(string_view str)
+{
+	if (!str.empty() && (str[0] == '+' || str[0] == '-'))
+		str.remove_prefix(1);
+
+	return isDigits(str);
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if [str] is a valid hex string (see strutil::isHex)
+// -----------------------------------------------------------------------------
+bool isHex(string_view str)
+{
+	if (str.size() < 3 || str[0] != '0' || str[1] != 'x')
+		return false;
+
+	return std::all_of(str.begin() + 2, str.end(), [](char c) { return isxdigit(static_cast<unsigned char>(c)); });
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if [str] matches the [0-9]*.?[0-9]+ part of the float regex in
+// strutil::isFloat (where . is any character)
+// -----------------------------------------------------------------------------
+bool isFloatMantissa(string_view str)
+{
+	size_t digits = 0;
+	while (digits < str.size() && isDigit(str[digits]))
+		++digits;
+
+	if (digits == str.size())
+		return digits > 0;
+
+	return isDigits(str.substr(digits + 1));
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if [str] matches the float regex in strutil::isFloat, without
+// the optional sign
+// -----------------------------------------------------------------------------
+bool isUnsignedFloat(string_view str)
+{
+	if (isFloatMantissa(str))
+		return true;
+
+	// Check for exponent (can only begin at the last e)
+	auto exp = str.find_last_of("eE");
+	if (exp == string_view::npos || !isFloatMantissa(str.substr(0, exp)))
+		return false;
+
+	auto exp_value = str.substr(exp + 1);
+	if (!exp_value.empty() && (exp_value[0] == '+' || exp_value[0] == '-'))
+		exp_value.remove_prefix(1);
+
+	return isDigits(exp_value);
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if [str] is a valid floating-point number (see strutil::isFloat)
+// -----------------------------------------------------------------------------
+bool isFloat(string_view str)
+{
+	if (str.empty() || str[0] == '$')
+		return false;
+
+	return isUnsignedFloat(str) || ((str[0] == '+' || str[0] == '-') && isUnsignedFloat(str.substr(1)));
+}
+} // namespace
+
+
+// -----------------------------------------------------------------------------
+//
+// UDMFBlock Struct Functions
+//
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+// Returns the first field in the block matching [name] (case-insensitive), or
+// nullptr if none found
+// -----------------------------------------------------------------------------
+const UDMFField* UDMFBlock::field(string_view name) const
+{
+	for (const auto& field : fields)
+		if (strutil::equalCI(field.name, name))
+			return &field;
+
+	return nullptr;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+// UDMFReader Class Functions
+//
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+// Reads all definitions in the text, calling [field_func] for each top-level
+// field and [block_func] for each definition block. Blocks are only valid
+// within [block_func], though their field names and values can be kept.
+// Returns false if a syntax error was encountered
+// -----------------------------------------------------------------------------
+bool UDMFReader::read(
+	const std::function<void(const UDMFField&)>& field_func,
+	const std::function<void(UDMFBlock&)>&       block_func)
+{
+	// Read first tokens
+	nextToken(token_);
+	finishToken(token_);
+	nextToken(next_);
+	finishToken(next_);
+
+	UDMFBlock block;
+	while (token_.start && !token_.is('}'))
+	{
+		// Preprocessor directives aren't valid here, just skip the line
+		// (Parser logs an error but doesn't fail on unknown directives)
+		if (!token_.quoted && *token_.start == '#')
+		{
+			error(token_.line, fmt::format("Unrecognised preprocessor directive \"{}\"", token_.text()));
+			auto line = token_.line;
+			while (token_.start && token_.line == line)
+				advance();
+			continue;
+		}
+
+		// Check name
+		if (!checkName())
+			return false;
+		auto name = token_.text();
+		advance();
+
+		// Field
+		if (token_.is('=') || token_.is(';'))
+		{
+			UDMFField field{ name };
+			if (!readValues(field))
+				return false;
+
+			field_func(field);
+		}
+
+		// Definition block
+		else if (token_.is('{'))
+		{
+			advance();
+
+			block.type = name;
+			block.fields.clear();
+			if (!readBlock(block))
+				return false;
+
+			block_func(block);
+		}
+
+		// Unexpected token (type+name pairs and inheritance aren't valid UDMF)
+		else
+		{
+			error(token_.line, fmt::format("Unexpected token \"{}\"", token_.text()));
+			return false;
+		}
+
+		advance();
+	}
+
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Splits the text from [start] to [end] into at most [max_ranges] ranges of
+// roughly equal size, each containing only complete top-level definitions.
+// The text isn't modified
+// -----------------------------------------------------------------------------
+vector<UDMFReader::Range> UDMFReader::splitBlocks(char* start, char* end, unsigned max_ranges)
+{
+	vector<Range> ranges{ { start, end, 1 } };
+	if (max_ranges <= 1)
+		return ranges;
+
+	auto       target_size = static_cast<size_t>(end - start) / max_ranges;
+	UDMFReader reader{ ranges[0] };
+	Token      token;
+	int        depth = 0;
+	while (ranges.size() < max_ranges && reader.nextToken(token))
+	{
+		if (token.is('{'))
+			++depth;
+		else if (token.is('}'))
+		{
+			// Nothing after an unmatched } is read, so no point splitting further
+			if (--depth < 0)
+				break;
+		}
+		else if (!token.is(';'))
+			continue;
+
+		// Begin a new range if this is the end of a top-level definition and
+		// the current range is large enough
+		if (depth == 0 && static_cast<size_t>(reader.pos_ - ranges.back().start) >= target_size)
+		{
+			ranges.back().end = reader.pos_;
+			ranges.push_back({ reader.pos_, end, reader.line_ });
+		}
+	}
+
+	return ranges;
+}
+
+// -----------------------------------------------------------------------------
+// Reads the next token from the text into [token], skipping any whitespace and
+// comments. Returns false if the end of the text was reached
+// -----------------------------------------------------------------------------
+bool UDMFReader::nextToken(Token& token)
+{
+	while (pos_ < end_)
+	{
+		auto c = *pos_;
+
+		// Whitespace
+		if (isWhitespace(c))
+		{
+			if (c == '\n')
+				++line_;
+			++pos_;
+			continue;
+		}
+
+		// Comment
+		auto comment = commentBegin(pos_, end_);
+		if (comment == Comment::CStyle)
+		{
+			pos_ += 2;
+			while (pos_ < end_ && !(pos_[0] == '*' && pos_ + 1 < end_ && pos_[1] == '/'))
+			{
+				if (*pos_ == '\n')
+					++line_;
+				++pos_;
+			}
+			pos_ = std::min(pos_ + 2, end_);
+			continue;
+		}
+		if (comment != Comment::None)
+		{
+			// Line comment, the newline is handled as whitespace
+			while (pos_ < end_ && *pos_ != '\n')
+				++pos_;
+			continue;
+		}
+
+		token.line   = line_;
+		token.quoted = false;
+
+		// Special character
+		if (isSpecialCharacter(c))
+		{
+			token.start = pos_;
+			token.end   = ++pos_;
+			return true;
+		}
+
+		// Quoted string
+		if (c == '\"')
+		{
+			token.start  = ++pos_;
+			token.quoted = true;
+			while (pos_ < end_ && *pos_ != '\"')
+			{
+				// Escaped character
+				if (*pos_ == '\\')
+					++pos_;
+				else if (*pos_ == '\n')
+					++line_;
+
+				++pos_;
+			}
+			pos_      = std::min(pos_, end_);
+			token.end = pos_;
+
+			// Skip closing "
+			if (pos_ < end_)
+				++pos_;
+
+			return true;
+		}
+
+		// Token (ends at whitespace, a special character or comment)
+		token.start = pos_;
+		while (pos_ < end_ && !isWhitespace(*pos_) && !isSpecialCharacter(*pos_)
+			   && commentBegin(pos_, end_) == Comment::None)
+			++pos_;
+		token.end = pos_;
+
+		return true;
+	}
+
+	token = {};
+	return false;
+}
+
+// -----------------------------------------------------------------------------
+// Moves to the next token
+// -----------------------------------------------------------------------------
+void UDMFReader::advance()
+{
+	token_ = next_;
+	nextToken(next_);
+	finishToken(next_);
+}
+
+// -----------------------------------------------------------------------------
+// Converts [token] to lowercase if it is unquoted, or removes escape
+// backslashes if it is a quoted string
+// -----------------------------------------------------------------------------
+void UDMFReader::finishToken(Token& token) const
+{
+	if (token.quoted)
+	{
+		auto out = token.start;
+		for (auto c = token.start; c < token.end; ++c)
+		{
+			if (*c == '\\' && c + 1 < token.end)
+				++c;
+
+			*out++ = *c;
+		}
+		token.end = out;
+	}
+	else
+	{
+		for (auto c = token.start; c < token.end; ++c)
+			*c = static_cast<char>(tolower(static_cast<unsigned char>(*c)));
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Checks the current token is a valid field or block name
+// -----------------------------------------------------------------------------
+bool UDMFReader::checkName()
+{
+	if (token_.start == token_.end)
+	{
+		error(token_.line, "Unexpected empty string");
+		return false;
+	}
+
+	if (isSpecialCharacter(*token_.start))
+	{
+		error(token_.line, fmt::format("Unexpected special character '{}'", token_.text()));
+		return false;
+	}
+
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Reads the fields of a definition block into [block], up to the closing }
+// (or the end of the text)
+// -----------------------------------------------------------------------------
+bool UDMFReader::readBlock(UDMFBlock& block)
+{
+	while (token_.start && !token_.is('}'))
+	{
+		if (!checkName())
+			return false;
+		auto name = token_.text();
+		advance();
+
+		if (!token_.is('=') && !token_.is(';'))
+		{
+			error(token_.line, fmt::format("Unexpected token \"{}\" (expected \"=\" or \";\")", token_.text()));
+			return false;
+		}
+
+		auto& field = block.fields.emplace_back();
+		field.name  = name;
+		if (!readValues(field))
+			return false;
+
+		advance();
+	}
+
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Reads the values of [field], from the current = (or ;) token up to the
+// closing ; (or } for a { } value list). Only the first value is kept
+// -----------------------------------------------------------------------------
+bool UDMFReader::readValues(UDMFField& field)
+{
+	// No values
+	if (token_.is(';'))
+		return true;
+
+	// Check type of value list
+	advance();
+	char list_end = ';';
+	if (token_.is('{'))
+	{
+		list_end = '}';
+		advance();
+	}
+
+	// Read until ; or }
+	while (!token_.is(list_end))
+	{
+		if (!token_.start)
+		{
+			error(line_, "Unexpected end of text");
+			return false;
+		}
+
+		if (!field.has_value)
+		{
+			field.value     = tokenValue(token_);
+			field.has_value = true;
+		}
+
+		// Check for ,
+		if (next_.is(','))
+			advance();
+		else if (!next_.is(list_end))
+		{
+			error(next_.line, fmt::format(R"(Expected "," or "{}", got "{}")", list_end, next_.text()));
+			return false;
+		}
+
+		advance();
+	}
+
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Returns the value of [token], with its type detected the same way as in
+// ParseTreeNode::parseAssignment
+// -----------------------------------------------------------------------------
+Property UDMFReader::tokenValue(const Token& token)
+{
+	auto text = token.text();
+
+	// Quoted string
+	if (token.quoted)
+		return string{ text };
+
+	// Boolean
+	if (text == "true")
+		return true;
+	if (text == "false")
+		return false;
+
+	// Integer or hex (0xXXXXXX)
+	auto integer = isInteger(text);
+	if (integer || isHex(text))
+	{
+		auto digits = integer ? text : text.substr(2);
+		int  value  = 0;
+		auto result = std::from_chars(digits.data(), digits.data() + digits.size(), value, integer ? 10 : 16);
+		if (result.ec == std::errc::invalid_argument)
+			errors_.push_back(fmt::format("Can't convert \"{}\" to an integer (invalid)", digits));
+		else if (result.ec == std::errc::result_out_of_range)
+			errors_.push_back(fmt::format("Can't convert \"{}\" to an integer (out of range)", digits));
+
+		return value;
+	}
+
+	// Floating point
+	if (isFloat(text))
+	{
+		string str{ text };
+		char*  end = nullptr;
+		errno      = 0;
+		auto value = strtod(str.c_str(), &end);
+		if (end == str.c_str() || errno == ERANGE)
+		{
+			errors_.push_back(fmt::format("Can't convert \"{}\" to a double", text));
+			return 0.;
+		}
+
+		return value;
+	}
+
+	// Unknown, just treat as string
+	return string{ text };
+}
+
+// -----------------------------------------------------------------------------
+// Adds a parse error [message] at [line] to the errors list
+// -----------------------------------------------------------------------------
+void UDMFReader::error(unsigned line, string_view message)
+{
+	errors_.push_back(fmt::format("Parse Error in TEXTMAP (Line {}): {}", line, message));
+}
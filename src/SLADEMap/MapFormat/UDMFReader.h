@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Utility/Property.h"
+
+namespace slade
+{
+// A single 'name = value;' field, either at the top level of a TEXTMAP or
+// within a definition block
+struct UDMFField
+{
+	string_view name;
+	Property    value     = false; // First value only, false if there were none
+	bool        has_value = false;
+
+	int    intValue() const { return has_value ? property::asInt(value) : 0; }
+	double floatValue() const { return has_value ? property::asFloat(value) : 0.; }
+	string stringValue() const { return has_value ? property::asString(value) : string{}; }
+};
+
+// A 'type { fields }' definition block (vertex, linedef, etc.)
+struct UDMFBlock
+{
+	string_view       type;
+	vector<UDMFField> fields;
+
+	const UDMFField* field(string_view name) const;
+};
+
+// Reads UDMF definitions directly from TEXTMAP text, one at a time, without
+// building a parse tree for the whole map.
+//
+// Tokens and values are read the same way as Parser (case-insensitive) would
+// read them, but in-place: unquoted tokens are lowercased and escapes removed
+// from quoted strings within the text itself. Field names and block types
+// reference the text, so they are only valid while it exists and are
+// unaffected by reading further blocks.
+//
+// Since the reader doesn't log anything itself, separate ranges of the same
+// text (see splitBlocks) can be read on multiple threads at once
+class UDMFReader
+{
+public:
+	// A range of text starting at [line]
+	struct Range
+	{
+		char*    start;
+		char*    end;
+		unsigned line;
+	};
+
+	UDMFReader(const Range& range) : pos_{ range.start }, end_{ range.end }, line_{ range.line } {}
+
+	const vector<string>& errors() const { return errors_; }
+
+	bool read(
+		const std::function<void(const UDMFField&)>& field_func,
+		const std::function<void(UDMFBlock&)>&       block_func);
+
+	static vector<Range> splitBlocks(char* start, char* end, unsigned max_ranges);
+
+private:
+	struct Token
+	{
+		char*    start  = nullptr;
+		char*    end    = nullptr;
+		bool     quoted = false;
+		unsigned line   = 0;
+
+		bool        is(char c) const { return !quoted && end - start == 1 && *start == c; }
+		string_view text() const { return { start, static_cast<size_t>(end - start) }; }
+	};
+
+	char*          pos_;
+	char*          end_;
+	unsigned       line_;
+	Token          token_;
+	Token          next_;
+	vector<string> errors_;
+
+	bool     nextToken(Token& token);
+	void     advance();
+	void     finishToken(Token& token) const;
+	bool     checkName();
+	bool     readBlock(UDMFBlock& block);
+	bool     readValues(UDMFField& field);
+	Property tokenValue(const Token& token);
+	void     error(unsigned line, string_view message);
+};
+} // namespace slade
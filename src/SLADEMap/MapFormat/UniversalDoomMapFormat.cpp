@@ -31,20 +31,63 @@
 // -----------------------------------------------------------------------------
 #include "Main.h"
 #include "UniversalDoomMapFormat.h"
-#include "App.h"
 #include "Game/Configuration.h"
 #include "General/UI.h"
+#include "SLADEMap/MapFormat/UDMFReader.h"
 #include "SLADEMap/MapObject/MapLine.h"
 #include "SLADEMap/MapObject/MapSector.h"
 #include "SLADEMap/MapObject/MapVertex.h"
 #include "SLADEMap/MapObjectCollection.h"
 #include "SLADEMap/SLADEMap.h"
+#include "Utility/Parallel.h"
 #include "Utility/Parser.h"
 #include "Utility/StringUtils.h"
 
 using namespace slade;
 
 
+// -----------------------------------------------------------------------------
+//
+// Variables
+//
+// -----------------------------------------------------------------------------
+CVAR(Bool, map_udmf_stream_read, true, CVar::Flag::Save)
+CVAR(Bool, map_udmf_parallel_read, true, CVar::Flag::Save)
+CVAR(Bool, map_udmf_parallel_write, true, CVar::Flag::Save)
+
+namespace
+{
+// TEXTMAPs smaller than this are always read on a single thread
+constexpr long PARALLEL_READ_MIN_SIZE = 1024 * 1024;
+
+// Maps with fewer objects than this are always written on a single thread
+constexpr size_t PARALLEL_WRITE_MIN_OBJECTS = 10000;
+
+const property::Key KEY_FLAGS{ "flags" };
+} // namespace
+
+
+// -----------------------------------------------------------------------------
+//
+// UniversalDoomMapFormat::Definitions Struct
+//
+// -----------------------------------------------------------------------------
+
+// The definitions read from a TEXTMAP, in the order they were defined.
+// Vertices, sectors and things are created as soon as they are read (null if
+// the definition was invalid), while sides and lines reference other objects
+// by index so their creation is deferred until those are all added to the map
+struct UniversalDoomMapFormat::Definitions
+{
+	vector<unique_ptr<MapVertex>> vertices;
+	vector<unique_ptr<MapSector>> sectors;
+	vector<unique_ptr<MapThing>>  things;
+	vector<UDMFBlock>             sides;
+	vector<UDMFBlock>             lines;
+	vector<UDMFField>             fields; // Top-level (map-scope) fields
+};
+
+
 // -----------------------------------------------------------------------------
 //
 // UniversalDoomMapFormat Class Functions
@@ -69,100 +112,261 @@ bool UniversalDoomMapFormat::readMap(Archive::MapDesc map, MapObjectCollection&
 	// --- Parse UDMF text ---
 	ui::setSplashProgressMessage("Parsing TEXTMAP");
 	ui::setSplashProgress(-100.0f);
-	Parser parser;
-	if (!parser.parseText(textmap->data()))
-		return false;
-
-	// --- Process parsed data ---
-
-	// First we have to sort the definition blocks by type so they can
-	// be created in the correct order (verts->sides->lines->sectors->things),
-	// even if they aren't defined in that order.
-	// Unknown definitions are also kept, just in case
-	ui::setSplashProgressMessage("Sorting definitions");
-	auto                   root = parser.parseTreeRoot();
-	vector<ParseTreeNode*> defs_vertices;
-	vector<ParseTreeNode*> defs_lines;
-	vector<ParseTreeNode*> defs_sides;
-	vector<ParseTreeNode*> defs_sectors;
-	vector<ParseTreeNode*> defs_things;
-	vector<ParseTreeNode*> defs_other;
-	for (unsigned a = 0; a < root->nChildren(); a++)
+	if (map_udmf_stream_read)
+	{
+		// Read directly from a copy of the text (it is modified while reading,
+		// and read definitions reference it so it must be kept until the map
+		// objects are created)
+		const auto& data = textmap->data();
+		string      text(reinterpret_cast<const char*>(data.data()), data.size());
+		Definitions defs;
+		if (!readDefinitions(text.data(), text.data() + text.size(), defs))
+			return false;
+
+		addObjects(defs, map_data, map_extra_props);
+	}
+	else
 	{
-		ui::setSplashProgress((float)a / root->nChildren());
+		// Parse the full text into a tree first
+		Parser parser;
+		if (!parser.parseText(textmap->data()))
+			return false;
+
+		Definitions defs;
+		readDefinitions(*parser.parseTreeRoot(), defs);
+		addObjects(defs, map_data, map_extra_props);
+	}
 
-		auto node = root->childPTN(a);
+	ui::setSplashProgressMessage("Init map data");
 
-		// Vertex definition
-		if (strutil::equalCI(node->name(), "vertex"))
-			defs_vertices.push_back(node);
+	return true;
+}
 
-		// Line definition
-		else if (strutil::equalCI(node->name(), "linedef"))
-			defs_lines.push_back(node);
+// -----------------------------------------------------------------------------
+// Writes the given [map_data] to UDMF format, returning the list of entries
+// making up the map
+// -----------------------------------------------------------------------------
+vector<unique_ptr<ArchiveEntry>> UniversalDoomMapFormat::writeMap(
+	const MapObjectCollection& map_data,
+	const PropertyList&        map_extra_props)
+{
+	vector<unique_ptr<ArchiveEntry>> entries;
+	entries.push_back(std::make_unique<ArchiveEntry>("TEXTMAP"));
 
-		// Side definition
-		else if (strutil::equalCI(node->name(), "sidedef"))
-			defs_sides.push_back(node);
+	// Write map namespace and map-scope props
+	string header = "// Written by SLADE3\n";
+	fmt::format_to(std::back_inserter(header), "namespace=\"{}\";\n", udmf_namespace_);
+	map_extra_props.toString(header, true);
+	header += "\n";
+
+	// Cleanup properties and gather objects in the order they are written.
+	// This has to be done first on this thread since the configuration isn't
+	// thread-safe (UDMF property lookups can add to it)
+	vector<MapObject*> objects;
+	objects.reserve(
+		map_data.things().size() + map_data.lines().size() + map_data.sides().size() + map_data.vertices().size()
+		+ map_data.sectors().size());
+	auto add_objects = [&objects](const auto& list, bool remove_flags) {
+		for (auto object : list)
+		{
+			if (!object->props().empty())
+			{
+				if (remove_flags)
+					object->props().remove(KEY_FLAGS);
+				game::configuration().cleanObjectUDMFProps(object);
+			}
+
+			objects.push_back(object);
+		}
+	};
+	add_objects(map_data.things(), true);
+	add_objects(map_data.lines(), true);
+	add_objects(map_data.sides(), false);
+	add_objects(map_data.vertices(), false);
+	add_objects(map_data.sectors(), false);
+
+	// Write object definitions, split into ranges (written to separate
+	// strings) if writing on multiple threads
+	size_t n_ranges = 1;
+	if (map_udmf_parallel_write && objects.size() >= PARALLEL_WRITE_MIN_OBJECTS)
+		n_ranges = parallel::numThreads() * 4;
+	auto           range_size = (objects.size() + n_ranges - 1) / n_ranges;
+	vector<string> range_defs(n_ranges);
+	parallel::forEach(
+		n_ranges,
+		[&](size_t a) {
+			auto end = std::min(objects.size(), (a + 1) * range_size);
+			for (auto i = a * range_size; i < end; ++i)
+				objects[i]->writeUDMF(range_defs[a]);
+		},
+		{},
+		1);
+
+	// Write everything to the entry
+	auto total_size = header.size();
+	for (const auto& def : range_defs)
+		total_size += def.size();
+	MemChunk mc;
+	mc.reSize(total_size, false);
+	mc.write(header.data(), header.size());
+	for (const auto& def : range_defs)
+		mc.write(def.data(), def.size());
+	entries[0]->importMemChunk(mc);
+
+	return entries;
+}
+
+// -----------------------------------------------------------------------------
+// Reads all UDMF definitions in the text from [start] to [end] into [defs].
+// Large TEXTMAPs are split into multiple ranges which are read in parallel.
+// Returns false if there was a syntax error in the text
+// -----------------------------------------------------------------------------
+bool UniversalDoomMapFormat::readDefinitions(char* start, char* end, Definitions& defs) const
+{
+	// Split the text up if needed (more ranges than threads so that ranges with
+	// more objects to create don't hold the others up)
+	unsigned max_ranges = 1;
+	if (map_udmf_parallel_read && end - start >= PARALLEL_READ_MIN_SIZE)
+		max_ranges = parallel::numThreads() * 4;
+	auto ranges = UDMFReader::splitBlocks(start, end, max_ranges);
+
+	// Read each range
+	vector<Definitions>    range_defs(ranges.size());
+	vector<vector<string>> range_errors(ranges.size());
+	vector<uint8_t>        range_ok(ranges.size(), 0);
+	parallel::forEach(
+		ranges.size(),
+		[&](size_t a) {
+			UDMFReader reader{ ranges[a] };
+			range_ok[a] = reader.read(
+				[&](const UDMFField& field) { range_defs[a].fields.push_back(field); },
+				[&](UDMFBlock& block) { addDefinition(block, range_defs[a]); });
+			range_errors[a] = reader.errors();
+		},
+		{},
+		1);
+
+	// Merge (in order) into [defs]. Stop at the first syntax error, since a
+	// single pass wouldn't have read anything after it
+	auto append = [](auto& target, auto& source) {
+		target.insert(target.end(), std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()));
+	};
+	for (unsigned a = 0; a < ranges.size(); ++a)
+	{
+		for (const auto& error : range_errors[a])
+			log::error("{}", error);
+
+		if (!range_ok[a])
+			return false;
+
+		append(defs.vertices, range_defs[a].vertices);
+		append(defs.sectors, range_defs[a].sectors);
+		append(defs.things, range_defs[a].things);
+		append(defs.sides, range_defs[a].sides);
+		append(defs.lines, range_defs[a].lines);
+		append(defs.fields, range_defs[a].fields);
+	}
 
-		// Sector definition
-		else if (strutil::equalCI(node->name(), "sector"))
-			defs_sectors.push_back(node);
+	return true;
+}
 
-		// Thing definition
-		else if (strutil::equalCI(node->name(), "thing"))
-			defs_things.push_back(node);
+// -----------------------------------------------------------------------------
+// Reads all UDMF definitions from parse tree [root] into [defs]
+// -----------------------------------------------------------------------------
+void UniversalDoomMapFormat::readDefinitions(ParseTreeNode& root, Definitions& defs) const
+{
+	for (unsigned a = 0; a < root.nChildren(); a++)
+	{
+		auto node = root.childPTN(a);
 
-		// Namespace
-		else if (strutil::equalCI(node->name(), "namespace"))
-			udmf_namespace_ = node->stringValue();
+		// Definition block
+		if (strutil::equalCI(node->name(), "vertex") || strutil::equalCI(node->name(), "linedef")
+			|| strutil::equalCI(node->name(), "sidedef") || strutil::equalCI(node->name(), "sector")
+			|| strutil::equalCI(node->name(), "thing"))
+		{
+			UDMFBlock block{ node->name() };
+			for (unsigned c = 0; c < node->nChildren(); c++)
+			{
+				auto prop = node->childPTN(c);
+				block.fields.push_back({ prop->name(), prop->value(), prop->nValues() > 0 });
+			}
+
+			addDefinition(block, defs);
+		}
 
-		// Unknown
+		// Top-level field
 		else
-			defs_other.push_back(node);
+			defs.fields.push_back({ node->name(), node->value(), node->nValues() > 0 });
 	}
+}
 
-	// Now create map structures from parsed data, in the right order
+// -----------------------------------------------------------------------------
+// Adds UDMF definition [block] to [defs], creating the map object for it if
+// it doesn't reference any other objects
+// -----------------------------------------------------------------------------
+void UniversalDoomMapFormat::addDefinition(UDMFBlock& block, Definitions& defs) const
+{
+	if (strutil::equalCI(block.type, "vertex"))
+		defs.vertices.push_back(createVertex(block));
+	else if (strutil::equalCI(block.type, "sector"))
+		defs.sectors.push_back(createSector(block));
+	else if (strutil::equalCI(block.type, "thing"))
+		defs.things.push_back(createThing(block));
+	else if (strutil::equalCI(block.type, "sidedef"))
+		defs.sides.push_back(std::move(block));
+	else if (strutil::equalCI(block.type, "linedef"))
+		defs.lines.push_back(std::move(block));
+
+	// TODO: Unknown blocks
+}
 
-	// Create vertices from parsed data
+// -----------------------------------------------------------------------------
+// Adds the map objects from [defs] to [map_data], creating sides and lines
+// once the objects they reference are added. Map-scope fields are added to
+// [map_extra_props]
+// -----------------------------------------------------------------------------
+void UniversalDoomMapFormat::addObjects(
+	Definitions&         defs,
+	MapObjectCollection& map_data,
+	PropertyList&        map_extra_props)
+{
+	// Add vertices
 	ui::setSplashProgressMessage("Reading Vertices");
-	for (unsigned a = 0; a < defs_vertices.size(); a++)
+	for (unsigned a = 0; a < defs.vertices.size(); a++)
 	{
-		ui::setSplashProgress(((float)a / defs_vertices.size()) * 0.2f);
+		ui::setSplashProgress(((float)a / defs.vertices.size()) * 0.2f);
 
-		auto vertex = createVertex(defs_vertices[a]);
-		if (!vertex)
+		if (!defs.vertices[a])
 		{
 			log::warning("Invalid UDMF vertex definition {}, not added", a);
 			continue;
 		}
 
-		map_data.addVertex(std::move(vertex));
+		map_data.addVertex(std::move(defs.vertices[a]));
 	}
 
-	// Create sectors from parsed data
+	// Add sectors
 	ui::setSplashProgressMessage("Reading Sectors");
-	for (unsigned a = 0; a < defs_sectors.size(); a++)
+	for (unsigned a = 0; a < defs.sectors.size(); a++)
 	{
-		ui::setSplashProgress(0.2f + ((float)a / defs_sectors.size()) * 0.2f);
+		ui::setSplashProgress(0.2f + ((float)a / defs.sectors.size()) * 0.2f);
 
-		auto sector = createSector(defs_sectors[a]);
-		if (!sector)
+		if (!defs.sectors[a])
 		{
 			log::warning("Invalid UDMF sector definition {}, not added", a);
 			continue;
 		}
 
-		map_data.addSector(std::move(sector));
+		map_data.addSector(std::move(defs.sectors[a]));
 	}
 
-	// Create sides from parsed data
+	// Create sides
 	ui::setSplashProgressMessage("Reading Sides");
-	for (unsigned a = 0; a < defs_sides.size(); a++)
+	for (unsigned a = 0; a < defs.sides.size(); a++)
 	{
-		ui::setSplashProgress(0.4f + ((float)a / defs_sides.size()) * 0.2f);
+		ui::setSplashProgress(0.4f + ((float)a / defs.sides.size()) * 0.2f);
 
-		auto side = createSide(defs_sides[a], map_data);
+		auto side = createSide(defs.sides[a], map_data);
 		if (!side)
 		{
 			log::warning("Invalid UDMF side definition {}, not added", a);
@@ -172,13 +376,13 @@ bool UniversalDoomMapFormat::readMap(Archive::MapDesc map, MapObjectCollection&
 		map_data.addSide(std::move(side));
 	}
 
-	// Create lines from parsed data
+	// Create lines
 	ui::setSplashProgressMessage("Reading Lines");
-	for (unsigned a = 0; a < defs_lines.size(); a++)
+	for (unsigned a = 0; a < defs.lines.size(); a++)
 	{
-		ui::setSplashProgress(0.6f + ((float)a / defs_lines.size()) * 0.2f);
+		ui::setSplashProgress(0.6f + ((float)a / defs.lines.size()) * 0.2f);
 
-		auto line = createLine(defs_lines[a], map_data);
+		auto line = createLine(defs.lines[a], map_data);
 		if (!line)
 		{
 			log::warning("Invalid UDMF line definition {}, not added", a);
@@ -188,151 +392,39 @@ bool UniversalDoomMapFormat::readMap(Archive::MapDesc map, MapObjectCollection&
 		map_data.addLine(std::move(line));
 	}
 
-	// Create things from parsed data
+	// Add things
 	ui::setSplashProgressMessage("Reading Things");
-	for (unsigned a = 0; a < defs_things.size(); a++)
+	for (unsigned a = 0; a < defs.things.size(); a++)
 	{
-		ui::setSplashProgress(0.8f + ((float)a / defs_things.size()) * 0.2f);
+		ui::setSplashProgress(0.8f + ((float)a / defs.things.size()) * 0.2f);
 
-		auto thing = createThing(defs_things[a]);
-		if (!thing)
+		if (!defs.things[a])
 		{
 			log::warning("Invalid UDMF thing definition {}, not added", a);
 			continue;
 		}
 
-		map_data.addThing(std::move(thing));
+		map_data.addThing(std::move(defs.things[a]));
 	}
 
 	// Keep map-scope values
-	for (auto node : defs_other)
-	{
-		if (node->nValues() > 0)
-			map_extra_props[node->name()] = node->value();
-
-		// TODO: Unknown blocks
-	}
-
-	ui::setSplashProgressMessage("Init map data");
-
-	return true;
-}
-
-// -----------------------------------------------------------------------------
-// Writes the given [map_data] to UDMF format, returning the list of entries
-// making up the map
-// -----------------------------------------------------------------------------
-vector<unique_ptr<ArchiveEntry>> UniversalDoomMapFormat::writeMap(
-	const MapObjectCollection& map_data,
-	const PropertyList&        map_extra_props)
-{
-	vector<unique_ptr<ArchiveEntry>> entries;
-	entries.push_back(std::make_unique<ArchiveEntry>("TEXTMAP"));
-
-	// Open temp text file
-	wxFile tempfile(app::path("sladetemp.txt", app::Dir::Temp), wxFile::write);
-
-	// Write map namespace
-	tempfile.Write("// Written by SLADE3\n");
-	tempfile.Write(fmt::format("namespace=\"{}\";\n", udmf_namespace_));
-
-	// Write map-scope props
-	tempfile.Write(map_extra_props.toString(true));
-	tempfile.Write("\n");
-
-	// sf::Clock clock;
-
-	// Locale for float number format
-	setlocale(LC_NUMERIC, "C");
-
-	// Write things
-	string object_def;
-	for (const auto& thing : map_data.things())
-	{
-		// Cleanup properties
-		if (!thing->props().empty())
-		{
-			thing->props().remove("flags");
-			game::configuration().cleanObjectUDMFProps(thing);
-		}
-
-		thing->writeUDMF(object_def);
-		tempfile.Write(object_def);
-	}
-	// log::info(1, "Writing things took %dms", clock.getElapsedTime().asMilliseconds());
-
-	// Write lines
-	// clock.restart();
-	for (const auto& line : map_data.lines())
-	{
-		// Cleanup properties
-		if (!line->props().empty())
-		{
-			line->props().remove("flags");
-			game::configuration().cleanObjectUDMFProps(line);
-		}
-
-		line->writeUDMF(object_def);
-		tempfile.Write(object_def);
-	}
-	// log::info(1, "Writing lines took %dms", clock.getElapsedTime().asMilliseconds());
-
-	// Write sides
-	// clock.restart();
-	for (const auto& side : map_data.sides())
-	{
-		// Cleanup properties
-		if (!side->props().empty())
-			game::configuration().cleanObjectUDMFProps(side);
-
-		side->writeUDMF(object_def);
-		tempfile.Write(object_def);
-	}
-	// log::info(1, "Writing sides took %dms", clock.getElapsedTime().asMilliseconds());
-
-	// Write vertices
-	// clock.restart();
-	for (const auto& vertex : map_data.vertices())
-	{
-		// Cleanup properties
-		if (!vertex->props().empty())
-			game::configuration().cleanObjectUDMFProps(vertex);
-
-		vertex->writeUDMF(object_def);
-		tempfile.Write(object_def);
-	}
-	// log::info(1, "Writing vertices took %dms", clock.getElapsedTime().asMilliseconds());
-
-	// Write sectors
-	// clock.restart();
-	for (const auto& sector : map_data.sectors())
+	for (const auto& field : defs.fields)
 	{
-		// Cleanup properties
-		if (!sector->props().empty())
-			game::configuration().cleanObjectUDMFProps(sector);
-
-		sector->writeUDMF(object_def);
-		tempfile.Write(object_def);
+		if (strutil::equalCI(field.name, "namespace"))
+			udmf_namespace_ = field.stringValue();
+		else if (field.has_value)
+			map_extra_props[field.name] = field.value;
 	}
-	// log::info(1, "Writing sectors took %dms", clock.getElapsedTime().asMilliseconds());
-
-	// Close file
-	tempfile.Close();
-
-	// Load file to entry
-	entries[0]->importFile(app::path("sladetemp.txt", app::Dir::Temp));
-
-	return entries;
 }
 
 // -----------------------------------------------------------------------------
 // Creates and returns a vertex from parsed UDMF definition [def]
 // -----------------------------------------------------------------------------
-unique_ptr<MapVertex> UniversalDoomMapFormat::createVertex(ParseTreeNode* def) const
+unique_ptr<MapVertex> UniversalDoomMapFormat::createVertex(const UDMFBlock& def) const
 {
 	// Check for required properties
-	auto prop_x = def->childPTN("x");
-	auto prop_y = def->childPTN("y");
+	auto prop_x = def.field("x");
+	auto prop_y = def.field("y");
 	if (!prop_x || !prop_y)
 		return nullptr;
 
@@ -343,11 +435,11 @@ unique_ptr<MapVertex> UniversalDoomMapFormat::createVertex(ParseTreeNode* def) c
 // -----------------------------------------------------------------------------
 // Creates and returns a sector from parsed UDMF definition [def]
 // -----------------------------------------------------------------------------
-unique_ptr<MapSector> UniversalDoomMapFormat::createSector(ParseTreeNode* def) const
+unique_ptr<MapSector> UniversalDoomMapFormat::createSector(const UDMFBlock& def) const
 {
 	// Check for required properties
-	auto prop_ftex = def->childPTN("texturefloor");
-	auto prop_ctex = def->childPTN("textureceiling");
+	auto prop_ftex = def.field("texturefloor");
+	auto prop_ctex = def.field("textureceiling");
 	if (!prop_ftex || !prop_ctex)
 		return nullptr;
 
@@ -358,10 +450,10 @@ unique_ptr<MapSector> UniversalDoomMapFormat::createSector(ParseTreeNode* def) c
 // -----------------------------------------------------------------------------
 // Creates and returns a side from parsed UDMF definition [def]
 // -----------------------------------------------------------------------------
-unique_ptr<MapSide> UniversalDoomMapFormat::createSide(ParseTreeNode* def, const MapObjectCollection& map_data) const
+unique_ptr<MapSide> UniversalDoomMapFormat::createSide(const UDMFBlock& def, const MapObjectCollection& map_data) const
 {
 	// Check for required properties
-	auto prop_sector = def->childPTN("sector");
+	auto prop_sector = def.field("sector");
 	if (!prop_sector)
 		return nullptr;
 
@@ -377,13 +469,13 @@ unique_ptr<MapSide> UniversalDoomMapFormat::createSide(ParseTreeNode* def, const
 // -----------------------------------------------------------------------------
 // Creates and returns a line from parsed UDMF definition [def]
 // -----------------------------------------------------------------------------
-unique_ptr<MapLine> UniversalDoomMapFormat::createLine(ParseTreeNode* def, const MapObjectCollection& map_data) const
+unique_ptr<MapLine> UniversalDoomMapFormat::createLine(const UDMFBlock& def, const MapObjectCollection& map_data) const
 {
 	// Check for required properties
-	auto prop_v1 = def->childPTN(MapLine::PROP_V1);
-	auto prop_v2 = def->childPTN(MapLine::PROP_V2);
-	auto prop_s1 = def->childPTN(MapLine::PROP_S1);
-	auto prop_s2 = def->childPTN(MapLine::PROP_S2);
+	auto prop_v1 = def.field(MapLine::PROP_V1);
+	auto prop_v2 = def.field(MapLine::PROP_V2);
+	auto prop_s1 = def.field(MapLine::PROP_S1);
+	auto prop_s2 = def.field(MapLine::PROP_S2);
 	if (!prop_v1 || !prop_v2 || !prop_s1)
 		return nullptr;
 
@@ -404,12 +496,12 @@ unique_ptr<MapLine> UniversalDoomMapFormat::createLine(ParseTreeNode* def, const
 // -----------------------------------------------------------------------------
 // Creates and returns a thing from parsed UDMF definition [def]
 // -----------------------------------------------------------------------------
-unique_ptr<MapThing> UniversalDoomMapFormat::createThing(ParseTreeNode* def) const
+unique_ptr<MapThing> UniversalDoomMapFormat::createThing(const UDMFBlock& def) const
 {
 	// Check for required properties
-	auto prop_x    = def->childPTN(MapThing::PROP_X);
-	auto prop_y    = def->childPTN(MapThing::PROP_Y);
-	auto prop_type = def->childPTN(MapThing::PROP_TYPE);
+	auto prop_x    = def.field(MapThing::PROP_X);
+	auto prop_y    = def.field(MapThing::PROP_Y);
+	auto prop_type = def.field(MapThing::PROP_TYPE);
 	if (!prop_x || !prop_y || !prop_type)
 		return nullptr;
 
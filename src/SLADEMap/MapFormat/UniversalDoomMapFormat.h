@@ -10,6 +10,7 @@ class MapSide;
 class MapLine;
 class MapThing;
 class ParseTreeNode;
+struct UDMFBlock;
 
 class UniversalDoomMapFormat : public MapFormatHandler
 {
@@ -23,12 +24,19 @@ public:
 	void   setUDMFNamespace(string_view ns) override { udmf_namespace_ = ns; }
 
 private:
+	struct Definitions;
+
 	string udmf_namespace_;
 
-	unique_ptr<MapVertex> createVertex(ParseTreeNode* def) const;
-	unique_ptr<MapSector> createSector(ParseTreeNode* def) const;
-	unique_ptr<MapSide>   createSide(ParseTreeNode* def, const MapObjectCollection& map_data) const;
-	unique_ptr<MapLine>   createLine(ParseTreeNode* def, const MapObjectCollection& map_data) const;
-	unique_ptr<MapThing>  createThing(ParseTreeNode* def) const;
+	bool readDefinitions(char* start, char* end, Definitions& defs) const;
+	void readDefinitions(ParseTreeNode& root, Definitions& defs) const;
+	void addDefinition(UDMFBlock& block, Definitions& defs) const;
+	void addObjects(Definitions& defs, MapObjectCollection& map_data, PropertyList& map_extra_props);
+
+	unique_ptr<MapVertex> createVertex(const UDMFBlock& def) const;
+	unique_ptr<MapSector> createSector(const UDMFBlock& def) const;
+	unique_ptr<MapSide>   createSide(const UDMFBlock& def, const MapObjectCollection& map_data) const;
+	unique_ptr<MapLine>   createLine(const UDMFBlock& def, const MapObjectCollection& map_data) const;
+	unique_ptr<MapThing>  createThing(const UDMFBlock& def) const;
 };
 } // namespace slade
@@ -41,7 +41,7 @@ public:
 		int        special = 0,
 		int        flags   = 0,
 		ArgSet     args    = {});
-	MapLine(MapVertex* v1, MapVertex* v2, MapSide* s1, MapSide* s2, ParseTreeNode* udmf_def);
+	MapLine(MapVertex* v1, MapVertex* v2, MapSide* s1, MapSide* s2, const UDMFBlock& udmf_def);
 	~MapLine() = default;
 
 	bool isOk() const { return vertex1_ && vertex2_; }
@@ -39,17 +39,6 @@
 using namespace slade;
 
 
-// -----------------------------------------------------------------------------
-//
-// Variables
-//
-// -----------------------------------------------------------------------------
-namespace
-{
-long prop_backup_time = -1;
-} // namespace
-
-
 // -----------------------------------------------------------------------------
 //
 // MapObject Class Functions
@@ -96,11 +85,20 @@ string MapObject::typeName() const
 // -----------------------------------------------------------------------------
 void MapObject::setModified()
 {
-	// Backup current properties if required
-	if (obj_id_ > 0 && modified_time_ < prop_backup_time)
+	if (parent_map_)
 	{
-		obj_backup_ = std::make_unique<Backup>();
-		backupTo(obj_backup_.get());
+		// Backup current properties if this is the first modification while
+		// recording undo
+		if (obj_id_ > 0 && parent_map_->undoJournal().objectModified(this))
+		{
+			obj_backup_ = std::make_unique<Backup>();
+			backupTo(obj_backup_.get());
+		}
+
+		// Flag as modified in the map's spatial and tag indices and specials
+		parent_map_->spatialIndex().objectModified(this);
+		parent_map_->tagIndex().objectModified(this);
+		parent_map_->mapSpecials()->objectModified(this);
 	}
 
 	modified_time_ = app::runTimer();
@@ -135,8 +133,8 @@ void MapObject::copy(MapObject* c)
 // -----------------------------------------------------------------------------
 bool MapObject::hasProp(string_view key)
 {
-	if (properties_.contains(key))
-		return property::hasValue(properties_[key]);
+	if (auto prop = properties_.getIf(key))
+		return property::hasValue(*prop);
 
 	return false;
 }
@@ -317,34 +315,6 @@ MapObject::Backup* MapObject::backup(bool remove)
 // -----------------------------------------------------------------------------
 
 
-// -----------------------------------------------------------------------------
-// Returns the property backup time (used for the undo system - if an object's
-// properties are modified, they will be backed up first if they haven't since
-// this time)
-// -----------------------------------------------------------------------------
-long MapObject::propBackupTime()
-{
-	return prop_backup_time;
-}
-
-// -----------------------------------------------------------------------------
-// Begins property backup, any time a MapObject property is changed its
-// properties will be backed up before changing (only once)
-// -----------------------------------------------------------------------------
-void MapObject::beginPropBackup(long current_time)
-{
-	prop_backup_time = current_time;
-}
-
-// -----------------------------------------------------------------------------
-// End property backup
-// -----------------------------------------------------------------------------
-void MapObject::endPropBackup()
-{
-	prop_backup_time = -1;
-}
-
-
 // -----------------------------------------------------------------------------
 // Checks the boolean property [prop] on all objects in [objects].
 // If all values are the same, [value] is set and returns true, otherwise
@@ -11,6 +11,7 @@ namespace slade
 {
 class ParseTreeNode;
 class SLADEMap;
+struct UDMFBlock;
 
 // Forward declare map object types
 class MapVertex;
@@ -99,10 +100,6 @@ public:
 
 	virtual void writeUDMF(string& def) {}
 
-	static long propBackupTime();
-	static void beginPropBackup(long current_time);
-	static void endPropBackup();
-
 	static bool multiBoolProperty(vector<MapObject*>& objects, string_view prop, bool& value);
 	static bool multiIntProperty(vector<MapObject*>& objects, string_view prop, int& value);
 	static bool multiFloatProperty(vector<MapObject*>& objects, string_view prop, double& value);
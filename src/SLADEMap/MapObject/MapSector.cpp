@@ -33,13 +33,26 @@
 #include "MapSector.h"
 #include "App.h"
 #include "Game/Configuration.h"
+#include "SLADEMap/MapFormat/UDMFReader.h"
 #include "SLADEMap/SLADEMap.h"
 #include "Utility/MathStuff.h"
-#include "Utility/Parser.h"
 
 using namespace slade;
 
 
+// -----------------------------------------------------------------------------
+//
+// Variables
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// Keys of the plane equation properties kept when writing sloped planes
+const property::Key KEY_FLOORPLANE[]   = { "floorplane_a", "floorplane_b", "floorplane_c", "floorplane_d" };
+const property::Key KEY_CEILINGPLANE[] = { "ceilingplane_a", "ceilingplane_b", "ceilingplane_c", "ceilingplane_d" };
+} // namespace
+
+
 // -----------------------------------------------------------------------------
 //
 // MapSector Class Functions
@@ -71,7 +84,7 @@ MapSector::MapSector(
 // -----------------------------------------------------------------------------
 // MapSector class constructor from UDMF definition
 // -----------------------------------------------------------------------------
-MapSector::MapSector(string_view f_tex, string_view c_tex, ParseTreeNode* udmf_def) :
+MapSector::MapSector(string_view f_tex, string_view c_tex, const UDMFBlock& udmf_def) :
 	MapObject(Type::Sector),
 	floor_{ f_tex },
 	ceiling_{ c_tex }
@@ -80,27 +93,24 @@ MapSector::MapSector(string_view f_tex, string_view c_tex, ParseTreeNode* udmf_d
 	light_ = 160;
 
 	// Set properties from UDMF definition
-	ParseTreeNode* prop;
-	for (unsigned a = 0; a < udmf_def->nChildren(); a++)
+	for (const auto& prop : udmf_def.fields)
 	{
-		prop = udmf_def->childPTN(a);
-
 		// Skip required properties
-		if (prop->nameIsCI(PROP_TEXFLOOR) || prop->nameIsCI(PROP_TEXCEILING))
+		if (strutil::equalCI(prop.name, PROP_TEXFLOOR) || strutil::equalCI(prop.name, PROP_TEXCEILING))
 			continue;
 
-		if (prop->nameIsCI(PROP_HEIGHTFLOOR))
-			setFloorHeight(prop->intValue());
-		else if (prop->nameIsCI(PROP_HEIGHTCEILING))
-			setCeilingHeight(prop->intValue());
-		else if (prop->nameIsCI(PROP_LIGHTLEVEL))
-			light_ = prop->intValue();
-		else if (prop->nameIsCI(PROP_SPECIAL))
-			special_ = prop->intValue();
-		else if (prop->nameIsCI(PROP_ID))
-			id_ = prop->intValue();
+		if (strutil::equalCI(prop.name, PROP_HEIGHTFLOOR))
+			setFloorHeight(prop.intValue());
+		else if (strutil::equalCI(prop.name, PROP_HEIGHTCEILING))
+			setCeilingHeight(prop.intValue());
+		else if (strutil::equalCI(prop.name, PROP_LIGHTLEVEL))
+			light_ = prop.intValue();
+		else if (strutil::equalCI(prop.name, PROP_SPECIAL))
+			special_ = prop.intValue();
+		else if (strutil::equalCI(prop.name, PROP_ID))
+			id_ = prop.intValue();
 		else
-			properties_[prop->name()] = prop->value();
+			properties_[prop.name] = prop.value;
 	}
 }
 
@@ -897,24 +907,25 @@ void MapSector::readBackup(Backup* backup)
 }
 
 // -----------------------------------------------------------------------------
-// Writes the sector as a UDMF text definition to [def]
+// Appends the sector as a UDMF text definition to [def]
 // -----------------------------------------------------------------------------
 void MapSector::writeUDMF(string& def)
 {
-	def = fmt::format("sector//#{}\n{{\n", index_);
+	auto out = std::back_inserter(def);
+	fmt::format_to(out, "sector//#{}\n{{\n", index_);
 
 	// Basic properties
-	def += fmt::format("texturefloor=\"{}\";\ntextureceiling=\"{}\";\n", floor_.texture, ceiling_.texture);
+	fmt::format_to(out, "texturefloor=\"{}\";\ntextureceiling=\"{}\";\n", floor_.texture, ceiling_.texture);
 	if (floor_.height != 0)
-		def += fmt::format("heightfloor={};\n", floor_.height);
+		fmt::format_to(out, "heightfloor={};\n", floor_.height);
 	if (ceiling_.height != 0)
-		def += fmt::format("heightceiling={};\n", ceiling_.height);
+		fmt::format_to(out, "heightceiling={};\n", ceiling_.height);
 	if (light_ != 160)
-		def += fmt::format("lightlevel={};\n", light_);
+		fmt::format_to(out, "lightlevel={};\n", light_);
 	if (special_ != 0)
-		def += fmt::format("special={};\n", special_);
+		fmt::format_to(out, "special={};\n", special_);
 	if (id_ != 0)
-		def += fmt::format("id={};\n", id_);
+		fmt::format_to(out, "id={};\n", id_);
 
 	// For UDMF sector planes, ALL values must be added, or else GZDoom
 	// will consider them invalid.
@@ -934,10 +945,8 @@ void MapSector::writeUDMF(string& def)
 		floor_c = -floor_.plane.c;
 		floor_d = floor_.plane.d;
 		// Write the floor/ceiling plane properties in order later
-		properties_.remove("floorplane_a");
-		properties_.remove("floorplane_b");
-		properties_.remove("floorplane_c");
-		properties_.remove("floorplane_d");
+		for (const auto& key : KEY_FLOORPLANE)
+			properties_.remove(key);
 	}
 	// Do the same for the ceiling plane
 	double ceiling_a = 0, ceiling_b = 0, ceiling_c = 0, ceiling_d = 0;
@@ -950,40 +959,38 @@ void MapSector::writeUDMF(string& def)
 		ceiling_b = -ceiling_.plane.b;
 		ceiling_c = -ceiling_.plane.c;
 		ceiling_d = ceiling_.plane.d;
-		properties_.remove("ceilingplane_a");
-		properties_.remove("ceilingplane_b");
-		properties_.remove("ceilingplane_c");
-		properties_.remove("ceilingplane_d");
+		for (const auto& key : KEY_CEILINGPLANE)
+			properties_.remove(key);
 	}
 
 	// Other properties (that are not related to floor/ceiling planes
 	if (!properties_.empty())
-		def += properties_.toString(true);
+		properties_.toString(def, true);
 
 	// Write the floor and ceiling plane values in order
 	if (hasFloorPlane)
 	{
-		def += fmt::format("floorplane_a = {};", floor_a);
-		def += fmt::format("floorplane_b = {};", floor_b);
-		def += fmt::format("floorplane_c = {};", floor_c);
-		def += fmt::format("floorplane_d = {};", floor_d);
+		fmt::format_to(out, "floorplane_a = {};", floor_a);
+		fmt::format_to(out, "floorplane_b = {};", floor_b);
+		fmt::format_to(out, "floorplane_c = {};", floor_c);
+		fmt::format_to(out, "floorplane_d = {};", floor_d);
 		// Persist between multiple saves
-		properties_["floorplane_a"] = floor_a;
-		properties_["floorplane_b"] = floor_b;
-		properties_["floorplane_c"] = floor_c;
-		properties_["floorplane_d"] = floor_d;
+		properties_[KEY_FLOORPLANE[0]] = floor_a;
+		properties_[KEY_FLOORPLANE[1]] = floor_b;
+		properties_[KEY_FLOORPLANE[2]] = floor_c;
+		properties_[KEY_FLOORPLANE[3]] = floor_d;
 	}
 	if (hasCeilingPlane)
 	{
-		def += fmt::format("ceilingplane_a = {};", ceiling_a);
-		def += fmt::format("ceilingplane_b = {};", ceiling_b);
-		def += fmt::format("ceilingplane_c = {};", ceiling_c);
-		def += fmt::format("ceilingplane_d = {};", ceiling_d);
+		fmt::format_to(out, "ceilingplane_a = {};", ceiling_a);
+		fmt::format_to(out, "ceilingplane_b = {};", ceiling_b);
+		fmt::format_to(out, "ceilingplane_c = {};", ceiling_c);
+		fmt::format_to(out, "ceilingplane_d = {};", ceiling_d);
 		// Persist between multiple saves
-		properties_["ceilingplane_a"] = ceiling_a;
-		properties_["ceilingplane_b"] = ceiling_b;
-		properties_["ceilingplane_c"] = ceiling_c;
-		properties_["ceilingplane_d"] = ceiling_d;
+		properties_[KEY_CEILINGPLANE[0]] = ceiling_a;
+		properties_[KEY_CEILINGPLANE[1]] = ceiling_b;
+		properties_[KEY_CEILINGPLANE[2]] = ceiling_c;
+		properties_[KEY_CEILINGPLANE[3]] = ceiling_d;
 	}
 
 	def += "}\n\n";
@@ -49,7 +49,7 @@ public:
 		short       light    = 0,
 		short       special  = 0,
 		short       id       = 0);
-	MapSector(string_view f_tex, string_view c_tex, ParseTreeNode* udmf_def);
+	MapSector(string_view f_tex, string_view c_tex, const UDMFBlock& udmf_def);
 	~MapSector() = default;
 
 	void copy(MapObject* obj) override;
@@ -32,8 +32,8 @@
 #include "Main.h"
 #include "MapSide.h"
 #include "Game/Configuration.h"
+#include "SLADEMap/MapFormat/UDMFReader.h"
 #include "SLADEMap/SLADEMap.h"
-#include "Utility/Parser.h"
 #include "Utility/StringUtils.h"
 
 using namespace slade;
@@ -69,33 +69,30 @@ MapSide::MapSide(
 // -----------------------------------------------------------------------------
 // MapSide class constructor from UDMF definition
 // -----------------------------------------------------------------------------
-MapSide::MapSide(MapSector* sector, ParseTreeNode* udmf_def) : MapObject{ Type::Side }, sector_{ sector }
+MapSide::MapSide(MapSector* sector, const UDMFBlock& udmf_def) : MapObject{ Type::Side }, sector_{ sector }
 {
 	if (sector)
 		sector->connectSide(this);
 
 	// Set properties from UDMF definition
-	ParseTreeNode* prop;
-	for (unsigned a = 0; a < udmf_def->nChildren(); a++)
+	for (const auto& prop : udmf_def.fields)
 	{
-		prop = udmf_def->childPTN(a);
-
 		// Skip required properties
-		if (prop->nameIsCI(PROP_SECTOR))
+		if (strutil::equalCI(prop.name, PROP_SECTOR))
 			continue;
 
-		if (prop->nameIsCI(PROP_TEXUPPER))
-			tex_upper_ = prop->stringValue();
-		else if (prop->nameIsCI(PROP_TEXMIDDLE))
-			tex_middle_ = prop->stringValue();
-		else if (prop->nameIsCI(PROP_TEXLOWER))
-			tex_lower_ = prop->stringValue();
-		else if (prop->nameIsCI(PROP_OFFSETX))
-			tex_offset_.x = prop->intValue();
-		else if (prop->nameIsCI(PROP_OFFSETY))
-			tex_offset_.y = prop->intValue();
+		if (strutil::equalCI(prop.name, PROP_TEXUPPER))
+			tex_upper_ = prop.stringValue();
+		else if (strutil::equalCI(prop.name, PROP_TEXMIDDLE))
+			tex_middle_ = prop.stringValue();
+		else if (strutil::equalCI(prop.name, PROP_TEXLOWER))
+			tex_lower_ = prop.stringValue();
+		else if (strutil::equalCI(prop.name, PROP_OFFSETX))
+			tex_offset_.x = prop.intValue();
+		else if (strutil::equalCI(prop.name, PROP_OFFSETY))
+			tex_offset_.y = prop.intValue();
 		else
-			properties_[prop->name()] = prop->value();
+			properties_[prop.name] = prop.value;
 		// log::info(1, "Property %s type %s (%s)", prop->getName(), prop->getValue().typeString(),
 		// prop->getValue().getStringValue());
 	}
@@ -243,6 +240,10 @@ void MapSide::setSector(MapSector* sector)
 	// Add side to new sector
 	sector_ = sector;
 	sector->connectSide(this);
+
+	// Sector adjacency has changed
+	if (parent_map_)
+		parent_map_->setGeometryUpdated();
 }
 
 // -----------------------------------------------------------------------------
@@ -376,28 +377,29 @@ void MapSide::readBackup(Backup* backup)
 }
 
 // -----------------------------------------------------------------------------
-// Writes the side as a UDMF text definition to [def]
+// Appends the side as a UDMF text definition to [def]
 // -----------------------------------------------------------------------------
 void MapSide::writeUDMF(string& def)
 {
-	def = fmt::format("sidedef//#{}\n{{\n", index_);
+	auto out = std::back_inserter(def);
+	fmt::format_to(out, "sidedef//#{}\n{{\n", index_);
 
 	// Basic properties
-	def += fmt::format("sector={};\n", sector_->index());
+	fmt::format_to(out, "sector={};\n", sector_->index());
 	if (tex_upper_ != "-")
-		def += fmt::format("texturetop=\"{}\";\n", tex_upper_);
+		fmt::format_to(out, "texturetop=\"{}\";\n", tex_upper_);
 	if (tex_middle_ != "-")
-		def += fmt::format("texturemiddle=\"{}\";\n", tex_middle_);
+		fmt::format_to(out, "texturemiddle=\"{}\";\n", tex_middle_);
 	if (tex_lower_ != "-")
-		def += fmt::format("texturebottom=\"{}\";\n", tex_lower_);
+		fmt::format_to(out, "texturebottom=\"{}\";\n", tex_lower_);
 	if (tex_offset_.x != 0)
-		def += fmt::format("offsetx={};\n", tex_offset_.x);
+		fmt::format_to(out, "offsetx={};\n", tex_offset_.x);
 	if (tex_offset_.y != 0)
-		def += fmt::format("offsety={};\n", tex_offset_.y);
+		fmt::format_to(out, "offsety={};\n", tex_offset_.y);
 
 	// Other properties
 	if (!properties_.empty())
-		def += properties_.toString(true);
+		properties_.toString(def, true);
 
 	def += "}\n\n";
 }
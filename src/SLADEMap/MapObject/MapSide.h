@@ -27,7 +27,7 @@ public:
 		string_view tex_middle = TEX_NONE,
 		string_view tex_lower  = TEX_NONE,
 		Vec2i       tex_offset = { 0, 0 });
-	MapSide(MapSector* sector, ParseTreeNode* udmf_def);
+	MapSide(MapSector* sector, const UDMFBlock& udmf_def);
 	~MapSide() = default;
 
 	void copy(MapObject* c) override;
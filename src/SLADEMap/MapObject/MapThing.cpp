@@ -31,7 +31,7 @@
 // -----------------------------------------------------------------------------
 #include "Main.h"
 #include "MapThing.h"
-#include "Utility/Parser.h"
+#include "SLADEMap/MapFormat/UDMFReader.h"
 
 using namespace slade;
 
@@ -62,45 +62,42 @@ MapThing::MapThing(const Vec3d& pos, short type, short angle, short flags, const
 // -----------------------------------------------------------------------------
 // MapThing class constructor from UDMF definition
 // -----------------------------------------------------------------------------
-MapThing::MapThing(const Vec3d& pos, short type, ParseTreeNode* def) :
+MapThing::MapThing(const Vec3d& pos, short type, const UDMFBlock& def) :
 	MapObject(Type::Thing),
 	type_{ type },
 	position_{ pos.x, pos.y },
 	z_{ pos.z }
 {
 	// Set properties from UDMF definition
-	ParseTreeNode* prop;
-	for (unsigned a = 0; a < def->nChildren(); a++)
+	for (const auto& prop : def.fields)
 	{
-		prop = def->childPTN(a);
-
 		// Skip required properties
-		if (prop->name() == PROP_X || prop->name() == PROP_Y || prop->name() == PROP_TYPE)
+		if (prop.name == PROP_X || prop.name == PROP_Y || prop.name == PROP_TYPE)
 			continue;
 
 		// Builtin properties
-		if (prop->name() == PROP_Z)
-			z_ = prop->floatValue();
-		else if (prop->name() == PROP_ANGLE)
-			angle_ = prop->intValue();
-		else if (prop->name() == PROP_FLAGS)
-			flags_ = prop->intValue();
-		else if (prop->name() == PROP_ARG0)
-			args_[0] = prop->intValue();
-		else if (prop->name() == PROP_ARG1)
-			args_[1] = prop->intValue();
-		else if (prop->name() == PROP_ARG2)
-			args_[2] = prop->intValue();
-		else if (prop->name() == PROP_ARG3)
-			args_[3] = prop->intValue();
-		else if (prop->name() == PROP_ARG4)
-			args_[4] = prop->intValue();
-		else if (prop->name() == PROP_ID)
-			id_ = prop->intValue();
-		else if (prop->name() == PROP_SPECIAL)
-			special_ = prop->intValue();
+		if (prop.name == PROP_Z)
+			z_ = prop.floatValue();
+		else if (prop.name == PROP_ANGLE)
+			angle_ = prop.intValue();
+		else if (prop.name == PROP_FLAGS)
+			flags_ = prop.intValue();
+		else if (prop.name == PROP_ARG0)
+			args_[0] = prop.intValue();
+		else if (prop.name == PROP_ARG1)
+			args_[1] = prop.intValue();
+		else if (prop.name == PROP_ARG2)
+			args_[2] = prop.intValue();
+		else if (prop.name == PROP_ARG3)
+			args_[3] = prop.intValue();
+		else if (prop.name == PROP_ARG4)
+			args_[4] = prop.intValue();
+		else if (prop.name == PROP_ID)
+			id_ = prop.intValue();
+		else if (prop.name == PROP_SPECIAL)
+			special_ = prop.intValue();
 		else
-			properties_[prop->name()] = prop->value();
+			properties_[prop.name] = prop.value;
 	}
 }
 
@@ -419,31 +416,32 @@ void MapThing::readBackup(Backup* backup)
 }
 
 // -----------------------------------------------------------------------------
-// Writes the thing as a UDMF text definition to [def]
+// Appends the thing as a UDMF text definition to [def]
 // -----------------------------------------------------------------------------
 void MapThing::writeUDMF(string& def)
 {
-	def = fmt::format("thing//#{}\n{{\n", index_);
+	auto out = std::back_inserter(def);
+	fmt::format_to(out, "thing//#{}\n{{\n", index_);
 
 	// Basic properties
-	def += fmt::format("x={:1.3f};\ny={:1.3f};\ntype={};\n", position_.x, position_.y, type_);
+	fmt::format_to(out, "x={:1.3f};\ny={:1.3f};\ntype={};\n", position_.x, position_.y, type_);
 	if (z_ != 0)
-		def += fmt::format("height={:1.3f};\n", z_);
+		fmt::format_to(out, "height={:1.3f};\n", z_);
 	if (angle_ != 0)
-		def += fmt::format("angle={};\n", angle_);
+		fmt::format_to(out, "angle={};\n", angle_);
 	if (flags_ != 0)
-		def += fmt::format("flags={};\n", flags_);
+		fmt::format_to(out, "flags={};\n", flags_);
 	if (id_ != 0)
-		def += fmt::format("id={};\n", id_);
+		fmt::format_to(out, "id={};\n", id_);
 	for (unsigned i = 0; i < 5; ++i)
 		if (args_[i] != 0)
-			def += fmt::format("arg{}={};\n", i, args_[i]);
+			fmt::format_to(out, "arg{}={};\n", i, args_[i]);
 	if (special_ != 0)
-		def += fmt::format("special={};\n", special_);
+		fmt::format_to(out, "special={};\n", special_);
 
 	// Other properties
 	if (!properties_.empty())
-		def += properties_.toString(true);
+		properties_.toString(def, true);
 
 	def += "}\n\n";
 }
@@ -32,7 +32,7 @@ public:
 		const ArgSet& args    = {},
 		int           id      = 0,
 		int           special = 0);
-	MapThing(const Vec3d& pos, short type, ParseTreeNode* def);
+	MapThing(const Vec3d& pos, short type, const UDMFBlock& def);
 	~MapThing() = default;
 
 	double        xPos() const { return position_.x; }
@@ -31,8 +31,8 @@
 // -----------------------------------------------------------------------------
 #include "Main.h"
 #include "MapVertex.h"
+#include "SLADEMap/MapFormat/UDMFReader.h"
 #include "SLADEMap/SLADEMap.h"
-#include "Utility/Parser.h"
 
 using namespace slade;
 
@@ -52,19 +52,16 @@ MapVertex::MapVertex(const Vec2d& pos) : MapObject(Type::Vertex), position_{ pos
 // -----------------------------------------------------------------------------
 // MapVertex class constructor from UDMF definition
 // -----------------------------------------------------------------------------
-MapVertex::MapVertex(const Vec2d& pos, ParseTreeNode* udmf_def) : MapObject(Type::Vertex), position_{ pos }
+MapVertex::MapVertex(const Vec2d& pos, const UDMFBlock& udmf_def) : MapObject(Type::Vertex), position_{ pos }
 {
 	// Set properties from UDMF definition
-	ParseTreeNode* prop;
-	for (unsigned a = 0; a < udmf_def->nChildren(); a++)
+	for (const auto& prop : udmf_def.fields)
 	{
-		prop = udmf_def->childPTN(a);
-
 		// Skip required properties
-		if (prop->name() == PROP_X || prop->name() == PROP_Y)
+		if (prop.name == PROP_X || prop.name == PROP_Y)
 			continue;
 
-		properties_[prop->name()] = prop->value();
+		properties_[prop.name] = prop.value;
 	}
 }
 
@@ -226,18 +223,19 @@ void MapVertex::readBackup(Backup* backup)
 }
 
 // -----------------------------------------------------------------------------
-// Writes the vertex as a UDMF text definition to [def]
+// Appends the vertex as a UDMF text definition to [def]
 // -----------------------------------------------------------------------------
 void MapVertex::writeUDMF(string& def)
 {
-	def = fmt::format("vertex//#{}\n{{\n", index_);
+	auto out = std::back_inserter(def);
+	fmt::format_to(out, "vertex//#{}\n{{\n", index_);
 
 	// Basic properties
-	def += fmt::format("x={:1.3f};\ny={:1.3f};\n", position_.x, position_.y);
+	fmt::format_to(out, "x={:1.3f};\ny={:1.3f};\n", position_.x, position_.y);
 
 	// Other properties
 	if (!properties_.empty())
-		def += properties_.toString(true);
+		properties_.toString(def, true);
 
 	def += "}\n\n";
 }
@@ -16,7 +16,7 @@ public:
 	inline static const string PROP_Y = "y";
 
 	MapVertex(const Vec2d& pos);
-	MapVertex(const Vec2d& pos, ParseTreeNode* udmf_def);
+	MapVertex(const Vec2d& pos, const UDMFBlock& udmf_def);
 	~MapVertex() = default;
 
 	double xPos() const { return position_.x; }
@@ -40,6 +40,34 @@
 using namespace slade;
 
 
+// -----------------------------------------------------------------------------
+//
+// Functions
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// -----------------------------------------------------------------------------
+// Adds [object] back to [list] at [index] if [add] is true, otherwise removes
+// it from [list]
+// -----------------------------------------------------------------------------
+template<class T, class L> void applyChange(L& list, T* object, unsigned index, bool add)
+{
+	if (add)
+		list.restore(object, index);
+	else if (list.at(object->index()) == object)
+		list.remove(object->index());
+}
+} // namespace
+
+
+// -----------------------------------------------------------------------------
+//
+// MapObjectCollection Class Functions
+//
+// -----------------------------------------------------------------------------
+
+
 // -----------------------------------------------------------------------------
 // MapObjectCollection class constructor
 // -----------------------------------------------------------------------------
@@ -47,6 +75,13 @@ MapObjectCollection::MapObjectCollection(SLADEMap* parent_map) : parent_map_{ pa
 {
 	// Object id 0 is always null
 	objects_.emplace_back(nullptr, false);
+
+	vertices_.setSpatialIndex(&spatial_index_);
+	lines_.setSpatialIndex(&spatial_index_);
+	sectors_.setSpatialIndex(&spatial_index_);
+	lines_.setTagIndex(&tag_index_);
+	sectors_.setTagIndex(&tag_index_);
+	things_.setTagIndex(&tag_index_);
 }
 
 // -----------------------------------------------------------------------------
@@ -57,6 +92,8 @@ void MapObjectCollection::addMapObject(unique_ptr<MapObject> object)
 	object->obj_id_     = objects_.size();
 	object->parent_map_ = parent_map_;
 	objects_.emplace_back(std::move(object), true);
+	objectModified(objects_.back().object.get());
+	undo_journal_.objectAdded(objects_.back().object.get());
 }
 
 // -----------------------------------------------------------------------------
@@ -66,120 +103,47 @@ void MapObjectCollection::addMapObject(unique_ptr<MapObject> object)
 void MapObjectCollection::removeMapObject(MapObject* object)
 {
 	objects_[object->obj_id_].in_map = false;
+	objectModified(object);
+	undo_journal_.objectRemoved(object);
 }
 
 // -----------------------------------------------------------------------------
-// Adds all object ids of [type] currently in the map to [list]
+// Flags [object] as modified (or added/removed) in the indices and the parent
+// map's specials
 // -----------------------------------------------------------------------------
-void MapObjectCollection::putObjectIdList(MapObject::Type type, vector<unsigned>& list) const
+void MapObjectCollection::objectModified(MapObject* object)
 {
-	if (type == MapObject::Type::Vertex)
-	{
-		for (auto& vertex : vertices_)
-			list.push_back(vertex->obj_id_);
-	}
-	else if (type == MapObject::Type::Line)
-	{
-		for (auto& line : lines_)
-			list.push_back(line->obj_id_);
-	}
-	else if (type == MapObject::Type::Side)
-	{
-		for (auto& side : sides_)
-			list.push_back(side->obj_id_);
-	}
-	else if (type == MapObject::Type::Sector)
-	{
-		for (auto& sector : sectors_)
-			list.push_back(sector->obj_id_);
-	}
-	else if (type == MapObject::Type::Thing)
-	{
-		for (auto& thing : things_)
-			list.push_back(thing->obj_id_);
-	}
+	spatial_index_.objectModified(object);
+	tag_index_.objectModified(object);
+	if (parent_map_)
+		parent_map_->mapSpecials()->objectModified(object);
 }
 
 // -----------------------------------------------------------------------------
-// Add all object ids in [list] to the map as [type], clearing any objects of
-// [type] currently in the map
+// Re-applies (or reverses if [undo] is true) an object being added to or
+// removed from its object list, as recorded by the undo journal
 // -----------------------------------------------------------------------------
-void MapObjectCollection::restoreObjectIdList(MapObject::Type type, vector<unsigned>& list)
+void MapObjectCollection::applyListChange(const MapUndoJournal::ListChange& change, bool undo)
 {
-	if (type == MapObject::Type::Vertex)
-	{
-		// Clear
-		for (auto& vertex : vertices_)
-			objects_[vertex->obj_id_].in_map = false;
-		vertices_.clear();
-
-		// Restore
-		for (auto id : list)
-		{
-			objects_[id].in_map = true;
-			vertices_.add(dynamic_cast<MapVertex*>(objects_[id].object.get()));
-			vertices_.last()->index_ = vertices_.size() - 1;
-		}
-	}
-	else if (type == MapObject::Type::Line)
-	{
-		// Clear
-		for (auto& line : lines_)
-			objects_[line->obj_id_].in_map = false;
-		lines_.clear();
-
-		// Restore
-		for (auto id : list)
-		{
-			objects_[id].in_map = true;
-			lines_.add(dynamic_cast<MapLine*>(objects_[id].object.get()));
-			lines_.back()->index_ = lines_.size() - 1;
-		}
-	}
-	else if (type == MapObject::Type::Side)
-	{
-		// Clear
-		for (auto& side : sides_)
-			objects_[side->obj_id_].in_map = false;
-		sides_.clear();
+	auto object = getObjectById(change.id);
+	if (!object)
+		return;
 
-		// Restore
-		for (auto id : list)
-		{
-			objects_[id].in_map = true;
-			sides_.add(dynamic_cast<MapSide*>(objects_[id].object.get()));
-			sides_.back()->index_ = sides_.size() - 1;
-		}
-	}
-	else if (type == MapObject::Type::Sector)
-	{
-		// Clear
-		for (auto& sector : sectors_)
-			objects_[sector->obj_id_].in_map = false;
-		sectors_.clear();
+	// Undoing an add is a removal and vice versa
+	bool add = change.added != undo;
+	if (objects_[change.id].in_map == add)
+		return;
 
-		// Restore
-		for (auto id : list)
-		{
-			objects_[id].in_map = true;
-			sectors_.add(dynamic_cast<MapSector*>(objects_[id].object.get()));
-			sectors_.back()->index_ = sectors_.size() - 1;
-		}
-	}
-	else if (type == MapObject::Type::Thing)
+	objectModified(object);
+	objects_[change.id].in_map = add;
+	switch (change.type)
 	{
-		// Clear
-		for (auto& thing : things_)
-			objects_[thing->obj_id_].in_map = false;
-		things_.clear();
-
-		// Restore
-		for (auto id : list)
-		{
-			objects_[id].in_map = true;
-			things_.add(dynamic_cast<MapThing*>(objects_[id].object.get()));
-			things_.back()->index_ = things_.size() - 1;
-		}
+	case MapObject::Type::Vertex: applyChange(vertices_, dynamic_cast<MapVertex*>(object), change.index, add); break;
+	case MapObject::Type::Line: applyChange(lines_, dynamic_cast<MapLine*>(object), change.index, add); break;
+	case MapObject::Type::Side: applyChange(sides_, dynamic_cast<MapSide*>(object), change.index, add); break;
+	case MapObject::Type::Sector: applyChange(sectors_, dynamic_cast<MapSector*>(object), change.index, add); break;
+	case MapObject::Type::Thing: applyChange(things_, dynamic_cast<MapThing*>(object), change.index, add); break;
+	default: break;
 	}
 }
 
@@ -222,6 +186,9 @@ void MapObjectCollection::clear()
 	things_.clear();
 
 	// Clear map objects
+	spatial_index_.invalidate();
+	tag_index_.invalidate();
+	undo_journal_.end();
 	objects_.clear();
 
 	// Object id 0 is always null
@@ -569,22 +536,6 @@ vector<MapObject*> MapObjectCollection::modifiedObjects(long since, MapObject::T
 	return modified_objects;
 }
 
-// -----------------------------------------------------------------------------
-// Returns a list of objects that have a modified time later than [since]
-// -----------------------------------------------------------------------------
-vector<MapObject*> MapObjectCollection::allModifiedObjects(long since) const
-{
-	vector<MapObject*> modified_objects;
-
-	for (auto& holder : objects_)
-	{
-		if (holder.object && holder.object->modified_time_ >= since)
-			modified_objects.push_back(holder.object.get());
-	}
-
-	return modified_objects;
-}
-
 // -----------------------------------------------------------------------------
 // Returns the newest modified time on any map object
 // -----------------------------------------------------------------------------
@@ -735,6 +686,8 @@ void MapObjectCollection::rebuildConnectedLines()
 		line->v1()->connectLine(line);
 		line->v2()->connectLine(line);
 	}
+
+	spatial_index_.invalidate();
 }
 
 // -----------------------------------------------------------------------------
@@ -752,4 +705,6 @@ void MapObjectCollection::rebuildConnectedSides()
 		if (side->sector())
 			side->sector()->connectSide(side);
 	}
+
+	spatial_index_.invalidate();
 }
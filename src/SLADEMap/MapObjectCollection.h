@@ -1,6 +1,9 @@
 #pragma once
 
 #include "General/Defs.h"
+#include "MapSpatialIndex.h"
+#include "MapTagIndex.h"
+#include "MapUndoJournal.h"
 #include "MapObjectList/LineList.h"
 #include "MapObjectList/SectorList.h"
 #include "MapObjectList/SideList.h"
@@ -25,15 +28,20 @@ public:
 	const LineList&   lines() const { return lines_; }
 	const SectorList& sectors() const { return sectors_; }
 	const ThingList&  things() const { return things_; }
+	MapSpatialIndex&  spatialIndex() { return spatial_index_; }
+	MapTagIndex&      tagIndex() { return tag_index_; }
+	MapUndoJournal&   undoJournal() { return undo_journal_; }
 
 	void setParentMap(SLADEMap* map) { parent_map_ = map; }
 
 	// MapObject id stuff (used for undo/redo)
 	void       addMapObject(unique_ptr<MapObject> object);
 	void       removeMapObject(MapObject* object);
-	MapObject* getObjectById(unsigned id) const { return objects_[id].object.get(); }
-	void       putObjectIdList(MapObject::Type type, vector<unsigned>& list) const;
-	void       restoreObjectIdList(MapObject::Type type, vector<unsigned>& list);
+	MapObject* getObjectById(unsigned id) const
+	{
+		return id < objects_.size() ? objects_[id].object.get() : nullptr;
+	}
+	void       applyListChange(const MapUndoJournal::ListChange& change, bool undo);
 
 	void refreshIndices();
 	void clear();
@@ -62,7 +70,6 @@ public:
 
 	// Modified times
 	vector<MapObject*> modifiedObjects(long since, MapObject::Type type) const;
-	vector<MapObject*> allModifiedObjects(long since) const;
 	long               lastModifiedTime() const;
 	bool               modifiedSince(long since, MapObject::Type type) const;
 
@@ -93,5 +100,10 @@ private:
 	LineList                lines_;
 	SectorList              sectors_;
 	ThingList               things_;
+	MapSpatialIndex         spatial_index_{ this };
+	MapTagIndex             tag_index_{ this };
+	MapUndoJournal          undo_journal_{ this };
+
+	void objectModified(MapObject* object);
 };
 } // namespace slade
@@ -34,12 +34,138 @@
 #include "Main.h"
 #include "LineList.h"
 #include "Game/Configuration.h"
+#include "SLADEMap/MapSpatialIndex.h"
+#include "SLADEMap/MapTagIndex.h"
 #include "SLADEMap/SLADEMap.h"
 #include "Utility/MathStuff.h"
 
 using namespace slade;
 
 
+// -----------------------------------------------------------------------------
+//
+// Functions
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// -----------------------------------------------------------------------------
+// Returns true if [line]'s special affects objects of [type] with [id]
+// -----------------------------------------------------------------------------
+#define IDEQ(x) (((x) != 0) && ((x) == id))
+bool lineTagsId(MapLine* line, int id, int type)
+{
+	using game::TagType;
+
+	int special = line->special();
+	if (!special)
+		return false;
+
+	int  tag  = line->arg(0);
+	int  arg2, arg3, arg4, arg5;
+	bool fits = false;
+	switch (game::configuration().actionSpecial(special).needsTag())
+	{
+	case TagType::Sector:
+	case TagType::SectorOrBack:
+	case TagType::SectorAndBack: fits = (IDEQ(tag) && type == SLADEMap::SECTORS); break;
+	case TagType::LineNegative: tag = abs(tag);
+	case TagType::Line: fits = (IDEQ(tag) && type == SLADEMap::LINEDEFS); break;
+	case TagType::Thing: fits = (IDEQ(tag) && type == SLADEMap::THINGS); break;
+	case TagType::Thing1Sector2:
+		arg2 = line->arg(1);
+		fits = (type == SLADEMap::THINGS ? IDEQ(tag) : (IDEQ(arg2) && type == SLADEMap::SECTORS));
+		break;
+	case TagType::Thing1Sector3:
+		arg3 = line->arg(2);
+		fits = (type == SLADEMap::THINGS ? IDEQ(tag) : (IDEQ(arg3) && type == SLADEMap::SECTORS));
+		break;
+	case TagType::Thing1Thing2:
+		arg2 = line->arg(1);
+		fits = (type == SLADEMap::THINGS && (IDEQ(tag) || IDEQ(arg2)));
+		break;
+	case TagType::Thing1Thing4:
+		arg4 = line->arg(3);
+		fits = (type == SLADEMap::THINGS && (IDEQ(tag) || IDEQ(arg4)));
+		break;
+	case TagType::Thing1Thing2Thing3:
+		arg2 = line->arg(1);
+		arg3 = line->arg(2);
+		fits = (type == SLADEMap::THINGS && (IDEQ(tag) || IDEQ(arg2) || IDEQ(arg3)));
+		break;
+	case TagType::Sector1Thing2Thing3Thing5:
+		arg2 = line->arg(1);
+		arg3 = line->arg(2);
+		arg5 = line->arg(4);
+		fits =
+			(type == SLADEMap::SECTORS ?
+				 (IDEQ(tag)) :
+				 (type == SLADEMap::THINGS && (IDEQ(arg2) || IDEQ(arg3) || IDEQ(arg5))));
+		break;
+	case TagType::LineId1Line2:
+		arg2 = line->arg(1);
+		fits = (type == SLADEMap::LINEDEFS && IDEQ(arg2));
+		break;
+	case TagType::Thing4:
+		arg4 = line->arg(3);
+		fits = (type == SLADEMap::THINGS && IDEQ(arg4));
+		break;
+	case TagType::Thing5:
+		arg5 = line->arg(4);
+		fits = (type == SLADEMap::THINGS && IDEQ(arg5));
+		break;
+	case TagType::Line1Sector2:
+		arg2 = line->arg(1);
+		fits = (type == SLADEMap::LINEDEFS ? (IDEQ(tag)) : (IDEQ(arg2) && type == SLADEMap::SECTORS));
+		break;
+	case TagType::Sector1Sector2:
+		arg2 = line->arg(1);
+		fits = (type == SLADEMap::SECTORS && (IDEQ(tag) || IDEQ(arg2)));
+		break;
+	case TagType::Sector1Sector2Sector3Sector4:
+		arg2 = line->arg(1);
+		arg3 = line->arg(2);
+		arg4 = line->arg(3);
+		fits = (type == SLADEMap::SECTORS && (IDEQ(tag) || IDEQ(arg2) || IDEQ(arg3) || IDEQ(arg4)));
+		break;
+	case TagType::Sector2Is3Line:
+		arg2 = line->arg(1);
+		fits = (IDEQ(tag) && (arg2 == 3 ? type == SLADEMap::LINEDEFS : type == SLADEMap::SECTORS));
+		break;
+	case TagType::Sector1Thing2:
+		arg2 = line->arg(1);
+		fits = (type == SLADEMap::SECTORS ? (IDEQ(tag)) : (IDEQ(arg2) && type == SLADEMap::THINGS));
+		break;
+	default: break;
+	}
+
+	return fits;
+}
+#undef IDEQ
+
+// -----------------------------------------------------------------------------
+// Returns the lowest value (> 0) that isn't the first arg of any line in
+// [index]. If [special] is not 0, only lines with that special are checked
+// -----------------------------------------------------------------------------
+int firstFreeArg0(MapTagIndex& index, int special = 0)
+{
+	auto used = [&index, special](int id) {
+		for (auto& line : index.linesWithArg(id))
+			if ((special == 0 || line->special() == special) && line->arg(0) == id)
+				return true;
+
+		return false;
+	};
+
+	int id = 1;
+	while (used(id))
+		++id;
+
+	return id;
+}
+} // namespace
+
+
 // -----------------------------------------------------------------------------
 //
 // LineList Class Functions
@@ -53,11 +179,24 @@ using namespace slade;
 // -----------------------------------------------------------------------------
 MapLine* LineList::nearest(Vec2d point, double min) const
 {
+	// Get lines within [min] of the point from the spatial index, if it can be
+	// used
+	vector<MapLine*> candidates;
+	bool             use_index = useSpatialIndex();
+	if (use_index)
+	{
+		double range = std::max(min, 0.) + 1.;
+		BBox   area;
+		area.min.set(point.x - range, point.y - range);
+		area.max.set(point.x + range, point.y + range);
+		candidates = spatial_index_->linesIn(area);
+	}
+
 	// Go through lines
 	double   dist;
 	double   min_dist = min;
 	MapLine* nearest  = nullptr;
-	for (const auto& line : objects_)
+	for (const auto& line : use_index ? candidates : objects_)
 	{
 		// Check with line bounding box first (since we have a minimum distance)
 		auto bbox = line->seg();
@@ -104,8 +243,20 @@ vector<Vec2d> LineList::cutPoints(const Seg2d& cutter) const
 	vector<Vec2d> intersect_points;
 	Vec2d         intersection;
 
+	// Get lines within the cutter bbox from the spatial index, if it can be
+	// used
+	vector<MapLine*> candidates;
+	bool             use_index = useSpatialIndex();
+	if (use_index)
+	{
+		BBox area;
+		area.min.set(cutter.left() - 1., cutter.top() - 1.);
+		area.max.set(cutter.right() + 1., cutter.bottom() + 1.);
+		candidates = spatial_index_->linesIn(area);
+	}
+
 	// Go through map lines
-	for (const auto& line : objects_)
+	for (const auto& line : use_index ? candidates : objects_)
 	{
 		// Check for intersection
 		intersection = cutter.start();
@@ -161,6 +312,13 @@ vector<Vec2d> LineList::cutPoints(const Seg2d& cutter) const
 // -----------------------------------------------------------------------------
 MapLine* LineList::firstWithId(int id) const
 {
+	// Lines with no id aren't in the tag index
+	if (id != 0 && useTagIndex())
+	{
+		auto lines = tag_index_->linesWithId(id);
+		return lines.empty() ? nullptr : lines[0];
+	}
+
 	for (auto& line : objects_)
 		if (line->id() == id)
 			return line;
@@ -173,6 +331,14 @@ MapLine* LineList::firstWithId(int id) const
 // -----------------------------------------------------------------------------
 void LineList::putAllWithId(int id, vector<MapLine*>& list) const
 {
+	// Lines with no id aren't in the tag index
+	if (id != 0 && useTagIndex())
+	{
+		auto lines = tag_index_->linesWithId(id);
+		list.insert(list.end(), lines.begin(), lines.end());
+		return;
+	}
+
 	for (auto& line : objects_)
 		if (line->id() == id)
 			list.push_back(line);
@@ -191,100 +357,23 @@ vector<MapLine*> LineList::allWithId(int id) const
 // -----------------------------------------------------------------------------
 // Adds all lines with special affecting matching [id] to [list]
 // -----------------------------------------------------------------------------
-#define IDEQ(x) (((x) != 0) && ((x) == id))
 void LineList::putAllTaggingWithId(int id, int type, vector<MapLine*>& list) const
 {
-	using game::TagType;
-
-	// Find lines with special affecting matching id
-	int tag, arg2, arg3, arg4, arg5;
-	for (auto& line : objects_)
+	// Only lines with [id] as an arg can be tagging it, so just check those if
+	// the tag index can be used
+	if (useTagIndex())
 	{
-		int special = line->special();
-		if (special)
-		{
-			tag       = line->arg(0);
-			bool fits = false;
-			switch (game::configuration().actionSpecial(special).needsTag())
-			{
-			case TagType::Sector:
-			case TagType::SectorOrBack:
-			case TagType::SectorAndBack: fits = (IDEQ(tag) && type == SLADEMap::SECTORS); break;
-			case TagType::LineNegative: tag = abs(tag);
-			case TagType::Line: fits = (IDEQ(tag) && type == SLADEMap::LINEDEFS); break;
-			case TagType::Thing: fits = (IDEQ(tag) && type == SLADEMap::THINGS); break;
-			case TagType::Thing1Sector2:
-				arg2 = line->arg(1);
-				fits = (type == SLADEMap::THINGS ? IDEQ(tag) : (IDEQ(arg2) && type == SLADEMap::SECTORS));
-				break;
-			case TagType::Thing1Sector3:
-				arg3 = line->arg(2);
-				fits = (type == SLADEMap::THINGS ? IDEQ(tag) : (IDEQ(arg3) && type == SLADEMap::SECTORS));
-				break;
-			case TagType::Thing1Thing2:
-				arg2 = line->arg(1);
-				fits = (type == SLADEMap::THINGS && (IDEQ(tag) || IDEQ(arg2)));
-				break;
-			case TagType::Thing1Thing4:
-				arg4 = line->arg(3);
-				fits = (type == SLADEMap::THINGS && (IDEQ(tag) || IDEQ(arg4)));
-				break;
-			case TagType::Thing1Thing2Thing3:
-				arg2 = line->arg(1);
-				arg3 = line->arg(2);
-				fits = (type == SLADEMap::THINGS && (IDEQ(tag) || IDEQ(arg2) || IDEQ(arg3)));
-				break;
-			case TagType::Sector1Thing2Thing3Thing5:
-				arg2 = line->arg(1);
-				arg3 = line->arg(2);
-				arg5 = line->arg(4);
-				fits =
-					(type == SLADEMap::SECTORS ?
-						 (IDEQ(tag)) :
-						 (type == SLADEMap::THINGS && (IDEQ(arg2) || IDEQ(arg3) || IDEQ(arg5))));
-				break;
-			case TagType::LineId1Line2:
-				arg2 = line->arg(1);
-				fits = (type == SLADEMap::LINEDEFS && IDEQ(arg2));
-				break;
-			case TagType::Thing4:
-				arg4 = line->arg(3);
-				fits = (type == SLADEMap::THINGS && IDEQ(arg4));
-				break;
-			case TagType::Thing5:
-				arg5 = line->arg(4);
-				fits = (type == SLADEMap::THINGS && IDEQ(arg5));
-				break;
-			case TagType::Line1Sector2:
-				arg2 = line->arg(1);
-				fits = (type == SLADEMap::LINEDEFS ? (IDEQ(tag)) : (IDEQ(arg2) && type == SLADEMap::SECTORS));
-				break;
-			case TagType::Sector1Sector2:
-				arg2 = line->arg(1);
-				fits = (type == SLADEMap::SECTORS && (IDEQ(tag) || IDEQ(arg2)));
-				break;
-			case TagType::Sector1Sector2Sector3Sector4:
-				arg2 = line->arg(1);
-				arg3 = line->arg(2);
-				arg4 = line->arg(3);
-				fits = (type == SLADEMap::SECTORS && (IDEQ(tag) || IDEQ(arg2) || IDEQ(arg3) || IDEQ(arg4)));
-				break;
-			case TagType::Sector2Is3Line:
-				arg2 = line->arg(1);
-				fits = (IDEQ(tag) && (arg2 == 3 ? type == SLADEMap::LINEDEFS : type == SLADEMap::SECTORS));
-				break;
-			case TagType::Sector1Thing2:
-				arg2 = line->arg(1);
-				fits = (type == SLADEMap::SECTORS ? (IDEQ(tag)) : (IDEQ(arg2) && type == SLADEMap::THINGS));
-				break;
-			default: break;
-			}
-			if (fits)
+		for (auto& line : tag_index_->linesWithArg(id))
+			if (lineTagsId(line, id, type))
 				list.push_back(line);
-		}
+
+		return;
 	}
+
+	for (auto& line : objects_)
+		if (lineTagsId(line, id, type))
+			list.push_back(line);
 }
-#undef IDEQ
 
 // -----------------------------------------------------------------------------
 // Returns the lowest unused id.
@@ -298,6 +387,9 @@ int LineList::firstFreeId(MapFormat format) const
 	// UDMF (id property)
 	if (format == MapFormat::UDMF)
 	{
+		if (useTagIndex())
+			return tag_index_->firstFreeLineId();
+
 		for (unsigned a = 0; a < count_; a++)
 		{
 			if (objects_[a]->id() == id)
@@ -311,6 +403,9 @@ int LineList::firstFreeId(MapFormat format) const
 	// Hexen (special 121 arg0)
 	else if (format == MapFormat::Hexen)
 	{
+		if (useTagIndex())
+			return firstFreeArg0(*tag_index_, 121);
+
 		for (unsigned a = 0; a < count_; a++)
 		{
 			if (objects_[a]->special() == 121 && objects_[a]->arg(0) == id)
@@ -324,6 +419,9 @@ int LineList::firstFreeId(MapFormat format) const
 	// Boom (sector tag (arg0))
 	else if (format == MapFormat::Doom && game::configuration().featureSupported(game::Feature::Boom))
 	{
+		if (useTagIndex())
+			return firstFreeArg0(*tag_index_);
+
 		for (unsigned a = 0; a < count_; a++)
 		{
 			if (objects_[a]->arg(0) == id)
@@ -336,3 +434,19 @@ int LineList::firstFreeId(MapFormat format) const
 
 	return id;
 }
+
+// -----------------------------------------------------------------------------
+// Returns true if the map's spatial index can be used for queries on this list
+// -----------------------------------------------------------------------------
+bool LineList::useSpatialIndex() const
+{
+	return spatial_index_ && MapSpatialIndex::enabled() && spatial_index_->indexes(*this);
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if the map's tag index can be used for queries on this list
+// -----------------------------------------------------------------------------
+bool LineList::useTagIndex() const
+{
+	return tag_index_ && tag_index_->indexes(*this);
+}
@@ -17,5 +17,9 @@ public:
 	vector<MapLine*> allWithId(int id) const;
 	void             putAllTaggingWithId(int id, int type, vector<MapLine*>& list) const;
 	int              firstFreeId(MapFormat format) const;
+
+private:
+	bool useSpatialIndex() const;
+	bool useTagIndex() const;
 };
 } // namespace slade
@@ -3,6 +3,8 @@
 namespace slade
 {
 class MapObject;
+class MapSpatialIndex;
+class MapTagIndex;
 
 template<class T> class MapObjectList
 {
@@ -57,6 +59,20 @@ public:
 		--count_;
 	}
 
+	// Puts [object] back at [index], moving the object currently there to the
+	// end of the list (ie. the reverse of remove)
+	void restore(T* object, unsigned index)
+	{
+		add(object);
+		object->setIndex(count_ - 1);
+		if (index < count_ - 1)
+		{
+			std::swap(objects_[index], objects_.back());
+			objects_[index]->setIndex(index);
+			objects_.back()->setIndex(count_ - 1);
+		}
+	}
+
 	// Misc
 	void putModifiedObjects(long since, vector<MapObject*>& modified_objects) const
 	{
@@ -72,9 +88,13 @@ public:
 
 		return false;
 	}
+	void setSpatialIndex(MapSpatialIndex* index) { spatial_index_ = index; }
+	void setTagIndex(MapTagIndex* index) { tag_index_ = index; }
 
 protected:
-	vector<T*> objects_;
-	unsigned   count_ = 0;
+	vector<T*>       objects_;
+	unsigned         count_         = 0;
+	MapSpatialIndex* spatial_index_ = nullptr;
+	MapTagIndex*     tag_index_     = nullptr;
 };
 } // namespace slade
@@ -34,6 +34,8 @@
 #include "Main.h"
 #include "SectorList.h"
 #include "General/UI.h"
+#include "SLADEMap/MapSpatialIndex.h"
+#include "SLADEMap/MapTagIndex.h"
 #include "Utility/StringUtils.h"
 
 using namespace slade;
@@ -87,8 +89,15 @@ void SectorList::remove(unsigned index)
 // -----------------------------------------------------------------------------
 MapSector* SectorList::atPos(Vec2d point) const
 {
+	// Get sectors with a bbox containing the point from the spatial index, if
+	// it can be used
+	vector<MapSector*> candidates;
+	bool               use_index = useSpatialIndex();
+	if (use_index)
+		candidates = spatial_index_->sectorsAt(point);
+
 	// Go through sectors
-	for (const auto& sector : objects_)
+	for (const auto& sector : use_index ? candidates : objects_)
 	{
 		// Check if point is within sector
 		if (sector->containsPoint(point))
@@ -158,6 +167,14 @@ void SectorList::initBBoxes()
 // -----------------------------------------------------------------------------
 void SectorList::putAllWithId(int id, vector<MapSector*>& list) const
 {
+	// Sectors with no tag aren't in the tag index
+	if (id != 0 && useTagIndex())
+	{
+		auto tagged = tag_index_->sectorsWithId(id);
+		list.insert(list.end(), tagged.begin(), tagged.end());
+		return;
+	}
+
 	for (auto& sector : objects_)
 		if (sector->tag() == id)
 			list.push_back(sector);
@@ -178,6 +195,13 @@ vector<MapSector*> SectorList::allWithId(int id) const
 // -----------------------------------------------------------------------------
 MapSector* SectorList::firstWithId(int id) const
 {
+	// Sectors with no tag aren't in the tag index
+	if (id != 0 && useTagIndex())
+	{
+		auto tagged = tag_index_->sectorsWithId(id);
+		return tagged.empty() ? nullptr : tagged[0];
+	}
+
 	for (auto& sector : objects_)
 		if (sector->tag() == id)
 			return sector;
@@ -190,6 +214,9 @@ MapSector* SectorList::firstWithId(int id) const
 // -----------------------------------------------------------------------------
 int SectorList::firstFreeId() const
 {
+	if (useTagIndex())
+		return tag_index_->firstFreeSectorId();
+
 	int id = 1;
 	for (unsigned i = 0; i < count_; ++i)
 	{
@@ -218,3 +245,19 @@ int SectorList::texUsageCount(string_view tex) const
 {
 	return usage_tex_[strutil::upper(tex)];
 }
+
+// -----------------------------------------------------------------------------
+// Returns true if the map's spatial index can be used for queries on this list
+// -----------------------------------------------------------------------------
+bool SectorList::useSpatialIndex() const
+{
+	return spatial_index_ && MapSpatialIndex::enabled() && spatial_index_->indexes(*this);
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if the map's tag index can be used for queries on this list
+// -----------------------------------------------------------------------------
+bool SectorList::useTagIndex() const
+{
+	return tag_index_ && tag_index_->indexes(*this);
+}
@@ -28,5 +28,8 @@ public:
 
 private:
 	mutable std::map<string, int> usage_tex_;
+
+	bool useSpatialIndex() const;
+	bool useTagIndex() const;
 };
 } // namespace slade
@@ -34,12 +34,131 @@
 #include "Main.h"
 #include "ThingList.h"
 #include "Game/Configuration.h"
+#include "SLADEMap/MapTagIndex.h"
 #include "SLADEMap/SLADEMap.h"
 #include "Utility/MathStuff.h"
 
 using namespace slade;
 
 
+// -----------------------------------------------------------------------------
+//
+// Functions
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// -----------------------------------------------------------------------------
+// Returns true if [thing]'s special (or type) affects objects of [type] with
+// [id]. [ttype] is the type of the thing being checked for patrol point or
+// interpolation point things
+// -----------------------------------------------------------------------------
+#define IDEQ(x) (((x) != 0) && ((x) == id))
+bool thingTagsId(MapThing* thing, int id, int type, int ttype)
+{
+	using game::TagType;
+
+	auto& tt        = game::configuration().thingType(thing->type());
+	auto  needs_tag = tt.needsTag();
+	if (needs_tag == TagType::None && (!thing->special() || (tt.flags() & game::ThingType::Flags::Script)))
+		return false;
+
+	if (needs_tag == TagType::None)
+		needs_tag = game::configuration().actionSpecial(thing->special()).needsTag();
+	int  tag  = thing->arg(0);
+	int  arg2, arg3, arg4, arg5, tid;
+	bool fits = false;
+	int  path_type;
+	switch (needs_tag)
+	{
+	case TagType::Sector:
+	case TagType::SectorOrBack:
+	case TagType::SectorAndBack: fits = (IDEQ(tag) && type == SLADEMap::SECTORS); break;
+	case TagType::LineNegative: tag = abs(tag);
+	case TagType::Line: fits = (IDEQ(tag) && type == SLADEMap::LINEDEFS); break;
+	case TagType::Thing: fits = (IDEQ(tag) && type == SLADEMap::THINGS); break;
+	case TagType::Thing1Sector2:
+		arg2 = thing->arg(1);
+		fits = (type == SLADEMap::THINGS ? IDEQ(tag) : (IDEQ(arg2) && type == SLADEMap::SECTORS));
+		break;
+	case TagType::Thing1Sector3:
+		arg3 = thing->arg(2);
+		fits = (type == SLADEMap::THINGS ? IDEQ(tag) : (IDEQ(arg3) && type == SLADEMap::SECTORS));
+		break;
+	case TagType::Thing1Thing2:
+		arg2 = thing->arg(1);
+		fits = (type == SLADEMap::THINGS && (IDEQ(tag) || IDEQ(arg2)));
+		break;
+	case TagType::Thing1Thing4:
+		arg4 = thing->arg(3);
+		fits = (type == SLADEMap::THINGS && (IDEQ(tag) || IDEQ(arg4)));
+		break;
+	case TagType::Thing1Thing2Thing3:
+		arg2 = thing->arg(1);
+		arg3 = thing->arg(2);
+		fits = (type == SLADEMap::THINGS && (IDEQ(tag) || IDEQ(arg2) || IDEQ(arg3)));
+		break;
+	case TagType::Sector1Thing2Thing3Thing5:
+		arg2 = thing->arg(1);
+		arg3 = thing->arg(2);
+		arg5 = thing->arg(4);
+		fits =
+			(type == SLADEMap::SECTORS ?
+				 (IDEQ(tag)) :
+				 (type == SLADEMap::THINGS && (IDEQ(arg2) || IDEQ(arg3) || IDEQ(arg5))));
+		break;
+	case TagType::LineId1Line2:
+		arg2 = thing->arg(1);
+		fits = (type == SLADEMap::LINEDEFS && IDEQ(arg2));
+		break;
+	case TagType::Thing4:
+		arg4 = thing->arg(3);
+		fits = (type == SLADEMap::THINGS && IDEQ(arg4));
+		break;
+	case TagType::Thing5:
+		arg5 = thing->arg(4);
+		fits = (type == SLADEMap::THINGS && IDEQ(arg5));
+		break;
+	case TagType::Line1Sector2:
+		arg2 = thing->arg(1);
+		fits = (type == SLADEMap::LINEDEFS ? (IDEQ(tag)) : (IDEQ(arg2) && type == SLADEMap::SECTORS));
+		break;
+	case TagType::Sector1Sector2:
+		arg2 = thing->arg(1);
+		fits = (type == SLADEMap::SECTORS && (IDEQ(tag) || IDEQ(arg2)));
+		break;
+	case TagType::Sector1Sector2Sector3Sector4:
+		arg2 = thing->arg(1);
+		arg3 = thing->arg(2);
+		arg4 = thing->arg(3);
+		fits = (type == SLADEMap::SECTORS && (IDEQ(tag) || IDEQ(arg2) || IDEQ(arg3) || IDEQ(arg4)));
+		break;
+	case TagType::Sector2Is3Line:
+		arg2 = thing->arg(1);
+		fits = (IDEQ(tag) && (arg2 == 3 ? type == SLADEMap::LINEDEFS : type == SLADEMap::SECTORS));
+		break;
+	case TagType::Sector1Thing2:
+		arg2 = thing->arg(1);
+		fits = (type == SLADEMap::SECTORS ? (IDEQ(tag)) : (IDEQ(arg2) && type == SLADEMap::THINGS));
+		break;
+	case TagType::Patrol: path_type = 9047;
+	case TagType::Interpolation:
+	{
+		path_type = 9075;
+
+		tid  = thing->id();
+		fits = ((path_type == ttype) && (IDEQ(tid)) && (tt.needsTag() == needs_tag));
+	}
+	break;
+	default: break;
+	}
+
+	return fits;
+}
+#undef IDEQ
+} // namespace
+
+
 // -----------------------------------------------------------------------------
 //
 // ThingList Class Functions
@@ -133,6 +252,16 @@ BBox ThingList::allThingBounds() const
 // -----------------------------------------------------------------------------
 void ThingList::putAllWithId(int id, vector<MapThing*>& list, unsigned start, int type) const
 {
+	// Things with no TID aren't in the tag index
+	if (id != 0 && useTagIndex())
+	{
+		for (auto& thing : tag_index_->thingsWithId(id))
+			if (thing->index() >= start && (type == 0 || thing->type() == type))
+				list.push_back(thing);
+
+		return;
+	}
+
 	for (unsigned i = start; i < count_; ++i)
 		if (objects_[i]->id() == id && (type == 0 || objects_[i]->type() == type))
 			list.push_back(objects_[i]);
@@ -155,18 +284,33 @@ vector<MapThing*> ThingList::allWithId(int id, unsigned start, int type) const
 // -----------------------------------------------------------------------------
 MapThing* ThingList::firstWithId(int id, unsigned start, int type, bool ignore_dragon) const
 {
-	for (unsigned i = start; i < count_; ++i)
-		if (objects_[i]->id() == id && (type == 0 || objects_[i]->type() == type))
+	auto matches = [type, ignore_dragon](MapThing* thing) {
+		if (type != 0 && thing->type() != type)
+			return false;
+
+		if (ignore_dragon)
 		{
-			if (ignore_dragon)
-			{
-				auto& tt = game::configuration().thingType(objects_[i]->type());
-				if (tt.flags() & game::ThingType::Flags::Dragon)
-					continue;
-			}
+			auto& tt = game::configuration().thingType(thing->type());
+			if (tt.flags() & game::ThingType::Flags::Dragon)
+				return false;
+		}
+
+		return true;
+	};
+
+	// Things with no TID aren't in the tag index
+	if (id != 0 && useTagIndex())
+	{
+		for (auto& thing : tag_index_->thingsWithId(id))
+			if (thing->index() >= start && matches(thing))
+				return thing;
+
+		return nullptr;
+	}
 
+	for (unsigned i = start; i < count_; ++i)
+		if (objects_[i]->id() == id && matches(objects_[i]))
 			return objects_[i];
-		}
 
 	return nullptr;
 }
@@ -188,119 +332,32 @@ void ThingList::putAllPathed(vector<MapThing*>& list) const
 // -----------------------------------------------------------------------------
 // Adds all things with special affecting matching id to [list]
 // -----------------------------------------------------------------------------
-#define IDEQ(x) (((x) != 0) && ((x) == id))
 void ThingList::putAllTaggingWithId(int id, int type, vector<MapThing*>& list, int ttype) const
 {
-	using game::TagType;
-
-	// Find things with special affecting matching id
-	int tag, arg2, arg3, arg4, arg5, tid;
-	for (auto& thing : objects_)
+	// Only things with [id] as an arg or TID can be tagging it, so just check
+	// those if the tag index can be used
+	if (useTagIndex())
 	{
-		auto& tt        = game::configuration().thingType(thing->type());
-		auto  needs_tag = tt.needsTag();
-		if (needs_tag != TagType::None || (thing->special() && !(tt.flags() & game::ThingType::Flags::Script)))
-		{
-			if (needs_tag == TagType::None)
-				needs_tag = game::configuration().actionSpecial(thing->special()).needsTag();
-			tag       = thing->arg(0);
-			bool fits = false;
-			int  path_type;
-			switch (needs_tag)
-			{
-			case TagType::Sector:
-			case TagType::SectorOrBack:
-			case TagType::SectorAndBack: fits = (IDEQ(tag) && type == SLADEMap::SECTORS); break;
-			case TagType::LineNegative: tag = abs(tag);
-			case TagType::Line: fits = (IDEQ(tag) && type == SLADEMap::LINEDEFS); break;
-			case TagType::Thing: fits = (IDEQ(tag) && type == SLADEMap::THINGS); break;
-			case TagType::Thing1Sector2:
-				arg2 = thing->arg(1);
-				fits = (type == SLADEMap::THINGS ? IDEQ(tag) : (IDEQ(arg2) && type == SLADEMap::SECTORS));
-				break;
-			case TagType::Thing1Sector3:
-				arg3 = thing->arg(2);
-				fits = (type == SLADEMap::THINGS ? IDEQ(tag) : (IDEQ(arg3) && type == SLADEMap::SECTORS));
-				break;
-			case TagType::Thing1Thing2:
-				arg2 = thing->arg(1);
-				fits = (type == SLADEMap::THINGS && (IDEQ(tag) || IDEQ(arg2)));
-				break;
-			case TagType::Thing1Thing4:
-				arg4 = thing->arg(3);
-				fits = (type == SLADEMap::THINGS && (IDEQ(tag) || IDEQ(arg4)));
-				break;
-			case TagType::Thing1Thing2Thing3:
-				arg2 = thing->arg(1);
-				arg3 = thing->arg(2);
-				fits = (type == SLADEMap::THINGS && (IDEQ(tag) || IDEQ(arg2) || IDEQ(arg3)));
-				break;
-			case TagType::Sector1Thing2Thing3Thing5:
-				arg2 = thing->arg(1);
-				arg3 = thing->arg(2);
-				arg5 = thing->arg(4);
-				fits =
-					(type == SLADEMap::SECTORS ?
-						 (IDEQ(tag)) :
-						 (type == SLADEMap::THINGS && (IDEQ(arg2) || IDEQ(arg3) || IDEQ(arg5))));
-				break;
-			case TagType::LineId1Line2:
-				arg2 = thing->arg(1);
-				fits = (type == SLADEMap::LINEDEFS && IDEQ(arg2));
-				break;
-			case TagType::Thing4:
-				arg4 = thing->arg(3);
-				fits = (type == SLADEMap::THINGS && IDEQ(arg4));
-				break;
-			case TagType::Thing5:
-				arg5 = thing->arg(4);
-				fits = (type == SLADEMap::THINGS && IDEQ(arg5));
-				break;
-			case TagType::Line1Sector2:
-				arg2 = thing->arg(1);
-				fits = (type == SLADEMap::LINEDEFS ? (IDEQ(tag)) : (IDEQ(arg2) && type == SLADEMap::SECTORS));
-				break;
-			case TagType::Sector1Sector2:
-				arg2 = thing->arg(1);
-				fits = (type == SLADEMap::SECTORS && (IDEQ(tag) || IDEQ(arg2)));
-				break;
-			case TagType::Sector1Sector2Sector3Sector4:
-				arg2 = thing->arg(1);
-				arg3 = thing->arg(2);
-				arg4 = thing->arg(3);
-				fits = (type == SLADEMap::SECTORS && (IDEQ(tag) || IDEQ(arg2) || IDEQ(arg3) || IDEQ(arg4)));
-				break;
-			case TagType::Sector2Is3Line:
-				arg2 = thing->arg(1);
-				fits = (IDEQ(tag) && (arg2 == 3 ? type == SLADEMap::LINEDEFS : type == SLADEMap::SECTORS));
-				break;
-			case TagType::Sector1Thing2:
-				arg2 = thing->arg(1);
-				fits = (type == SLADEMap::SECTORS ? (IDEQ(tag)) : (IDEQ(arg2) && type == SLADEMap::THINGS));
-				break;
-			case TagType::Patrol: path_type = 9047;
-			case TagType::Interpolation:
-			{
-				path_type = 9075;
-
-				tid  = thing->id();
-				fits = ((path_type == ttype) && (IDEQ(tid)) && (tt.needsTag() == needs_tag));
-			}
-			break;
-			default: break;
-			}
-			if (fits)
+		for (auto& thing : tag_index_->thingsWithArg(id))
+			if (thingTagsId(thing, id, type, ttype))
 				list.push_back(thing);
-		}
+
+		return;
 	}
+
+	for (auto& thing : objects_)
+		if (thingTagsId(thing, id, type, ttype))
+			list.push_back(thing);
 }
-#undef IDEQ
 
 // -----------------------------------------------------------------------------
 // Returns the lowest unused thing id
 // -----------------------------------------------------------------------------
 int ThingList::firstFreeId() const
 {
+	if (useTagIndex())
+		return tag_index_->firstFreeThingId();
+
 	int id = 1;
 	for (unsigned i = 0; i < count_; ++i)
 	{
@@ -313,3 +370,11 @@ int ThingList::firstFreeId() const
 
 	return id;
 }
+
+// -----------------------------------------------------------------------------
+// Returns true if the map's tag index can be used for queries on this list
+// -----------------------------------------------------------------------------
+bool ThingList::useTagIndex() const
+{
+	return tag_index_ && tag_index_->indexes(*this);
+}
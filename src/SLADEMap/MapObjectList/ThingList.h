@@ -17,5 +17,8 @@ public:
 	void              putAllPathed(vector<MapThing*>& list) const;
 	void              putAllTaggingWithId(int id, int type, vector<MapThing*>& list, int ttype) const;
 	int               firstFreeId() const;
+
+private:
+	bool useTagIndex() const;
 };
 } // namespace slade
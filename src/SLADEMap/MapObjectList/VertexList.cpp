@@ -33,6 +33,7 @@
 // -----------------------------------------------------------------------------
 #include "Main.h"
 #include "VertexList.h"
+#include "SLADEMap/MapSpatialIndex.h"
 #include "Utility/MathStuff.h"
 
 using namespace slade;
@@ -51,11 +52,24 @@ using namespace slade;
 // -----------------------------------------------------------------------------
 MapVertex* VertexList::nearest(Vec2d point, double min) const
 {
+	// If the spatial index can be used, only vertices within [min] (as a
+	// taxicab distance, which can be up to sqrt(2) * [min]) need checking
+	vector<MapVertex*> candidates;
+	bool               use_index = useSpatialIndex();
+	if (use_index)
+	{
+		double range = std::max(min * std::sqrt(2.) + 1., 0.);
+		BBox   area;
+		area.min.set(point.x - range, point.y - range);
+		area.max.set(point.x + range, point.y + range);
+		candidates = spatial_index_->verticesIn(area);
+	}
+
 	// Go through vertices
 	double     dist;
 	double     min_dist = 999999999;
 	MapVertex* nearest  = nullptr;
-	for (const auto& vertex : objects_)
+	for (const auto& vertex : use_index ? candidates : objects_)
 	{
 		// Get 'quick' distance (no need to get real distance)
 		dist = point.taxicabDistanceTo(vertex->position());
@@ -85,8 +99,20 @@ MapVertex* VertexList::nearest(Vec2d point, double min) const
 // -----------------------------------------------------------------------------
 MapVertex* VertexList::vertexAt(double x, double y) const
 {
+	// Get vertices in the same grid cell as [x,y] from the spatial index, if
+	// it can be used
+	vector<MapVertex*> candidates;
+	bool               use_index = useSpatialIndex();
+	if (use_index)
+	{
+		BBox area;
+		area.min.set(x, y);
+		area.max.set(x, y);
+		candidates = spatial_index_->verticesIn(area);
+	}
+
 	// Go through all vertices
-	for (auto& vertex : objects_)
+	for (auto& vertex : use_index ? candidates : objects_)
 	{
 		if (vertex->position_.x == x && vertex->position_.y == y)
 			return vertex;
@@ -101,10 +127,22 @@ MapVertex* VertexList::vertexAt(double x, double y) const
 // -----------------------------------------------------------------------------
 MapVertex* VertexList::firstCrossed(const Seg2d& line) const
 {
+	// Get vertices within the line bbox from the spatial index, if it can be
+	// used
+	vector<MapVertex*> candidates;
+	bool               use_index = useSpatialIndex();
+	if (use_index)
+	{
+		BBox area;
+		area.min.set(line.left() - 1., line.top() - 1.);
+		area.max.set(line.right() + 1., line.bottom() + 1.);
+		candidates = spatial_index_->verticesIn(area);
+	}
+
 	// Go through vertices
 	MapVertex* cv       = nullptr;
 	double     min_dist = 999999;
-	for (const auto& vertex : objects_)
+	for (const auto& vertex : use_index ? candidates : objects_)
 	{
 		auto point = vertex->position();
 
@@ -132,3 +170,11 @@ MapVertex* VertexList::firstCrossed(const Seg2d& line) const
 	// Return closest overlapping vertex to line start
 	return cv;
 }
+
+// -----------------------------------------------------------------------------
+// Returns true if the map's spatial index can be used for queries on this list
+// -----------------------------------------------------------------------------
+bool VertexList::useSpatialIndex() const
+{
+	return spatial_index_ && MapSpatialIndex::enabled() && spatial_index_->indexes(*this);
+}
@@ -11,5 +11,8 @@ public:
 	MapVertex* nearest(Vec2d point, double min = 64) const;
 	MapVertex* vertexAt(double x, double y) const;
 	MapVertex* firstCrossed(const Seg2d& line) const;
+
+private:
+	bool useSpatialIndex() const;
 };
 } // namespace slade
@@ -0,0 +1,498 @@
+// -----------------------------------------------------------------------------
+// SLADE - It's a Doom Editor
+// Copyright(C) 2008 - 2020 Simon Judd
+//
+// Email:       sirjuddington@gmail.com
+// Web:         http://slade.mancubus.net
+// Filename:    MapSpatialIndex.cpp
+// Description: A uniform grid spatial index over map vertices, lines and
+//              sectors, kept up to date as objects are modified, added and
+//              removed
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation; either version 2 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+//
+// Includes
+//
+// -----------------------------------------------------------------------------
+#include "Main.h"
+#include "MapSpatialIndex.h"
+#include "MapObject/MapLine.h"
+#include "MapObject/MapSector.h"
+#include "MapObject/MapSide.h"
+#include "MapObject/MapThing.h"
+#include "MapObject/MapVertex.h"
+#include "MapObjectCollection.h"
+
+using namespace slade;
+
+
+// -----------------------------------------------------------------------------
+//
+// Variables
+//
+// -----------------------------------------------------------------------------
+CVAR(Bool, map_spatial_index, true, CVar::Flag::Save)
+
+namespace
+{
+constexpr double CELL_SIZE = 256.;
+constexpr i64    MAX_CELLS = 64; // Max cells an object can cover before it's considered 'large'
+constexpr double MAX_CELL  = 1 << 30;
+} // namespace
+
+
+// -----------------------------------------------------------------------------
+//
+// Functions
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// -----------------------------------------------------------------------------
+// Returns the grid cell coordinate containing map coordinate [pos]
+// -----------------------------------------------------------------------------
+int cellCoord(double pos)
+{
+	if (std::isnan(pos))
+		return 0;
+
+	return static_cast<int>(std::floor(std::clamp(pos / CELL_SIZE, -MAX_CELL, MAX_CELL)));
+}
+
+// -----------------------------------------------------------------------------
+// Returns the key for the grid cell at [x,y]
+// -----------------------------------------------------------------------------
+i64 cellKey(int x, int y)
+{
+	return static_cast<i64>(static_cast<u64>(static_cast<u32>(x)) << 32 | static_cast<u32>(y));
+}
+
+// -----------------------------------------------------------------------------
+// Returns a bounding box from [x1,y1] to [x2,y2]
+// -----------------------------------------------------------------------------
+BBox makeBBox(double x1, double y1, double x2, double y2)
+{
+	BBox bbox;
+	bbox.min.set(std::min(x1, x2), std::min(y1, y2));
+	bbox.max.set(std::max(x1, x2), std::max(y1, y2));
+	return bbox;
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if [object] is currently in [list] (ie. hasn't been removed)
+// -----------------------------------------------------------------------------
+template<class T, class L> bool inList(T* object, const L& list)
+{
+	return list.at(object->index()) == object;
+}
+
+// -----------------------------------------------------------------------------
+// Removes any objects no longer in [objects] from the query result [list],
+// then sorts it by index and removes duplicates
+// -----------------------------------------------------------------------------
+template<class T, class L> void finaliseResult(vector<T*>& list, const L& objects)
+{
+	list.erase(
+		std::remove_if(list.begin(), list.end(), [&objects](T* object) { return !inList(object, objects); }),
+		list.end());
+	std::sort(list.begin(), list.end(), [](T* left, T* right) { return left->index() < right->index(); });
+	list.erase(std::unique(list.begin(), list.end()), list.end());
+}
+} // namespace
+
+
+// -----------------------------------------------------------------------------
+//
+// MapSpatialIndex::Grid Struct Functions
+//
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+// Adds [object] to all cells overlapping [bbox]
+// -----------------------------------------------------------------------------
+template<class T> void MapSpatialIndex::Grid<T>::insert(T* object, const BBox& bbox)
+{
+	Range range{ cellCoord(bbox.min.x), cellCoord(bbox.min.y), cellCoord(bbox.max.x), cellCoord(bbox.max.y) };
+
+	// Objects covering a large area are kept in a separate list that is
+	// included in every query, rather than being added to lots of cells
+	if ((static_cast<i64>(range.x2) - range.x1 + 1) * (static_cast<i64>(range.y2) - range.y1 + 1) > MAX_CELLS)
+	{
+		large.push_back(object);
+		range.x1 = 1;
+		range.x2 = 0;
+	}
+	else
+	{
+		for (int x = range.x1; x <= range.x2; ++x)
+			for (int y = range.y1; y <= range.y2; ++y)
+				cells[cellKey(x, y)].push_back(object);
+	}
+
+	ranges[object] = range;
+}
+
+// -----------------------------------------------------------------------------
+// Removes [object] from the grid, if it was added
+// -----------------------------------------------------------------------------
+template<class T> void MapSpatialIndex::Grid<T>::remove(T* object)
+{
+	auto i = ranges.find(object);
+	if (i == ranges.end())
+		return;
+
+	// Removes [object] from [list] (order doesn't matter)
+	auto remove_from = [object](vector<T*>& list) {
+		auto pos = std::find(list.begin(), list.end(), object);
+		if (pos != list.end())
+		{
+			*pos = list.back();
+			list.pop_back();
+		}
+	};
+
+	auto& range = i->second;
+	if (range.x1 > range.x2)
+		remove_from(large);
+	else
+	{
+		for (int x = range.x1; x <= range.x2; ++x)
+			for (int y = range.y1; y <= range.y2; ++y)
+			{
+				auto cell = cells.find(cellKey(x, y));
+				if (cell == cells.end())
+					continue;
+
+				remove_from(cell->second);
+				if (cell->second.empty())
+					cells.erase(cell);
+			}
+	}
+
+	ranges.erase(i);
+}
+
+// -----------------------------------------------------------------------------
+// Adds all objects in cells overlapping [area] to [list]. Objects may be added
+// more than once, and in no particular order
+// -----------------------------------------------------------------------------
+template<class T> void MapSpatialIndex::Grid<T>::query(const BBox& area, vector<T*>& list) const
+{
+	list.insert(list.end(), large.begin(), large.end());
+
+	int x1 = cellCoord(area.min.x);
+	int y1 = cellCoord(area.min.y);
+	int x2 = cellCoord(area.max.x);
+	int y2 = cellCoord(area.max.y);
+	if (x1 > x2 || y1 > y2)
+		return;
+
+	// If the area covers more cells than are actually in use, it's quicker to
+	// just go through the used cells
+	auto n_cells = (static_cast<i64>(x2) - x1 + 1) * (static_cast<i64>(y2) - y1 + 1);
+	if (n_cells > static_cast<i64>(cells.size()))
+	{
+		for (const auto& cell : cells)
+		{
+			int x = static_cast<int>(static_cast<u32>(static_cast<u64>(cell.first) >> 32));
+			int y = static_cast<int>(static_cast<u32>(cell.first));
+			if (x >= x1 && x <= x2 && y >= y1 && y <= y2)
+				list.insert(list.end(), cell.second.begin(), cell.second.end());
+		}
+
+		return;
+	}
+
+	for (int x = x1; x <= x2; ++x)
+		for (int y = y1; y <= y2; ++y)
+		{
+			auto cell = cells.find(cellKey(x, y));
+			if (cell != cells.end())
+				list.insert(list.end(), cell->second.begin(), cell->second.end());
+		}
+}
+
+// -----------------------------------------------------------------------------
+// Removes all objects from the grid
+// -----------------------------------------------------------------------------
+template<class T> void MapSpatialIndex::Grid<T>::clear()
+{
+	cells.clear();
+	ranges.clear();
+	large.clear();
+}
+
+
+// -----------------------------------------------------------------------------
+//
+// MapSpatialIndex Class Functions
+//
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+// Returns true if [list] is the list of vertices this index is for
+// -----------------------------------------------------------------------------
+bool MapSpatialIndex::indexes(const VertexList& list) const
+{
+	return &list == &map_data_->vertices();
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if [list] is the list of lines this index is for
+// -----------------------------------------------------------------------------
+bool MapSpatialIndex::indexes(const LineList& list) const
+{
+	return &list == &map_data_->lines();
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if [list] is the list of sectors this index is for
+// -----------------------------------------------------------------------------
+bool MapSpatialIndex::indexes(const SectorList& list) const
+{
+	return &list == &map_data_->sectors();
+}
+
+// -----------------------------------------------------------------------------
+// Flags [object] as modified (or added/removed), so that it will be re-indexed
+// on the next query
+// -----------------------------------------------------------------------------
+void MapSpatialIndex::objectModified(MapObject* object)
+{
+	// Nothing to update if the index hasn't been built yet
+	if (!built_)
+		return;
+
+	// Ignore objects that aren't part of the map (eg. copies for the clipboard)
+	if (map_data_->getObjectById(object->objId()) != object)
+		return;
+
+	dirty_.insert(object);
+}
+
+// -----------------------------------------------------------------------------
+// Clears the index, it will be rebuilt on the next query
+// -----------------------------------------------------------------------------
+void MapSpatialIndex::invalidate()
+{
+	built_ = false;
+	dirty_.clear();
+	vertices_.clear();
+	lines_.clear();
+	sectors_.clear();
+	things_.clear();
+}
+
+// -----------------------------------------------------------------------------
+// Builds the index if needed, or re-indexes any modified objects
+// -----------------------------------------------------------------------------
+void MapSpatialIndex::update()
+{
+	if (!built_)
+	{
+		build();
+		return;
+	}
+
+	if (dirty_.empty())
+		return;
+
+	// Just rebuild if most of the map was modified
+	auto n_objects = map_data_->vertices().size() + map_data_->lines().size() + map_data_->sectors().size()
+					 + map_data_->things().size();
+	if (dirty_.size() > n_objects / 2)
+	{
+		build();
+		return;
+	}
+
+	// Determine objects to re-index - modifying a vertex also affects its
+	// connected lines, and modifying a line or side affects its sector(s)
+	std::unordered_set<MapVertex*> vertices;
+	std::unordered_set<MapLine*>   lines;
+	std::unordered_set<MapSector*> sectors;
+	std::unordered_set<MapThing*>  things;
+	for (auto object : dirty_)
+	{
+		switch (object->objType())
+		{
+		case MapObject::Type::Vertex:
+		{
+			auto vertex = dynamic_cast<MapVertex*>(object);
+			vertices.insert(vertex);
+			for (auto line : vertex->connectedLines())
+				lines.insert(line);
+			break;
+		}
+		case MapObject::Type::Line: lines.insert(dynamic_cast<MapLine*>(object)); break;
+		case MapObject::Type::Side:
+			if (auto sector = dynamic_cast<MapSide*>(object)->sector())
+				sectors.insert(sector);
+			break;
+		case MapObject::Type::Sector: sectors.insert(dynamic_cast<MapSector*>(object)); break;
+		case MapObject::Type::Thing: things.insert(dynamic_cast<MapThing*>(object)); break;
+		default: break;
+		}
+	}
+	dirty_.clear();
+
+	for (auto line : lines)
+	{
+		if (!inList(line, map_data_->lines()))
+			continue;
+
+		if (auto sector = line->frontSector())
+			sectors.insert(sector);
+		if (auto sector = line->backSector())
+			sectors.insert(sector);
+	}
+
+	// Re-index
+	for (auto vertex : vertices)
+	{
+		vertices_.remove(vertex);
+		if (inList(vertex, map_data_->vertices()))
+			vertices_.insert(vertex, makeBBox(vertex->xPos(), vertex->yPos(), vertex->xPos(), vertex->yPos()));
+	}
+	for (auto line : lines)
+	{
+		lines_.remove(line);
+		if (inList(line, map_data_->lines()))
+			lines_.insert(line, makeBBox(line->x1(), line->y1(), line->x2(), line->y2()));
+	}
+	for (auto sector : sectors)
+	{
+		sectors_.remove(sector);
+		if (inList(sector, map_data_->sectors()))
+			sectors_.insert(sector, sector->boundingBox());
+	}
+	for (auto thing : things)
+	{
+		things_.remove(thing);
+		if (inList(thing, map_data_->things()))
+			things_.insert(thing, makeBBox(thing->xPos(), thing->yPos(), thing->xPos(), thing->yPos()));
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Returns all vertices within [area], sorted by index
+// -----------------------------------------------------------------------------
+vector<MapVertex*> MapSpatialIndex::verticesIn(const BBox& area)
+{
+	update();
+
+	vector<MapVertex*> list;
+	vertices_.query(area, list);
+	finaliseResult(list, map_data_->vertices());
+
+	return list;
+}
+
+// -----------------------------------------------------------------------------
+// Returns all lines with a bounding box overlapping [area], sorted by index
+// -----------------------------------------------------------------------------
+vector<MapLine*> MapSpatialIndex::linesIn(const BBox& area)
+{
+	update();
+
+	vector<MapLine*> list;
+	lines_.query(area, list);
+	finaliseResult(list, map_data_->lines());
+
+	return list;
+}
+
+// -----------------------------------------------------------------------------
+// Returns all sectors with a bounding box containing [point], sorted by index
+// -----------------------------------------------------------------------------
+vector<MapSector*> MapSpatialIndex::sectorsAt(Vec2d point)
+{
+	update();
+
+	vector<MapSector*> list;
+	sectors_.query(makeBBox(point.x, point.y, point.x, point.y), list);
+	finaliseResult(list, map_data_->sectors());
+
+	return list;
+}
+
+// -----------------------------------------------------------------------------
+// Returns all sectors with a bounding box overlapping [area], sorted by index
+// -----------------------------------------------------------------------------
+vector<MapSector*> MapSpatialIndex::sectorsIn(const BBox& area)
+{
+	update();
+
+	vector<MapSector*> list;
+	sectors_.query(area, list);
+	finaliseResult(list, map_data_->sectors());
+
+	return list;
+}
+
+// -----------------------------------------------------------------------------
+// Returns all things positioned within [area], sorted by index
+// -----------------------------------------------------------------------------
+vector<MapThing*> MapSpatialIndex::thingsIn(const BBox& area)
+{
+	update();
+
+	vector<MapThing*> list;
+	things_.query(area, list);
+	finaliseResult(list, map_data_->things());
+
+	return list;
+}
+
+// -----------------------------------------------------------------------------
+// Builds the index from all vertices, lines, sectors and things in the map
+// -----------------------------------------------------------------------------
+void MapSpatialIndex::build()
+{
+	invalidate();
+
+	for (auto vertex : map_data_->vertices())
+		vertices_.insert(vertex, makeBBox(vertex->xPos(), vertex->yPos(), vertex->xPos(), vertex->yPos()));
+	for (auto line : map_data_->lines())
+		lines_.insert(line, makeBBox(line->x1(), line->y1(), line->x2(), line->y2()));
+	for (auto sector : map_data_->sectors())
+		sectors_.insert(sector, sector->boundingBox());
+	for (auto thing : map_data_->things())
+		things_.insert(thing, makeBBox(thing->xPos(), thing->yPos(), thing->xPos(), thing->yPos()));
+
+	built_ = true;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+// MapSpatialIndex Class Static Functions
+//
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+// Returns true if spatial indexing is enabled
+// -----------------------------------------------------------------------------
+bool MapSpatialIndex::enabled()
+{
+	return map_spatial_index;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace slade
+{
+class MapObject;
+class MapObjectCollection;
+class MapVertex;
+class MapLine;
+class MapSector;
+class MapThing;
+class VertexList;
+class LineList;
+class SectorList;
+
+// A uniform grid spatial index over the vertices, lines, sectors and things in
+// a MapObjectCollection, used to speed up position-based queries (hilighting,
+// line drawing, merging, 2d view culling etc.) on large maps.
+//
+// The index is built on the first query. After that, any objects that are
+// modified (see MapObject::setModified), added or removed are flagged and
+// re-indexed before the next query
+class MapSpatialIndex
+{
+public:
+	MapSpatialIndex(MapObjectCollection* map_data) : map_data_{ map_data } {}
+
+	bool indexes(const VertexList& list) const;
+	bool indexes(const LineList& list) const;
+	bool indexes(const SectorList& list) const;
+
+	void objectModified(MapObject* object);
+	void invalidate();
+	void update();
+
+	// Queries (results are sorted by index)
+	vector<MapVertex*> verticesIn(const BBox& area);
+	vector<MapLine*>   linesIn(const BBox& area);
+	vector<MapSector*> sectorsAt(Vec2d point);
+	vector<MapSector*> sectorsIn(const BBox& area);
+	vector<MapThing*>  thingsIn(const BBox& area);
+
+	static bool enabled();
+
+private:
+	// A grid of square cells, each containing a list of the objects whose
+	// bounding box overlaps it
+	template<class T> struct Grid
+	{
+		struct Range
+		{
+			int x1, y1, x2, y2; // Cells covered, or x1 > x2 if in [large]
+		};
+
+		std::unordered_map<i64, vector<T*>> cells;
+		std::unordered_map<T*, Range>       ranges;
+		vector<T*>                          large; // Objects covering too many cells to add to each
+
+		void insert(T* object, const BBox& bbox);
+		void remove(T* object);
+		void query(const BBox& area, vector<T*>& list) const;
+		void clear();
+	};
+
+	MapObjectCollection*           map_data_ = nullptr;
+	bool                           built_    = false;
+	std::unordered_set<MapObject*> dirty_;
+	Grid<MapVertex>                vertices_;
+	Grid<MapLine>                  lines_;
+	Grid<MapSector>                sectors_;
+	Grid<MapThing>                 things_; // By position only
+
+	void build();
+};
+} // namespace slade
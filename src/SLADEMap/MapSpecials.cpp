@@ -52,6 +52,71 @@ const double TAU = math::PI * 2; // Number of radians in the unit circle
 } // namespace
 
 
+// -----------------------------------------------------------------------------
+//
+// Functions
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// -----------------------------------------------------------------------------
+// Returns true if [object] is currently in [map] (ie. hasn't been removed)
+// -----------------------------------------------------------------------------
+bool inMap(SLADEMap* map, MapObject* object)
+{
+	switch (object->objType())
+	{
+	case MapObject::Type::Vertex: return map->vertices().at(object->index()) == object;
+	case MapObject::Type::Line: return map->lines().at(object->index()) == object;
+	case MapObject::Type::Side: return map->sides().at(object->index()) == object;
+	case MapObject::Type::Sector: return map->sectors().at(object->index()) == object;
+	case MapObject::Type::Thing: return map->things().at(object->index()) == object;
+	default: return false;
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Adds the front and back sectors of [line] (if any) to [sectors]
+// -----------------------------------------------------------------------------
+template<class C> void addLineSectors(MapLine* line, C& sectors)
+{
+	if (auto sector = line->frontSector())
+		sectors.insert(sectors.end(), sector);
+	if (auto sector = line->backSector())
+		sectors.insert(sectors.end(), sector);
+}
+
+// -----------------------------------------------------------------------------
+// Adds any sectors whose shape or properties depend on [object] to [sectors]
+// -----------------------------------------------------------------------------
+void putAffectedSectors(MapObject* object, std::unordered_set<MapSector*>& sectors)
+{
+	switch (object->objType())
+	{
+	case MapObject::Type::Vertex:
+		for (auto line : dynamic_cast<MapVertex*>(object)->connectedLines())
+			addLineSectors(line, sectors);
+		break;
+	case MapObject::Type::Line: addLineSectors(dynamic_cast<MapLine*>(object), sectors); break;
+	case MapObject::Type::Side:
+		if (auto sector = dynamic_cast<MapSide*>(object)->sector())
+			sectors.insert(sector);
+		break;
+	case MapObject::Type::Sector: sectors.insert(dynamic_cast<MapSector*>(object)); break;
+	default: break;
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Sorts [list] by object index
+// -----------------------------------------------------------------------------
+template<class T> void sortByIndex(vector<T*>& list)
+{
+	std::sort(list.begin(), list.end(), [](T* left, T* right) { return left->index() < right->index(); });
+}
+} // namespace
+
+
 // -----------------------------------------------------------------------------
 //
 // MapSpecials Class Functions
@@ -66,19 +131,296 @@ void MapSpecials::reset()
 {
 	sector_colours_.clear();
 	sector_fadecolours_.clear();
+
+	map_      = nullptr;
+	tracking_ = false;
+	port_.clear();
+	modified_.clear();
+	affected_sectors_.clear();
+	slope_specials_.clear();
+	translucent_lines_.clear();
+}
+
+// -----------------------------------------------------------------------------
+// Called when [object] is about to be modified (or added/removed), so that
+// any specials it could affect are re-processed on the next update
+// -----------------------------------------------------------------------------
+void MapSpecials::objectModified(MapObject* object)
+{
+	if (!tracking_)
+		return;
+
+	// Ignore objects that aren't part of the map (eg. copies for the clipboard)
+	if (map_->mapData().getObjectById(object->objId()) != object || !modified_.insert(object).second)
+		return;
+
+	// Sectors affected by the object before it is modified. Those affected
+	// after it is modified are added when updating
+	putAffectedSectors(object, affected_sectors_);
 }
 
 // -----------------------------------------------------------------------------
-// Process map specials, depending on the current game/port
+// Process map specials for the whole of [map], depending on the current
+// game/port
 // -----------------------------------------------------------------------------
-void MapSpecials::processMapSpecials(SLADEMap* map) const
+void MapSpecials::processMapSpecials(SLADEMap* map)
 {
+	sf::Clock clock;
+	tracking_ = false;
+
 	// ZDoom
-	if (game::configuration().currentPort() == "zdoom")
+	auto port = game::configuration().currentPort();
+	if (port == "zdoom")
 		processZDoomMapSpecials(map);
 	// Eternity, currently no need for processEternityMapSpecials
-	else if (game::configuration().currentPort() == "eternity")
-		processEternitySlopes(map);
+	else if (port == "eternity")
+		processEternitySlopes(map, map->sectors().all(), map->lines().all());
+
+	startTracking(map);
+
+	last_update_.full     = true;
+	last_update_.sectors  = map->nSectors();
+	last_update_.specials = slope_specials_.size();
+	last_update_.time     = clock.getElapsedTime().asMicroseconds() / 1000.;
+}
+
+// -----------------------------------------------------------------------------
+// Re-processes any map specials that could be affected by objects modified
+// since the last update. Processes all specials if they haven't been for
+// [map] yet
+// -----------------------------------------------------------------------------
+void MapSpecials::updateMapSpecials(SLADEMap* map)
+{
+	if (!tracking_ || map != map_ || port_ != game::configuration().currentPort())
+	{
+		processMapSpecials(map);
+		return;
+	}
+
+	sf::Clock clock;
+	tracking_ = false;
+
+	// Add sectors affected by modified objects after modification, and update
+	// the lists of special lines/things
+	vector<MapSector*> sectors;
+	for (auto object : modified_)
+	{
+		putAffectedSectors(object, affected_sectors_);
+
+		bool in_map = inMap(map, object);
+		if (object->objType() == MapObject::Type::Line)
+		{
+			auto line = dynamic_cast<MapLine*>(object);
+			if (in_map && line->special() == 208)
+				translucent_lines_.insert(line);
+			else
+				translucent_lines_.erase(line);
+		}
+
+		auto special = slope_specials_.find(object);
+		if (in_map && isSlopeSpecial(object))
+		{
+			if (special == slope_specials_.end())
+				slope_specials_[object] = {};
+		}
+		else if (special != slope_specials_.end())
+		{
+			// No longer a slope special, but the sectors it affected still
+			// need to be recomputed
+			affected_sectors_.insert(special->second.begin(), special->second.end());
+			slope_specials_.erase(special);
+		}
+	}
+
+	// ZDoom TranslucentLine specials on modified lines or targeting them
+	if (port_ == "zdoom")
+	{
+		std::unordered_set<int> modified_ids;
+		for (auto object : modified_)
+			if (object->objType() == MapObject::Type::Line)
+				modified_ids.insert(dynamic_cast<MapLine*>(object)->id());
+
+		for (auto line : translucent_lines_)
+			if (modified_.count(line) > 0 || modified_ids.count(line->arg(0)) > 0)
+				processZDoomLineSpecial(line);
+	}
+
+	// Find all slope specials linked to the affected sectors. Any sectors
+	// these specials read from or apply to are also affected, so keep going
+	// until no more are found
+	std::unordered_set<MapObject*> apply;
+	bool                           found = true;
+	while (found)
+	{
+		found = false;
+		for (auto& special : slope_specials_)
+		{
+			if (apply.count(special.first) > 0)
+				continue;
+
+			sectors.clear();
+			putSlopeSpecialSectors(map, special.first, sectors);
+			auto linked = [this](const vector<MapSector*>& list) {
+				for (auto sector : list)
+					if (affected_sectors_.count(sector) > 0)
+						return true;
+				return false;
+			};
+			if (modified_.count(special.first) == 0 && !linked(special.second) && !linked(sectors))
+				continue;
+
+			affected_sectors_.insert(special.second.begin(), special.second.end());
+			affected_sectors_.insert(sectors.begin(), sectors.end());
+			special.second = sectors;
+			apply.insert(special.first);
+			found = true;
+		}
+	}
+
+	// Recompute affected sectors (in map order)
+	sectors.clear();
+	for (auto sector : affected_sectors_)
+		if (map->sectors().at(sector->index()) == sector)
+			sectors.push_back(sector);
+	vector<MapLine*>  lines;
+	vector<MapThing*> things;
+	for (auto special : apply)
+	{
+		if (special->objType() == MapObject::Type::Line)
+			lines.push_back(dynamic_cast<MapLine*>(special));
+		else
+			things.push_back(dynamic_cast<MapThing*>(special));
+	}
+	sortByIndex(sectors);
+	sortByIndex(lines);
+	sortByIndex(things);
+	if (port_ == "zdoom")
+		processZDoomSlopes(map, sectors, lines, things);
+	else if (port_ == "eternity")
+		processEternitySlopes(map, sectors, lines);
+
+	modified_.clear();
+	affected_sectors_.clear();
+	tracking_ = true;
+
+	last_update_.full     = false;
+	last_update_.sectors  = sectors.size();
+	last_update_.specials = apply.size();
+	last_update_.time     = clock.getElapsedTime().asMicroseconds() / 1000.;
+}
+
+// -----------------------------------------------------------------------------
+// Begins tracking changes to [map] after all specials have been processed.
+// Records all current slope specials and the sectors linked to them
+// -----------------------------------------------------------------------------
+void MapSpecials::startTracking(SLADEMap* map)
+{
+	map_  = map;
+	port_ = game::configuration().currentPort();
+	modified_.clear();
+	affected_sectors_.clear();
+	slope_specials_.clear();
+	translucent_lines_.clear();
+
+	for (auto line : map->lines())
+	{
+		if (line->special() == 208)
+			translucent_lines_.insert(line);
+		if (isSlopeSpecial(line))
+			putSlopeSpecialSectors(map, line, slope_specials_[line]);
+	}
+	for (auto thing : map->things())
+		if (isSlopeSpecial(thing))
+			putSlopeSpecialSectors(map, thing, slope_specials_[thing]);
+
+	tracking_ = true;
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if [object] is a line or thing with a slope special for the
+// current port
+// -----------------------------------------------------------------------------
+bool MapSpecials::isSlopeSpecial(MapObject* object) const
+{
+	if (object->objType() == MapObject::Type::Line)
+	{
+		auto special = dynamic_cast<MapLine*>(object)->special();
+		return (port_ == "zdoom" || port_ == "eternity") && (special == 181 || special == 118);
+	}
+
+	if (object->objType() == MapObject::Type::Thing && port_ == "zdoom")
+	{
+		switch (dynamic_cast<MapThing*>(object)->type())
+		{
+		case 1500:
+		case 1501:
+		case 1504:
+		case 1505:
+		case 9500:
+		case 9501:
+		case 9502:
+		case 9503:
+		case 9510:
+		case 9511: return true;
+		default: return false;
+		}
+	}
+
+	return false;
+}
+
+// -----------------------------------------------------------------------------
+// Adds all sectors that the slope special line/thing [object] can read from or
+// apply a slope to in [map] to [list]
+// -----------------------------------------------------------------------------
+void MapSpecials::putSlopeSpecialSectors(SLADEMap* map, MapObject* object, vector<MapSector*>& list) const
+{
+	auto add_tagged = [map, &list](int tag) {
+		if (tag != 0)
+			if (auto sector = map->sectors().firstWithId(tag))
+				list.push_back(sector);
+	};
+
+	// Lines (Plane_Align, Plane_Copy)
+	if (object->objType() == MapObject::Type::Line)
+	{
+		auto line = dynamic_cast<MapLine*>(object);
+		addLineSectors(line, list);
+		if (line->special() == 118)
+			for (unsigned a = 0; a < 4; ++a)
+				add_tagged(line->arg(a));
+
+		return;
+	}
+
+	auto thing = dynamic_cast<MapThing*>(object);
+	if (!thing)
+		return;
+
+	// Vertex height things affect all sectors around the vertex they are on
+	if (thing->type() == 1504 || thing->type() == 1505)
+	{
+		if (auto vertex = map->vertices().vertexAt(thing->xPos(), thing->yPos()))
+			for (auto line : vertex->connectedLines())
+				addLineSectors(line, list);
+
+		return;
+	}
+
+	// Other slope things all use the sector they are in
+	if (auto sector = map->sectors().atPos(thing->position()))
+		list.push_back(sector);
+
+	// Line slope things apply to sectors on either side of lines with the
+	// given id, slope copy things copy from the sector with the given tag
+	if (thing->type() == 9500 || thing->type() == 9501)
+	{
+		if (thing->arg(0) != 0)
+			for (auto line : map->lines().allWithId(thing->arg(0)))
+				addLineSectors(line, list);
+	}
+	else if (thing->type() == 9510 || thing->type() == 9511)
+		add_tagged(thing->arg(0));
 }
 
 // -----------------------------------------------------------------------------
@@ -180,14 +522,14 @@ void MapSpecials::updateTaggedSectors(SLADEMap* map)
 // Process ZDoom map specials, mostly to convert hexen specials to UDMF
 // counterparts
 // -----------------------------------------------------------------------------
-void MapSpecials::processZDoomMapSpecials(SLADEMap* map) const
+void MapSpecials::processZDoomMapSpecials(SLADEMap* map)
 {
 	// Line specials
 	for (unsigned a = 0; a < map->nLines(); a++)
 		processZDoomLineSpecial(map->line(a));
 
 	// All slope specials, which must be done in a particular order
-	processZDoomSlopes(map);
+	processZDoomSlopes(map, map->sectors().all(), map->lines().all(), map->things().all());
 }
 
 // -----------------------------------------------------------------------------
@@ -357,9 +699,14 @@ void MapSpecials::processACSScripts(ArchiveEntry* entry)
 }
 
 // -----------------------------------------------------------------------------
-// Process ZDoom slope specials
+// Process ZDoom slope specials for [sectors], from the slope special [lines]
+// and [things] (which must be in map order)
 // -----------------------------------------------------------------------------
-void MapSpecials::processZDoomSlopes(SLADEMap* map) const
+void MapSpecials::processZDoomSlopes(
+	SLADEMap*                 map,
+	const vector<MapSector*>& sectors,
+	const vector<MapLine*>&   lines,
+	const vector<MapThing*>&  things) const
 {
 	// ZDoom has a variety of slope mechanisms, which must be evaluated in a
 	// specific order.
@@ -372,17 +719,15 @@ void MapSpecials::processZDoomSlopes(SLADEMap* map) const
 	//  - Plane_Copy, in line order
 
 	// First things first: reset every sector to flat planes
-	for (unsigned a = 0; a < map->nSectors(); a++)
+	for (auto target : sectors)
 	{
-		auto target = map->sector(a);
 		target->setPlane<SurfaceType::Floor>(Plane::flat(target->planeHeight<SurfaceType::Floor>()));
 		target->setPlane<SurfaceType::Ceiling>(Plane::flat(target->planeHeight<SurfaceType::Ceiling>()));
 	}
 
 	// Floor/ceiling plane properties
-	for (unsigned a = 0; a < map->nSectors(); a++)
+	for (auto target : sectors)
 	{
-		auto target        = map->sector(a);
 		auto floorplane    = Plane::flat(target->floor().height);
 		bool hasFloorplane = false;
 		// Check for floor plane.
@@ -445,9 +790,8 @@ void MapSpecials::processZDoomSlopes(SLADEMap* map) const
 	}
 
 	// Plane_Align (line special 181)
-	for (unsigned a = 0; a < map->nLines(); a++)
+	for (auto line : lines)
 	{
-		auto line = map->line(a);
 		if (line->special() != 181)
 			continue;
 
@@ -479,10 +823,8 @@ void MapSpecials::processZDoomSlopes(SLADEMap* map) const
 
 	// Line slope things (9500/9501), sector tilt things (9502/9503), and
 	// vavoom things (1500/1501), all in the same pass
-	for (unsigned a = 0; a < map->nThings(); a++)
+	for (auto thing : things)
 	{
-		auto thing = map->thing(a);
-
 		// Line slope things
 		if (thing->type() == 9500)
 			applyLineSlopeThing<SurfaceType::Floor>(map, thing);
@@ -501,10 +843,8 @@ void MapSpecials::processZDoomSlopes(SLADEMap* map) const
 	}
 
 	// Slope copy things (9510/9511)
-	for (unsigned a = 0; a < map->nThings(); a++)
+	for (auto thing : things)
 	{
-		auto thing = map->thing(a);
-
 		if (thing->type() == 9510 || thing->type() == 9511)
 		{
 			auto target = map->sectors().atPos(thing->position());
@@ -540,9 +880,8 @@ void MapSpecials::processZDoomSlopes(SLADEMap* map) const
 	// we store them in a hashmap.
 	VertexHeightMap vertex_floor_heights;
 	VertexHeightMap vertex_ceiling_heights;
-	for (unsigned a = 0; a < map->nThings(); a++)
+	for (auto thing : things)
 	{
-		auto thing = map->thing(a);
 		if (thing->type() == 1504 || thing->type() == 1505)
 		{
 			// TODO there could be more than one vertex at this point
@@ -561,9 +900,8 @@ void MapSpecials::processZDoomSlopes(SLADEMap* map) const
 	// Heights may be set by UDMF properties, or by a vertex height thing
 	// placed exactly on the vertex (which takes priority over the prop).
 	vector<MapVertex*> vertices;
-	for (unsigned a = 0; a < map->nSectors(); a++)
+	for (auto target : sectors)
 	{
-		auto target = map->sector(a);
 		vertices.clear();
 		target->putVertices(vertices);
 		if (vertices.size() != 3)
@@ -574,9 +912,8 @@ void MapSpecials::processZDoomSlopes(SLADEMap* map) const
 	}
 
 	// Plane_Copy
-	for (unsigned a = 0; a < map->nLines(); a++)
+	for (auto line : lines)
 	{
-		auto line = map->line(a);
 		if (line->special() != 118)
 			continue;
 
@@ -624,9 +961,13 @@ void MapSpecials::processZDoomSlopes(SLADEMap* map) const
 }
 
 // -----------------------------------------------------------------------------
-// Process Eternity slope specials
+// Process Eternity slope specials for [sectors], from the slope special
+// [lines] (which must be in map order)
 // -----------------------------------------------------------------------------
-void MapSpecials::processEternitySlopes(SLADEMap* map) const
+void MapSpecials::processEternitySlopes(
+	SLADEMap*                 map,
+	const vector<MapSector*>& sectors,
+	const vector<MapLine*>&   lines) const
 {
 	// Eternity plans on having a few slope mechanisms,
 	// which must be evaluated in a specific order.
@@ -635,17 +976,15 @@ void MapSpecials::processEternitySlopes(SLADEMap* map) const
 	//  - Plane_Copy, in line order
 
 	// First things first: reset every sector to flat planes
-	for (unsigned a = 0; a < map->nSectors(); a++)
+	for (auto target : sectors)
 	{
-		auto target = map->sector(a);
 		target->setPlane<SurfaceType::Floor>(Plane::flat(target->planeHeight<SurfaceType::Floor>()));
 		target->setPlane<SurfaceType::Ceiling>(Plane::flat(target->planeHeight<SurfaceType::Ceiling>()));
 	}
 
 	// Plane_Align (line special 181)
-	for (unsigned a = 0; a < map->nLines(); a++)
+	for (auto line : lines)
 	{
-		auto line = map->line(a);
 		if (line->special() != 181)
 			continue;
 
@@ -676,10 +1015,8 @@ void MapSpecials::processEternitySlopes(SLADEMap* map) const
 	}
 
 	// Plane_Copy
-	vector<MapSector*> sectors;
-	for (unsigned a = 0; a < map->nLines(); a++)
+	for (auto line : lines)
 	{
-		auto line = map->line(a);
 		if (line->special() != 118)
 			continue;
 
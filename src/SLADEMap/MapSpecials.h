@@ -1,6 +1,8 @@
 #pragma once
 
 #include "SLADEMap/MapObject/MapSector.h"
+#include <unordered_map>
+#include <unordered_set>
 
 namespace slade
 {
@@ -10,12 +12,33 @@ class MapLine;
 class SLADEMap;
 class ArchiveEntry;
 
+// Processes port-specific map specials (slopes, translucent lines, ACS sector
+// colours etc.) that affect how the map is displayed.
+//
+// After the specials have been processed for the whole map, any modified
+// objects are tracked, and updateMapSpecials will only re-process the slope
+// specials and sectors that could be affected by them. Each slope special
+// (line or thing) is recorded along with all the sectors it reads from or
+// applies to, and any sectors linked to a modified object through these are
+// recomputed together, in the same order as a full update would
 class MapSpecials
 {
 public:
+	struct UpdateStats
+	{
+		bool     full     = true;
+		unsigned sectors  = 0; // Number of sectors recomputed
+		unsigned specials = 0; // Number of slope specials applied
+		double   time     = 0; // Time taken (ms)
+	};
+
+	const UpdateStats& lastUpdateStats() const { return last_update_; }
+
 	void reset();
+	void objectModified(MapObject* object);
 
-	void processMapSpecials(SLADEMap* map) const;
+	void processMapSpecials(SLADEMap* map);
+	void updateMapSpecials(SLADEMap* map);
 	void processLineSpecial(MapLine* line) const;
 
 	bool tagColour(int tag, ColRGBA* colour);
@@ -25,7 +48,7 @@ public:
 	void updateTaggedSectors(SLADEMap* map);
 
 	// ZDoom
-	void processZDoomMapSpecials(SLADEMap* map) const;
+	void processZDoomMapSpecials(SLADEMap* map);
 	void processZDoomLineSpecial(MapLine* line) const;
 	void updateZDoomSector(MapSector* line);
 	void processACSScripts(ArchiveEntry* entry);
@@ -43,8 +66,26 @@ private:
 	vector<SectorColour> sector_colours_;
 	vector<SectorColour> sector_fadecolours_;
 
-	void processZDoomSlopes(SLADEMap* map) const;
-	void processEternitySlopes(SLADEMap* map) const;
+	// Change tracking
+	SLADEMap*                                          map_      = nullptr;
+	bool                                               tracking_ = false;
+	string                                             port_;
+	std::unordered_set<MapObject*>                     modified_;
+	std::unordered_set<MapSector*>                     affected_sectors_;
+	std::unordered_map<MapObject*, vector<MapSector*>> slope_specials_;
+	std::unordered_set<MapLine*>                       translucent_lines_;
+	UpdateStats                                        last_update_;
+
+	void startTracking(SLADEMap* map);
+	bool isSlopeSpecial(MapObject* object) const;
+	void putSlopeSpecialSectors(SLADEMap* map, MapObject* object, vector<MapSector*>& list) const;
+
+	void processZDoomSlopes(
+		SLADEMap*                 map,
+		const vector<MapSector*>& sectors,
+		const vector<MapLine*>&   lines,
+		const vector<MapThing*>&  things) const;
+	void processEternitySlopes(SLADEMap* map, const vector<MapSector*>& sectors, const vector<MapLine*>& lines) const;
 
 	template<MapSector::SurfaceType>
 	void applyPlaneAlign(MapLine* line, MapSector* target, MapSector* model_sector) const;
@@ -0,0 +1,435 @@
+// -----------------------------------------------------------------------------
+// SLADE - It's a Doom Editor
+// Copyright(C) 2008 - 2020 Simon Judd
+//
+// Email:       sirjuddington@gmail.com
+// Web:         http://slade.mancubus.net
+// Filename:    MapTagIndex.cpp
+// Description: A reverse index from id/tag values to map sectors, lines and
+//              things, kept up to date as objects are modified, added and
+//              removed
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation; either version 2 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+//
+// Includes
+//
+// -----------------------------------------------------------------------------
+#include "Main.h"
+#include "MapTagIndex.h"
+#include "MapObject/MapLine.h"
+#include "MapObject/MapSector.h"
+#include "MapObject/MapThing.h"
+#include "MapObjectCollection.h"
+
+using namespace slade;
+
+
+// -----------------------------------------------------------------------------
+//
+// Functions
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// -----------------------------------------------------------------------------
+// Returns true if [object] is currently in [list] (ie. hasn't been removed)
+// -----------------------------------------------------------------------------
+template<class T, class L> bool inList(T* object, const L& list)
+{
+	return list.at(object->index()) == object;
+}
+
+// -----------------------------------------------------------------------------
+// Returns the values of [object]'s args that a special could use as a tag.
+// The first arg is also added as a positive value since some specials use
+// negative line ids
+// -----------------------------------------------------------------------------
+template<class T> vector<int> argValues(T* object)
+{
+	vector<int> values;
+	for (unsigned a = 0; a < 5; ++a)
+		values.push_back(object->arg(a));
+	values.push_back(std::abs(object->arg(0)));
+
+	return values;
+}
+
+// -----------------------------------------------------------------------------
+// Sorts [list] by object index
+// -----------------------------------------------------------------------------
+template<class T> void sortByIndex(vector<T*>& list)
+{
+	std::sort(list.begin(), list.end(), [](T* left, T* right) { return left->index() < right->index(); });
+}
+} // namespace
+
+
+// -----------------------------------------------------------------------------
+//
+// MapTagIndex::Lookup Struct Functions
+//
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+// Adds [object] to the lists for each non-zero value in [object_values]
+// -----------------------------------------------------------------------------
+template<class T> void MapTagIndex::Lookup<T>::insert(T* object, vector<int> object_values)
+{
+	object_values.erase(std::remove(object_values.begin(), object_values.end(), 0), object_values.end());
+	std::sort(object_values.begin(), object_values.end());
+	object_values.erase(std::unique(object_values.begin(), object_values.end()), object_values.end());
+	if (object_values.empty())
+		return;
+
+	for (auto value : object_values)
+		objects[value].push_back(object);
+
+	values[object] = std::move(object_values);
+}
+
+// -----------------------------------------------------------------------------
+// Removes [object] from the lookup, if it was added
+// -----------------------------------------------------------------------------
+template<class T> void MapTagIndex::Lookup<T>::remove(T* object)
+{
+	auto i = values.find(object);
+	if (i == values.end())
+		return;
+
+	for (auto value : i->second)
+	{
+		auto list = objects.find(value);
+		if (list == objects.end())
+			continue;
+
+		// Order doesn't matter, so just swap the last object into its place
+		auto pos = std::find(list->second.begin(), list->second.end(), object);
+		if (pos != list->second.end())
+		{
+			*pos = list->second.back();
+			list->second.pop_back();
+		}
+		if (list->second.empty())
+			objects.erase(list);
+	}
+
+	values.erase(i);
+}
+
+// -----------------------------------------------------------------------------
+// Adds all objects with [value] to [list], in no particular order
+// -----------------------------------------------------------------------------
+template<class T> void MapTagIndex::Lookup<T>::query(int value, vector<T*>& list) const
+{
+	auto i = objects.find(value);
+	if (i != objects.end())
+		list.insert(list.end(), i->second.begin(), i->second.end());
+}
+
+// -----------------------------------------------------------------------------
+// Returns the lowest value (> 0) that no objects have
+// -----------------------------------------------------------------------------
+template<class T> int MapTagIndex::Lookup<T>::firstFree() const
+{
+	int value = 1;
+	while (objects.count(value) > 0)
+		++value;
+
+	return value;
+}
+
+// -----------------------------------------------------------------------------
+// Removes all objects from the lookup
+// -----------------------------------------------------------------------------
+template<class T> void MapTagIndex::Lookup<T>::clear()
+{
+	objects.clear();
+	values.clear();
+}
+
+
+// -----------------------------------------------------------------------------
+//
+// MapTagIndex Class Functions
+//
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+// Returns true if [list] is the list of lines this index is for
+// -----------------------------------------------------------------------------
+bool MapTagIndex::indexes(const LineList& list) const
+{
+	return &list == &map_data_->lines();
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if [list] is the list of sectors this index is for
+// -----------------------------------------------------------------------------
+bool MapTagIndex::indexes(const SectorList& list) const
+{
+	return &list == &map_data_->sectors();
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if [list] is the list of things this index is for
+// -----------------------------------------------------------------------------
+bool MapTagIndex::indexes(const ThingList& list) const
+{
+	return &list == &map_data_->things();
+}
+
+// -----------------------------------------------------------------------------
+// Flags [object] as modified (or added/removed), so that it will be re-indexed
+// on the next query
+// -----------------------------------------------------------------------------
+void MapTagIndex::objectModified(MapObject* object)
+{
+	// Nothing to update if the index hasn't been built yet
+	if (!built_)
+		return;
+
+	auto type = object->objType();
+	if (type != MapObject::Type::Sector && type != MapObject::Type::Line && type != MapObject::Type::Thing)
+		return;
+
+	// Ignore objects that aren't part of the map (eg. copies for the clipboard)
+	if (map_data_->getObjectById(object->objId()) != object)
+		return;
+
+	dirty_.insert(object);
+}
+
+// -----------------------------------------------------------------------------
+// Clears the index, it will be rebuilt on the next query
+// -----------------------------------------------------------------------------
+void MapTagIndex::invalidate()
+{
+	built_ = false;
+	dirty_.clear();
+	sector_ids_.clear();
+	line_ids_.clear();
+	thing_ids_.clear();
+	line_args_.clear();
+	thing_args_.clear();
+}
+
+// -----------------------------------------------------------------------------
+// Builds the index if needed, or re-indexes any modified objects
+// -----------------------------------------------------------------------------
+void MapTagIndex::update()
+{
+	if (!built_)
+	{
+		build();
+		return;
+	}
+
+	if (dirty_.empty())
+		return;
+
+	// Just rebuild if most of the map was modified
+	auto n_objects = map_data_->sectors().size() + map_data_->lines().size() + map_data_->things().size();
+	if (dirty_.size() > n_objects / 2)
+	{
+		build();
+		return;
+	}
+
+	for (auto object : dirty_)
+	{
+		switch (object->objType())
+		{
+		case MapObject::Type::Sector:
+		{
+			auto sector = dynamic_cast<MapSector*>(object);
+			sector_ids_.remove(sector);
+			if (inList(sector, map_data_->sectors()))
+				indexSector(sector);
+			break;
+		}
+		case MapObject::Type::Line:
+		{
+			auto line = dynamic_cast<MapLine*>(object);
+			line_ids_.remove(line);
+			line_args_.remove(line);
+			if (inList(line, map_data_->lines()))
+				indexLine(line);
+			break;
+		}
+		case MapObject::Type::Thing:
+		{
+			auto thing = dynamic_cast<MapThing*>(object);
+			thing_ids_.remove(thing);
+			thing_args_.remove(thing);
+			if (inList(thing, map_data_->things()))
+				indexThing(thing);
+			break;
+		}
+		default: break;
+		}
+	}
+	dirty_.clear();
+}
+
+// -----------------------------------------------------------------------------
+// Returns all sectors with tag [id], sorted by index
+// -----------------------------------------------------------------------------
+vector<MapSector*> MapTagIndex::sectorsWithId(int id)
+{
+	update();
+
+	vector<MapSector*> list;
+	sector_ids_.query(id, list);
+	sortByIndex(list);
+
+	return list;
+}
+
+// -----------------------------------------------------------------------------
+// Returns all lines with [id], sorted by index
+// -----------------------------------------------------------------------------
+vector<MapLine*> MapTagIndex::linesWithId(int id)
+{
+	update();
+
+	vector<MapLine*> list;
+	line_ids_.query(id, list);
+	sortByIndex(list);
+
+	return list;
+}
+
+// -----------------------------------------------------------------------------
+// Returns all things with TID [id], sorted by index
+// -----------------------------------------------------------------------------
+vector<MapThing*> MapTagIndex::thingsWithId(int id)
+{
+	update();
+
+	vector<MapThing*> list;
+	thing_ids_.query(id, list);
+	sortByIndex(list);
+
+	return list;
+}
+
+// -----------------------------------------------------------------------------
+// Returns all lines with [value] as any arg (or the absolute value of the
+// first arg), sorted by index
+// -----------------------------------------------------------------------------
+vector<MapLine*> MapTagIndex::linesWithArg(int value)
+{
+	update();
+
+	vector<MapLine*> list;
+	line_args_.query(value, list);
+	sortByIndex(list);
+
+	return list;
+}
+
+// -----------------------------------------------------------------------------
+// Returns all things with [value] as any arg (or the absolute value of the
+// first arg) or TID, sorted by index
+// -----------------------------------------------------------------------------
+vector<MapThing*> MapTagIndex::thingsWithArg(int value)
+{
+	update();
+
+	vector<MapThing*> list;
+	thing_args_.query(value, list);
+	sortByIndex(list);
+
+	return list;
+}
+
+// -----------------------------------------------------------------------------
+// Returns the lowest unused sector tag
+// -----------------------------------------------------------------------------
+int MapTagIndex::firstFreeSectorId()
+{
+	update();
+	return sector_ids_.firstFree();
+}
+
+// -----------------------------------------------------------------------------
+// Returns the lowest unused line id
+// -----------------------------------------------------------------------------
+int MapTagIndex::firstFreeLineId()
+{
+	update();
+	return line_ids_.firstFree();
+}
+
+// -----------------------------------------------------------------------------
+// Returns the lowest unused thing TID
+// -----------------------------------------------------------------------------
+int MapTagIndex::firstFreeThingId()
+{
+	update();
+	return thing_ids_.firstFree();
+}
+
+// -----------------------------------------------------------------------------
+// Builds the index from all sectors, lines and things in the map
+// -----------------------------------------------------------------------------
+void MapTagIndex::build()
+{
+	invalidate();
+
+	for (auto sector : map_data_->sectors())
+		indexSector(sector);
+	for (auto line : map_data_->lines())
+		indexLine(line);
+	for (auto thing : map_data_->things())
+		indexThing(thing);
+
+	built_ = true;
+}
+
+// -----------------------------------------------------------------------------
+// Adds [sector] to the index
+// -----------------------------------------------------------------------------
+void MapTagIndex::indexSector(MapSector* sector)
+{
+	sector_ids_.insert(sector, { sector->tag() });
+}
+
+// -----------------------------------------------------------------------------
+// Adds [line] to the index
+// -----------------------------------------------------------------------------
+void MapTagIndex::indexLine(MapLine* line)
+{
+	line_ids_.insert(line, { line->id() });
+	line_args_.insert(line, argValues(line));
+}
+
+// -----------------------------------------------------------------------------
+// Adds [thing] to the index
+// -----------------------------------------------------------------------------
+void MapTagIndex::indexThing(MapThing* thing)
+{
+	thing_ids_.insert(thing, { thing->id() });
+
+	auto values = argValues(thing);
+	values.push_back(thing->id());
+	thing_args_.insert(thing, values);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace slade
+{
+class MapObject;
+class MapObjectCollection;
+class MapLine;
+class MapSector;
+class MapThing;
+class LineList;
+class SectorList;
+class ThingList;
+
+// A reverse index from id/tag values to the sectors, lines and things in a
+// MapObjectCollection that use them, used to speed up tag/id lookups (tagged
+// object hilighting, map specials, finding free ids etc.) on large maps.
+//
+// Objects are indexed both by their own id (sector tag, line id, thing TID)
+// and by any values in their args (and TID for things), which are the only
+// values a special can possibly tag. Since the args are indexed as raw values,
+// the index doesn't depend on the game configuration and callers still check
+// what each candidate's special actually tags.
+//
+// Like MapSpatialIndex, the index is built on the first query and modified
+// objects are re-indexed before the next query after that
+class MapTagIndex
+{
+public:
+	MapTagIndex(MapObjectCollection* map_data) : map_data_{ map_data } {}
+
+	bool indexes(const LineList& list) const;
+	bool indexes(const SectorList& list) const;
+	bool indexes(const ThingList& list) const;
+
+	void objectModified(MapObject* object);
+	void invalidate();
+	void update();
+
+	// Queries (results are sorted by index)
+	vector<MapSector*> sectorsWithId(int id);
+	vector<MapLine*>   linesWithId(int id);
+	vector<MapThing*>  thingsWithId(int id);
+	vector<MapLine*>   linesWithArg(int value);
+	vector<MapThing*>  thingsWithArg(int value);
+
+	// Lowest id (> 0) not used by any object
+	int firstFreeSectorId();
+	int firstFreeLineId();
+	int firstFreeThingId();
+
+private:
+	// A map of values to the objects that have them
+	template<class T> struct Lookup
+	{
+		std::unordered_map<int, vector<T*>> objects;
+		std::unordered_map<T*, vector<int>> values; // Values each object was added with
+
+		void insert(T* object, vector<int> object_values);
+		void remove(T* object);
+		void query(int value, vector<T*>& list) const;
+		int  firstFree() const;
+		void clear();
+	};
+
+	MapObjectCollection*           map_data_ = nullptr;
+	bool                           built_    = false;
+	std::unordered_set<MapObject*> dirty_;
+	Lookup<MapSector>              sector_ids_;
+	Lookup<MapLine>                line_ids_;
+	Lookup<MapThing>               thing_ids_;
+	Lookup<MapLine>                line_args_;
+	Lookup<MapThing>               thing_args_;
+
+	void build();
+	void indexSector(MapSector* sector);
+	void indexLine(MapLine* line);
+	void indexThing(MapThing* thing);
+};
+} // namespace slade
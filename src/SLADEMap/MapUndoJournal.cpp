@@ -0,0 +1,112 @@
+// -----------------------------------------------------------------------------
+// SLADE - It's a Doom Editor
+// Copyright(C) 2008 - 2020 Simon Judd
+//
+// Email:       sirjuddington@gmail.com
+// Web:         http://slade.mancubus.net
+// Filename:    MapUndoJournal.cpp
+// Description: Records the map objects modified, added and removed while an
+//              undo level is being recorded
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation; either version 2 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+//
+// Includes
+//
+// -----------------------------------------------------------------------------
+#include "Main.h"
+#include "MapUndoJournal.h"
+#include "MapObjectCollection.h"
+
+using namespace slade;
+
+
+// -----------------------------------------------------------------------------
+//
+// MapUndoJournal Class Functions
+//
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+// Begins recording changes. If [record_modified] is true, objects will also be
+// backed up on their first modification
+// -----------------------------------------------------------------------------
+void MapUndoJournal::begin(bool record_modified)
+{
+	end();
+
+	recording_       = true;
+	record_modified_ = record_modified;
+}
+
+// -----------------------------------------------------------------------------
+// Stops recording changes and clears the journal
+// -----------------------------------------------------------------------------
+void MapUndoJournal::end()
+{
+	recording_       = false;
+	record_modified_ = false;
+	journalled_.clear();
+	modified_.clear();
+	list_changes_.clear();
+}
+
+// -----------------------------------------------------------------------------
+// Called when [object] is about to be modified. Returns true if this is its
+// first modification since recording began, meaning its current properties
+// should be backed up
+// -----------------------------------------------------------------------------
+bool MapUndoJournal::objectModified(MapObject* object)
+{
+	if (!record_modified_)
+		return false;
+
+	// Ignore objects that aren't part of the map (eg. copies for the clipboard)
+	if (map_data_->getObjectById(object->objId()) != object)
+		return false;
+
+	if (!journalled_.insert(object).second)
+		return false;
+
+	modified_.push_back(object);
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Called when [object] has been added to the end of its object list
+// -----------------------------------------------------------------------------
+void MapUndoJournal::objectAdded(MapObject* object)
+{
+	if (!recording_)
+		return;
+
+	// New objects don't need backing up, there is nothing to restore them to
+	journalled_.insert(object);
+
+	list_changes_.push_back({ object->objType(), object->objId(), object->index(), true });
+}
+
+// -----------------------------------------------------------------------------
+// Called when [object] is about to be removed from its object list
+// -----------------------------------------------------------------------------
+void MapUndoJournal::objectRemoved(MapObject* object)
+{
+	if (recording_)
+		list_changes_.push_back({ object->objType(), object->objId(), object->index(), false });
+}
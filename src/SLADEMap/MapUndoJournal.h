@@ -0,0 +1,51 @@
+#pragma once
+
+#include "MapObject/MapObject.h"
+#include <unordered_set>
+
+namespace slade
+{
+class MapObjectCollection;
+
+// Records changes made to the objects in a MapObjectCollection while an undo
+// level is being recorded, so that undo steps can be built from exactly what
+// changed rather than by scanning the whole map.
+//
+// Objects are journalled the first time they are modified (their properties
+// are backed up beforehand), and every add to/removal from the collection's
+// object lists is recorded in order, along with the list index involved so
+// that it can be reversed exactly
+class MapUndoJournal
+{
+public:
+	// An object being added to or removed from one of the object lists
+	struct ListChange
+	{
+		MapObject::Type type;
+		unsigned        id;
+		unsigned        index;
+		bool            added;
+	};
+
+	MapUndoJournal(MapObjectCollection* map_data) : map_data_{ map_data } {}
+
+	bool                      recording() const { return recording_; }
+	const vector<MapObject*>& modifiedObjects() const { return modified_; }
+	const vector<ListChange>& listChanges() const { return list_changes_; }
+
+	void begin(bool record_modified);
+	void end();
+
+	bool objectModified(MapObject* object);
+	void objectAdded(MapObject* object);
+	void objectRemoved(MapObject* object);
+
+private:
+	MapObjectCollection*           map_data_        = nullptr;
+	bool                           recording_       = false;
+	bool                           record_modified_ = false;
+	std::unordered_set<MapObject*> journalled_;
+	vector<MapObject*>             modified_;
+	vector<ListChange>             list_changes_;
+};
+} // namespace slade
@@ -491,11 +491,12 @@ void SLADEMap::setOpenedTime()
 // Re-applies all the currently calculated special map properties (currently
 // this just means ZDoom slopes).
 // Since this needs to be done anytime the map changes, it's called whenever a
-// map is read, an undo record ends, or an undo/redo is performed.
+// map is read, an undo record ends, or an undo/redo is performed. Only
+// specials affected by objects modified since the last call are re-applied
 // -----------------------------------------------------------------------------
 void SLADEMap::recomputeSpecials()
 {
-	map_specials_.processMapSpecials(this);
+	map_specials_.updateMapSpecials(this);
 }
 
 // -----------------------------------------------------------------------------
@@ -35,6 +35,9 @@ public:
 	long                       geometryUpdated() const { return geometry_updated_; }
 	long                       thingsUpdated() const { return things_updated_; }
 	const MapObjectCollection& mapData() const { return data_; }
+	MapSpatialIndex&           spatialIndex() { return data_.spatialIndex(); }
+	MapTagIndex&               tagIndex() { return data_.tagIndex(); }
+	MapUndoJournal&            undoJournal() { return data_.undoJournal(); }
 
 	void setGeometryUpdated();
 	void setThingsUpdated();
@@ -125,7 +128,7 @@ public:
 	// Misc. map data access
 	void rebuildConnectedLines() { data_.rebuildConnectedLines(); }
 	void rebuildConnectedSides() { data_.rebuildConnectedSides(); }
-	void restoreObjectIdList(MapObject::Type type, vector<unsigned>& list) { data_.restoreObjectIdList(type, list); }
+	void applyListChange(const MapUndoJournal::ListChange& change, bool undo) { data_.applyListChange(change, undo); }
 
 	// Convert
 	bool convertToHexen() const;
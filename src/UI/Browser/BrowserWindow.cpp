@@ -345,6 +345,26 @@ void BrowserWindow::reloadItems(BrowserTreeNode* node) const
 		reloadItems(dynamic_cast<BrowserTreeNode*>(node->child(a)));
 }
 
+// -----------------------------------------------------------------------------
+// Reloads (clears) the images of any items in [node] and its children
+// recursively with a name (uppercase) in [names]
+// -----------------------------------------------------------------------------
+void BrowserWindow::reloadItems(const std::set<string>& names, BrowserTreeNode* node) const
+{
+	// Check node was given to begin reload
+	if (!node)
+		node = items_root_;
+
+	// Go through items in this node
+	for (unsigned a = 0; a < node->nItems(); a++)
+		if (names.count(node->item(a)->name().Upper().ToStdString()) > 0)
+			node->item(a)->clearImage();
+
+	// Go through child nodes
+	for (unsigned a = 0; a < node->nChildren(); a++)
+		reloadItems(names, dynamic_cast<BrowserTreeNode*>(node->child(a)));
+}
+
 // -----------------------------------------------------------------------------
 // Returns the currently selected item
 // -----------------------------------------------------------------------------
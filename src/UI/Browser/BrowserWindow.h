@@ -56,6 +56,7 @@ public:
 	void         addGlobalItem(BrowserItem* item);
 	void         clearItems(BrowserTreeNode* node = nullptr) const;
 	void         reloadItems(BrowserTreeNode* node = nullptr) const;
+	void         reloadItems(const std::set<string>& names, BrowserTreeNode* node = nullptr) const;
 	BrowserItem* selectedItem() const;
 	bool         selectItem(const wxString& name, BrowserTreeNode* node = nullptr);
 
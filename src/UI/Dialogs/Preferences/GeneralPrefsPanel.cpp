@@ -48,6 +48,7 @@ EXTERN_CVAR(Bool, update_check)
 EXTERN_CVAR(Bool, update_check_beta)
 EXTERN_CVAR(Bool, confirm_exit)
 EXTERN_CVAR(Bool, backup_archives)
+EXTERN_CVAR(Int, zip_compression_level)
 
 
 // -----------------------------------------------------------------------------
@@ -62,6 +63,8 @@ EXTERN_CVAR(Bool, backup_archives)
 // -----------------------------------------------------------------------------
 GeneralPrefsPanel::GeneralPrefsPanel(wxWindow* parent) : PrefsPanelBase(parent)
 {
+	spin_zip_level_ = wxutil::createSpinCtrl(this, zip_compression_level, 0, 9);
+
 	// Create + Layout controls
 	SetSizer(wxutil::layoutVertically(
 		{ cb_archive_load_      = new wxCheckBox(this, -1, "Load all archive entry data to memory when opened"),
@@ -72,10 +75,14 @@ GeneralPrefsPanel::GeneralPrefsPanel(wxWindow* parent) : PrefsPanelBase(parent)
 		  cb_update_check_beta_ = new wxCheckBox(this, -1, "Include beta versions when checking for updates"),
 #endif
 		  cb_confirm_exit_    = new wxCheckBox(this, -1, "Show confirmation dialog on exit"),
-		  cb_backup_archives_ = new wxCheckBox(this, -1, "Back up archives") }));
+		  cb_backup_archives_ = new wxCheckBox(this, -1, "Back up archives"),
+		  wxutil::createLabelHBox(this, "Zip compression level (0 = store only):", spin_zip_level_) }));
 
 	cb_wads_root_->SetToolTip(
 		"When opening a zip or folder archive, automatically open all wad entries in the root directory");
+	spin_zip_level_->SetToolTip(
+		"The deflate level used for modified entries when saving zip archives. Higher levels are smaller but "
+		"slower to save");
 }
 
 // -----------------------------------------------------------------------------
@@ -92,6 +99,7 @@ void GeneralPrefsPanel::init()
 #endif
 	cb_confirm_exit_->SetValue(confirm_exit);
 	cb_backup_archives_->SetValue(backup_archives);
+	spin_zip_level_->SetValue(zip_compression_level);
 }
 
 // -----------------------------------------------------------------------------
@@ -106,6 +114,7 @@ void GeneralPrefsPanel::applyPreferences()
 	update_check      = cb_update_check_->GetValue();
 	update_check_beta = cb_update_check_beta_->GetValue();
 #endif
-	confirm_exit    = cb_confirm_exit_->GetValue();
-	backup_archives = cb_backup_archives_->GetValue();
+	confirm_exit          = cb_confirm_exit_->GetValue();
+	backup_archives       = cb_backup_archives_->GetValue();
+	zip_compression_level = spin_zip_level_->GetValue();
 }
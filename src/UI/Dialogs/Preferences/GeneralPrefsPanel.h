@@ -22,5 +22,6 @@ private:
 	wxCheckBox* cb_update_check_beta_ = nullptr;
 	wxCheckBox* cb_confirm_exit_      = nullptr;
 	wxCheckBox* cb_backup_archives_   = nullptr;
+	wxSpinCtrl* spin_zip_level_       = nullptr;
 };
 } // namespace slade
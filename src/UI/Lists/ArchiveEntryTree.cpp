@@ -42,6 +42,8 @@
 #include "General/UndoRedo.h"
 #include "Graphics/Icons.h"
 #include "UI/WxUtils.h"
+#include "Utility/Parallel.h"
+#include <unordered_set>
 #include <wx/headerctrl.h>
 
 using namespace slade;
@@ -72,6 +74,12 @@ CVAR(Bool, elist_rename_inplace, false, CVar::Save)
 CVAR(Bool, elist_rename_inplace, true, CVar::Save)
 #endif
 
+namespace
+{
+// Directories with at least this many items are filtered across multiple threads
+constexpr size_t FILTER_PARALLEL_MIN = 4096;
+} // namespace
+
 
 // -----------------------------------------------------------------------------
 //
@@ -118,6 +126,7 @@ void ArchiveViewModel::openArchive(shared_ptr<Archive> archive, UndoManager* und
 {
 	archive_      = archive;
 	undo_manager_ = undo_manager;
+	sort_by_name_ = archive->formatId() == "folder";
 
 	// Add root items
 	wxDataViewItemArray items;
@@ -129,12 +138,18 @@ void ArchiveViewModel::openArchive(shared_ptr<Archive> archive, UndoManager* und
 
 	// Entry added
 	connections_ += archive->signals().entry_added.connect([this](Archive& archive, ArchiveEntry& entry) {
+		if (auto i = dir_items_.find(entry.parentDir()); i != dir_items_.end())
+			i->second.push_back(&entry);
+
 		ItemAdded(createItemForDirectory(*entry.parentDir()), wxDataViewItem(&entry));
 	});
 
 	// Entry removed
 	connections_ += archive->signals().entry_removed.connect(
 		[this](Archive& archive, ArchiveDir& dir, ArchiveEntry& entry) {
+			if (auto i = dir_items_.find(&dir); i != dir_items_.end())
+				i->second.erase(std::remove(i->second.begin(), i->second.end(), &entry), i->second.end());
+
 			ItemDeleted(createItemForDirectory(dir), wxDataViewItem(&entry));
 		});
 
@@ -144,12 +159,20 @@ void ArchiveViewModel::openArchive(shared_ptr<Archive> archive, UndoManager* und
 
 	// Dir added
 	connections_ += archive->signals().dir_added.connect([this](Archive& archive, ArchiveDir& dir) {
+		if (auto i = dir_items_.find(dir.parent().get()); i != dir_items_.end())
+			i->second.push_back(dir.dirEntry());
+
 		ItemAdded(createItemForDirectory(*dir.parent()), wxDataViewItem(dir.dirEntry()));
 	});
 
 	// Dir removed
 	connections_ += archive->signals().dir_removed.connect(
 		[this](Archive& archive, ArchiveDir& parent, ArchiveDir& dir) {
+			if (auto i = dir_items_.find(&parent); i != dir_items_.end())
+				i->second.erase(
+					std::remove(i->second.begin(), i->second.end(), dir.dirEntry()), i->second.end());
+			forgetDir(dir);
+
 			ItemDeleted(createItemForDirectory(parent), wxDataViewItem(dir.dirEntry()));
 		});
 
@@ -176,7 +199,10 @@ void ArchiveViewModel::openArchive(shared_ptr<Archive> archive, UndoManager* und
 }
 
 // -----------------------------------------------------------------------------
-// Sets the current filter options for the model
+// Sets the current filter options for the model.
+// Only the items in directories the control has already loaded are updated,
+// and if the new filter can only narrow down the currently shown items (eg.
+// more characters were typed), only those items are checked
 // -----------------------------------------------------------------------------
 void ArchiveViewModel::setFilter(string_view name, string_view category)
 {
@@ -184,15 +210,8 @@ void ArchiveViewModel::setFilter(string_view name, string_view category)
 	if (name.empty() && filter_name_.empty() && filter_category_ == category)
 		return;
 
-	// Get current root items (to remove)
-	wxDataViewItemArray prev_items;
-	if (auto* archive = archive_.lock().get())
-		getDirChildItems(prev_items, *archive->rootDir());
-
-	filter_category_ = category;
-
 	// Process filter string
-	filter_name_.clear();
+	vector<string> filter_name;
 	if (!name.empty())
 	{
 		auto filter_parts = strutil::splitV(name, ',');
@@ -204,24 +223,27 @@ void ArchiveViewModel::setFilter(string_view name, string_view category)
 
 			strutil::upperIP(filter_part);
 			filter_part += '*';
-			filter_name_.push_back(filter_part);
+			filter_name.push_back(filter_part);
 		}
 	}
 
+	auto narrowing   = filterNarrows(filter_name, category);
+	filter_name_     = std::move(filter_name);
+	filter_category_ = category;
+
 	if (auto* archive = archive_.lock().get())
 	{
 		sort_enabled_ = false;
 
-		// Remove previous root items
-		ItemsDeleted({}, prev_items);
-
-		// Re-Add root items (filtered)
-		wxDataViewItemArray items;
-		getDirChildItems(items, *archive->rootDir());
-		ItemsAdded({}, items);
+		// Update shown items, starting from the root dir
+		auto added = refilterDir(*archive->rootDir(), narrowing);
 
 		sort_enabled_ = true;
-		Resort();
+
+		// Removing items doesn't affect the sort order, so only resort if any
+		// were added
+		if (added)
+			Resort();
 	}
 }
 
@@ -553,7 +575,7 @@ int ArchiveViewModel::Compare(
 		else
 		{
 			// Directory archives default to alphabetical order
-			if (auto archive = archive_.lock(); archive->formatId() == "folder")
+			if (sort_by_name_)
 				cmpval = e1->upperName().compare(e2->upperName());
 
 			// Everything else defaults to index order
@@ -604,28 +626,182 @@ bool ArchiveViewModel::matchesFilter(const ArchiveEntry& entry) const
 	return true;
 }
 
+// -----------------------------------------------------------------------------
+// Returns true if the filter [name] + [category] can only match a subset of
+// what the current filter matches
+// -----------------------------------------------------------------------------
+bool ArchiveViewModel::filterNarrows(const vector<string>& name, string_view category) const
+{
+	if (category != filter_category_)
+		return false;
+
+	// No current filter, everything is shown
+	if (filter_name_.empty())
+		return filter_category_.empty();
+
+	// Each name filter part must be a continuation of the current one
+	// (parts end with a '*' that needs to be ignored here)
+	if (name.size() != filter_name_.size())
+		return false;
+	for (unsigned a = 0; a < name.size(); a++)
+		if (!strutil::startsWith(name[a], string_view{ filter_name_[a] }.substr(0, filter_name_[a].size() - 1)))
+			return false;
+
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Returns a flag for each of [items], 1 if it should be shown with the current
+// filter, 0 if not
+// -----------------------------------------------------------------------------
+vector<uint8_t> ArchiveViewModel::checkFilter(const vector<ArchiveEntry*>& items) const
+{
+	vector<uint8_t> show(items.size(), 1);
+	if (filter_name_.empty() && filter_category_.empty())
+		return show;
+
+	auto check = [&](size_t a) {
+		if (items[a]->type() == EntryType::folderType())
+			show[a] = !elist_filter_dirs || matchesFilter(*items[a]);
+		else
+			show[a] = matchesFilter(*items[a]);
+	};
+
+	// Large directories are split across multiple threads
+	if (items.size() >= FILTER_PARALLEL_MIN)
+		parallel::forEach(items.size(), check, {}, 1024);
+	else
+		for (unsigned a = 0; a < items.size(); a++)
+			check(a);
+
+	return show;
+}
+
 // -----------------------------------------------------------------------------
 // Populates [items] with all child entries/subrirs of [dir].
-// If [filtered] is true, only adds children matching the current filter
+// If [filtered] is true, only adds children matching the current filter (and
+// records them as the items given to the control for [dir])
 // -----------------------------------------------------------------------------
 void ArchiveViewModel::getDirChildItems(wxDataViewItemArray& items, const ArchiveDir& dir, bool filtered) const
 {
+	vector<ArchiveEntry*> children;
+	children.reserve(dir.subdirs().size() + dir.entries().size());
+	for (const auto& subdir : dir.subdirs())
+		children.push_back(subdir->dirEntry());
+	for (const auto& entry : dir.entries())
+		children.push_back(entry.get());
+
 	if (filtered)
 	{
-		for (const auto& subdir : dir.subdirs())
-			if (!elist_filter_dirs || matchesFilter(*subdir->dirEntry()))
-				items.push_back(wxDataViewItem{ subdir->dirEntry() });
-		for (const auto& entry : dir.entries())
-			if (matchesFilter(*entry))
-				items.push_back(wxDataViewItem{ entry.get() });
+		auto show = checkFilter(children);
+		auto n    = 0u;
+		for (unsigned a = 0; a < children.size(); a++)
+			if (show[a])
+				children[n++] = children[a];
+		children.resize(n);
 	}
+
+	items.reserve(items.size() + children.size());
+	for (auto* entry : children)
+		items.push_back(wxDataViewItem{ entry });
+
+	if (filtered)
+		dir_items_[&dir] = std::move(children);
+}
+
+// -----------------------------------------------------------------------------
+// Re-applies the current filter to the items shown in [dir] and any of its
+// subdirs the control has loaded, adding/removing items to match.
+// If [narrowing] is true, only the currently shown items are checked.
+// Returns true if any items were added
+// -----------------------------------------------------------------------------
+bool ArchiveViewModel::refilterDir(const ArchiveDir& dir, bool narrowing)
+{
+	// Nothing to do if the control hasn't loaded the directory's items
+	auto prev = dir_items_.find(&dir);
+	if (prev == dir_items_.end())
+		return false;
+
+	// Get items to check
+	vector<ArchiveEntry*> items;
+	if (narrowing)
+		items = prev->second;
 	else
 	{
+		items.reserve(dir.subdirs().size() + dir.entries().size());
 		for (const auto& subdir : dir.subdirs())
-			items.push_back(wxDataViewItem{ subdir->dirEntry() });
+			items.push_back(subdir->dirEntry());
 		for (const auto& entry : dir.entries())
-			items.push_back(wxDataViewItem{ entry.get() });
+			items.push_back(entry.get());
 	}
+
+	// Check items against the filter, and get what was added and removed
+	auto                  show = checkFilter(items);
+	vector<ArchiveEntry*> shown;
+	wxDataViewItemArray   added, removed;
+	if (narrowing)
+	{
+		for (unsigned a = 0; a < items.size(); a++)
+		{
+			if (show[a])
+				shown.push_back(items[a]);
+			else
+				removed.push_back(wxDataViewItem{ items[a] });
+		}
+	}
+	else
+	{
+		std::unordered_set<ArchiveEntry*> prev_items(prev->second.begin(), prev->second.end());
+		for (unsigned a = 0; a < items.size(); a++)
+		{
+			if (!show[a])
+				continue;
+
+			shown.push_back(items[a]);
+			if (prev_items.erase(items[a]) == 0)
+				added.push_back(wxDataViewItem{ items[a] });
+		}
+		for (auto* entry : prev->second)
+			if (prev_items.count(entry) > 0)
+				removed.push_back(wxDataViewItem{ entry });
+	}
+
+	// Update the control
+	auto parent = createItemForDirectory(dir);
+	if (!removed.empty())
+		ItemsDeleted(parent, removed);
+	if (!added.empty())
+		ItemsAdded(parent, added);
+
+	// Continue with any subdirs still shown, and forget any that aren't (the
+	// control will have removed their items)
+	std::unordered_set<ArchiveEntry*> shown_dirs;
+	for (auto* entry : shown)
+		if (entry->type() == EntryType::folderType())
+			shown_dirs.insert(entry);
+	dir_items_[&dir] = std::move(shown);
+
+	auto any_added = !added.empty();
+	for (const auto& subdir : dir.subdirs())
+	{
+		if (shown_dirs.count(subdir->dirEntry()) > 0)
+			any_added |= refilterDir(*subdir, narrowing);
+		else
+			forgetDir(*subdir);
+	}
+
+	return any_added;
+}
+
+// -----------------------------------------------------------------------------
+// Forgets the recorded shown items for [dir] and all its subdirs
+// -----------------------------------------------------------------------------
+void ArchiveViewModel::forgetDir(const ArchiveDir& dir)
+{
+	for (const auto& subdir : dir.subdirs())
+		forgetDir(*subdir);
+
+	dir_items_.erase(&dir);
 }
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "General/Sigslot.h"
+#include <unordered_map>
 #include <wx/dataview.h>
 
 namespace slade
@@ -21,12 +22,16 @@ namespace ui
 		void setFilter(string_view name, string_view category);
 
 	private:
+		typedef std::unordered_map<const ArchiveDir*, vector<ArchiveEntry*>> DirItemsMap;
+
 		weak_ptr<Archive>    archive_;
 		ScopedConnectionList connections_;
 		vector<string>       filter_name_;
 		string               filter_category_;
 		UndoManager*         undo_manager_ = nullptr;
 		bool                 sort_enabled_ = true;
+		bool                 sort_by_name_ = false; // Default sort is by name rather than index
+		mutable DirItemsMap  dir_items_;            // Items given to the control for each loaded directory
 
 		// wxDataViewModel
 		unsigned int   GetColumnCount() const override { return 4; }
@@ -42,9 +47,13 @@ namespace ui
 		int Compare(const wxDataViewItem& item1, const wxDataViewItem& item2, unsigned int column, bool ascending)
 			const override;
 
-		wxDataViewItem createItemForDirectory(const ArchiveDir& dir) const;
-		bool           matchesFilter(const ArchiveEntry& entry) const;
-		void           getDirChildItems(wxDataViewItemArray& items, const ArchiveDir& dir, bool filter = true) const;
+		wxDataViewItem  createItemForDirectory(const ArchiveDir& dir) const;
+		bool            matchesFilter(const ArchiveEntry& entry) const;
+		bool            filterNarrows(const vector<string>& name, string_view category) const;
+		vector<uint8_t> checkFilter(const vector<ArchiveEntry*>& items) const;
+		void            getDirChildItems(wxDataViewItemArray& items, const ArchiveDir& dir, bool filter = true) const;
+		bool            refilterDir(const ArchiveDir& dir, bool narrowing);
+		void            forgetDir(const ArchiveDir& dir);
 	};
 
 	class ArchiveEntryTree : public wxDataViewCtrl
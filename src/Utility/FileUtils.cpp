@@ -8,7 +8,8 @@
 // Filename:    FileUtils.cpp
 // Description: Various filesystem utility functions. Also includes SFile, a
 //              simple safe-ish wrapper around a c-style FILE with various
-//              convenience functions
+//              convenience functions, and MappedFile, a read-only memory
+//              mapped file
 //
 // This program is free software; you can redistribute it and/or modify it
 // under the terms of the GNU General Public License as published by the Free
@@ -35,6 +36,14 @@
 #include "FileUtils.h"
 #include <filesystem>
 #include <fstream>
+#include <limits>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 using namespace slade;
 namespace fs = std::filesystem;
@@ -324,3 +333,118 @@ bool SFile::writeStr(string_view str) const
 
 	return false;
 }
+
+
+// -----------------------------------------------------------------------------
+//
+// MappedFile Class Functions
+//
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+// Maps the file at [path] into memory.
+// Returns false if the file couldn't be opened or mapped
+// -----------------------------------------------------------------------------
+bool MappedFile::open(string_view path)
+{
+	// Needs to be closed first if already open
+	if (data_)
+		return false;
+
+	auto fs_path = fs::path{ path };
+	if (!fs::is_regular_file(fs_path))
+		return false;
+
+	// Can't map an empty file (or one too large for a MemChunk)
+	auto file_size = fs::file_size(fs_path);
+	if (file_size == 0 || file_size > (std::numeric_limits<uint32_t>::max)())
+		return false;
+
+#ifdef _WIN32
+	file_handle_ = CreateFileW(
+		fs_path.wstring().c_str(),
+		GENERIC_READ,
+		FILE_SHARE_READ | FILE_SHARE_DELETE, // Allow the file to be replaced (but not written) while mapped
+		nullptr,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		nullptr);
+	if (file_handle_ == INVALID_HANDLE_VALUE)
+	{
+		file_handle_ = nullptr;
+		return false;
+	}
+
+	mapping_handle_ = CreateFileMappingW(file_handle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping_handle_)
+	{
+		close();
+		return false;
+	}
+
+	data_ = static_cast<uint8_t*>(MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+	if (!data_)
+	{
+		close();
+		return false;
+	}
+#else
+	int fd = ::open(fs_path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	auto mapped = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd); // The mapping keeps its own reference to the file
+
+	if (mapped == MAP_FAILED)
+		return false;
+
+	data_ = static_cast<uint8_t*>(mapped);
+#endif
+
+	size_          = static_cast<unsigned>(file_size);
+	path_          = path;
+	modified_time_ = fileutil::fileModifiedTime(path);
+
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Unmaps the file
+// -----------------------------------------------------------------------------
+void MappedFile::close()
+{
+#ifdef _WIN32
+	if (data_)
+		UnmapViewOfFile(data_);
+	if (mapping_handle_)
+		CloseHandle(mapping_handle_);
+	if (file_handle_)
+		CloseHandle(file_handle_);
+	mapping_handle_ = nullptr;
+	file_handle_    = nullptr;
+#else
+	if (data_)
+		munmap(data_, size_);
+#endif
+
+	data_ = nullptr;
+	size_ = 0;
+	path_.clear();
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if the mapped file has been modified (or truncated) since it
+// was mapped. If the file was deleted the mapping is still valid, so this
+// returns false
+// -----------------------------------------------------------------------------
+bool MappedFile::fileChanged() const
+{
+	std::error_code ec;
+	auto            file_size = fs::file_size(fs::path{ path_ }, ec);
+	if (ec)
+		return false;
+
+	return file_size != size_ || fileutil::fileModifiedTime(path_) != modified_time_;
+}
@@ -55,4 +55,42 @@ private:
 	FILE*       handle_ = nullptr;
 	struct stat stat_;
 };
+
+// A read-only memory mapping of a file. The mapped memory can't be written to,
+// anything that needs to modify it must copy it first (see MemChunk::detach).
+//
+// Note that the file should not be modified by anything else while it is
+// mapped. On Windows the file is opened without write sharing so this is
+// prevented, but elsewhere, if another process truncates the file, accessing
+// mapped pages past its new end will raise SIGBUS. Use fileChanged() to check
+// before accessing data that may not have been accessed yet
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	MappedFile(string_view path) { open(path); }
+	~MappedFile() { close(); }
+
+	// Non-copyable
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool           isOpen() const { return data_ != nullptr; }
+	const uint8_t* data() const { return data_; }
+	unsigned       size() const { return size_; }
+
+	bool open(string_view path);
+	void close();
+	bool fileChanged() const;
+
+private:
+	uint8_t* data_          = nullptr;
+	unsigned size_          = 0;
+	string   path_;
+	time_t   modified_time_ = 0;
+#ifdef _WIN32
+	void* file_handle_    = nullptr;
+	void* mapping_handle_ = nullptr;
+#endif
+};
 } // namespace slade
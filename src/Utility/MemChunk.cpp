@@ -72,7 +72,7 @@ MemChunk::MemChunk(const uint8_t* data, uint32_t size) : size_{ size }
 MemChunk::~MemChunk()
 {
 	// Free memory
-	delete[] data_;
+	freeData();
 }
 
 // -----------------------------------------------------------------------------
@@ -91,7 +91,7 @@ bool MemChunk::clear()
 {
 	if (hasData())
 	{
-		delete[] data_;
+		freeData();
 		data_    = nullptr;
 		size_    = 0;
 		cur_ptr_ = 0;
@@ -128,7 +128,7 @@ bool MemChunk::reSize(uint32_t new_size, bool preserve_data)
 	else if (data_ != nullptr)
 	{
 		memcpy(ndata, data_, size_ * sizeof(uint8_t));
-		delete[] data_;
+		freeData();
 		data_ = ndata;
 	}
 	else
@@ -298,6 +298,69 @@ bool MemChunk::importMem(const uint8_t* start, uint32_t len)
 	return true;
 }
 
+// -----------------------------------------------------------------------------
+// Loads [len] bytes from [offset] in [source] into the MemChunk.
+// If [source] is a view, no data is copied and this MemChunk will also become a
+// view into the same memory, otherwise the data is copied as with importMem.
+// Returns false if the given range is outside of [source], true otherwise
+// -----------------------------------------------------------------------------
+bool MemChunk::importView(const MemChunk& source, uint32_t offset, uint32_t len)
+{
+	// Check range
+	if (!source.hasData() || offset + len > source.size_)
+		return false;
+
+	// Just copy if the source isn't a view
+	if (!source.isView() || len == 0)
+		return importMem(source.data_ + offset, len);
+
+	setView(source.data_ + offset, len, source.view_owner_);
+
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+// Sets the MemChunk to be a view of [size] bytes of existing [data], clearing
+// any current data. The memory is kept valid by holding a reference to
+// [owner] while the view exists.
+//
+// The viewed memory is never written to (it may be a read-only mapping of a
+// file, and other MemChunks may be viewing the same memory). Anything that can
+// modify the data (write, fill, non-const data access, etc.) copies it first via
+// detach(), and any operation that reallocates the data (resize, import, etc.)
+// also stops the MemChunk from being a view
+// -----------------------------------------------------------------------------
+void MemChunk::setView(const uint8_t* data, uint32_t size, shared_ptr<void> owner)
+{
+	clear();
+
+	data_       = const_cast<uint8_t*>(data);
+	size_       = size;
+	cur_ptr_    = 0;
+	view_owner_ = std::move(owner);
+}
+
+// -----------------------------------------------------------------------------
+// If the MemChunk is a view, copies the viewed data into memory owned by the
+// MemChunk so that it no longer references the view owner.
+// Returns false if the copy failed
+// -----------------------------------------------------------------------------
+bool MemChunk::detach()
+{
+	if (!isView())
+		return true;
+
+	auto ndata = allocData(size_, false);
+	if (!ndata)
+		return false;
+
+	memcpy(ndata, data_, size_);
+	view_owner_.reset();
+	data_ = ndata;
+
+	return true;
+}
+
 // -----------------------------------------------------------------------------
 // Writes the MemChunk data to a new file of [filename], starting from [start]
 // to [start+size].
@@ -377,6 +440,10 @@ bool MemChunk::write(unsigned offset, const void* data, unsigned size, bool expa
 			return false;
 	}
 
+	// Copy the data first if it's a view
+	if (!detach())
+		return false;
+
 	// Write the data
 	memcpy(data_ + offset, data, size);
 
@@ -420,6 +487,10 @@ bool MemChunk::write(const void* buffer, uint32_t count)
 	if (cur_ptr_ + count > size_)
 		reSize(cur_ptr_ + count, true);
 
+	// Copy the data first if it's a view
+	if (!detach())
+		return false;
+
 	// Write the data and move to the byte after what was written
 	memcpy(data_ + cur_ptr_, buffer, count);
 	cur_ptr_ += count;
@@ -529,10 +600,10 @@ bool MemChunk::readMC(MemChunk& mc, uint32_t size)
 // Overwrites all data bytes with [val] (basically is memset).
 // Returns false if no data exists, true otherwise
 // -----------------------------------------------------------------------------
-bool MemChunk::fillData(uint8_t val) const
+bool MemChunk::fillData(uint8_t val)
 {
-	// Check data exists
-	if (!hasData())
+	// Check data exists (and copy it first if it's a view)
+	if (!hasData() || !detach())
 		return false;
 
 	// Fill data with value
@@ -583,3 +654,15 @@ uint8_t* MemChunk::allocData(uint32_t size, bool set_data)
 
 	return ndata;
 }
+
+// -----------------------------------------------------------------------------
+// Frees the current data (or releases it if the MemChunk is a view).
+// Note that this doesn't reset data_ or size_
+// -----------------------------------------------------------------------------
+void MemChunk::freeData()
+{
+	if (view_owner_)
+		view_owner_.reset();
+	else
+		delete[] data_;
+}
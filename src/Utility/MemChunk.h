@@ -14,11 +14,20 @@ public:
 	MemChunk(const uint8_t* data, uint32_t size);
 	~MemChunk();
 
-	uint8_t& operator[](int a) const { return data_[a]; }
+	// Read-only, since writing could modify viewed data. Write via data() instead
+	const uint8_t& operator[](int a) const { return data_[a]; }
 
 	// Accessors
+	// (non-const data access detaches a view first, as the data may be modified.
+	// For a view of a memory-mapped file this silently copies all the viewed
+	// data, so code that only reads should go through a const MemChunk, and code
+	// that writes in a loop should get the pointer once before the loop)
 	const uint8_t* data() const { return data_; }
-	uint8_t*       data() { return data_; }
+	uint8_t*       data()
+	{
+		detach();
+		return data_;
+	}
 
 	// SeekableData
 	unsigned size() const override { return size_; }
@@ -40,6 +49,12 @@ public:
 	bool importFileStream(SFile& file, unsigned len = 0);
 	bool importMem(const uint8_t* start, uint32_t len);
 	bool importMem(const MemChunk& other) { return importMem(other.data_, other.size_); }
+	bool importView(const MemChunk& source, uint32_t offset, uint32_t len);
+
+	// Views
+	bool isView() const { return view_owner_ != nullptr; }
+	void setView(const uint8_t* data, uint32_t size, shared_ptr<void> owner);
+	bool detach();
 
 	// Data export
 	bool exportFile(string_view filename, uint32_t start = 0, uint32_t size = 0) const;
@@ -58,7 +73,7 @@ public:
 	bool readMC(MemChunk& mc, uint32_t size);
 
 	// Misc
-	bool     fillData(uint8_t val) const;
+	bool     fillData(uint8_t val);
 	uint32_t crc() const;
 
 	// Platform-independent functions to read values in little (L##) or big (B##) endian
@@ -80,6 +95,11 @@ protected:
 	uint32_t cur_ptr_ = 0;
 	uint32_t size_    = 0;
 
+	// If set, data_ points into memory owned by this (eg. a MappedFile) rather
+	// than being allocated by the MemChunk itself
+	shared_ptr<void> view_owner_;
+
 	uint8_t* allocData(uint32_t size, bool set_data = true);
+	void     freeData();
 };
 } // namespace slade
@@ -0,0 +1,181 @@
+// -----------------------------------------------------------------------------
+// SLADE - It's a Doom Editor
+// Copyright(C) 2008 - 2020 Simon Judd
+//
+// Email:       sirjuddington@gmail.com
+// Web:         http://slade.mancubus.net
+// Filename:    Parallel.cpp
+// Description: Simple helpers for splitting independent work across multiple
+//              worker threads
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation; either version 2 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+//
+// Includes
+//
+// -----------------------------------------------------------------------------
+#include "Main.h"
+#include "Parallel.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+using namespace slade;
+
+
+// -----------------------------------------------------------------------------
+//
+// Variables
+//
+// -----------------------------------------------------------------------------
+CVAR(Int, max_worker_threads, 0, CVar::Flag::Save) // 0 = use all available cores
+
+
+// -----------------------------------------------------------------------------
+//
+// Parallel Namespace Functions
+//
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+// Returns the number of threads (including the calling thread) to use for
+// parallel operations, taking the max_worker_threads cvar into account
+// -----------------------------------------------------------------------------
+unsigned parallel::numThreads()
+{
+	unsigned n_threads = std::thread::hardware_concurrency();
+	if (n_threads == 0)
+		n_threads = 1;
+
+	if (max_worker_threads > 0 && static_cast<unsigned>(max_worker_threads) < n_threads)
+		n_threads = max_worker_threads;
+
+	return n_threads;
+}
+
+// -----------------------------------------------------------------------------
+// Calls [func] for each index from 0 to [count]-1, split across worker threads.
+// Indices are handed out in batches of [batch_size], so [func] must be safe to
+// call concurrently for different indices.
+//
+// The calling thread also processes batches, and calls [progress] (if given)
+// with the number of indices completed so far after each of its batches - this
+// means [progress] is always called from the calling thread, so it can safely
+// update the UI.
+//
+// If [func] (or [progress]) throws, no more batches are started and the first
+// exception is rethrown on the calling thread once all workers have finished
+// -----------------------------------------------------------------------------
+void parallel::forEach(
+	size_t                             count,
+	const std::function<void(size_t)>& func,
+	const std::function<void(size_t)>& progress,
+	size_t                             batch_size)
+{
+	if (count == 0)
+		return;
+
+	if (batch_size == 0)
+		batch_size = 1;
+
+	// Determine number of threads to use
+	auto n_batches = (count + batch_size - 1) / batch_size;
+	auto n_threads = std::min<size_t>(numThreads(), n_batches);
+
+	// Just process everything on this thread if there's no point in splitting it up
+	if (n_threads <= 1)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			func(i);
+			if (progress && (i + 1) % batch_size == 0)
+				progress(i + 1);
+		}
+		if (progress)
+			progress(count);
+		return;
+	}
+
+	std::atomic<size_t> next{ 0 };
+	std::atomic<size_t> done{ 0 };
+	std::exception_ptr  error;
+	std::mutex          error_mutex;
+
+	// Stops handing out batches, and keeps [e] if it is the first exception
+	auto fail = [&](std::exception_ptr e) {
+		next = count;
+
+		std::unique_lock lock(error_mutex);
+		if (!error)
+			error = std::move(e);
+	};
+
+	// Processes a batch, returns false if there were none left (or processing
+	// failed)
+	auto process_batch = [&]() {
+		auto start = next.fetch_add(batch_size);
+		if (start >= count)
+			return false;
+
+		auto end = std::min(start + batch_size, count);
+		try
+		{
+			for (auto i = start; i < end; ++i)
+				func(i);
+		}
+		catch (...)
+		{
+			fail(std::current_exception());
+			return false;
+		}
+
+		done += end - start;
+		return true;
+	};
+
+	// Start worker threads, and process batches on this thread too
+	vector<std::thread> workers;
+	try
+	{
+		workers.reserve(n_threads - 1);
+		for (size_t t = 0; t < n_threads - 1; ++t)
+			workers.emplace_back([&]() {
+				while (process_batch()) {}
+			});
+
+		while (process_batch())
+			if (progress)
+				progress(done.load());
+	}
+	catch (...)
+	{
+		fail(std::current_exception());
+	}
+
+	// Wait for workers to finish (always, since destroying a joinable thread
+	// terminates the program)
+	for (auto& worker : workers)
+		worker.join();
+
+	if (error)
+		std::rethrow_exception(error);
+
+	if (progress)
+		progress(count);
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+namespace slade::parallel
+{
+unsigned numThreads();
+void     forEach(
+		size_t                             count,
+		const std::function<void(size_t)>& func,
+		const std::function<void(size_t)>& progress   = {},
+		size_t                             batch_size = 16);
+} // namespace slade::parallel
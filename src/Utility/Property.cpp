@@ -33,9 +33,74 @@
 // -----------------------------------------------------------------------------
 #include "Main.h"
 #include "Property.h"
+#include <array>
+#include <cassert>
+#include <shared_mutex>
+#include <unordered_map>
 
 using namespace slade;
 
+
+// -----------------------------------------------------------------------------
+//
+// Variables
+//
+// -----------------------------------------------------------------------------
+namespace
+{
+// Case-insensitive hash and comparison of property names, so they can be
+// looked up without converting them to lowercase first
+struct KeyHash
+{
+	size_t operator()(string_view name) const
+	{
+		// FNV-1a
+		uint64_t hash = 14695981039346656037ull;
+		for (auto c : name)
+		{
+			hash ^= static_cast<uint8_t>(tolower(c));
+			hash *= 1099511628211ull;
+		}
+		return static_cast<size_t>(hash);
+	}
+};
+struct KeyEqual
+{
+	bool operator()(string_view left, string_view right) const { return strutil::equalCI(left, right); }
+};
+using KeyIdMap = std::unordered_map<string_view, unsigned, KeyHash, KeyEqual>;
+
+// Interned property names, may be used from multiple threads (eg. archive
+// entry properties set while loading).
+// Names are never removed or moved once added, so the id map can refer to
+// them by string_view, and they can be read without locking: an id can only
+// be obtained after its name has been added
+struct KeyTable
+{
+	static constexpr unsigned chunk_size  = 1024;
+	static constexpr unsigned max_chunks  = 4096;
+	static constexpr unsigned overflow_id = 0; // Reserved for names that can't be added once the table is full
+
+	std::shared_mutex                            mutex;
+	KeyIdMap                                     ids;   // Name -> id
+	std::array<unique_ptr<string[]>, max_chunks> names; // Name (as first given) for each id, in chunks
+	unsigned                                     count = 1;
+
+	KeyTable()
+	{
+		names[0]              = std::make_unique<string[]>(chunk_size);
+		names[0][overflow_id] = "<overflow>";
+	}
+};
+
+KeyTable& keyTable()
+{
+	static KeyTable table;
+	return table;
+}
+} // namespace
+
+
 namespace slade::property
 {
 bool asBool(const Property& prop)
@@ -103,33 +168,92 @@ string asString(const Property& prop)
 	}
 }
 
+// Returns the id for property name [name], adding it to the table if needed
+unsigned keyId(string_view name)
+{
+	// Check names already looked up on this thread first, to avoid locking
+	thread_local KeyIdMap cache;
+	if (auto i = cache.find(name); i != cache.end())
+		return i->second;
+
+	auto& table = keyTable();
+	{
+		std::shared_lock lock(table.mutex);
+		if (auto i = table.ids.find(name); i != table.ids.end())
+		{
+			cache.emplace(i->first, i->second);
+			return i->second;
+		}
+	}
+
+	std::unique_lock lock(table.mutex);
+	if (auto i = table.ids.find(name); i != table.ids.end())
+	{
+		cache.emplace(i->first, i->second);
+		return i->second;
+	}
+
+	auto id    = table.count;
+	auto chunk = id / KeyTable::chunk_size;
+	if (chunk >= KeyTable::max_chunks)
+	{
+		// Shouldn't ever happen, but if it does all further names share the
+		// reserved overflow id rather than another name's id
+		log::error("Too many property names, unable to add \"{}\"", name);
+		assert(chunk < KeyTable::max_chunks);
+		return KeyTable::overflow_id;
+	}
+	if (!table.names[chunk])
+		table.names[chunk] = std::make_unique<string[]>(KeyTable::chunk_size);
+
+	auto& stored = table.names[chunk][id % KeyTable::chunk_size];
+	stored       = name;
+	table.ids.emplace(stored, id);
+	cache.emplace(stored, id);
+	++table.count;
+
+	return id;
+}
+
+// Returns the property name for [id]. If a name was given with different
+// cases, the first one given is returned
+const string& keyName(unsigned id)
+{
+	return keyTable().names[id / KeyTable::chunk_size][id % KeyTable::chunk_size];
+}
 
 } // namespace property
 
 string PropertyList::toString(bool condensed) const
 {
-	// Init return string
 	string ret;
+	toString(ret, condensed);
+	return ret;
+}
 
-	// Go through all properties
+// -----------------------------------------------------------------------------
+// Appends all properties as "key = value;\n" lines to [out] (or "key=value;\n"
+// if [condensed] is true)
+// -----------------------------------------------------------------------------
+void PropertyList::toString(string& out, bool condensed) const
+{
+	auto separator = condensed ? "=" : " = ";
+	auto out_it    = std::back_inserter(out);
 	for (const auto& prop : properties_)
 	{
-		// Add "key = value;\n" to the return string
-		auto val = property::asString(prop.value);
-
-		if (property::valueType(prop.value) == property::ValueType::String)
+		const auto& name = prop.name();
+		switch (prop.value.index())
 		{
-			val.insert(val.begin(), '\"');
-			val.push_back('\"');
+		case 0:
+			fmt::format_to(out_it, "{}{}{};\n", name, separator, std::get<bool>(prop.value) ? "true" : "false");
+			break;
+		case 1: fmt::format_to(out_it, "{}{}{};\n", name, separator, std::get<int>(prop.value)); break;
+		case 2: fmt::format_to(out_it, "{}{}{};\n", name, separator, std::get<unsigned int>(prop.value)); break;
+		case 3: fmt::format_to(out_it, "{}{}{};\n", name, separator, std::get<double>(prop.value)); break;
+		case 4: fmt::format_to(out_it, "{}{}\"{}\";\n", name, separator, std::get<string>(prop.value)); break;
+		default: break;
 		}
-
-		if (condensed)
-			ret += fmt::format("{}={};\n", prop.name, val);
-		else
-			ret += fmt::format("{} = {};\n", prop.name, val);
 	}
-
-	return ret;
 }
 
 
@@ -51,66 +51,87 @@ namespace property
 	double       asFloat(const Property& prop);
 	string       asString(const Property& prop);
 
+	// Property name interning (case-insensitive)
+	unsigned      keyId(string_view name);
+	const string& keyName(unsigned id);
+
+	// An interned property name. Each distinct (case-insensitive) name is given
+	// a small integer id the first time it is used, so that PropertyList lookups
+	// only need to compare ids rather than strings.
+	// Converting a name to a Key still needs a (case-insensitive) hash lookup,
+	// so frequently used names should be kept as static Keys
+	class Key
+	{
+	public:
+		Key(string_view name) : id_{ keyId(name) } {}
+		Key(const char* name) : id_{ keyId(name) } {}
+		Key(const string& name) : id_{ keyId(name) } {}
+
+		unsigned      id() const { return id_; }
+		const string& name() const { return keyName(id_); }
+
+		bool operator==(const Key& rhs) const { return id_ == rhs.id_; }
+		bool operator!=(const Key& rhs) const { return id_ != rhs.id_; }
+
+	private:
+		unsigned id_;
+	};
 } // namespace property
 
 class PropertyList
 {
 public:
-	const vector<Named<Property>>& properties() const { return properties_; }
-	
-	Property& operator[](string_view key)
+	struct Entry
 	{
-		for (auto& prop : properties_)
-			if (strutil::equalCI(key, prop.name))
-				return prop.value;
+		property::Key key;
+		Property      value;
 
-		properties_.emplace_back(key, Property{});
-		return properties_.back().value;
-	}
+		const string& name() const { return key.name(); }
+	};
 
-	bool empty() const { return properties_.empty(); }
+	const vector<Entry>& properties() const { return properties_; }
 
-	bool contains(string_view key) const
+	Property& operator[](property::Key key)
 	{
-		for (const auto& prop : properties_)
-			if (strutil::equalCI(key, prop.name))
-				return true;
+		if (auto prop = find(key))
+			return *prop;
 
-		return false;
+		properties_.push_back({ key, Property{} });
+		return properties_.back().value;
 	}
 
-	template<typename T> T get(string_view key) const
+	bool empty() const { return properties_.empty(); }
+
+	bool contains(property::Key key) const { return find(key) != nullptr; }
+
+	template<typename T> T get(property::Key key) const
 	{
-		for (const auto& prop : properties_)
-			if (strutil::equalCI(key, prop.name))
-				return std::get<T>(prop.value);
+		if (auto prop = find(key))
+			return std::get<T>(*prop);
 
 		return T{};
 	}
-	
-	std::optional<Property> getIf(string_view key) const
+
+	std::optional<Property> getIf(property::Key key) const
 	{
-		for (const auto& prop : properties_)
-			if (strutil::equalCI(key, prop.name))
-				return prop.value;
+		if (auto prop = find(key))
+			return *prop;
 
 		return {};
 	}
 
-	template<typename T> std::optional<T> getIf(string_view key) const
+	template<typename T> std::optional<T> getIf(property::Key key) const
 	{
-		for (const auto& prop : properties_)
-			if (strutil::equalCI(key, prop.name))
-				return property::value<T>(prop.value);
+		if (auto prop = find(key))
+			return property::value<T>(*prop);
 
 		return {};
 	}
 
-	template<typename T> T getOr(string_view key, T default_val) const
+	template<typename T> T getOr(property::Key key, T default_val) const
 	{
-		for (const auto& prop : properties_)
-			if (strutil::equalCI(key, prop.name))
-				return property::value<T>(prop.value, default_val);
+		if (auto prop = find(key))
+			return property::value<T>(*prop, default_val);
 
 		return default_val;
 	}
@@ -124,16 +145,16 @@ public:
 	void allPropertyNames(vector<string>& list)
 	{
 		for (const auto& prop : properties_)
-			list.push_back(prop.name);
+			list.push_back(prop.name());
 	}
 
 	void clear() { properties_.clear(); }
 
-	bool remove(string_view key)
+	bool remove(property::Key key)
 	{
 		const auto count = properties_.size();
 		for (unsigned i = 0; i < count; ++i)
-			if (strutil::equalCI(key, properties_[i].name))
+			if (properties_[i].key == key)
 			{
 				properties_.erase(properties_.begin() + i);
 				return true;
@@ -143,9 +164,28 @@ public:
 	}
 
 	string toString(bool condensed = false) const;
+	void   toString(string& out, bool condensed = false) const;
 
 private:
-	vector<Named<Property>> properties_;
+	vector<Entry> properties_;
+
+	Property* find(property::Key key)
+	{
+		for (auto& prop : properties_)
+			if (prop.key == key)
+				return &prop.value;
+
+		return nullptr;
+	}
+
+	const Property* find(property::Key key) const
+	{
+		for (const auto& prop : properties_)
+			if (prop.key == key)
+				return &prop.value;
+
+		return nullptr;
+	}
 };
 } // namespace slade
 